@@ -0,0 +1,91 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmark of request encoding on write path.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "engine/write_data.h"
+#include "proto/common.pb.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+static std::vector<pb::common::KeyValue> GenKvs(int64_t num, int64_t value_size) {
+  std::vector<pb::common::KeyValue> kvs(num);
+  for (int64_t i = 0; i < num; ++i) {
+    kvs[i].set_key("key_" + std::to_string(i));
+    kvs[i].set_value(std::string(value_size, 'v'));
+  }
+  return kvs;
+}
+
+// Args: kv num, value size.
+static void BM_PutDatumTransformToRaft(benchmark::State& state) {
+  PutDatum datum;
+  datum.cf_name = "default";
+  datum.kvs = GenKvs(state.range(0), state.range(1));
+  for (auto _ : state) {
+    std::unique_ptr<pb::raft::Request> request(datum.TransformToRaft());
+    benchmark::DoNotOptimize(request.get());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_PutDatumTransformToRaft)->ArgsProduct({{1, 10, 100, 1000}, {64, 1024, 16384}});
+
+// Args: kv num, value size. Const overload copies every item.
+static void BM_PbRepeatedToVectorCopy(benchmark::State& state) {
+  pb::raft::PutRequest request;
+  for (auto& kv : GenKvs(state.range(0), state.range(1))) {
+    *request.add_kvs() = kv;
+  }
+  const auto& kvs = request.kvs();
+  for (auto _ : state) {
+    auto vec = Helper::PbRepeatedToVector(kvs);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_PbRepeatedToVectorCopy)->ArgsProduct({{1, 10, 100, 1000}, {64, 1024, 16384}});
+
+// Args: kv num, value size. Mutable overload moves items, rebuild source is not timed.
+static void BM_PbRepeatedToVectorMove(benchmark::State& state) {
+  auto kvs = GenKvs(state.range(0), state.range(1));
+  for (auto _ : state) {
+    state.PauseTiming();
+    pb::raft::PutRequest request;
+    for (auto& kv : kvs) {
+      *request.add_kvs() = kv;
+    }
+    state.ResumeTiming();
+
+    auto vec = Helper::PbRepeatedToVector(request.mutable_kvs());
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_PbRepeatedToVectorMove)->ArgsProduct({{1, 10, 100, 1000}, {64, 1024, 16384}});
+
+}  // namespace dingodb
+
+BENCHMARK_MAIN();
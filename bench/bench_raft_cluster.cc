@@ -0,0 +1,186 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replication pipeline benchmark on an in-process cluster, load is sent through
+// StoreService to region leaders.
+// e.g. ./bench_raft_cluster --store_num=3 --region_num=4 --benchmark_filter=KvPut
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "bench/raft_cluster.h"
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/strings/stringprintf.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+#include "store/store_metrics.h"
+
+DEFINE_int32(store_num, 3, "Number of store nodes");
+DEFINE_int32(coordinator_num, 3, "Number of coordinator nodes");
+DEFINE_int32(region_num, 1, "Number of regions, every store has all of them");
+DEFINE_int32(base_port, 23000, "First port of cluster nodes");
+DEFINE_string(cluster_path, "./raft_cluster", "Data dir of cluster nodes");
+DEFINE_string(conf_dir, "../conf", "Dir of store and coordinator config templates");
+DEFINE_int32(leader_change_interval_ms, 1000, "Transfer leaders interval of leader change benchmark");
+
+namespace dingodb {
+
+static RaftCluster* cluster = nullptr;
+
+// Send KvPut to the region leader, follow leader change until success.
+// Return retry times, -1 is failed.
+static int Put(uint64_t region_id, const std::string& key, const std::string& value, int& leader_index) {
+  for (int retry = 0; retry < 100; ++retry) {
+    if (leader_index < 0) {
+      leader_index = cluster->LeaderIndex(region_id);
+      if (leader_index < 0) {
+        bthread_usleep(10 * 1000);
+        continue;
+      }
+    }
+
+    pb::store::StoreService_Stub stub(cluster->StoreChannel(leader_index));
+    pb::store::KvPutRequest request;
+    pb::store::KvPutResponse response;
+    request.set_region_id(region_id);
+    request.mutable_kv()->set_key(key);
+    request.mutable_kv()->set_value(value);
+    brpc::Controller cntl;
+    stub.KvPut(&cntl, &request, &response, nullptr);
+    if (!cntl.Failed() && response.error().errcode() == 0) {
+      return retry;
+    }
+    leader_index = -1;
+  }
+  return -1;
+}
+
+static void ReportRaftCounters(benchmark::State& state) {
+  int64_t max_lag = 0;
+  for (auto region_id : cluster->RegionIds()) {
+    max_lag = std::max(max_lag, cluster->ApplyLag(region_id));
+  }
+  state.counters["apply_lag"] = max_lag;
+  // Propose to leader apply, include log replication and commit.
+  state.counters["commit_p50_us"] = StoreMetrics::write_raft_latency.latency_percentile(0.5);
+  state.counters["commit_p99_us"] = StoreMetrics::write_raft_latency.latency_percentile(0.99);
+  state.counters["apply_p99_us"] = StoreMetrics::write_apply_latency.latency_percentile(0.99);
+}
+
+static void RunPut(benchmark::State& state, std::atomic<int64_t>& retries, std::atomic<int64_t>& errors) {
+  const auto& region_ids = cluster->RegionIds();
+  uint64_t region_id = region_ids[state.thread_index() % region_ids.size()];
+  std::string value(state.range(0), 'v');
+  std::string prefix = butil::StringPrintf("%lu_%d_", region_id, state.thread_index());
+  int leader_index = -1;
+  int64_t num = 0;
+
+  for (auto _ : state) {
+    int retry = Put(region_id, prefix + std::to_string(num++), value, leader_index);
+    if (retry < 0) {
+      errors++;
+    } else {
+      retries += retry;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Args: value size.
+static void BM_KvPut(benchmark::State& state) {
+  std::atomic<int64_t> retries{0};
+  std::atomic<int64_t> errors{0};
+  RunPut(state, retries, errors);
+
+  state.counters["retries"] = retries.load();
+  state.counters["errors"] = errors.load();
+  if (state.thread_index() == 0) {
+    ReportRaftCounters(state);
+  }
+}
+BENCHMARK(BM_KvPut)->Arg(64)->Arg(1024)->Arg(16384)->ThreadRange(1, 64)->UseRealTime();
+
+// Args: value size. Thread 0 move every region leader to next store periodically while writing.
+static void BM_KvPutWithLeaderChange(benchmark::State& state) {
+  std::atomic<bool> stopped{false};
+  std::atomic<int64_t> leader_changes{0};
+  std::thread changer;
+  if (state.thread_index() == 0) {
+    changer = std::thread([&]() {
+      while (!stopped.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_leader_change_interval_ms));
+        for (auto region_id : cluster->RegionIds()) {
+          int leader_index = cluster->LeaderIndex(region_id);
+          if (leader_index >= 0 &&
+              cluster->TransferLeader(region_id, (leader_index + 1) % cluster->StoreNum()).ok()) {
+            leader_changes++;
+          }
+        }
+      }
+    });
+  }
+
+  std::atomic<int64_t> retries{0};
+  std::atomic<int64_t> errors{0};
+  RunPut(state, retries, errors);
+
+  state.counters["retries"] = retries.load();
+  state.counters["errors"] = errors.load();
+  if (state.thread_index() == 0) {
+    stopped = true;
+    changer.join();
+    state.counters["leader_changes"] = leader_changes.load();
+    ReportRaftCounters(state);
+  }
+}
+BENCHMARK(BM_KvPutWithLeaderChange)->Arg(1024)->Threads(16)->UseRealTime()->MinTime(10);
+
+}  // namespace dingodb
+
+int main(int argc, char* argv[]) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  dingodb::RaftClusterOptions options;
+  options.store_num = FLAGS_store_num;
+  options.coordinator_num = FLAGS_coordinator_num;
+  options.region_num = FLAGS_region_num;
+  options.base_port = FLAGS_base_port;
+  options.base_path = FLAGS_cluster_path;
+  options.conf_dir = FLAGS_conf_dir;
+
+  dingodb::RaftCluster raft_cluster(options);
+  if (!raft_cluster.Start() || !raft_cluster.WaitLeaders(30 * 1000)) {
+    fprintf(stderr, "Start raft cluster failed\n");
+    return -1;
+  }
+  dingodb::cluster = &raft_cluster;
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  raft_cluster.Stop();
+  return 0;
+}
@@ -0,0 +1,241 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmark of RawRocksEngine reader and writer.
+// e.g. ./bench_raw_rocks_engine --benchmark_filter=KvPut --benchmark_format=json
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "butil/files/file_path.h"
+#include "butil/files/file_util.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+static const std::string kDbPath = "./bench_raw_rocks_engine_db";
+static const std::string kCfName = "default";
+// Keys for reader benchmarks, loaded once.
+static const int64_t kReadKeyNum = 1000000;
+static const int kReadKeySize = 24;
+static const int kReadValueSize = 256;
+
+static const std::string kConfig =
+    "store:\n"
+    "  dbPath: " +
+    kDbPath +
+    "\n"
+    "  columnFamilies:\n"
+    "    - default\n"
+    "  memoryBudget: 1024\n"
+    "  writeBufferRatio: 50\n"
+    "  blockCacheType: lru\n"
+    "  perfContextSampleRate: 0\n"
+    "  base:\n"
+    "    block_size: 131072\n";
+
+static std::shared_ptr<RawRocksEngine> GetEngine() {
+  static std::shared_ptr<RawRocksEngine> engine;
+  static std::once_flag once;
+  std::call_once(once, []() {
+    butil::DeleteFile(butil::FilePath(kDbPath), true);
+
+    auto config = std::make_shared<YamlConfig>();
+    config->Load(kConfig);
+    engine = std::make_shared<RawRocksEngine>();
+    if (!engine->Init(config)) {
+      fprintf(stderr, "Init RawRocksEngine failed\n");
+      abort();
+    }
+  });
+  return engine;
+}
+
+// Zero padded number with prefix, same length keep numeric order.
+static std::string GenKey(const std::string& prefix, int64_t num, int key_size) {
+  std::string key(std::max<int>(key_size, prefix.size() + 1), '0');
+  key.replace(0, prefix.size(), prefix);
+  for (int i = key.size() - 1; i >= static_cast<int>(prefix.size()) && num > 0; --i, num /= 10) {
+    key[i] = '0' + num % 10;
+  }
+  return key;
+}
+
+static std::string GenValue(int value_size) {
+  std::string value(value_size, 0);
+  for (auto& c : value) {
+    c = 'a' + butil::fast_rand_less_than(26);
+  }
+  return value;
+}
+
+// Every benchmark thread write its own key range.
+static std::string ThreadPrefix(const benchmark::State& state, const char* name) {
+  return std::string(name) + "_" + std::to_string(state.thread_index()) + "_";
+}
+
+static void LoadReadKeys() {
+  static std::once_flag once;
+  std::call_once(once, []() {
+    auto writer = GetEngine()->NewWriter(kCfName);
+    std::vector<pb::common::KeyValue> kvs;
+    for (int64_t i = 0; i < kReadKeyNum; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key(GenKey("r", i, kReadKeySize));
+      kv.set_value(GenValue(kReadValueSize));
+      kvs.push_back(std::move(kv));
+      if (kvs.size() == 1000) {
+        writer->KvBatchPut(kvs);
+        kvs.clear();
+      }
+    }
+    writer->KvBatchPut(kvs);
+    GetEngine()->Flush(kCfName);
+  });
+}
+
+// Args: key size, value size.
+static void BM_KvPut(benchmark::State& state) {
+  auto writer = GetEngine()->NewWriter(kCfName);
+  std::string prefix = ThreadPrefix(state, "put");
+  std::string value = GenValue(state.range(1));
+  int64_t num = 0;
+  pb::common::KeyValue kv;
+  for (auto _ : state) {
+    kv.set_key(GenKey(prefix, num++, state.range(0)));
+    kv.set_value(value);
+    writer->KvPut(kv);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (state.range(0) + state.range(1)));
+}
+BENCHMARK(BM_KvPut)
+    ->ArgsProduct({{16, 64}, {64, 1024, 16384}})
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// Args: batch size, value size.
+static void BM_KvBatchPut(benchmark::State& state) {
+  auto writer = GetEngine()->NewWriter(kCfName);
+  std::string prefix = ThreadPrefix(state, "batch_put");
+  std::string value = GenValue(state.range(1));
+  int64_t num = 0;
+  std::vector<pb::common::KeyValue> kvs(state.range(0));
+  for (auto _ : state) {
+    for (auto& kv : kvs) {
+      kv.set_key(GenKey(prefix, num++, 24));
+      kv.set_value(value);
+    }
+    writer->KvBatchPut(kvs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * (24 + state.range(1)));
+}
+BENCHMARK(BM_KvBatchPut)
+    ->ArgsProduct({{10, 100, 1000}, {64, 1024}})
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// Args: batch size, all keys are absent.
+static void BM_KvBatchPutIfAbsent(benchmark::State& state) {
+  auto writer = GetEngine()->NewWriter(kCfName);
+  std::string prefix = ThreadPrefix(state, "batch_put_if_absent");
+  std::string value = GenValue(128);
+  int64_t num = 0;
+  std::vector<pb::common::KeyValue> kvs(state.range(0));
+  std::vector<std::string> put_keys;
+  for (auto _ : state) {
+    for (auto& kv : kvs) {
+      kv.set_key(GenKey(prefix, num++, 24));
+      kv.set_value(value);
+    }
+    put_keys.clear();
+    writer->KvBatchPutIfAbsent(kvs, put_keys, true);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KvBatchPutIfAbsent)->Arg(1)->Arg(10)->Arg(100)->ThreadRange(1, 16)->UseRealTime();
+
+// Args: value size, every thread swap value of one key.
+static void BM_KvCompareAndSet(benchmark::State& state) {
+  auto writer = GetEngine()->NewWriter(kCfName);
+  std::string key = GenKey(ThreadPrefix(state, "cas"), 0, 24);
+  std::string values[2] = {GenValue(state.range(0)), GenValue(state.range(0))};
+  pb::common::KeyValue kv;
+  kv.set_key(key);
+  kv.set_value(values[0]);
+  writer->KvPut(kv);
+
+  int64_t i = 0;
+  for (auto _ : state) {
+    kv.set_value(values[(i + 1) % 2]);
+    writer->KvCompareAndSet(kv, values[i % 2]);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KvCompareAndSet)->Arg(64)->Arg(1024)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_KvGet(benchmark::State& state) {
+  LoadReadKeys();
+  auto reader = GetEngine()->NewReader(kCfName);
+  std::string value;
+  for (auto _ : state) {
+    reader->KvGet(GenKey("r", butil::fast_rand_less_than(kReadKeyNum), kReadKeySize), value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KvGet)->ThreadRange(1, 16)->UseRealTime();
+
+// Args: scan length.
+static void BM_KvScan(benchmark::State& state) {
+  LoadReadKeys();
+  auto reader = GetEngine()->NewReader(kCfName);
+  std::vector<pb::common::KeyValue> kvs;
+  for (auto _ : state) {
+    int64_t start = butil::fast_rand_less_than(kReadKeyNum - state.range(0));
+    kvs.clear();
+    reader->KvScan(GenKey("r", start, kReadKeySize), GenKey("r", start + state.range(0), kReadKeySize), kvs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KvScan)->Arg(10)->Arg(100)->Arg(1000)->ThreadRange(1, 16)->UseRealTime();
+
+// Args: count range length.
+static void BM_KvCount(benchmark::State& state) {
+  LoadReadKeys();
+  auto reader = GetEngine()->NewReader(kCfName);
+  int64_t count = 0;
+  for (auto _ : state) {
+    int64_t start = butil::fast_rand_less_than(kReadKeyNum - state.range(0));
+    reader->KvCount(GenKey("r", start, kReadKeySize), GenKey("r", start + state.range(0), kReadKeySize), count);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KvCount)->Arg(100)->Arg(10000)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace dingodb
+
+BENCHMARK_MAIN();
@@ -0,0 +1,370 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bench/raft_cluster.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "braft/raft.h"
+#include "butil/files/file_path.h"
+#include "butil/files/file_util.h"
+#include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+#include "common/constant.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "config/config_manager.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "glog/logging.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+static const char* kHost = "127.0.0.1";
+static const uint64_t kRegionStartId = 10001;
+static const int kStoreStartId = 1001;
+static const int kCoordinatorStartId = 2001;
+
+static void ReplaceAll(std::string& str, const std::string& from, const std::string& to) {
+  for (size_t pos = str.find(from); pos != std::string::npos; pos = str.find(from, pos + to.size())) {
+    str.replace(pos, from.size(), to);
+  }
+}
+
+RaftCluster::RaftCluster(const RaftClusterOptions& options) : options_(options) {
+  for (int i = 0; i < options_.region_num; ++i) {
+    region_ids_.push_back(kRegionStartId + i);
+  }
+  for (int i = 0; i < options_.coordinator_num; ++i) {
+    coordinator_peers_ += butil::StringPrintf("%s%s:%d", i == 0 ? "" : ",", kHost, options_.base_port + 200 + i);
+    coordinator_raft_peers_ += butil::StringPrintf("%s%s:%d", i == 0 ? "" : ",", kHost, options_.base_port + 300 + i);
+  }
+}
+
+RaftCluster::~RaftCluster() { Stop(); }
+
+std::shared_ptr<Config> RaftCluster::GenConfig(const std::string& role, const std::string& path, int server_port,
+                                               int raft_port, int instance_id) {
+  std::string template_file = options_.conf_dir + "/" + role + ".template.yaml";
+  std::ifstream file(template_file);
+  if (!file) {
+    LOG(ERROR) << "Open config template failed: " << template_file;
+    return nullptr;
+  }
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  ReplaceAll(content, "$INSTANCE_ID$", std::to_string(instance_id));
+  ReplaceAll(content, "$SERVER_HOST$", kHost);
+  ReplaceAll(content, "$SERVER_PORT$", std::to_string(server_port));
+  ReplaceAll(content, "$RAFT_HOST$", kHost);
+  ReplaceAll(content, "$RAFT_PORT$", std::to_string(raft_port));
+  ReplaceAll(content, "$BASE_PATH$", path);
+  ReplaceAll(content, "$COORDINATOR_SERVICE_PEERS$", coordinator_peers_);
+  ReplaceAll(content, "$COORDINATOR_RAFT_PEERS$", coordinator_raft_peers_);
+  content = std::regex_replace(content, std::regex("memoryBudget: [0-9]+"),
+                               "memoryBudget: " + std::to_string(options_.memory_budget));
+
+  for (const auto& dir : {"/log", "/data/store/db", "/data/store/raft", "/data/coordinator/raft"}) {
+    butil::CreateDirectory(butil::FilePath(path + dir));
+  }
+
+  auto config = std::make_shared<YamlConfig>();
+  config->Load(content);
+  return config;
+}
+
+// Region meta of Server singleton, used by StoreService to validate requests.
+bool RaftCluster::StartStoreMeta() {
+  auto config = GenConfig("store", options_.base_path + "/store_meta", 0, 0, kStoreStartId);
+  if (config == nullptr) {
+    return false;
+  }
+  ConfigManager::GetInstance()->Register(pb::common::STORE, config);
+
+  auto* server = Server::GetInstance();
+  server->SetRole(pb::common::STORE);
+  if (!server->InitServerID() || !server->InitRawEngines() || !server->InitStoreMetaManager()) {
+    LOG(ERROR) << "Init store meta failed";
+    return false;
+  }
+
+  for (auto region_id : region_ids_) {
+    server->GetStoreMetaManager()->AddRegion(GenRegion(region_id));
+  }
+  return true;
+}
+
+std::shared_ptr<pb::common::Region> RaftCluster::GenRegion(uint64_t region_id) {
+  auto region = std::make_shared<pb::common::Region>();
+  region->set_id(region_id);
+  region->set_epoch(1);
+  region->set_table_id(region_id);
+  region->set_name("bench-" + std::to_string(region_id));
+  region->set_state(pb::common::RegionState::REGION_NEW);
+  region->mutable_range()->set_start_key(butil::StringPrintf("%lu", region_id));
+  region->mutable_range()->set_end_key(butil::StringPrintf("%lu", region_id + 1));
+  for (int i = 0; i < options_.store_num; ++i) {
+    auto* peer = region->add_peers();
+    peer->set_store_id(kStoreStartId + i);
+    peer->mutable_raft_location()->set_host(kHost);
+    peer->mutable_raft_location()->set_port(options_.base_port + 100 + i);
+  }
+  return region;
+}
+
+bool RaftCluster::StartStore(int index) {
+  auto node = std::make_unique<StoreNode>();
+  int server_port = options_.base_port + index;
+  int raft_port = options_.base_port + 100 + index;
+  node->config = GenConfig("store", butil::StringPrintf("%s/store%d", options_.base_path.c_str(), index), server_port,
+                           raft_port, kStoreStartId + index);
+  if (node->config == nullptr) {
+    return false;
+  }
+
+  node->raw_engine = std::make_shared<RawRocksEngine>();
+  if (!node->raw_engine->Init(node->config)) {
+    LOG(ERROR) << "Init raw engine failed, store " << index;
+    return false;
+  }
+  node->engine = std::make_shared<RaftKvEngine>(node->raw_engine);
+  if (!node->engine->Init(node->config)) {
+    LOG(ERROR) << "Init raft kv engine failed, store " << index;
+    return false;
+  }
+  std::map<pb::common::Engine, std::shared_ptr<Engine> > engines = {{pb::common::ENG_RAFT_STORE, node->engine}};
+  node->storage = std::make_shared<Storage>(engines);
+  node->service = std::make_unique<StoreServiceImpl>();
+  node->service->set_storage(node->storage);
+
+  node->server = std::make_unique<brpc::Server>();
+  if (node->server->AddService(node->service.get(), brpc::SERVER_DOESNT_OWN_SERVICE) != 0 ||
+      node->server->Start(Helper::GetEndPoint(kHost, server_port), nullptr) != 0) {
+    LOG(ERROR) << "Start store server failed, port " << server_port;
+    return false;
+  }
+  node->raft_endpoint = Helper::GetEndPoint(kHost, raft_port);
+  node->raft_server = std::make_unique<brpc::Server>();
+  if (braft::add_service(node->raft_server.get(), node->raft_endpoint) != 0 ||
+      node->raft_server->Start(node->raft_endpoint, nullptr) != 0) {
+    LOG(ERROR) << "Start store raft server failed, port " << raft_port;
+    return false;
+  }
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetClusterRole(pb::common::STORE);
+  for (auto region_id : region_ids_) {
+    auto status = node->engine->AddRegion(ctx, GenRegion(region_id));
+    if (!status.ok()) {
+      LOG(ERROR) << "Add region " << region_id << " failed, store " << index << " " << status.error_str();
+      return false;
+    }
+  }
+
+  node->channel = std::make_unique<brpc::Channel>();
+  if (node->channel->Init(Helper::GetEndPoint(kHost, server_port), nullptr) != 0) {
+    LOG(ERROR) << "Init channel failed, store " << index;
+    return false;
+  }
+
+  stores_.push_back(std::move(node));
+  return true;
+}
+
+bool RaftCluster::StartCoordinator(int index) {
+  auto node = std::make_unique<CoordinatorNode>();
+  int server_port = options_.base_port + 200 + index;
+  int raft_port = options_.base_port + 300 + index;
+  node->config = GenConfig("coordinator", butil::StringPrintf("%s/coordinator%d", options_.base_path.c_str(), index),
+                           server_port, raft_port, kCoordinatorStartId + index);
+  if (node->config == nullptr) {
+    return false;
+  }
+
+  node->raw_engine = std::make_shared<RawRocksEngine>();
+  if (!node->raw_engine->Init(node->config)) {
+    LOG(ERROR) << "Init raw engine failed, coordinator " << index;
+    return false;
+  }
+  node->control = std::make_shared<CoordinatorControl>(std::make_shared<MetaReader>(node->raw_engine),
+                                                       std::make_shared<MetaWriter>(node->raw_engine));
+  if (!node->control->Recover() || !node->control->Init()) {
+    LOG(ERROR) << "Init coordinator control failed, coordinator " << index;
+    return false;
+  }
+  node->engine = std::make_shared<RaftMetaEngine>(node->raw_engine, node->control);
+  if (!node->engine->Init(node->config)) {
+    LOG(ERROR) << "Init raft meta engine failed, coordinator " << index;
+    return false;
+  }
+  node->service = std::make_unique<CoordinatorServiceImpl>();
+  node->service->SetControl(node->control);
+  node->service->SetKvEngine(node->engine);
+
+  node->server = std::make_unique<brpc::Server>();
+  if (node->server->AddService(node->service.get(), brpc::SERVER_DOESNT_OWN_SERVICE) != 0 ||
+      node->server->Start(Helper::GetEndPoint(kHost, server_port), nullptr) != 0) {
+    LOG(ERROR) << "Start coordinator server failed, port " << server_port;
+    return false;
+  }
+  auto raft_endpoint = Helper::GetEndPoint(kHost, raft_port);
+  node->raft_server = std::make_unique<brpc::Server>();
+  if (braft::add_service(node->raft_server.get(), raft_endpoint) != 0 ||
+      node->raft_server->Start(raft_endpoint, nullptr) != 0) {
+    LOG(ERROR) << "Start coordinator raft server failed, port " << raft_port;
+    return false;
+  }
+
+  auto status = Server::GetInstance()->StartMetaRegion(node->config, node->engine);
+  if (!status.ok()) {
+    LOG(ERROR) << "Start meta region failed, coordinator " << index << " " << status.error_str();
+    return false;
+  }
+
+  coordinators_.push_back(std::move(node));
+  return true;
+}
+
+bool RaftCluster::Start() {
+  butil::DeleteFile(butil::FilePath(options_.base_path), true);
+  started_ = true;
+
+  if (!StartStoreMeta()) {
+    return false;
+  }
+  for (int i = 0; i < options_.coordinator_num; ++i) {
+    if (!StartCoordinator(i)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < options_.store_num; ++i) {
+    if (!StartStore(i)) {
+      return false;
+    }
+  }
+
+  LOG(INFO) << butil::StringPrintf("Raft cluster started, %d stores %d coordinators %d regions", options_.store_num,
+                                   options_.coordinator_num, options_.region_num);
+  return true;
+}
+
+void RaftCluster::Stop() {
+  if (!started_) {
+    return;
+  }
+  started_ = false;
+
+  auto ctx = std::make_shared<Context>();
+  for (auto& node : stores_) {
+    node->server->Stop(0);
+    node->server->Join();
+    for (auto region_id : region_ids_) {
+      node->engine->DestroyRegion(ctx, region_id);
+    }
+    node->raft_server->Stop(0);
+    node->raft_server->Join();
+  }
+  for (auto& node : coordinators_) {
+    node->server->Stop(0);
+    node->server->Join();
+    node->engine->DestroyRegion(ctx, Constant::kCoordinatorRegionId);
+    node->raft_server->Stop(0);
+    node->raft_server->Join();
+  }
+  stores_.clear();
+  coordinators_.clear();
+}
+
+bool RaftCluster::WaitLeaders(int timeout_ms) {
+  int64_t deadline_ms = butil::gettimeofday_ms() + timeout_ms;
+  while (butil::gettimeofday_ms() < deadline_ms) {
+    bool all_ready = true;
+    for (auto region_id : region_ids_) {
+      all_ready = all_ready && LeaderIndex(region_id) >= 0;
+    }
+
+    bool coordinator_ready = coordinators_.empty();
+    for (auto& node : coordinators_) {
+      auto raft_node = node->engine->GetNode(Constant::kCoordinatorRegionId);
+      coordinator_ready = coordinator_ready || (raft_node != nullptr && raft_node->IsLeader());
+    }
+
+    if (all_ready && coordinator_ready) {
+      return true;
+    }
+    usleep(100 * 1000);
+  }
+
+  LOG(ERROR) << "Wait leaders timeout " << timeout_ms << "ms";
+  return false;
+}
+
+int RaftCluster::LeaderIndex(uint64_t region_id) {
+  for (int i = 0; i < static_cast<int>(stores_.size()); ++i) {
+    auto raft_node = stores_[i]->engine->GetNode(region_id);
+    if (raft_node != nullptr && raft_node->IsLeader()) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+butil::Status RaftCluster::TransferLeader(uint64_t region_id, int store_index) {
+  int leader_index = LeaderIndex(region_id);
+  if (leader_index < 0) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Region has no leader");
+  }
+  if (leader_index == store_index) {
+    return butil::Status();
+  }
+
+  auto raft_node = stores_[leader_index]->engine->GetNode(region_id);
+  int ret = raft_node->TransferLeadershipTo(braft::PeerId(stores_[store_index]->raft_endpoint));
+  if (ret != 0) {
+    return butil::Status(pb::error::EINTERNAL, "Transfer leadership failed %d", ret);
+  }
+  return butil::Status();
+}
+
+int64_t RaftCluster::ApplyLag(uint64_t region_id) {
+  int leader_index = LeaderIndex(region_id);
+  if (leader_index < 0) {
+    return -1;
+  }
+
+  braft::NodeStatus leader_status;
+  stores_[leader_index]->engine->GetNode(region_id)->GetStatus(&leader_status);
+  int64_t lag = 0;
+  for (auto& node : stores_) {
+    braft::NodeStatus status;
+    node->engine->GetNode(region_id)->GetStatus(&status);
+    lag = std::max(lag, leader_status.committed_index - status.known_applied_index);
+  }
+  return lag;
+}
+
+}  // namespace dingodb
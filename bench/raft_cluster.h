@@ -0,0 +1,126 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_RAFT_CLUSTER_H_
+#define DINGODB_BENCH_RAFT_CLUSTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "brpc/server.h"
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "config/config.h"
+#include "coordinator/coordinator_control.h"
+#include "engine/raft_kv_engine.h"
+#include "engine/raft_meta_engine.h"
+#include "engine/raw_engine.h"
+#include "engine/storage.h"
+#include "proto/common.pb.h"
+#include "server/coordinator_service.h"
+#include "server/store_service.h"
+
+namespace dingodb {
+
+struct RaftClusterOptions {
+  int store_num = 3;
+  int coordinator_num = 3;
+  // Every region has a replica on each store.
+  int region_num = 1;
+  // Store server port is base_port + i, raft port + 100, coordinators + 200 and + 300.
+  int base_port = 23000;
+  // Data of every node is in its own dir under it, removed at start.
+  std::string base_path = "./raft_cluster";
+  // Config templates, same as deploy_server.sh use.
+  std::string conf_dir = "../conf";
+  // MB of every node, all nodes share one process.
+  int memory_budget = 128;
+};
+
+// Start stores and coordinators of a cluster in one process on loopback ports,
+// each node has its own rocksdb, raft log and brpc servers, load is sent to
+// store nodes through the real StoreService.
+// Server is a process singleton, so region meta for request validation is
+// shared by all store nodes, every store hold replicas of all regions.
+class RaftCluster {
+ public:
+  explicit RaftCluster(const RaftClusterOptions& options);
+  ~RaftCluster();
+
+  RaftCluster(const RaftCluster&) = delete;
+  const RaftCluster& operator=(const RaftCluster&) = delete;
+
+  bool Start();
+  void Stop();
+
+  // Wait every region and coordinator group has leader.
+  bool WaitLeaders(int timeout_ms);
+
+  const std::vector<uint64_t>& RegionIds() const { return region_ids_; }
+  int StoreNum() const { return stores_.size(); }
+  brpc::Channel* StoreChannel(int store_index) { return stores_[store_index]->channel.get(); }
+
+  // Index of store where the region leader is, -1 is no leader.
+  int LeaderIndex(uint64_t region_id);
+  // Transfer region leader to the store, leadership change is async.
+  butil::Status TransferLeader(uint64_t region_id, int store_index);
+  // Entries committed by leader and not applied by the slowest replica.
+  int64_t ApplyLag(uint64_t region_id);
+
+ private:
+  struct StoreNode {
+    std::shared_ptr<Config> config;
+    std::shared_ptr<RawEngine> raw_engine;
+    std::shared_ptr<RaftKvEngine> engine;
+    std::shared_ptr<Storage> storage;
+    std::unique_ptr<StoreServiceImpl> service;
+    std::unique_ptr<brpc::Server> server;
+    std::unique_ptr<brpc::Server> raft_server;
+    std::unique_ptr<brpc::Channel> channel;
+    butil::EndPoint raft_endpoint;
+  };
+
+  struct CoordinatorNode {
+    std::shared_ptr<Config> config;
+    std::shared_ptr<RawEngine> raw_engine;
+    std::shared_ptr<CoordinatorControl> control;
+    std::shared_ptr<RaftMetaEngine> engine;
+    std::unique_ptr<CoordinatorServiceImpl> service;
+    std::unique_ptr<brpc::Server> server;
+    std::unique_ptr<brpc::Server> raft_server;
+  };
+
+  // Load role template and fill placeholders of node i.
+  std::shared_ptr<Config> GenConfig(const std::string& role, const std::string& path, int server_port,
+                                    int raft_port, int instance_id);
+  bool StartStoreMeta();
+  bool StartStore(int index);
+  bool StartCoordinator(int index);
+  std::shared_ptr<pb::common::Region> GenRegion(uint64_t region_id);
+
+  RaftClusterOptions options_;
+  std::string coordinator_peers_;
+  std::string coordinator_raft_peers_;
+  std::vector<uint64_t> region_ids_;
+  std::vector<std::unique_ptr<StoreNode>> stores_;
+  std::vector<std::unique_ptr<CoordinatorNode>> coordinators_;
+  bool started_ = false;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCH_RAFT_CLUSTER_H_
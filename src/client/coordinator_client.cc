@@ -194,6 +194,24 @@ void SendStoreHearbeat(brpc::Controller& cntl, dingodb::pb::coordinator::Coordin
   }
 }
 
+void SendTso(brpc::Controller& cntl, dingodb::pb::coordinator::CoordinatorService_Stub& stub) {
+  dingodb::pb::coordinator::TsoRequest request;
+  dingodb::pb::coordinator::TsoResponse response;
+
+  request.set_count(10);
+  stub.Tso(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    LOG(WARNING) << "Fail to send request to : " << cntl.ErrorCode() << "[" << cntl.ErrorText() << "]";
+  }
+
+  if (FLAGS_log_each_request) {
+    LOG(INFO) << "Received response"
+              << " tso count=" << request.count() << " request_attachment=" << cntl.request_attachment().size()
+              << " response_attachment=" << cntl.response_attachment().size() << " latency=" << cntl.latency_us();
+    LOG(INFO) << response.DebugString();
+  }
+}
+
 void* Sender(void* /*arg*/) {
   while (!brpc::IsAskedToQuit()) {
     braft::PeerId leader(FLAGS_coordinator_addr);
@@ -224,6 +242,8 @@ void* Sender(void* /*arg*/) {
       SendGetStoreMap(cntl, stub);
     } else if (FLAGS_method == "GetRegionMap") {
       SendGetRegionMap(cntl, stub);
+    } else if (FLAGS_method == "Tso") {
+      SendTso(cntl, stub);
     } else {
       LOG(INFO) << " method illegal , exit";
       return nullptr;
@@ -0,0 +1,541 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// dingo-coordinator-sim, fake a large cluster against a real coordinator.
+//
+// store_num fake stores send StoreHeartbeat every heartbeat_interval_s, spread
+// evenly over the interval, each carries the regions it leads. region_num
+// regions have replica_num peers on consecutive stores. Meanwhile route lookup
+// clients send GetRegionMap at route_qps.
+//
+// Heartbeat latency is counted from the intended send time, so a coordinator
+// falling behind is visible. CPU and memory are read from the builtin /vars of
+// the coordinator, raft apply backlog (committed - applied) from /raft_stat of
+// its raft port.
+//
+// e.g.
+//   dingodb_coordinator_sim --coordinator_addr=127.0.0.1:22001 --coordinator_raft_addr=127.0.0.1:22101
+//                           --store_num=5000 --region_num=100000 --duration_s=600
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/strings/string_split.h"
+#include "butil/strings/string_util.h"
+#include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+#include "client/latency_histogram.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator.pb.h"
+#include "proto/error.pb.h"
+
+DEFINE_string(coordinator_addr, "127.0.0.1:22001", "Coordinator server addr, redirect to leader at start");
+DEFINE_string(coordinator_raft_addr, "", "Raft addr of the coordinator leader for apply backlog, empty is disable");
+DEFINE_int32(store_num, 5000, "Number of fake stores");
+DEFINE_int32(region_num, 100000, "Number of fake regions");
+DEFINE_int32(replica_num, 3, "Peers of each region");
+DEFINE_uint64(store_id_base, 100000000, "Id of first fake store, avoid conflict with real stores");
+DEFINE_uint64(region_id_base, 100000000, "Id of first fake region, avoid conflict with real regions");
+DEFINE_int32(heartbeat_interval_s, 10, "Heartbeat interval of each store");
+DEFINE_double(route_qps, 10, "GetRegionMap qps of route lookup, 0 is disable");
+DEFINE_int32(thread_num, 64, "Number of bthreads sending heartbeats");
+DEFINE_int32(route_thread_num, 4, "Number of bthreads sending route lookups");
+DEFINE_int32(duration_s, 300, "Run seconds");
+DEFINE_int32(timeout_ms, 10000, "Timeout for each request");
+DEFINE_int32(report_interval_s, 10, "Print progress and sample coordinator every interval");
+DEFINE_string(output, "text", "Result format: text or json");
+DEFINE_string(output_file, "", "Write result to file, empty is stdout");
+
+namespace dingodb {
+namespace bench {
+
+struct OpStats {
+  LatencyHistogram histogram;
+  uint64_t error_count = 0;
+};
+
+// Sample of coordinator process.
+struct CoordinatorSample {
+  double cpu_usage = 0;
+  int64_t memory_resident = 0;
+  int64_t apply_backlog = 0;
+  int64_t pending_queue_size = 0;
+};
+
+class Simulator {
+ public:
+  Simulator() = default;
+  ~Simulator() = default;
+
+  bool Init();
+  void Run();
+  void Report(FILE* out) const;
+
+ private:
+  static void* HeartbeatSender(void* arg);
+  static void* RouteSender(void* arg);
+  void SendHeartbeat(int thread_index);
+  void SendRoute(int thread_index);
+  void Reporter();
+
+  void BuildHeartbeat(int store_index, pb::coordinator::StoreHeartbeatRequest& request) const;
+  pb::common::Location StoreLocation(int store_index) const;
+  bool SampleCoordinator(CoordinatorSample& sample);
+  static bool HttpGet(brpc::Channel& channel, const std::string& uri, std::string& body);
+
+  template <typename Response>
+  static bool IsSuccess(const brpc::Controller& cntl, const Response& response) {
+    return !cntl.Failed() && response.error().errcode() == 0;
+  }
+
+  brpc::Channel channel_;
+  brpc::Channel http_channel_;
+  brpc::Channel raft_http_channel_;
+  bool has_raft_stat_ = false;
+
+  // Regions led by each store.
+  std::vector<std::vector<int>> store_regions_;
+
+  int64_t start_time_us_ = 0;
+  int64_t end_time_us_ = 0;
+  std::atomic<bool> stopped_{false};
+  std::atomic<uint64_t> heartbeat_count_{0};
+  std::atomic<uint64_t> route_count_{0};
+  std::atomic<uint64_t> error_count_{0};
+  // Max delay between intended and actual send time of heartbeats in a report interval.
+  std::atomic<int64_t> max_behind_us_{0};
+
+  std::mutex mutex_;
+  OpStats heartbeat_stats_;
+  OpStats route_stats_;
+  std::vector<CoordinatorSample> samples_;
+};
+
+struct SenderArg {
+  Simulator* sim;
+  int thread_index;
+};
+
+bool Simulator::Init() {
+  if (FLAGS_store_num <= 0 || FLAGS_region_num < 0 || FLAGS_replica_num <= 0 || FLAGS_heartbeat_interval_s <= 0 ||
+      FLAGS_thread_num <= 0 || FLAGS_route_thread_num <= 0) {
+    LOG(ERROR) << "store_num, replica_num, heartbeat_interval_s and thread nums must be positive";
+    return false;
+  }
+  if (FLAGS_replica_num > FLAGS_store_num) {
+    LOG(ERROR) << "replica_num is larger than store_num";
+    return false;
+  }
+
+  brpc::ChannelOptions options;
+  options.timeout_ms = FLAGS_timeout_ms;
+  options.connection_type = "pooled";
+  if (channel_.Init(FLAGS_coordinator_addr.c_str(), &options) != 0) {
+    LOG(ERROR) << "Fail to init channel to " << FLAGS_coordinator_addr;
+    return false;
+  }
+
+  // Heartbeats to follower are rejected, send to leader.
+  pb::coordinator::CoordinatorService_Stub stub(&channel_);
+  pb::coordinator::GetCoordinatorMapRequest map_request;
+  pb::coordinator::GetCoordinatorMapResponse map_response;
+  brpc::Controller map_cntl;
+  stub.GetCoordinatorMap(&map_cntl, &map_request, &map_response, nullptr);
+  if (map_cntl.Failed()) {
+    LOG(ERROR) << "Fail to get coordinator map, " << map_cntl.ErrorText();
+    return false;
+  }
+  std::string leader_addr = FLAGS_coordinator_addr;
+  if (!map_response.leader_location().host().empty()) {
+    leader_addr = butil::StringPrintf("%s:%d", map_response.leader_location().host().c_str(),
+                                      map_response.leader_location().port());
+    if (leader_addr != FLAGS_coordinator_addr && channel_.Init(leader_addr.c_str(), &options) != 0) {
+      LOG(ERROR) << "Fail to init channel to " << leader_addr;
+      return false;
+    }
+  }
+  LOG(INFO) << "Coordinator leader " << leader_addr;
+
+  brpc::ChannelOptions http_options;
+  http_options.protocol = brpc::PROTOCOL_HTTP;
+  http_options.timeout_ms = FLAGS_timeout_ms;
+  if (http_channel_.Init(leader_addr.c_str(), &http_options) != 0) {
+    LOG(ERROR) << "Fail to init http channel to " << leader_addr;
+    return false;
+  }
+  if (!FLAGS_coordinator_raft_addr.empty()) {
+    if (raft_http_channel_.Init(FLAGS_coordinator_raft_addr.c_str(), &http_options) != 0) {
+      LOG(ERROR) << "Fail to init http channel to " << FLAGS_coordinator_raft_addr;
+      return false;
+    }
+    has_raft_stat_ = true;
+  }
+
+  store_regions_.resize(FLAGS_store_num);
+  for (int i = 0; i < FLAGS_region_num; ++i) {
+    store_regions_[i % FLAGS_store_num].push_back(i);
+  }
+
+  return true;
+}
+
+pb::common::Location Simulator::StoreLocation(int store_index) const {
+  // Fake addrs, coordinator never connect to stores.
+  pb::common::Location location;
+  location.set_host(butil::StringPrintf("10.%d.%d.%d", (store_index >> 16) & 0xFF, (store_index >> 8) & 0xFF,
+                                        store_index & 0xFF));
+  location.set_port(20001);
+  return location;
+}
+
+void Simulator::BuildHeartbeat(int store_index, pb::coordinator::StoreHeartbeatRequest& request) const {
+  auto* store = request.mutable_store();
+  store->set_id(FLAGS_store_id_base + store_index);
+  store->set_state(pb::common::STORE_NORMAL);
+  *store->mutable_server_location() = StoreLocation(store_index);
+  *store->mutable_raft_location() = StoreLocation(store_index);
+  store->mutable_raft_location()->set_port(20101);
+
+  for (int region_index : store_regions_[store_index]) {
+    auto* region = request.add_regions();
+    uint64_t region_id = FLAGS_region_id_base + region_index;
+    region->set_id(region_id);
+    region->set_epoch(1);
+    region->set_name(butil::StringPrintf("sim_region_%" PRIu64, region_id));
+    region->set_state(pb::common::REGION_NORMAL);
+    region->set_leader_store_id(FLAGS_store_id_base + store_index);
+    region->mutable_range()->set_start_key(butil::StringPrintf("sim%012d", region_index));
+    region->mutable_range()->set_end_key(butil::StringPrintf("sim%012d", region_index + 1));
+    for (int i = 0; i < FLAGS_replica_num; ++i) {
+      int peer_store_index = (store_index + i) % FLAGS_store_num;
+      auto* peer = region->add_peers();
+      peer->set_store_id(FLAGS_store_id_base + peer_store_index);
+      *peer->mutable_server_location() = StoreLocation(peer_store_index);
+      *peer->mutable_raft_location() = StoreLocation(peer_store_index);
+      peer->mutable_raft_location()->set_port(20101);
+    }
+
+    auto* metrics = request.add_region_metrics();
+    metrics->set_region_id(region_id);
+  }
+}
+
+void Simulator::SendHeartbeat(int thread_index) {
+  pb::coordinator::CoordinatorService_Stub stub(&channel_);
+  OpStats stats;
+  const int64_t interval_us = FLAGS_heartbeat_interval_s * 1000000L;
+
+  // Store i send at start + i * interval / store_num + round * interval.
+  std::vector<pb::coordinator::StoreHeartbeatRequest> requests;
+  std::vector<int64_t> offsets_us;
+  for (int i = thread_index; i < FLAGS_store_num; i += FLAGS_thread_num) {
+    requests.emplace_back();
+    BuildHeartbeat(i, requests.back());
+    offsets_us.push_back(interval_us * i / FLAGS_store_num);
+  }
+
+  for (int64_t round = 0; !stopped_.load() && !requests.empty(); ++round) {
+    for (size_t i = 0; i < requests.size() && !stopped_.load(); ++i) {
+      int64_t intended_us = start_time_us_ + round * interval_us + offsets_us[i];
+      int64_t now_us = butil::gettimeofday_us();
+      if (intended_us > now_us) {
+        bthread_usleep(intended_us - now_us);
+      } else {
+        int64_t behind_us = now_us - intended_us;
+        int64_t max_behind_us = max_behind_us_.load();
+        while (behind_us > max_behind_us && !max_behind_us_.compare_exchange_weak(max_behind_us, behind_us)) {
+        }
+      }
+
+      pb::coordinator::StoreHeartbeatResponse response;
+      brpc::Controller cntl;
+      stub.StoreHeartbeat(&cntl, &requests[i], &response, nullptr);
+      if (!IsSuccess(cntl, response)) {
+        stats.error_count++;
+        error_count_++;
+        LOG_EVERY_N(WARNING, 100) << "StoreHeartbeat failed: " << cntl.ErrorText() << " "
+                                  << response.error().ShortDebugString();
+      }
+      stats.histogram.Record(butil::gettimeofday_us() - intended_us);
+      heartbeat_count_++;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  heartbeat_stats_.histogram.Merge(stats.histogram);
+  heartbeat_stats_.error_count += stats.error_count;
+}
+
+void Simulator::SendRoute(int thread_index) {
+  pb::coordinator::CoordinatorService_Stub stub(&channel_);
+  OpStats stats;
+  // Every thread send at route_qps / route_thread_num, threads are staggered.
+  const double interval_us = 1e6 * FLAGS_route_thread_num / FLAGS_route_qps;
+  const double offset_us = interval_us * thread_index / FLAGS_route_thread_num;
+
+  for (int64_t i = 0; !stopped_.load(); ++i) {
+    int64_t intended_us = start_time_us_ + static_cast<int64_t>(offset_us + interval_us * i);
+    int64_t now_us = butil::gettimeofday_us();
+    if (intended_us > now_us) {
+      bthread_usleep(intended_us - now_us);
+    }
+
+    pb::coordinator::GetRegionMapRequest request;
+    pb::coordinator::GetRegionMapResponse response;
+    brpc::Controller cntl;
+    stub.GetRegionMap(&cntl, &request, &response, nullptr);
+    if (!IsSuccess(cntl, response)) {
+      stats.error_count++;
+      error_count_++;
+      LOG_EVERY_N(WARNING, 100) << "GetRegionMap failed: " << cntl.ErrorText() << " "
+                                << response.error().ShortDebugString();
+    }
+    stats.histogram.Record(butil::gettimeofday_us() - intended_us);
+    route_count_++;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  route_stats_.histogram.Merge(stats.histogram);
+  route_stats_.error_count += stats.error_count;
+}
+
+void* Simulator::HeartbeatSender(void* arg) {
+  auto* sender_arg = static_cast<SenderArg*>(arg);
+  sender_arg->sim->SendHeartbeat(sender_arg->thread_index);
+  return nullptr;
+}
+
+void* Simulator::RouteSender(void* arg) {
+  auto* sender_arg = static_cast<SenderArg*>(arg);
+  sender_arg->sim->SendRoute(sender_arg->thread_index);
+  return nullptr;
+}
+
+bool Simulator::HttpGet(brpc::Channel& channel, const std::string& uri, std::string& body) {
+  brpc::Controller cntl;
+  cntl.http_request().uri() = uri;
+  channel.CallMethod(nullptr, &cntl, nullptr, nullptr, nullptr);
+  if (cntl.Failed()) {
+    LOG_EVERY_N(WARNING, 10) << "Fail to get " << uri << ", " << cntl.ErrorText();
+    return false;
+  }
+  body = cntl.response_attachment().to_string();
+  return true;
+}
+
+// Parse lines of "name : value" or "name: value".
+static std::map<std::string, std::string> ParseStat(const std::string& body) {
+  std::map<std::string, std::string> stat;
+  std::vector<std::string> lines;
+  butil::SplitString(body, '\n', &lines);
+  for (const auto& line : lines) {
+    auto pos = line.find(':');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    std::string name;
+    std::string value;
+    butil::TrimWhitespaceASCII(line.substr(0, pos), butil::TRIM_ALL, &name);
+    butil::TrimWhitespaceASCII(line.substr(pos + 1), butil::TRIM_ALL, &value);
+    // Keep the first one, /raft_stat of one group is enough.
+    stat.emplace(name, value);
+  }
+  return stat;
+}
+
+bool Simulator::SampleCoordinator(CoordinatorSample& sample) {
+  std::string body;
+  if (!HttpGet(http_channel_, "/vars/process_cpu_usage", body)) {
+    return false;
+  }
+  sample.cpu_usage = strtod(ParseStat(body)["process_cpu_usage"].c_str(), nullptr);
+  if (!HttpGet(http_channel_, "/vars/process_memory_resident", body)) {
+    return false;
+  }
+  sample.memory_resident = strtoll(ParseStat(body)["process_memory_resident"].c_str(), nullptr, 10);
+
+  if (has_raft_stat_) {
+    if (!HttpGet(raft_http_channel_, "/raft_stat", body)) {
+      return false;
+    }
+    auto stat = ParseStat(body);
+    int64_t committed_index = strtoll(stat["last_committed_index"].c_str(), nullptr, 10);
+    int64_t applied_index = strtoll(stat["known_applied_index"].c_str(), nullptr, 10);
+    sample.apply_backlog = std::max<int64_t>(0, committed_index - applied_index);
+    sample.pending_queue_size = strtoll(stat["pending_queue_size"].c_str(), nullptr, 10);
+  }
+  return true;
+}
+
+void Simulator::Reporter() {
+  uint64_t last_count = 0;
+  int64_t last_time_us = start_time_us_;
+  while (!stopped_.load()) {
+    bthread_usleep(1000000L);
+    int64_t now_us = butil::gettimeofday_us();
+    if (now_us - start_time_us_ >= FLAGS_duration_s * 1000000L) {
+      stopped_ = true;
+    }
+    if (FLAGS_report_interval_s <= 0 || now_us - last_time_us < FLAGS_report_interval_s * 1000000L) {
+      continue;
+    }
+
+    CoordinatorSample sample;
+    bool sampled = SampleCoordinator(sample);
+    if (sampled) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      samples_.push_back(sample);
+    }
+
+    uint64_t count = heartbeat_count_.load();
+    LOG(INFO) << butil::StringPrintf(
+        "%" PRId64 "s heartbeats %" PRIu64 " qps %.0f behind %" PRId64 "ms routes %" PRIu64 " errors %" PRIu64
+        " cpu %.2f rss %" PRId64 "MB apply_backlog %" PRId64 " pending %" PRId64 "%s",
+        (now_us - start_time_us_) / 1000000, count, (count - last_count) * 1e6 / (now_us - last_time_us),
+        max_behind_us_.exchange(0) / 1000, route_count_.load(), error_count_.load(), sample.cpu_usage,
+        sample.memory_resident >> 20, sample.apply_backlog, sample.pending_queue_size,
+        sampled ? "" : " (sample failed)");
+    last_count = count;
+    last_time_us = now_us;
+  }
+}
+
+void Simulator::Run() {
+  start_time_us_ = butil::gettimeofday_us();
+
+  int route_thread_num = FLAGS_route_qps > 0 ? FLAGS_route_thread_num : 0;
+  std::vector<SenderArg> args(FLAGS_thread_num + route_thread_num);
+  std::vector<bthread_t> tids(args.size());
+  for (int i = 0; i < static_cast<int>(args.size()); ++i) {
+    bool is_route = i >= FLAGS_thread_num;
+    args[i] = {this, is_route ? i - FLAGS_thread_num : i};
+    if (bthread_start_background(&tids[i], nullptr, is_route ? RouteSender : HeartbeatSender, &args[i]) != 0) {
+      LOG(FATAL) << "Fail to create bthread";
+    }
+  }
+
+  Reporter();
+
+  for (auto tid : tids) {
+    bthread_join(tid, nullptr);
+  }
+  end_time_us_ = butil::gettimeofday_us();
+}
+
+void Simulator::Report(FILE* out) const {
+  double elapsed_s = (end_time_us_ - start_time_us_) / 1e6;
+  bool json = FLAGS_output == "json";
+
+  CoordinatorSample max_sample;
+  double total_cpu_usage = 0;
+  for (const auto& sample : samples_) {
+    max_sample.cpu_usage = std::max(max_sample.cpu_usage, sample.cpu_usage);
+    max_sample.memory_resident = std::max(max_sample.memory_resident, sample.memory_resident);
+    max_sample.apply_backlog = std::max(max_sample.apply_backlog, sample.apply_backlog);
+    max_sample.pending_queue_size = std::max(max_sample.pending_queue_size, sample.pending_queue_size);
+    total_cpu_usage += sample.cpu_usage;
+  }
+  double mean_cpu_usage = samples_.empty() ? 0 : total_cpu_usage / samples_.size();
+
+  if (json) {
+    fprintf(out,
+            "{\"stores\":%d,\"regions\":%d,\"heartbeat_interval_s\":%d,\"route_qps\":%.1f,\"elapsed_s\":%.3f,"
+            "\"coordinator\":{\"mean_cpu\":%.3f,\"max_cpu\":%.3f,\"max_rss_bytes\":%" PRId64
+            ",\"max_apply_backlog\":%" PRId64 ",\"max_pending_queue\":%" PRId64 "},\"ops\":{",
+            FLAGS_store_num, FLAGS_region_num, FLAGS_heartbeat_interval_s, FLAGS_route_qps, elapsed_s,
+            mean_cpu_usage, max_sample.cpu_usage, max_sample.memory_resident, max_sample.apply_backlog,
+            max_sample.pending_queue_size);
+  } else {
+    fprintf(out, "stores %d regions %d heartbeat_interval %ds route_qps %.1f elapsed %.3fs\n", FLAGS_store_num,
+            FLAGS_region_num, FLAGS_heartbeat_interval_s, FLAGS_route_qps, elapsed_s);
+    fprintf(out,
+            "coordinator cpu mean %.3f max %.3f rss max %" PRId64 "MB apply_backlog max %" PRId64
+            " pending_queue max %" PRId64 "\n",
+            mean_cpu_usage, max_sample.cpu_usage, max_sample.memory_resident >> 20, max_sample.apply_backlog,
+            max_sample.pending_queue_size);
+    fprintf(out, "%-18s %10s %8s %10s %8s %8s %8s %8s %8s\n", "op", "count", "errors", "mean(us)", "p50", "p99",
+            "p999", "max", "qps");
+  }
+
+  const std::pair<const char*, const OpStats*> ops[] = {{"heartbeat", &heartbeat_stats_},
+                                                        {"get_region_map", &route_stats_}};
+  bool first = true;
+  for (const auto& op : ops) {
+    const auto& histogram = op.second->histogram;
+    if (histogram.Count() == 0) {
+      continue;
+    }
+    if (json) {
+      fprintf(out,
+              "%s\"%s\":{\"count\":%" PRIu64 ",\"errors\":%" PRIu64 ",\"mean_us\":%.1f,\"p50_us\":%" PRIu64
+              ",\"p99_us\":%" PRIu64 ",\"p999_us\":%" PRIu64 ",\"max_us\":%" PRIu64 ",\"qps\":%.1f}",
+              first ? "" : ",", op.first, histogram.Count(), op.second->error_count, histogram.Mean(),
+              histogram.Percentile(50), histogram.Percentile(99), histogram.Percentile(99.9), histogram.Max(),
+              histogram.Count() / elapsed_s);
+    } else {
+      fprintf(out,
+              "%-18s %10" PRIu64 " %8" PRIu64 " %10.1f %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8.1f\n",
+              op.first, histogram.Count(), op.second->error_count, histogram.Mean(), histogram.Percentile(50),
+              histogram.Percentile(99), histogram.Percentile(99.9), histogram.Max(), histogram.Count() / elapsed_s);
+    }
+    first = false;
+  }
+
+  if (json) {
+    fprintf(out, "}}\n");
+  }
+}
+
+}  // namespace bench
+}  // namespace dingodb
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  dingodb::bench::Simulator sim;
+  if (!sim.Init()) {
+    return -1;
+  }
+
+  sim.Run();
+
+  FILE* out = stdout;
+  if (!FLAGS_output_file.empty()) {
+    out = fopen(FLAGS_output_file.c_str(), "w");
+    if (out == nullptr) {
+      LOG(ERROR) << "Fail to open output file " << FLAGS_output_file;
+      return -1;
+    }
+  }
+  sim.Report(out);
+  if (out != stdout) {
+    fclose(out);
+  }
+
+  return 0;
+}
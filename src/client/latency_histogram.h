@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_CLIENT_LATENCY_HISTOGRAM_H_
+#define DINGODB_CLIENT_LATENCY_HISTOGRAM_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+namespace bench {
+
+// Log linear buckets like HdrHistogram, values below 256 are exact,
+// above keep 8 significant bits, relative error < 1%.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() : counts_((kMaxShift + 2) * kHalfCount, 0) {}
+
+  void Record(int64_t value_us) {
+    uint64_t value = value_us > 0 ? value_us : 0;
+    counts_[Index(value)]++;
+    total_count_++;
+    total_value_ += value;
+    max_value_ = std::max(max_value_, value);
+  }
+
+  void Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    total_count_ += other.total_count_;
+    total_value_ += other.total_value_;
+    max_value_ = std::max(max_value_, other.max_value_);
+  }
+
+  uint64_t Count() const { return total_count_; }
+  uint64_t Max() const { return max_value_; }
+  double Mean() const { return total_count_ == 0 ? 0 : static_cast<double>(total_value_) / total_count_; }
+
+  // Highest value of the bucket reach the percentile, percentile is in (0, 100].
+  uint64_t Percentile(double percentile) const {
+    if (total_count_ == 0) {
+      return 0;
+    }
+    uint64_t target = std::max<uint64_t>(1, std::ceil(percentile / 100 * total_count_));
+    uint64_t count = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      count += counts_[i];
+      if (count >= target) {
+        return std::min(max_value_, UpperValue(i));
+      }
+    }
+    return max_value_;
+  }
+
+ private:
+  static const int kSubBucketBits = 8;
+  static const uint64_t kSubBucketCount = 1 << kSubBucketBits;
+  static const uint64_t kHalfCount = kSubBucketCount / 2;
+  // Max about 2^48us, enough for any latency.
+  static const int kMaxShift = 40;
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return value;
+    }
+    int shift = 63 - __builtin_clzll(value) - (kSubBucketBits - 1);
+    if (shift > kMaxShift) {
+      shift = kMaxShift;
+      value = ((kSubBucketCount - 1) << shift);
+    }
+    return (shift + 1) * kHalfCount + ((value >> shift) - kHalfCount);
+  }
+
+  static uint64_t UpperValue(size_t index) {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+    int shift = index / kHalfCount - 1;
+    uint64_t sub_bucket = index % kHalfCount + kHalfCount;
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_ = 0;
+  uint64_t total_value_ = 0;
+  uint64_t max_value_ = 0;
+};
+
+}  // namespace bench
+}  // namespace dingodb
+
+#endif  // DINGODB_CLIENT_LATENCY_HISTOGRAM_H_
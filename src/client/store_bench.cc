@@ -0,0 +1,619 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// dingo-bench, YCSB style load generator of store service.
+//
+// Load phase insert record_count keys by KvBatchPut, run phase execute one of
+// workload A-F:
+//   A: 50% read 50% update, zipfian
+//   B: 95% read 5% update, zipfian
+//   C: 100% read, zipfian
+//   D: 95% read 5% insert, latest
+//   E: 95% scan 5% insert, zipfian, scan is KvBatchGet of sequential keys
+//   F: 50% read 50% read-modify-write, zipfian
+// Key space is split by range to regions in order of region_ids.
+//
+// With target_qps every request has an intended start time, latency is counted
+// from it, so a stalled server is not hidden by senders waiting (open loop).
+//
+// e.g.
+//   dingodb_bench --phase=load --region_ids=111,112 --store_addrs=127.0.0.1:20001,127.0.0.1:20002
+//   dingodb_bench --phase=run --workload=A --target_qps=20000 --duration_s=60 --output=json
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/fast_rand.h"
+#include "butil/strings/string_split.h"
+#include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+#include "client/latency_histogram.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "proto/store.pb.h"
+
+DEFINE_string(store_addrs, "127.0.0.1:20001", "Store addrs, one for all regions or one for each region");
+DEFINE_string(region_ids, "111111", "Regions, key space is split to them by range in order");
+DEFINE_string(phase, "run", "load: insert record_count keys, run: execute workload");
+DEFINE_string(workload, "A", "YCSB workload A-F");
+DEFINE_string(distribution, "", "Override request distribution of workload: uniform, zipfian, latest");
+DEFINE_double(zipfian_theta, 0.99, "Skew of zipfian distribution");
+DEFINE_int64(record_count, 100000, "Number of keys in load phase");
+DEFINE_int64(operation_count, 1000000, "Number of operations in run phase");
+DEFINE_int32(duration_s, 0, "Stop run phase after seconds, 0 is until operation_count done");
+DEFINE_int32(thread_num, 16, "Number of bthreads sending requests");
+DEFINE_int64(target_qps, 0, "Open loop total qps, 0 is closed loop");
+DEFINE_int32(value_size, 100, "Value size in bytes");
+DEFINE_int32(batch_size, 100, "Kvs of one KvBatchPut in load phase");
+DEFINE_int32(max_scan_length, 100, "Max keys of one scan, length is uniform in [1, max]");
+DEFINE_int32(timeout_ms, 500, "Timeout for each request");
+DEFINE_string(key_prefix, "user", "Key prefix, key is prefix + zero padded key number");
+DEFINE_int32(report_interval_s, 10, "Print progress every interval, 0 is disable");
+DEFINE_string(output, "text", "Result format: text or json");
+DEFINE_string(output_file, "", "Write result to file, empty is stdout");
+
+namespace dingodb {
+namespace bench {
+
+enum OpType {
+  kRead = 0,
+  kUpdate = 1,
+  kInsert = 2,
+  kScan = 3,
+  kReadModifyWrite = 4,
+  kOpTypeNum = 5,
+};
+
+static const char* kOpTypeNames[] = {"read", "update", "insert", "scan", "read_modify_write"};
+
+enum Distribution {
+  kUniform = 0,
+  kZipfian = 1,
+  kLatest = 2,
+};
+
+struct Workload {
+  std::string name;
+  // Proportion of every op type, sum is 1.
+  double proportions[kOpTypeNum];
+  Distribution distribution;
+};
+
+static const Workload kWorkloads[] = {
+    {"A", {0.5, 0.5, 0, 0, 0}, kZipfian},    {"B", {0.95, 0.05, 0, 0, 0}, kZipfian},
+    {"C", {1.0, 0, 0, 0, 0}, kZipfian},      {"D", {0.95, 0, 0.05, 0, 0}, kLatest},
+    {"E", {0, 0, 0.05, 0.95, 0}, kZipfian},  {"F", {0.5, 0, 0, 0, 0.5}, kZipfian},
+};
+
+static uint64_t Fnv1aHash(uint64_t value) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= value & 0xFF;
+    hash *= 0x100000001B3ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+// Zipfian of [0, n), algorithm from Gray et al. "Quickly generating billion-record synthetic databases",
+// same as YCSB. Item 0 is the hottest.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta) : n_(n), theta_(theta) {
+    zetan_ = Zeta(n, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_ = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - Zeta(2, theta) / zetan_);
+    half_pow_theta_ = 1.0 + std::pow(0.5, theta);
+  }
+
+  uint64_t Next() const {
+    double u = butil::fast_rand_double();
+    double uz = u * zetan_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < half_pow_theta_) {
+      return 1;
+    }
+    return std::min(n_ - 1, static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_)));
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+      sum += 1 / std::pow(i + 1, theta);
+    }
+    return sum;
+  }
+
+  uint64_t n_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+  double half_pow_theta_;
+};
+
+struct OpStats {
+  LatencyHistogram histogram;
+  uint64_t error_count = 0;
+};
+
+struct Region {
+  uint64_t id;
+  std::shared_ptr<brpc::Channel> channel;
+};
+
+class Benchmark {
+ public:
+  Benchmark() = default;
+  ~Benchmark() = default;
+
+  bool Init();
+  void Run();
+  void Report(FILE* out) const;
+
+ private:
+  static void* Sender(void* arg);
+  void SendLoad(std::vector<OpStats>& stats);
+  void SendRun(int thread_index, std::vector<OpStats>& stats);
+  void Reporter();
+
+  std::string GenKey(uint64_t key_num) const {
+    return butil::StringPrintf("%s%012" PRIu64, FLAGS_key_prefix.c_str(), key_num);
+  }
+  std::string GenValue() const;
+  const Region& GetRegion(uint64_t key_num) const;
+  OpType ChooseOp() const;
+  uint64_t ChooseKey() const;
+
+  // Return false when failed, error response is counted as failed.
+  template <typename Response>
+  static bool IsSuccess(const brpc::Controller& cntl, const Response& response) {
+    return !cntl.Failed() && response.error().errcode() == 0;
+  }
+
+  bool Read(uint64_t key_num, std::string& value);
+  bool Put(uint64_t key_num);
+  bool Scan(uint64_t key_num, int length);
+
+  Workload workload_;
+  std::vector<Region> regions_;
+  std::unique_ptr<ZipfianGenerator> zipfian_;
+
+  // Key number of next insert, include loaded.
+  std::atomic<uint64_t> insert_key_num_{0};
+  std::atomic<uint64_t> next_op_{0};
+  uint64_t total_ops_ = 0;
+  int64_t start_time_us_ = 0;
+  int64_t end_time_us_ = 0;
+  std::atomic<bool> stopped_{false};
+  std::atomic<uint64_t> done_count_{0};
+  std::atomic<uint64_t> error_count_{0};
+
+  std::mutex mutex_;
+  std::vector<OpStats> stats_;
+};
+
+struct SenderArg {
+  Benchmark* bench;
+  int thread_index;
+};
+
+bool Benchmark::Init() {
+  if (FLAGS_phase != "load" && FLAGS_phase != "run") {
+    LOG(ERROR) << "Unknown phase " << FLAGS_phase;
+    return false;
+  }
+
+  bool found = false;
+  for (const auto& workload : kWorkloads) {
+    if (workload.name == FLAGS_workload) {
+      workload_ = workload;
+      found = true;
+    }
+  }
+  if (!found) {
+    LOG(ERROR) << "Unknown workload " << FLAGS_workload;
+    return false;
+  }
+  if (FLAGS_distribution == "uniform") {
+    workload_.distribution = kUniform;
+  } else if (FLAGS_distribution == "zipfian") {
+    workload_.distribution = kZipfian;
+  } else if (FLAGS_distribution == "latest") {
+    workload_.distribution = kLatest;
+  } else if (!FLAGS_distribution.empty()) {
+    LOG(ERROR) << "Unknown distribution " << FLAGS_distribution;
+    return false;
+  }
+
+  if (FLAGS_record_count <= 0 || FLAGS_thread_num <= 0 || FLAGS_batch_size <= 0 || FLAGS_max_scan_length <= 0) {
+    LOG(ERROR) << "record_count, thread_num, batch_size and max_scan_length must be positive";
+    return false;
+  }
+
+  std::vector<std::string> region_ids;
+  std::vector<std::string> addrs;
+  butil::SplitString(FLAGS_region_ids, ',', &region_ids);
+  butil::SplitString(FLAGS_store_addrs, ',', &addrs);
+  if (region_ids.empty() || (addrs.size() != 1 && addrs.size() != region_ids.size())) {
+    LOG(ERROR) << "store_addrs must be one addr or one addr for each region";
+    return false;
+  }
+
+  std::vector<std::shared_ptr<brpc::Channel>> channels;
+  for (const auto& addr : addrs) {
+    auto channel = std::make_shared<brpc::Channel>();
+    brpc::ChannelOptions options;
+    options.timeout_ms = FLAGS_timeout_ms;
+    if (channel->Init(addr.c_str(), &options) != 0) {
+      LOG(ERROR) << "Fail to init channel to " << addr;
+      return false;
+    }
+    channels.push_back(channel);
+  }
+  for (size_t i = 0; i < region_ids.size(); ++i) {
+    regions_.push_back({std::stoull(region_ids[i]), channels[addrs.size() == 1 ? 0 : i]});
+  }
+
+  // Keys inserted in run phase are also requested, same as YCSB.
+  uint64_t key_space = FLAGS_record_count;
+  if (FLAGS_phase == "run") {
+    key_space += static_cast<uint64_t>(FLAGS_operation_count * workload_.proportions[kInsert] * 2);
+  }
+  zipfian_ = std::make_unique<ZipfianGenerator>(key_space, FLAGS_zipfian_theta);
+
+  insert_key_num_ = FLAGS_phase == "load" ? 0 : FLAGS_record_count;
+  total_ops_ = FLAGS_phase == "load" ? FLAGS_record_count : FLAGS_operation_count;
+  stats_.resize(kOpTypeNum);
+  return true;
+}
+
+std::string Benchmark::GenValue() const {
+  std::string value(FLAGS_value_size, 0);
+  for (auto& c : value) {
+    c = 'a' + butil::fast_rand_less_than(26);
+  }
+  return value;
+}
+
+const Region& Benchmark::GetRegion(uint64_t key_num) const {
+  // Keys after record_count are inserted ones, belong to the last region.
+  uint64_t index = key_num * regions_.size() / FLAGS_record_count;
+  return regions_[std::min<uint64_t>(index, regions_.size() - 1)];
+}
+
+OpType Benchmark::ChooseOp() const {
+  double u = butil::fast_rand_double();
+  for (int i = 0; i < kOpTypeNum; ++i) {
+    if (u < workload_.proportions[i]) {
+      return static_cast<OpType>(i);
+    }
+    u -= workload_.proportions[i];
+  }
+  return kRead;
+}
+
+uint64_t Benchmark::ChooseKey() const {
+  uint64_t max_key_num = insert_key_num_.load(std::memory_order_relaxed);
+  uint64_t key_num = 0;
+  switch (workload_.distribution) {
+    case kUniform:
+      key_num = butil::fast_rand_less_than(max_key_num);
+      break;
+    case kZipfian:
+      // Scramble so hot keys spread over key space and regions.
+      key_num = Fnv1aHash(zipfian_->Next()) % max_key_num;
+      break;
+    case kLatest:
+      key_num = max_key_num - 1 - std::min(max_key_num - 1, zipfian_->Next());
+      break;
+  }
+  return key_num;
+}
+
+bool Benchmark::Read(uint64_t key_num, std::string& value) {
+  const auto& region = GetRegion(key_num);
+  pb::store::StoreService_Stub stub(region.channel.get());
+  pb::store::KvGetRequest request;
+  pb::store::KvGetResponse response;
+  request.set_region_id(region.id);
+  request.set_key(GenKey(key_num));
+
+  brpc::Controller cntl;
+  stub.KvGet(&cntl, &request, &response, nullptr);
+  value = response.value();
+  return IsSuccess(cntl, response);
+}
+
+bool Benchmark::Put(uint64_t key_num) {
+  const auto& region = GetRegion(key_num);
+  pb::store::StoreService_Stub stub(region.channel.get());
+  pb::store::KvPutRequest request;
+  pb::store::KvPutResponse response;
+  request.set_region_id(region.id);
+  request.mutable_kv()->set_key(GenKey(key_num));
+  request.mutable_kv()->set_value(GenValue());
+
+  brpc::Controller cntl;
+  stub.KvPut(&cntl, &request, &response, nullptr);
+  return IsSuccess(cntl, response);
+}
+
+// No scan rpc in store service, read sequential keys in one KvBatchGet, stop at region end.
+bool Benchmark::Scan(uint64_t key_num, int length) {
+  const auto& region = GetRegion(key_num);
+  pb::store::StoreService_Stub stub(region.channel.get());
+  pb::store::KvBatchGetRequest request;
+  pb::store::KvBatchGetResponse response;
+  request.set_region_id(region.id);
+  uint64_t max_key_num = insert_key_num_.load(std::memory_order_relaxed);
+  for (uint64_t i = key_num; i < key_num + length && i < max_key_num && GetRegion(i).id == region.id; ++i) {
+    request.add_keys(GenKey(i));
+  }
+
+  brpc::Controller cntl;
+  stub.KvBatchGet(&cntl, &request, &response, nullptr);
+  return IsSuccess(cntl, response);
+}
+
+void Benchmark::SendLoad(std::vector<OpStats>& stats) {
+  for (;;) {
+    uint64_t begin = next_op_.fetch_add(FLAGS_batch_size);
+    if (begin >= total_ops_) {
+      break;
+    }
+    uint64_t end = std::min<uint64_t>(begin + FLAGS_batch_size, total_ops_);
+
+    // One batch must be in one region.
+    while (begin < end) {
+      const auto& region = GetRegion(begin);
+      pb::store::StoreService_Stub stub(region.channel.get());
+      pb::store::KvBatchPutRequest request;
+      pb::store::KvBatchPutResponse response;
+      request.set_region_id(region.id);
+      uint64_t key_num = begin;
+      for (; key_num < end && GetRegion(key_num).id == region.id; ++key_num) {
+        auto* kv = request.add_kvs();
+        kv->set_key(GenKey(key_num));
+        kv->set_value(GenValue());
+      }
+
+      int64_t start_time_us = butil::gettimeofday_us();
+      brpc::Controller cntl;
+      stub.KvBatchPut(&cntl, &request, &response, nullptr);
+      stats[kInsert].histogram.Record(butil::gettimeofday_us() - start_time_us);
+      if (!IsSuccess(cntl, response)) {
+        stats[kInsert].error_count++;
+        error_count_++;
+        LOG_EVERY_N(WARNING, 100) << "KvBatchPut failed: " << cntl.ErrorText() << " "
+                                  << response.error().ShortDebugString();
+      }
+      done_count_ += key_num - begin;
+      begin = key_num;
+    }
+  }
+}
+
+void Benchmark::SendRun(int thread_index, std::vector<OpStats>& stats) {
+  // Every sender take its share of target qps.
+  int64_t interval_us = FLAGS_target_qps > 0 ? 1000000L * FLAGS_thread_num / FLAGS_target_qps : 0;
+  int64_t intended_time_us = start_time_us_ + (interval_us * thread_index) / FLAGS_thread_num;
+
+  while (!stopped_.load(std::memory_order_relaxed)) {
+    if (next_op_.fetch_add(1) >= total_ops_) {
+      break;
+    }
+
+    int64_t start_time_us = butil::gettimeofday_us();
+    if (interval_us > 0) {
+      if (intended_time_us > start_time_us) {
+        bthread_usleep(intended_time_us - start_time_us);
+      }
+      // Count latency from intended time, include time behind the schedule.
+      start_time_us = intended_time_us;
+      intended_time_us += interval_us;
+    }
+
+    OpType op = ChooseOp();
+    bool success = true;
+    std::string value;
+    switch (op) {
+      case kRead:
+        success = Read(ChooseKey(), value);
+        break;
+      case kUpdate:
+        success = Put(ChooseKey());
+        break;
+      case kInsert:
+        success = Put(insert_key_num_.fetch_add(1));
+        break;
+      case kScan:
+        success = Scan(ChooseKey(), 1 + butil::fast_rand_less_than(FLAGS_max_scan_length));
+        break;
+      case kReadModifyWrite: {
+        uint64_t key_num = ChooseKey();
+        success = Read(key_num, value) && Put(key_num);
+        break;
+      }
+      default:
+        break;
+    }
+
+    stats[op].histogram.Record(butil::gettimeofday_us() - start_time_us);
+    if (!success) {
+      stats[op].error_count++;
+      error_count_++;
+    }
+    done_count_++;
+  }
+}
+
+void* Benchmark::Sender(void* arg) {
+  auto* sender_arg = static_cast<SenderArg*>(arg);
+  Benchmark* bench = sender_arg->bench;
+
+  std::vector<OpStats> stats(kOpTypeNum);
+  if (FLAGS_phase == "load") {
+    bench->SendLoad(stats);
+  } else {
+    bench->SendRun(sender_arg->thread_index, stats);
+  }
+
+  std::lock_guard<std::mutex> lock(bench->mutex_);
+  for (int i = 0; i < kOpTypeNum; ++i) {
+    bench->stats_[i].histogram.Merge(stats[i].histogram);
+    bench->stats_[i].error_count += stats[i].error_count;
+  }
+  return nullptr;
+}
+
+void Benchmark::Reporter() {
+  uint64_t last_done_count = 0;
+  int64_t last_time_us = start_time_us_;
+  while (!stopped_.load()) {
+    bthread_usleep(1000000L);
+    int64_t now_us = butil::gettimeofday_us();
+    if (FLAGS_duration_s > 0 && now_us - start_time_us_ >= FLAGS_duration_s * 1000000L) {
+      stopped_ = true;
+    }
+    if (FLAGS_report_interval_s > 0 && now_us - last_time_us >= FLAGS_report_interval_s * 1000000L) {
+      uint64_t done_count = done_count_.load();
+      LOG(INFO) << butil::StringPrintf("%" PRId64 "s done %" PRIu64 " qps %.0f errors %" PRIu64,
+                                       (now_us - start_time_us_) / 1000000, done_count,
+                                       (done_count - last_done_count) * 1e6 / (now_us - last_time_us),
+                                       error_count_.load());
+      last_done_count = done_count;
+      last_time_us = now_us;
+    }
+  }
+}
+
+void Benchmark::Run() {
+  start_time_us_ = butil::gettimeofday_us();
+
+  std::vector<SenderArg> args(FLAGS_thread_num);
+  std::vector<bthread_t> tids(FLAGS_thread_num);
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    args[i] = {this, i};
+    if (bthread_start_background(&tids[i], nullptr, Sender, &args[i]) != 0) {
+      LOG(FATAL) << "Fail to create bthread";
+    }
+  }
+
+  bthread_t reporter_tid;
+  bthread_start_background(
+      &reporter_tid, nullptr,
+      [](void* arg) -> void* {
+        static_cast<Benchmark*>(arg)->Reporter();
+        return nullptr;
+      },
+      this);
+
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    bthread_join(tids[i], nullptr);
+  }
+  end_time_us_ = butil::gettimeofday_us();
+  stopped_ = true;
+  bthread_join(reporter_tid, nullptr);
+}
+
+void Benchmark::Report(FILE* out) const {
+  double elapsed_s = (end_time_us_ - start_time_us_) / 1e6;
+  uint64_t ops = done_count_.load();
+  bool json = FLAGS_output == "json";
+
+  if (json) {
+    fprintf(out,
+            "{\"phase\":\"%s\",\"workload\":\"%s\",\"threads\":%d,\"target_qps\":%" PRId64
+            ",\"elapsed_s\":%.3f,\"operations\":%" PRIu64 ",\"errors\":%" PRIu64 ",\"qps\":%.1f,\"ops\":{",
+            FLAGS_phase.c_str(), FLAGS_workload.c_str(), FLAGS_thread_num, FLAGS_target_qps, elapsed_s, ops,
+            error_count_.load(), ops / elapsed_s);
+  } else {
+    fprintf(out, "phase %s workload %s threads %d target_qps %" PRId64 "\n", FLAGS_phase.c_str(),
+            FLAGS_workload.c_str(), FLAGS_thread_num, FLAGS_target_qps);
+    fprintf(out, "elapsed %.3fs operations %" PRIu64 " errors %" PRIu64 " qps %.1f\n", elapsed_s, ops,
+            error_count_.load(), ops / elapsed_s);
+    fprintf(out, "%-18s %10s %8s %10s %8s %8s %8s %8s %8s\n", "op", "count", "errors", "mean(us)", "p50", "p99",
+            "p999", "max", "qps");
+  }
+
+  bool first = true;
+  for (int i = 0; i < kOpTypeNum; ++i) {
+    const auto& histogram = stats_[i].histogram;
+    if (histogram.Count() == 0) {
+      continue;
+    }
+    if (json) {
+      fprintf(out,
+              "%s\"%s\":{\"count\":%" PRIu64 ",\"errors\":%" PRIu64 ",\"mean_us\":%.1f,\"p50_us\":%" PRIu64
+              ",\"p99_us\":%" PRIu64 ",\"p999_us\":%" PRIu64 ",\"max_us\":%" PRIu64 ",\"qps\":%.1f}",
+              first ? "" : ",", kOpTypeNames[i], histogram.Count(), stats_[i].error_count, histogram.Mean(),
+              histogram.Percentile(50), histogram.Percentile(99), histogram.Percentile(99.9), histogram.Max(),
+              histogram.Count() / elapsed_s);
+    } else {
+      fprintf(out,
+              "%-18s %10" PRIu64 " %8" PRIu64 " %10.1f %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8.1f\n",
+              kOpTypeNames[i], histogram.Count(), stats_[i].error_count, histogram.Mean(), histogram.Percentile(50),
+              histogram.Percentile(99), histogram.Percentile(99.9), histogram.Max(), histogram.Count() / elapsed_s);
+    }
+    first = false;
+  }
+
+  if (json) {
+    fprintf(out, "}}\n");
+  }
+}
+
+}  // namespace bench
+}  // namespace dingodb
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  dingodb::bench::Benchmark bench;
+  if (!bench.Init()) {
+    return -1;
+  }
+
+  bench.Run();
+
+  FILE* out = stdout;
+  if (!FLAGS_output_file.empty()) {
+    out = fopen(FLAGS_output_file.c_str(), "w");
+    if (out == nullptr) {
+      LOG(ERROR) << "Fail to open output file " << FLAGS_output_file;
+      return -1;
+    }
+  }
+  bench.Report(out);
+  if (out != stdout) {
+    fclose(out);
+  }
+
+  return 0;
+}
@@ -12,14 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
 #include "braft/raft.h"
 #include "braft/route_table.h"
 #include "braft/util.h"
 #include "brpc/channel.h"
 #include "brpc/controller.h"
 #include "bthread/bthread.h"
+#include "butil/strings/string_split.h"
 #include "gflags/gflags.h"
 #include "proto/store.pb.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 
 DEFINE_bool(log_each_request, true, "Print log for each request");
 DEFINE_bool(use_bthread, false, "Use bthread to send requests");
@@ -30,6 +37,10 @@ DEFINE_string(store_addr, "127.0.0.1:20001", "store server addr");
 DEFINE_string(method, "KvGet", "Request method");
 DEFINE_string(key, "hello", "Request key");
 DEFINE_int32(region_id, 111111, "region id");
+DEFINE_int32(sst_kv_num, 10000, "Number of kvs in one ingest sst file");
+DEFINE_string(sst_path, "./ingest.sst", "Local sst file path for ingest");
+DEFINE_string(cf_name, "default", "Column family of engine options, empty is db options");
+DEFINE_string(options, "", "Engine options, e.g. write_buffer_size=134217728,max_write_buffer_number=4");
 
 bvar::LatencyRecorder g_latency_recorder("dingo-store");
 
@@ -180,6 +191,81 @@ void sendKvBatchPutIfAbsent(brpc::Controller& cntl, dingodb::pb::store::StoreSer
   }
 }
 
+// Build sorted sst file locally, then ship it to store for bulk load.
+void sendKvIngestSst(brpc::Controller& cntl, dingodb::pb::store::StoreService_Stub& stub) {
+  rocksdb::EnvOptions env_options;
+  rocksdb::Options options;
+  rocksdb::SstFileWriter sst_writer(env_options, options);
+  rocksdb::Status s = sst_writer.Open(FLAGS_sst_path);
+  if (!s.ok()) {
+    LOG(ERROR) << "Fail to open sst file " << FLAGS_sst_path << " : " << s.ToString();
+    return;
+  }
+
+  // Keys are added in order, zero padding keep numeric order same as bytes order.
+  char key_buf[32];
+  for (int i = 0; i < FLAGS_sst_kv_num; ++i) {
+    snprintf(key_buf, sizeof(key_buf), "%s_%010d", FLAGS_key.c_str(), i);
+    s = sst_writer.Put(key_buf, genRandomString(64));
+    if (!s.ok()) {
+      LOG(ERROR) << "Fail to put sst file : " << s.ToString();
+      return;
+    }
+  }
+
+  s = sst_writer.Finish();
+  if (!s.ok()) {
+    LOG(ERROR) << "Fail to finish sst file : " << s.ToString();
+    return;
+  }
+
+  dingodb::pb::store::KvIngestSstRequest request;
+  dingodb::pb::store::KvIngestSstResponse response;
+
+  request.set_region_id(FLAGS_region_id);
+  std::ifstream file(FLAGS_sst_path, std::ios::in | std::ios::binary);
+  request.mutable_sst()->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(FLAGS_sst_path.c_str());
+
+  stub.KvIngestSst(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    LOG(WARNING) << "Fail to send request to : " << cntl.ErrorText();
+  }
+
+  if (FLAGS_log_each_request) {
+    LOG(INFO) << " request sst size=" << request.sst().size() << " response=" << response.ShortDebugString()
+              << " latency=" << cntl.latency_us() << "us";
+  }
+}
+
+void sendSetEngineOptions(brpc::Controller& cntl, dingodb::pb::store::StoreService_Stub& stub) {
+  dingodb::pb::store::SetEngineOptionsRequest request;
+  dingodb::pb::store::SetEngineOptionsResponse response;
+
+  request.set_cf_name(FLAGS_cf_name);
+  std::vector<std::string> options;
+  butil::SplitString(FLAGS_options, ',', &options);
+  for (const auto& option : options) {
+    auto pos = option.find('=');
+    if (pos == std::string::npos) {
+      LOG(ERROR) << "Invalid option: " << option;
+      return;
+    }
+    (*request.mutable_options())[option.substr(0, pos)] = option.substr(pos + 1);
+  }
+
+  stub.SetEngineOptions(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    LOG(WARNING) << "Fail to send request to : " << cntl.ErrorText();
+  }
+
+  if (FLAGS_log_each_request) {
+    LOG(INFO) << " request=" << request.ShortDebugString() << " response=" << response.ShortDebugString()
+              << " latency=" << cntl.latency_us() << "us";
+  }
+}
+
 void sendAddRegion(brpc::Controller& cntl, dingodb::pb::store::StoreService_Stub& stub) {
   dingodb::pb::store::AddRegionRequest request;
   dingodb::pb::store::AddRegionResponse response;
@@ -317,6 +403,12 @@ void* sender(void* arg) {
     } else if (FLAGS_method == "KvBatchPutIfAbsent") {
       sendKvBatchPutIfAbsent(cntl, stub);
 
+    } else if (FLAGS_method == "KvIngestSst") {
+      sendKvIngestSst(cntl, stub);
+
+    } else if (FLAGS_method == "SetEngineOptions") {
+      sendSetEngineOptions(cntl, stub);
+
     } else if (FLAGS_method == "KvGet") {
       sendKvGet(cntl, stub);
 
@@ -18,5 +18,7 @@ namespace dingodb {
 
 const std::string Constant::kStoreDataCF = "default";
 const std::string Constant::kStoreMetaCF = "meta";
+const std::string Constant::kStoreMvccCF = "mvcc";
+const std::string Constant::kStoreTtlCF = "ttl";
 
 }  // namespace dingodb
@@ -31,10 +31,23 @@ class Constant {
   // Define Global SchemaId for Coordinator(As only one)
   static const uint64_t kCoordinatorSchemaId = 0;
 
+  // Define the id count of one leased id block, the coordinator leader persist high-water mark once per block
+  static const uint64_t kIdLeaseBlockSize = 1000;
+
+  // Define tso logical bits, the composed timestamp is (physical << kTsoLogicalBits) + logical
+  static const int kTsoLogicalBits = 18;
+  static const int64_t kTsoMaxLogical = 1 << kTsoLogicalBits;
+  // Define tso window in milliseconds, leader persist physical upper bound once per window
+  static const int64_t kTsoWindowMs = 3000;
+
   // Define Store data column family.
   static const std::string kStoreDataCF;
   // Define Store meta column family.
   static const std::string kStoreMetaCF;
+  // Define Store mvcc data column family, keys are versioned.
+  static const std::string kStoreMvccCF;
+  // Define Store ttl data column family, values carry expire time.
+  static const std::string kStoreTtlCF;
 };
 
 }  // namespace dingodb
@@ -19,7 +19,9 @@
 #include <string>
 
 #include "brpc/controller.h"
+#include "butil/time.h"
 #include "common/synchronization.h"
+#include "common/trace.h"
 #include "engine/write_data.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
@@ -33,30 +35,45 @@ class Context {
         done_(nullptr),
         response_(nullptr),
         region_id_(0),
+        engine_id_(pb::common::ENG_RAFT_STORE),
         directly_delete_(false),
         delete_files_in_range_(false),
         flush_(false),
         role_(pb::common::ClusterRole::STORE),
+        ts_(0),
+        ttl_(0),
+        start_time_us_(butil::gettimeofday_us()),
+        propose_time_us_(0),
         enable_sync_(false) {}
   Context(brpc::Controller* cntl, google::protobuf::Closure* done)
       : cntl_(cntl),
         done_(done),
         response_(nullptr),
         region_id_(0),
+        engine_id_(pb::common::ENG_RAFT_STORE),
         directly_delete_(false),
         delete_files_in_range_(false),
         flush_(false),
         role_(pb::common::ClusterRole::STORE),
+        ts_(0),
+        ttl_(0),
+        start_time_us_(butil::gettimeofday_us()),
+        propose_time_us_(0),
         enable_sync_(false) {}
   Context(brpc::Controller* cntl, google::protobuf::Closure* done, google::protobuf::Message* response)
       : cntl_(cntl),
         done_(done),
         response_(response),
         region_id_(0),
+        engine_id_(pb::common::ENG_RAFT_STORE),
         directly_delete_(false),
         delete_files_in_range_(false),
         flush_(false),
         role_(pb::common::ClusterRole::STORE),
+        ts_(0),
+        ttl_(0),
+        start_time_us_(butil::gettimeofday_us()),
+        propose_time_us_(0),
         enable_sync_(false) {}
   ~Context() = default;
 
@@ -84,6 +101,9 @@ class Context {
     return *this;
   }
 
+  pb::common::Engine EngineId() const { return engine_id_; }
+  void SetEngineId(pb::common::Engine engine_id) { engine_id_ = engine_id; }
+
   void SetCfName(const std::string& cf_name) { cf_name_ = cf_name; }
   const std::string& CfName() const { return cf_name_; }
 
@@ -99,6 +119,20 @@ class Context {
   pb::common::ClusterRole ClusterRole() { return role_; }
   void SetClusterRole(pb::common::ClusterRole role) { role_ = role; }
 
+  uint64_t Ts() { return ts_; }
+  void SetTs(uint64_t ts) { ts_ = ts; }
+
+  uint64_t Ttl() { return ttl_; }
+  void SetTtl(uint64_t ttl) { ttl_ = ttl; }
+
+  int64_t StartTimeUs() { return start_time_us_; }
+
+  int64_t ProposeTimeUs() { return propose_time_us_; }
+  void SetProposeTimeUs(int64_t propose_time_us) { propose_time_us_ = propose_time_us; }
+
+  std::shared_ptr<Trace> GetTrace() { return trace_; }
+  void SetTrace(std::shared_ptr<Trace> trace) { trace_ = trace; }
+
   void EnableSyncMode() {
     enable_sync_ = true;
     cond_ = std::make_shared<BthreadCond>();
@@ -120,6 +154,8 @@ class Context {
   google::protobuf::Message* response_;
 
   uint64_t region_id_;
+  // Engine of region table, storage route request to it.
+  pb::common::Engine engine_id_;
   // Column family name
   std::string cf_name_;
   // Directly delete data, not through raft.
@@ -130,6 +166,15 @@ class Context {
   bool flush_;
   // role
   pb::common::ClusterRole role_;
+  // Mvcc read/write timestamp, 0 is not versioned.
+  uint64_t ts_;
+  // Table ttl in seconds, 0 is never expire.
+  uint64_t ttl_;
+  // For write stage latency, context create and raft log propose time.
+  int64_t start_time_us_;
+  int64_t propose_time_us_;
+  // Write stages of sampled request, nullptr is not sampled.
+  std::shared_ptr<Trace> trace_;
 
   // For sync mode
   bool enable_sync_;
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/logging.h"
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/time.h"
+#include "common/helper.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+// Installed async loggers, protected by install_mutex.
+static std::mutex install_mutex;
+static std::vector<std::pair<int, AsyncLogger*>> installed_loggers;
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped, size_t max_buffer_bytes)
+    : wrapped_(wrapped), max_buffer_bytes_(max_buffer_bytes) {}
+
+AsyncLogger::~AsyncLogger() { Stop(); }
+
+void AsyncLogger::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!stopped_) {
+    return;
+  }
+  stopped_ = false;
+  thread_ = std::thread(&AsyncLogger::Run, this);
+}
+
+void AsyncLogger::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  wake_cond_.notify_all();
+  free_cond_.notify_all();
+  // Thread write remaining buffer before exit.
+  thread_.join();
+  wrapped_->Flush();
+}
+
+void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Wait for background thread take the buffer, a single too large message is always accepted.
+  free_cond_.wait(lock, [&]() {
+    return stopped_ || active_buf_.data.empty() || active_buf_.data.size() + message_len <= max_buffer_bytes_;
+  });
+  if (stopped_) {
+    lock.unlock();
+    wrapped_->Write(force_flush, timestamp, message, message_len);
+    return;
+  }
+
+  active_buf_.data.append(message, message_len);
+  active_buf_.timestamp = timestamp;
+  active_buf_.flush = active_buf_.flush || force_flush;
+  uint64_t seq = ++appended_seq_;
+  wake_cond_.notify_one();
+
+  if (force_flush) {
+    flushed_cond_.wait(lock, [&]() { return written_seq_ >= seq; });
+  }
+}
+
+void AsyncLogger::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!stopped_) {
+    uint64_t seq = appended_seq_;
+    active_buf_.flush = !active_buf_.data.empty() || active_buf_.flush;
+    wake_cond_.notify_one();
+    flushed_cond_.wait(lock, [&]() { return written_seq_ >= seq; });
+  }
+  lock.unlock();
+
+  wrapped_->Flush();
+}
+
+uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
+
+void AsyncLogger::Run() {
+  Buffer buf;
+  for (;;) {
+    uint64_t seq = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_cond_.wait(lock, [&]() { return stopped_ || !active_buf_.data.empty(); });
+      if (active_buf_.data.empty()) {
+        // Stopped and all written.
+        written_seq_ = appended_seq_;
+        flushed_cond_.notify_all();
+        break;
+      }
+      std::swap(buf, active_buf_);
+      seq = appended_seq_;
+    }
+    free_cond_.notify_all();
+
+    wrapped_->Write(buf.flush, buf.timestamp, buf.data.data(), buf.data.size());
+    if (buf.flush) {
+      wrapped_->Flush();
+    }
+    buf.data.clear();
+    buf.flush = false;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      written_seq_ = seq;
+    }
+    flushed_cond_.notify_all();
+  }
+}
+
+void AsyncLogger::Install(size_t max_buffer_bytes) {
+  std::lock_guard<std::mutex> lock(install_mutex);
+  if (!installed_loggers.empty()) {
+    return;
+  }
+
+  for (int severity : {google::GLOG_INFO, google::GLOG_WARNING, google::GLOG_ERROR}) {
+    auto* logger = new AsyncLogger(google::base::GetLogger(severity), max_buffer_bytes);
+    logger->Start();
+    google::base::SetLogger(severity, logger);
+    installed_loggers.emplace_back(severity, logger);
+  }
+}
+
+void AsyncLogger::FlushAll() {
+  std::lock_guard<std::mutex> lock(install_mutex);
+  for (auto& [severity, logger] : installed_loggers) {
+    logger->Flush();
+  }
+}
+
+void AsyncLogger::UninstallAll() {
+  std::lock_guard<std::mutex> lock(install_mutex);
+  for (auto& [severity, logger] : installed_loggers) {
+    logger->Stop();
+    // Glog delete the replaced logger.
+    google::base::SetLogger(severity, logger->wrapped_);
+  }
+  installed_loggers.clear();
+}
+
+bool LogRateLimiter::Allow(int64_t interval_ms) {
+  int64_t now_ms = butil::gettimeofday_ms();
+  int64_t last_time_ms = last_time_ms_.load(std::memory_order_relaxed);
+  if (now_ms - last_time_ms < interval_ms ||
+      !last_time_ms_.compare_exchange_strong(last_time_ms, now_ms, std::memory_order_relaxed)) {
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const LogRateLimiter::Suppressed& suppressed) {
+  if (suppressed.count > 0) {
+    os << "[suppressed " << suppressed.count << "] ";
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const ProtoJson& json) {
+  return os << Helper::MessageToJsonString(json.message_);
+}
+
+}  // namespace dingodb
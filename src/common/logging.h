@@ -0,0 +1,129 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_LOGGING_H_
+#define DINGODB_COMMON_LOGGING_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "glog/logging.h"
+#include "google/protobuf/message.h"
+
+namespace dingodb {
+
+// Wrap a glog file logger, Write only append to buffer and a background thread
+// write to the wrapped logger, so request thread never block on disk io.
+// When buffer is full writer wait, log is not dropped.
+// Message need force flush(severity above FLAGS_logbuflevel) wait until written.
+class AsyncLogger : public google::base::Logger {
+ public:
+  AsyncLogger(google::base::Logger* wrapped, size_t max_buffer_bytes);
+  ~AsyncLogger() override;
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  void Start();
+  void Stop();
+
+  void Write(bool force_flush, time_t timestamp, const char* message, size_t message_len) override;
+  void Flush() override;
+  uint32_t LogSize() override;
+
+  // Replace INFO/WARNING/ERROR file logger with async logger.
+  // FATAL keep sync, process abort after it.
+  static void Install(size_t max_buffer_bytes);
+  static void FlushAll();
+  static void UninstallAll();
+
+ private:
+  struct Buffer {
+    std::string data;
+    time_t timestamp = 0;
+    bool flush = false;
+  };
+
+  void Run();
+
+  google::base::Logger* wrapped_;
+  const size_t max_buffer_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_cond_;
+  std::condition_variable free_cond_;
+  std::condition_variable flushed_cond_;
+  Buffer active_buf_;
+  // Sequence of buffer appended and written, for waiting flush.
+  uint64_t appended_seq_ = 0;
+  uint64_t written_seq_ = 0;
+  bool stopped_ = true;
+  std::thread thread_;
+};
+
+// Allow one log per interval for a call site, count suppressed log between.
+class LogRateLimiter {
+ public:
+  LogRateLimiter() = default;
+  ~LogRateLimiter() = default;
+
+  bool Allow(int64_t interval_ms);
+
+  // Print suppressed count since last emitted log, nothing if none.
+  struct Suppressed {
+    int64_t count;
+  };
+  Suppressed TakeSuppressed() { return Suppressed{suppressed_.exchange(0, std::memory_order_relaxed)}; }
+
+ private:
+  std::atomic<int64_t> last_time_ms_{0};
+  std::atomic<int64_t> suppressed_{0};
+};
+
+std::ostream& operator<<(std::ostream& os, const LogRateLimiter::Suppressed& suppressed);
+
+// Lazy json of protobuf message, only format when streamed to an emitted log line.
+// e.g. DINGO_LOG_EVERY_SECOND(INFO) << "request: " << ProtoJson(*request);
+class ProtoJson {
+ public:
+  explicit ProtoJson(const google::protobuf::Message& message) : message_(message) {}
+
+  friend std::ostream& operator<<(std::ostream& os, const ProtoJson& json);
+
+ private:
+  const google::protobuf::Message& message_;
+};
+
+}  // namespace dingodb
+
+// Log at most once per interval_ms for this call site, every call site has
+// its own static limiter in the lambda. The for only run once, so it is safe
+// as a single statement under if/else.
+#define DINGO_LOG_EVERY_MS(severity, interval_ms)                             \
+  for (::dingodb::LogRateLimiter* dingo_log_limiter = []() {                  \
+         static ::dingodb::LogRateLimiter limiter;                            \
+         return &limiter;                                                     \
+       }();                                                                   \
+       dingo_log_limiter != nullptr && dingo_log_limiter->Allow(interval_ms); \
+       dingo_log_limiter = nullptr)                                           \
+  LOG(severity) << dingo_log_limiter->TakeSuppressed()
+
+#define DINGO_LOG_EVERY_SECOND(severity) DINGO_LOG_EVERY_MS(severity, 1000)
+
+#endif  // DINGODB_COMMON_LOGGING_H_
@@ -47,10 +47,11 @@ class MetaControl {
   virtual void SetRaftNode(std::shared_ptr<RaftNode> raft_node) = 0;
 
   // create region
-  // in: resource_tag
+  // in: resource_tag, ttl of table in seconds, engine and value columns of table
   // out: new region id
   virtual int CreateRegion(const std::string &region_name, const std::string &resource_tag, int32_t replica_num,
-                           pb::common::Range region_range, uint64_t schema_id, uint64_t table_id,
+                           pb::common::Range region_range, uint64_t schema_id, uint64_t table_id, uint64_t ttl,
+                           pb::common::Engine engine, const std::vector<pb::common::ColumnSchema> &columns,
                            uint64_t &new_region_id, pb::coordinator_internal::MetaIncrement &meta_increment) = 0;
 
   // drop region
@@ -113,7 +114,8 @@ class MetaControl {
 
   // on_apply callback
   // leader do need update next_xx_id, so leader call this function with update_ids=false
-  virtual void ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement &meta_increment, bool update_ids) = 0;
+  // all kv changes of one meta_increment are persisted in one atomic write, a failed write is fatal
+  virtual int ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement &meta_increment, bool update_ids) = 0;
 };
 
 }  // namespace dingodb
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/trace.h"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+std::atomic<int> Trace::sample_rate_{0};
+
+int64_t SlowRequestLog::threshold_us_ = 0;
+std::mutex SlowRequestLog::mutex_;
+std::ofstream SlowRequestLog::file_;
+std::deque<std::string> SlowRequestLog::recent_;
+
+static const char* kTraceStageNames[] = {"wait", "raft", "apply", "respond"};
+
+std::string Trace::ToString() const {
+  std::string result;
+  for (int i = kPropose; i < kStageNum; ++i) {
+    // Not reach the stage, e.g. propose failed.
+    if (times_[i] == 0) {
+      break;
+    }
+    butil::string_appendf(&result, "%s%s=%ldus", result.empty() ? "" : " ", kTraceStageNames[i - 1],
+                          times_[i] - times_[i - 1]);
+  }
+
+  return result;
+}
+
+bool Trace::IsSampled() {
+  int sample_rate = sample_rate_.load(std::memory_order_relaxed);
+  return sample_rate > 0 && butil::fast_rand_less_than(sample_rate) == 0;
+}
+
+void SlowRequestLog::Init(const std::string& log_file, int threshold_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threshold_us_ = threshold_ms > 0 ? static_cast<int64_t>(threshold_ms) * 1000 : 0;
+  if (threshold_us_ > 0) {
+    file_.open(log_file, std::ios::out | std::ios::app);
+    if (!file_.is_open()) {
+      LOG(ERROR) << "Open slow request log failed, file: " << log_file;
+    }
+  }
+}
+
+void SlowRequestLog::Record(const std::string& request) {
+  time_t now = time(nullptr);
+  struct tm now_tm;
+  localtime_r(&now, &now_tm);
+  char time_str[32];
+  strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &now_tm);
+  std::string line = butil::StringPrintf("%s %s", time_str, request.c_str());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open()) {
+    file_ << line << std::endl;
+  }
+
+  recent_.push_back(std::move(line));
+  if (recent_.size() > kMaxRecentNum) {
+    recent_.pop_front();
+  }
+}
+
+std::vector<std::string> SlowRequestLog::GetRecent() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<std::string>(recent_.begin(), recent_.end());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_TRACE_H_
+#define DINGODB_COMMON_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/time.h"
+
+namespace dingodb {
+
+// Timestamps of one write through raft pipeline, only sampled request has trace.
+//   wait: request received to propose, include validate and encode
+//   raft: braft apply queue, append log, replicate and commit, until leader on_apply
+//   apply: write engine in state machine
+//   respond: response sent
+// Marks are in order, node apply is async so no mark after it.
+class Trace {
+ public:
+  enum Stage {
+    kReceive = 0,
+    kPropose = 1,
+    kApply = 2,
+    kApplied = 3,
+    kRespond = 4,
+    kStageNum = 5,
+  };
+
+  explicit Trace(int64_t receive_time_us) : times_{receive_time_us} {}
+  ~Trace() = default;
+
+  void Mark(Stage stage) { times_[stage] = butil::gettimeofday_us(); }
+
+  // e.g. wait=12us raft=2100us apply=310us respond=20us
+  std::string ToString() const;
+
+  // Trace 1 of sample rate requests, 0 is disable.
+  static void SetSampleRate(int sample_rate) { sample_rate_.store(sample_rate > 0 ? sample_rate : 0); }
+  static bool IsSampled();
+
+ private:
+  static std::atomic<int> sample_rate_;
+
+  int64_t times_[kStageNum];
+};
+
+// Request slower than threshold is written to slow request log file,
+// recent ones are kept in memory for /slow_requests page.
+class SlowRequestLog {
+ public:
+  static void Init(const std::string& log_file, int threshold_ms);
+
+  static bool IsSlow(int64_t elapsed_us) { return threshold_us_ > 0 && elapsed_us >= threshold_us_; }
+  static void Record(const std::string& request);
+  static std::vector<std::string> GetRecent();
+
+ private:
+  static const size_t kMaxRecentNum = 256;
+
+  static int64_t threshold_us_;
+  static std::mutex mutex_;
+  static std::ofstream file_;
+  static std::deque<std::string> recent_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TRACE_H_
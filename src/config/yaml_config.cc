@@ -36,7 +36,7 @@ int YamlConfig::LoadFile(const std::string& filename) {
   return 0;
 }
 
-int YamlConfig::ReloadFile(const std::string& filename) { return Load(filename); }
+int YamlConfig::ReloadFile(const std::string& filename) { return LoadFile(filename); }
 
 int YamlConfig::GetInt(const std::string& key) {
   try {
@@ -20,7 +20,7 @@
 
 #include "braft/util.h"
 #include "brpc/closure_guard.h"
-#include "common/helper.h"
+#include "common/logging.h"
 #include "coordinator/coordinator_control.h"
 #include "proto/coordinator.pb.h"
 
@@ -37,10 +37,8 @@ class CoordinatorClosure : public braft::Closure {
   RESP* response() const { return response_; }     // NOLINT
   void Run() override {
     brpc::ClosureGuard done_guard(done_);
-    std::string str_request = Helper::MessageToJsonString(*request_);
-    std::string str_response = Helper::MessageToJsonString(*response_);
-    LOG(INFO) << "Coordinator Closure return respone [" << str_response << "] to client with request[" << str_request
-              << "]";
+    LOG(INFO) << "Coordinator Closure return respone [" << ProtoJson(*response_) << "] to client with request["
+              << ProtoJson(*request_) << "]";
   }
 
  private:
@@ -75,14 +73,16 @@ class CoordinatorClosure<pb::coordinator::StoreHeartbeatRequest, pb::coordinator
     auto* new_storemap = response()->mutable_storemap();
     coordinator_control_->GetStoreMap(*new_storemap);
 
+    response()->set_dead_range_epoch(
+        coordinator_control_->GetDeadRanges(request()->self_dead_range_epoch(), *response()->mutable_dead_ranges()));
+
     response()->set_storemap_epoch(new_storemap_epoch_);
     response()->set_regionmap_epoch(new_regionmap_epoch_);
 
     brpc::ClosureGuard done_guard(done_);
-    std::string str_request = Helper::MessageToJsonString(*request_);
-    std::string str_response = Helper::MessageToJsonString(*response_);
-    LOG(INFO) << "Coordinator Closure return Heartbeat response[" << str_response << "] to store with request["
-              << str_request << "]";
+    // Response carry whole region map and store map, every store heartbeat periodically.
+    DINGO_LOG_EVERY_SECOND(INFO) << "Coordinator Closure return Heartbeat response[" << ProtoJson(*response_)
+                                 << "] to store with request[" << ProtoJson(*request_) << "]";
   }
 
  private:
@@ -94,6 +94,37 @@ class CoordinatorClosure<pb::coordinator::StoreHeartbeatRequest, pb::coordinator
   std::shared_ptr<CoordinatorControl> coordinator_control_;
 };
 
+template <>
+class CoordinatorClosure<pb::coordinator::TsoRequest, pb::coordinator::TsoResponse> : public braft::Closure {
+ public:
+  CoordinatorClosure(const pb::coordinator::TsoRequest* request, pb::coordinator::TsoResponse* response,
+                     google::protobuf::Closure* done, std::shared_ptr<CoordinatorControl> coordinator_control)
+      : request_(request), response_(response), done_(done), coordinator_control_(coordinator_control) {}
+  ~CoordinatorClosure() override = default;
+
+  const pb::coordinator::TsoRequest* request() const { return request_; }  // NOLINT
+  pb::coordinator::TsoResponse* response() const { return response_; }     // NOLINT
+
+  // timestamps can only be returned after tso window covering them is committed
+  void Run() override {
+    brpc::ClosureGuard done_guard(done_);
+    if (!coordinator_control_->IsTsoCommitted(response_->start_timestamp().physical())) {
+      LOG(ERROR) << "Coordinator Closure tso window commit failed, physical="
+                 << response_->start_timestamp().physical();
+      response_->clear_start_timestamp();
+      response_->clear_count();
+      response_->mutable_error()->set_errcode(pb::error::Errno::ERAFT_NOTLEADER);
+      response_->mutable_error()->set_errmsg("Tso window commit failed");
+    }
+  }
+
+ private:
+  const pb::coordinator::TsoRequest* request_;
+  pb::coordinator::TsoResponse* response_;
+  google::protobuf::Closure* done_;
+  std::shared_ptr<CoordinatorControl> coordinator_control_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COORDINATOR_COMMON_H_
@@ -16,15 +16,19 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "butil/scoped_lock.h"
 #include "butil/strings/string_split.h"
+#include "butil/time.h"
+#include "common/constant.h"
 #include "google/protobuf/unknown_field_set.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator_internal.pb.h"
@@ -33,14 +37,22 @@
 namespace dingodb {
 
 CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<MetaWriter> meta_writer)
-    : meta_reader_(meta_reader), meta_writer_(meta_writer), is_leader_(false) {
+    : meta_reader_(meta_reader),
+      meta_writer_(meta_writer),
+      is_leader_(false),
+      tso_physical_(0),
+      tso_logical_(0),
+      tso_saved_end_(0),
+      tso_pending_end_(0) {
   bthread_mutex_init(&control_mutex_, nullptr);
+  bthread_mutex_init(&tso_mutex_, nullptr);
   root_schema_writed_to_raft_ = false;
 
   coordinator_meta_ = new MetaMapStorage<pb::coordinator_internal::CoordinatorInternal>(&coordinator_map_);
   store_meta_ = new MetaMapStorage<pb::common::Store>(&store_map_);
   schema_meta_ = new MetaMapStorage<pb::coordinator_internal::SchemaInternal>(&schema_map_);
   region_meta_ = new MetaMapStorage<pb::common::Region>(&region_map_);
+  deleted_region_meta_ = new MetaMapStorage<pb::common::Region>(&deleted_region_map_, "deleted_region");
   table_meta_ = new MetaMapStorage<pb::coordinator_internal::TableInternal>(&table_map_);
   id_epoch_meta_ = new MetaMapStorage<pb::coordinator_internal::IdEpochInternal>(&id_epoch_map_);
 }
@@ -50,13 +62,30 @@ CoordinatorControl::~CoordinatorControl() {
   delete store_meta_;
   delete schema_meta_;
   delete region_meta_;
+  delete deleted_region_meta_;
   delete table_meta_;
   delete id_epoch_meta_;
+
+  bthread_mutex_destroy(&tso_mutex_);
+  bthread_mutex_destroy(&control_mutex_);
 }
 
 bool CoordinatorControl::IsLeader() { return is_leader_.load(); }
-void CoordinatorControl::SetLeader() { is_leader_.store(true); }
-void CoordinatorControl::SetNotLeader() { is_leader_.store(false); }
+void CoordinatorControl::SetLeader() {
+  ResetIdLeases();
+  ResetTso();
+  is_leader_.store(true);
+}
+void CoordinatorControl::SetNotLeader() {
+  is_leader_.store(false);
+  ResetIdLeases();
+}
+
+// new leader must start allocating from the persisted high-water mark, ids leased by old leader are skipped
+void CoordinatorControl::ResetIdLeases() {
+  BAIDU_SCOPED_LOCK(control_mutex_);
+  id_lease_map_.clear();
+}
 
 bool CoordinatorControl::Recover() {
   BAIDU_SCOPED_LOCK(control_mutex_);
@@ -109,6 +138,17 @@ bool CoordinatorControl::Recover() {
   LOG(INFO) << "Recover region_meta, count=" << kvs.size();
   kvs.clear();
 
+  // deleted region map
+  if (!meta_reader_->Scan(deleted_region_meta_->Prefix(), kvs)) {
+    return false;
+  }
+
+  if (!deleted_region_meta_->Recover(kvs)) {
+    return false;
+  }
+  LOG(INFO) << "Recover deleted_region_meta, count=" << kvs.size();
+  kvs.clear();
+
   // table map
   if (!meta_reader_->Scan(table_meta_->Prefix(), kvs)) {
     return false;
@@ -131,6 +171,10 @@ bool CoordinatorControl::Recover() {
   LOG(INFO) << "Recover id_epoch_meta, count=" << kvs.size();
   kvs.clear();
 
+  if (id_epoch_map_.find(pb::coordinator_internal::IdEpochType::TSO_WINDOW_END) != id_epoch_map_.end()) {
+    UpdateTsoWindow(id_epoch_map_[pb::coordinator_internal::IdEpochType::TSO_WINDOW_END].value());
+  }
+
   return true;
 }
 
@@ -277,8 +321,39 @@ void CoordinatorControl::GetLeaderLocation(pb::common::Location& leader_location
   }
 }
 
+// ids are allocated from leased blocks, the other keys are epochs and windows persisted on every change
+static bool IsLeasedId(uint64_t key) {
+  static const std::set<uint64_t> kLeasedIds = {
+      pb::coordinator_internal::IdEpochType::ID_NEXT_COORINATOR, pb::coordinator_internal::IdEpochType::ID_NEXT_STORE,
+      pb::coordinator_internal::IdEpochType::ID_NEXT_SCHEMA, pb::coordinator_internal::IdEpochType::ID_NEXT_REGION,
+      pb::coordinator_internal::IdEpochType::ID_NEXT_TABLE};
+  return kLeasedIds.count(key) > 0;
+}
+
 uint64_t CoordinatorControl::GetNextId(const pb::coordinator_internal::IdEpochType& key,
                                        pb::coordinator_internal::MetaIncrement& meta_increment) {
+  // ids are allocated from leased block in memory, epochs are always persisted
+  bool is_id = IsLeasedId(key);
+  if (is_id) {
+    auto it = id_lease_map_.find(key);
+    if (it != id_lease_map_.end() && it->second.next_id < it->second.end_id) {
+      uint64_t value = ++it->second.next_id;
+      LOG(INFO) << "GetNextId key=" << key << " from leased block, value=" << value
+                << " end_id=" << it->second.end_id;
+
+      // the increment leasing the block may be discarded by its caller, until the high-water mark is applied
+      // every increment using the block carries it too, so no id of an applied increment is issued again
+      if (!it->second.persisted) {
+        auto* idepoch = meta_increment.add_idepochs();
+        idepoch->set_id(key);
+        idepoch->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::UPDATE);
+        idepoch->mutable_idepoch()->set_id(key);
+        idepoch->mutable_idepoch()->set_value(it->second.end_id);
+      }
+      return value;
+    }
+  }
+
   uint64_t value = 0;
   if (id_epoch_map_.find(key) == id_epoch_map_.end()) {
     value = 100;
@@ -287,10 +362,21 @@ uint64_t CoordinatorControl::GetNextId(const pb::coordinator_internal::IdEpochTy
     value = id_epoch_map_[key].value();
     LOG(INFO) << "GetNextId key=" << key << " value=" << value;
   }
+
+  // lease a new id block, persist the high-water mark instead of the allocated id
+  uint64_t high_water = value + 1;
+  if (is_id) {
+    high_water = value + Constant::kIdLeaseBlockSize;
+    auto& lease = id_lease_map_[key];
+    lease.next_id = value + 1;
+    lease.end_id = high_water;
+    lease.persisted = false;
+    LOG(INFO) << "GetNextId key=" << key << " lease new block (" << value << ", " << high_water << "]";
+  }
   value++;
 
   // update id in memory
-  id_epoch_map_[key].set_value(value);
+  id_epoch_map_[key].set_value(high_water);
 
   // generate meta_increment
   auto* idepoch = meta_increment.add_idepochs();
@@ -299,11 +385,76 @@ uint64_t CoordinatorControl::GetNextId(const pb::coordinator_internal::IdEpochTy
 
   auto* idepoch_internl = idepoch->mutable_idepoch();
   idepoch_internl->set_id(key);
-  idepoch_internl->set_value(value);
+  idepoch_internl->set_value(high_water);
 
   return value;
 }
 
+// new leader must allocate from the committed window end, old leader may have returned timestamps below it
+void CoordinatorControl::ResetTso() {
+  BAIDU_SCOPED_LOCK(tso_mutex_);
+  tso_physical_ = std::max(tso_physical_, tso_saved_end_);
+  tso_logical_ = 0;
+  tso_pending_end_ = tso_saved_end_;
+  LOG(INFO) << "ResetTso physical=" << tso_physical_ << " saved_end=" << tso_saved_end_;
+}
+
+void CoordinatorControl::UpdateTsoWindow(int64_t window_end) {
+  BAIDU_SCOPED_LOCK(tso_mutex_);
+  tso_saved_end_ = std::max(tso_saved_end_, window_end);
+  tso_pending_end_ = std::max(tso_pending_end_, tso_saved_end_);
+}
+
+bool CoordinatorControl::IsTsoCommitted(int64_t physical) {
+  BAIDU_SCOPED_LOCK(tso_mutex_);
+  return physical < tso_saved_end_;
+}
+
+int CoordinatorControl::GenTso(uint64_t count, pb::coordinator::TsoTimestamp& start_timestamp,
+                               pb::coordinator_internal::MetaIncrement& meta_increment) {
+  if (count == 0 || count >= static_cast<uint64_t>(Constant::kTsoMaxLogical)) {
+    LOG(ERROR) << "GenTso count is illegal " << count;
+    return -1;
+  }
+
+  BAIDU_SCOPED_LOCK(tso_mutex_);
+
+  int64_t now = butil::gettimeofday_ms();
+  if (now > tso_physical_) {
+    tso_physical_ = now;
+    tso_logical_ = 0;
+  }
+
+  // logical is exhausted in this tick, move to next tick
+  if (tso_logical_ + static_cast<int64_t>(count) >= Constant::kTsoMaxLogical) {
+    tso_physical_++;
+    tso_logical_ = 0;
+  }
+
+  start_timestamp.set_physical(tso_physical_);
+  start_timestamp.set_logical(tso_logical_);
+  tso_logical_ += count;
+
+  // extend window ahead of time, so most requests are served from memory
+  bool need_persist = tso_physical_ >= tso_saved_end_;
+  if (tso_physical_ + Constant::kTsoWindowMs / 3 >= tso_pending_end_) {
+    tso_pending_end_ = tso_physical_ + Constant::kTsoWindowMs;
+    need_persist = true;
+  }
+
+  if (need_persist) {
+    auto* idepoch = meta_increment.add_idepochs();
+    idepoch->set_id(pb::coordinator_internal::IdEpochType::TSO_WINDOW_END);
+    idepoch->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::UPDATE);
+
+    auto* idepoch_internl = idepoch->mutable_idepoch();
+    idepoch_internl->set_id(pb::coordinator_internal::IdEpochType::TSO_WINDOW_END);
+    idepoch_internl->set_value(tso_pending_end_);
+  }
+
+  return 0;
+}
+
 // TODO: check name comflicts before create new schema
 int CoordinatorControl::CreateSchema(uint64_t parent_schema_id, std::string schema_name, uint64_t& new_schema_id,
                                      pb::coordinator_internal::MetaIncrement& meta_increment) {
@@ -446,6 +597,31 @@ int CoordinatorControl::CreateStore(uint64_t cluster_id, uint64_t& store_id, std
   }
 }
 
+// Value columns of ENG_COLUMNAR table, all columns in definition order, integer and time types are int64.
+std::vector<pb::common::ColumnSchema> CoordinatorControl::GenColumnSchemas(
+    const pb::meta::TableDefinition& table_definition) {
+  std::vector<pb::common::ColumnSchema> columns;
+  for (const auto& column_definition : table_definition.columns()) {
+    pb::common::ColumnSchema column;
+    column.set_name(column_definition.name());
+    switch (column_definition.sql_type()) {
+      case pb::meta::SQL_TYPE_BOOLEAN:
+      case pb::meta::SQL_TYPE_INTEGER:
+      case pb::meta::SQL_TYPE_BIGINT:
+      case pb::meta::SQL_TYPE_DATE:
+      case pb::meta::SQL_TYPE_TIME:
+      case pb::meta::SQL_TYPE_TIMESTAMP:
+        column.set_type(pb::common::COLUMN_TYPE_INT64);
+        break;
+      default:
+        column.set_type(pb::common::COLUMN_TYPE_BYTES);
+        break;
+    }
+    columns.push_back(column);
+  }
+  return columns;
+}
+
 int CoordinatorControl::CreateTable(uint64_t schema_id, const pb::meta::TableDefinition& table_definition,
                                     uint64_t& new_table_id, pb::coordinator_internal::MetaIncrement& meta_increment) {
   // initial schema create
@@ -486,6 +662,25 @@ int CoordinatorControl::CreateTable(uint64_t schema_id, const pb::meta::TableDef
     return -1;
   }
 
+  // only the ttl column family of rocksdb expire keys
+  if (table_definition.ttl() > 0 && (table_definition.engine() == pb::common::ENG_MEMORY ||
+                                     table_definition.engine() == pb::common::ENG_COLUMNAR ||
+                                     table_definition.engine() == pb::common::ENG_XDP)) {
+    LOG(ERROR) << "ttl is not supported by engine " << pb::common::Engine_Name(table_definition.engine())
+               << " of table " << table_definition.name();
+    return -1;
+  }
+
+  // regions of table are created on the table engine
+  std::vector<pb::common::ColumnSchema> columns;
+  if (table_definition.engine() == pb::common::ENG_COLUMNAR) {
+    columns = GenColumnSchemas(table_definition);
+    if (columns.empty()) {
+      LOG(ERROR) << "no columns provided for columnar table " << table_definition.name();
+      return -1;
+    }
+  }
+
   // create table
   // extract part info, create region for each part
   // TODO: 3 is a temp default value
@@ -499,10 +694,12 @@ int CoordinatorControl::CreateTable(uint64_t schema_id, const pb::meta::TableDef
   for (int i = 0; i < range_partition.ranges_size(); i++) {
     // int ret = CreateRegion(const std::string &region_name, const std::string
     // &resource_tag, int32_t replica_num, pb::common::Range region_range,
-    // uint64_t schema_id, uint64_t table_id, uint64_t &new_region_id)
+    // uint64_t schema_id, uint64_t table_id, uint64_t ttl, pb::common::Engine engine,
+    // const std::vector<pb::common::ColumnSchema> &columns, uint64_t &new_region_id)
     std::string const region_name = table_definition.name() + "_part_" + std::to_string(i);
     uint64_t new_region_id;
-    int const ret = CreateRegion(region_name, "", 3, range_partition.ranges(i), schema_id, new_table_id, new_region_id,
+    int const ret = CreateRegion(region_name, "", 3, range_partition.ranges(i), schema_id, new_table_id,
+                                 table_definition.ttl(), table_definition.engine(), columns, new_region_id,
                                  meta_increment);
     if (ret < 0) {
       LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name();
@@ -670,7 +867,8 @@ int CoordinatorControl::DropTable(uint64_t schema_id, uint64_t table_id,
 
 int CoordinatorControl::CreateRegion(const std::string& region_name, const std::string& resource_tag,
                                      int32_t replica_num, pb::common::Range region_range, uint64_t schema_id,
-                                     uint64_t table_id, uint64_t& new_region_id,
+                                     uint64_t table_id, uint64_t ttl, pb::common::Engine engine,
+                                     const std::vector<pb::common::ColumnSchema>& columns, uint64_t& new_region_id,
                                      pb::coordinator_internal::MetaIncrement& meta_increment) {
   BAIDU_SCOPED_LOCK(control_mutex_);
 
@@ -731,6 +929,11 @@ int CoordinatorControl::CreateRegion(const std::string& region_name, const std::
 
   new_region.set_schema_id(schema_id);
   new_region.set_table_id(table_id);
+  new_region.set_ttl(ttl);
+  new_region.set_engine(engine);
+  for (const auto& column : columns) {
+    *new_region.add_columns() = column;
+  }
 
   // update meta_increment
   auto* region_increment = meta_increment.add_regions();
@@ -826,6 +1029,130 @@ void CoordinatorControl::GetRegionMap(pb::common::RegionMap& region_map) {
   }
 }
 
+// a range reused by a live region is not dead any more, or live data will be dropped by store compaction
+// a range reclaimed by all normal stores has no data left, drop it so the dead range set stays small
+void CoordinatorControl::UpdateDeadRanges(uint64_t store_id, const std::vector<uint64_t>& reclaimed_ids,
+                                          pb::coordinator_internal::MetaIncrement& meta_increment) {
+  BAIDU_SCOPED_LOCK(control_mutex_);
+
+  if (deleted_region_map_.empty()) {
+    return;
+  }
+
+  for (auto reclaimed_id : reclaimed_ids) {
+    if (deleted_region_map_.find(reclaimed_id) != deleted_region_map_.end()) {
+      dead_range_reclaimed_stores_[reclaimed_id].insert(store_id);
+    }
+  }
+
+  std::vector<uint64_t> normal_store_ids;
+  for (const auto& [id, store] : store_map_) {
+    if (store.state() == pb::common::StoreState::STORE_NORMAL) {
+      normal_store_ids.push_back(id);
+    }
+  }
+
+  // live ranges sorted by start_key, live regions do not overlap, so only the last one start before end_key of a
+  // dead range may overlap it
+  std::map<std::string, std::string> live_ranges;
+  for (const auto& [_, region] : region_map_) {
+    auto& end_key = live_ranges[region.range().start_key()];
+    end_key = std::max(end_key, region.range().end_key());
+  }
+  auto is_reused = [&live_ranges](const pb::common::Range& dead_range) -> bool {
+    auto it = live_ranges.lower_bound(dead_range.end_key());
+    if (it == live_ranges.begin()) {
+      return false;
+    }
+    --it;
+    return dead_range.start_key() < it->second;
+  };
+
+  for (const auto& [id, region] : deleted_region_map_) {
+    const auto& dead_range = region.range();
+    bool is_empty = dead_range.start_key().empty() || dead_range.end_key().empty();
+
+    bool reclaimed_by_all = false;
+    auto it = dead_range_reclaimed_stores_.find(id);
+    if (it != dead_range_reclaimed_stores_.end() && !normal_store_ids.empty()) {
+      reclaimed_by_all = std::all_of(normal_store_ids.begin(), normal_store_ids.end(),
+                                     [&it](uint64_t normal_store_id) { return it->second.count(normal_store_id) > 0; });
+    }
+
+    if (is_empty || reclaimed_by_all || is_reused(dead_range)) {
+      LOG(INFO) << "drop dead range, deleted region_id=" << id << " reclaimed_by_all=" << reclaimed_by_all;
+
+      auto* deleted_region_increment = meta_increment.add_deleted_regions();
+      deleted_region_increment->set_id(id);
+      deleted_region_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+      deleted_region_increment->mutable_region()->CopyFrom(region);
+    }
+  }
+}
+
+void CoordinatorControl::UpdateRegionMetrics(uint64_t store_id,
+                                             const std::vector<pb::common::RegionMetrics>& region_metrics) {
+  BAIDU_SCOPED_LOCK(control_mutex_);
+
+  // heartbeat carries all regions of store, drop flow of regions moved out of it
+  for (auto& [_, store_metrics] : region_metrics_map_) {
+    store_metrics.erase(store_id);
+  }
+
+  for (const auto& metrics : region_metrics) {
+    if (region_map_.find(metrics.region_id()) == region_map_.end()) {
+      continue;
+    }
+    region_metrics_map_[metrics.region_id()][store_id] = metrics;
+  }
+}
+
+// reads and writes are served by leader, followers report zero flow, so sum up all stores of region
+void CoordinatorControl::GetRegionMetrics(std::vector<pb::common::RegionMetrics>& region_metrics) {
+  BAIDU_SCOPED_LOCK(control_mutex_);
+
+  for (const auto& [region_id, store_metrics] : region_metrics_map_) {
+    pb::common::RegionMetrics sum_metrics;
+    sum_metrics.set_region_id(region_id);
+    for (const auto& [_, metrics] : store_metrics) {
+      sum_metrics.set_read_qps(sum_metrics.read_qps() + metrics.read_qps());
+      sum_metrics.set_write_qps(sum_metrics.write_qps() + metrics.write_qps());
+      sum_metrics.set_read_bytes_per_second(sum_metrics.read_bytes_per_second() + metrics.read_bytes_per_second());
+      sum_metrics.set_write_bytes_per_second(sum_metrics.write_bytes_per_second() +
+                                             metrics.write_bytes_per_second());
+    }
+    region_metrics.push_back(sum_metrics);
+  }
+}
+
+// dead ranges are only sent when store has an older epoch, ranges reused by live region are already dropped
+// by UpdateDeadRanges in the same heartbeat
+uint64_t CoordinatorControl::GetDeadRanges(
+    uint64_t self_epoch, google::protobuf::RepeatedPtrField<pb::coordinator::DeadRange>& dead_ranges) {
+  BAIDU_SCOPED_LOCK(control_mutex_);
+
+  uint64_t dead_range_epoch = 0;
+  auto epoch_it = id_epoch_map_.find(pb::coordinator_internal::IdEpochType::EPOCH_DEAD_RANGE);
+  if (epoch_it != id_epoch_map_.end()) {
+    dead_range_epoch = epoch_it->second.value();
+  }
+
+  if (self_epoch == dead_range_epoch) {
+    return dead_range_epoch;
+  }
+
+  for (const auto& [id, region] : deleted_region_map_) {
+    if (region.range().start_key().empty() || region.range().end_key().empty()) {
+      continue;
+    }
+    auto* dead_range = dead_ranges.Add();
+    dead_range->set_id(id);
+    dead_range->mutable_range()->CopyFrom(region.range());
+  }
+
+  return dead_range_epoch;
+}
+
 // GetSchemas
 // in: schema_id
 // out: schemas
@@ -1010,63 +1337,60 @@ void CoordinatorControl::GetCoordinatorMap(uint64_t cluster_id, uint64_t& epoch,
 
 // ApplyMetaIncrement is on_apply callback
 // leader do need update next_xx_id, so leader call this function with update_ids=false
-void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement& meta_increment, bool update_ids) {
+// the kv batch is built and written before the in-memory maps are changed, so a failed write leaves both unchanged
+int CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement& meta_increment, bool update_ids) {
   BAIDU_SCOPED_LOCK(control_mutex_);
 
   // prepare data to write to kv engine
   std::vector<pb::common::KeyValue> meta_write_to_kv;
   std::vector<pb::common::KeyValue> meta_delete_to_kv;
+  bool dead_range_changed = false;
+
+  // parent schemas changed by schema or table CREATE, copied from schema_map_ and applied after the write
+  std::map<uint64_t, pb::coordinator_internal::SchemaInternal> parent_schemas;
+  auto get_parent_schema = [this, &parent_schemas](uint64_t schema_id) -> pb::coordinator_internal::SchemaInternal* {
+    auto it = parent_schemas.find(schema_id);
+    if (it != parent_schemas.end()) {
+      return &it->second;
+    }
+    auto schema_it = schema_map_.find(schema_id);
+    if (schema_it == schema_map_.end()) {
+      return nullptr;
+    }
+    return &(parent_schemas[schema_id] = schema_it->second);
+  };
 
-  // leader do not need to update in-memory cache of id & epoch
-  // follower need to update in-memory cache of id & epoch
   // 0.id & epoch
+  // id high-water marks only move forward, a late apply must not drop below a block leased after it
+  std::vector<pb::coordinator_internal::IdEpochInternal> new_idepochs;
   for (int i = 0; i < meta_increment.idepochs_size(); i++) {
     const auto& idepoch = meta_increment.idepochs(i);
-    if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-      if (update_ids) {
-        auto& create_idepoch = id_epoch_map_[idepoch.id()];
-        create_idepoch.CopyFrom(idepoch.idepoch());
+    pb::coordinator_internal::IdEpochInternal new_idepoch = idepoch.idepoch();
+    if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      bool is_id = IsLeasedId(idepoch.id());
+      auto it = id_epoch_map_.find(idepoch.id());
+      if (is_id && it != id_epoch_map_.end() && it->second.value() > new_idepoch.value()) {
+        LOG(INFO) << "ApplyMetaIncrement idepoch id=" << idepoch.id() << " keep value=" << it->second.value()
+                  << " instead of older value=" << new_idepoch.value();
+        new_idepoch.set_value(it->second.value());
       }
 
-      meta_write_to_kv.push_back(id_epoch_meta_->TransformToKvValue(idepoch.idepoch()));
-
-    } else if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      if (update_ids) {
-        auto& update_idepoch = id_epoch_map_[idepoch.id()];
-        update_idepoch.CopyFrom(idepoch.idepoch());
-      }
-
-      meta_write_to_kv.push_back(id_epoch_meta_->TransformToKvValue(idepoch.idepoch()));
+      meta_write_to_kv.push_back(id_epoch_meta_->TransformToKvValue(new_idepoch));
 
     } else if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      if (update_ids) {
-        id_epoch_map_.erase(idepoch.id());
-      }
-
       meta_delete_to_kv.push_back(id_epoch_meta_->TransformToKvValue(idepoch.idepoch()));
     }
+    new_idepochs.push_back(new_idepoch);
   }
 
   // 1.coordinator map
   for (int i = 0; i < meta_increment.coordinators_size(); i++) {
     const auto& coordinator = meta_increment.coordinators(i);
-    if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-      coordinator_map_[coordinator.id()] = coordinator.coordinator();
-
-      // meta_write_kv
+    if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       meta_write_to_kv.push_back(coordinator_meta_->TransformToKvValue(coordinator.coordinator()));
-
-    } else if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      auto& update_coordinator = coordinator_map_[coordinator.id()];
-      update_coordinator.CopyFrom(coordinator.coordinator());
-
-      // meta_write_kv
-      meta_write_to_kv.push_back(coordinator_meta_->TransformToKvValue(coordinator.coordinator()));
-
     } else if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      coordinator_map_.erase(coordinator.id());
-
-      // meta_delete_kv
       meta_delete_to_kv.push_back(coordinator_meta_->TransformToKvValue(coordinator.coordinator()));
     }
   }
@@ -1074,23 +1398,10 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
   // 2.store map
   for (int i = 0; i < meta_increment.stores_size(); i++) {
     const auto& store = meta_increment.stores(i);
-    if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-      store_map_[store.id()] = store.store();
-
-      // meta_write_kv
+    if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        store.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       meta_write_to_kv.push_back(store_meta_->TransformToKvValue(store.store()));
-
-    } else if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      auto& update_store = store_map_[store.id()];
-      update_store.CopyFrom(store.store());
-
-      // meta_write_kv
-      meta_write_to_kv.push_back(store_meta_->TransformToKvValue(store.store()));
-
     } else if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      store_map_.erase(store.id());
-
-      // meta_delete_kv
       meta_delete_to_kv.push_back(store_meta_->TransformToKvValue(store.store()));
     }
   }
@@ -1101,35 +1412,23 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
     if (schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
       // update parent schema for user schemas
       if (schema.id() > pb::meta::ReservedSchemaIds::DINGO_SCHEMA) {
-        if (schema_map_.find(schema.schema_id()) != schema_map_.end()) {
-          auto& new_sub_schema = schema_map_[schema.schema_id()];
-          auto* new_sub_schema_id = new_sub_schema.mutable_schema()->add_schema_ids();
+        auto* parent_schema = get_parent_schema(schema.schema_id());
+        if (parent_schema != nullptr) {
+          auto* new_sub_schema_id = parent_schema->mutable_schema()->add_schema_ids();
           new_sub_schema_id->set_entity_type(::dingodb::pb::meta::EntityType::ENTITY_TYPE_SCHEMA);
           new_sub_schema_id->set_entity_id(schema.id());
           new_sub_schema_id->set_parent_entity_id(schema.schema_id());
 
           LOG(INFO) << "3.schema map CREATE new_sub_schema id=" << schema.id() << " parent_id=" << schema.schema_id();
-
-          // meta_write_kv
-          meta_write_to_kv.push_back(schema_meta_->TransformToKvValue(new_sub_schema));
         }
       }
-      schema_map_[schema.id()] = schema.schema_internal();
 
-      // meta_write_kv
       meta_write_to_kv.push_back(schema_meta_->TransformToKvValue(schema.schema_internal()));
 
     } else if (schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      auto& update_schema = schema_map_[schema.id()];
-      update_schema.CopyFrom(schema.schema_internal());
-
-      // meta_write_kv
       meta_write_to_kv.push_back(schema_meta_->TransformToKvValue(schema.schema_internal()));
 
     } else if (schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      schema_map_.erase(schema.id());
-
-      // meta_delete_kv
       meta_delete_to_kv.push_back(schema_meta_->TransformToKvValue(schema.schema_internal()));
     }
   }
@@ -1137,98 +1436,186 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
   // 4.region map
   for (int i = 0; i < meta_increment.regions_size(); i++) {
     const auto& region = meta_increment.regions(i);
-    if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-      // add region to region_map
-      region_map_[region.id()] = region.region();
-
-      // meta_write_kv
+    if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        region.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       meta_write_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
 
-    } else if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      // update region to region_map
-      auto& update_region = region_map_[region.id()];
-      update_region.CopyFrom(region.region());
+    } else if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      meta_delete_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
 
-      // meta_write_kv
-      meta_write_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
+      // keep range of deleted region, stores drop data in it by compaction
+      meta_write_to_kv.push_back(deleted_region_meta_->TransformToKvValue(region.region()));
+      dead_range_changed = true;
+    }
+  }
 
-    } else if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      // remove region from region_map
-      region_map_.erase(region.id());
+  // 4.1.deleted region map, only DELETE when data is reclaimed, may be proposed more than once
+  for (int i = 0; i < meta_increment.deleted_regions_size(); i++) {
+    const auto& deleted_region = meta_increment.deleted_regions(i);
+    if (deleted_region.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      if (deleted_region_map_.find(deleted_region.id()) != deleted_region_map_.end()) {
+        dead_range_changed = true;
+      }
 
-      // meta_delete_kv
-      meta_delete_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
+      meta_delete_to_kv.push_back(deleted_region_meta_->TransformToKvValue(deleted_region.region()));
     }
   }
 
+  // bump dead range epoch on every replica, stores fetch dead ranges again
+  pb::coordinator_internal::IdEpochInternal dead_range_epoch;
+  if (dead_range_changed) {
+    dead_range_epoch.set_id(pb::coordinator_internal::IdEpochType::EPOCH_DEAD_RANGE);
+    auto it = id_epoch_map_.find(pb::coordinator_internal::IdEpochType::EPOCH_DEAD_RANGE);
+    dead_range_epoch.set_value((it != id_epoch_map_.end() ? it->second.value() : 0) + 1);
+    meta_write_to_kv.push_back(id_epoch_meta_->TransformToKvValue(dead_range_epoch));
+  }
+
   // 5.table map
   for (int i = 0; i < meta_increment.tables_size(); i++) {
     const auto& table = meta_increment.tables(i);
     if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-      // add table to table_map
-      table_map_[table.id()] = table.table();
-
-      // meta_write_kv
-      meta_write_to_kv.push_back(table_meta_->TransformToKvValue(table.table()));
-
       // update parent schema
-      pb::meta::DingoCommonId table_common_id;
-      table_common_id.set_entity_type(::dingodb::pb::meta::EntityType::ENTITY_TYPE_TABLE);
-      table_common_id.set_entity_id(table.id());
-      table_common_id.set_parent_entity_id(table.schema_id());
-
-      if (schema_map_.find(table.schema_id()) != schema_map_.end()) {
-        auto& schema = schema_map_[table.schema_id()];
-        auto* add_table_id = schema.mutable_schema()->add_table_ids();
-        add_table_id->CopyFrom(table_common_id);
+      auto* parent_schema = get_parent_schema(table.schema_id());
+      if (parent_schema != nullptr) {
+        auto* add_table_id = parent_schema->mutable_schema()->add_table_ids();
+        add_table_id->set_entity_type(::dingodb::pb::meta::EntityType::ENTITY_TYPE_TABLE);
+        add_table_id->set_entity_id(table.id());
+        add_table_id->set_parent_entity_id(table.schema_id());
 
         LOG(INFO) << "5.table map CREATE new_sub_table id=" << table.id() << " parent_id=" << table.schema_id();
 
-        // meta_write_kv
-        meta_write_to_kv.push_back(schema_meta_->TransformToKvValue(schema));
-
       } else {
         LOG(ERROR) << " CREATE TABLE apply illegal schema_id=" << table.schema_id() << " table_id=" << table.id()
                    << " table_name=" << table.table().definition().name();
       }
 
-    } else if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-      // update table to table_map
-      auto& update_table = table_map_[table.id()];
-      update_table.CopyFrom(table.table());
+      meta_write_to_kv.push_back(table_meta_->TransformToKvValue(table.table()));
 
-      // meta_write_kv
+    } else if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       meta_write_to_kv.push_back(table_meta_->TransformToKvValue(table.table()));
 
     } else if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-      // delete table from table_map
-      table_map_.erase(table.id());
-
-      // meta_delete_kv
       meta_delete_to_kv.push_back(table_meta_->TransformToKvValue(table.table()));
     }
   }
 
-  // TODO: need engine support transaction
-  // write update to local engine, begin
-  if (!meta_write_to_kv.empty()) {
-    if (!meta_writer_->Put(meta_write_to_kv)) {
-      LOG(INFO) << "ApplyMetaIncrement meta_write failed, exit program";
-      LOG(ERROR) << "ApplyMetaIncrement meta_write failed, exit program";
+  // parent schemas are written after the schema entries of this increment, the last write of a key wins
+  for (const auto& [schema_id, parent_schema] : parent_schemas) {
+    meta_write_to_kv.push_back(schema_meta_->TransformToKvValue(parent_schema));
+  }
+
+  // write update to local engine in one atomic write batch
+  if (meta_write_to_kv.empty() && meta_delete_to_kv.empty()) {
+    return 0;
+  }
+
+  if (!meta_writer_->PutAndDelete(meta_write_to_kv, meta_delete_to_kv)) {
+    LOG(ERROR) << "ApplyMetaIncrement meta write failed, put key nums: " << meta_write_to_kv.size()
+               << " delete key nums: " << meta_delete_to_kv.size();
+    return -1;
+  }
+
+  // update in-memory maps after the write succeeded
+  // leader do not need to update in-memory cache of id & epoch
+  // follower need to update in-memory cache of id & epoch
+  for (int i = 0; i < meta_increment.idepochs_size(); i++) {
+    const auto& idepoch = meta_increment.idepochs(i);
+    if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      if (update_ids) {
+        id_epoch_map_[idepoch.id()].CopyFrom(new_idepochs[i]);
+      }
+
+      // ids of the leased block are safe to allocate once its high-water mark is persisted
+      auto lease_it = id_lease_map_.find(idepoch.id());
+      if (lease_it != id_lease_map_.end() && new_idepochs[i].value() >= lease_it->second.end_id) {
+        lease_it->second.persisted = true;
+      }
+
+      // tso window is updated on both leader and follower
+      if (idepoch.id() == pb::coordinator_internal::IdEpochType::TSO_WINDOW_END) {
+        UpdateTsoWindow(new_idepochs[i].value());
+      }
+    } else if (idepoch.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      if (update_ids) {
+        id_epoch_map_.erase(idepoch.id());
+      }
+    }
+  }
+
+  for (int i = 0; i < meta_increment.coordinators_size(); i++) {
+    const auto& coordinator = meta_increment.coordinators(i);
+    if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      coordinator_map_[coordinator.id()].CopyFrom(coordinator.coordinator());
+    } else if (coordinator.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      coordinator_map_.erase(coordinator.id());
+    }
+  }
 
-      exit(-1);
+  for (int i = 0; i < meta_increment.stores_size(); i++) {
+    const auto& store = meta_increment.stores(i);
+    if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        store.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      store_map_[store.id()].CopyFrom(store.store());
+    } else if (store.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      store_map_.erase(store.id());
     }
   }
 
-  for (auto const& kv : meta_delete_to_kv) {
-    if (!meta_writer_->Delete(kv.key())) {
-      LOG(INFO) << "ApplyMetaIncrement meta_delete failed, exit program";
-      LOG(ERROR) << "ApplyMetaIncrement meta_delete failed, exit program";
+  for (int i = 0; i < meta_increment.schemas_size(); i++) {
+    const auto& schema = meta_increment.schemas(i);
+    if (schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      schema_map_[schema.id()].CopyFrom(schema.schema_internal());
+    } else if (schema.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      schema_map_.erase(schema.id());
+    }
+  }
+
+  for (int i = 0; i < meta_increment.regions_size(); i++) {
+    const auto& region = meta_increment.regions(i);
+    if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        region.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      region_map_[region.id()].CopyFrom(region.region());
+    } else if (region.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      region_map_.erase(region.id());
+      region_metrics_map_.erase(region.id());
+      deleted_region_map_[region.id()] = region.region();
+    }
+  }
 
-      exit(-1);
+  for (int i = 0; i < meta_increment.deleted_regions_size(); i++) {
+    const auto& deleted_region = meta_increment.deleted_regions(i);
+    if (deleted_region.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      deleted_region_map_.erase(deleted_region.id());
+      dead_range_reclaimed_stores_.erase(deleted_region.id());
     }
   }
-  // write update to local engine, end
+
+  if (dead_range_changed) {
+    id_epoch_map_[pb::coordinator_internal::IdEpochType::EPOCH_DEAD_RANGE].CopyFrom(dead_range_epoch);
+  }
+
+  for (int i = 0; i < meta_increment.tables_size(); i++) {
+    const auto& table = meta_increment.tables(i);
+    if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+        table.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+      table_map_[table.id()].CopyFrom(table.table());
+    } else if (table.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
+      table_map_.erase(table.id());
+    }
+  }
+
+  // a parent schema deleted by the same increment stays deleted
+  for (auto& [schema_id, parent_schema] : parent_schemas) {
+    auto it = schema_map_.find(schema_id);
+    if (it != schema_map_.end()) {
+      it->second = std::move(parent_schema);
+    }
+  }
+
+  return 0;
 }
 
 }  // namespace dingodb
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <shared_mutex>
 #include <string>
 #include <vector>
@@ -152,6 +153,8 @@ class CoordinatorControl : public MetaControl {
   static void GenerateRootSchemas(pb::coordinator_internal::SchemaInternal &root_schema,
                                   pb::coordinator_internal::SchemaInternal &meta_schema,
                                   pb::coordinator_internal::SchemaInternal &dingo_schema);
+  // value columns of ENG_COLUMNAR table
+  static std::vector<pb::common::ColumnSchema> GenColumnSchemas(const pb::meta::TableDefinition &table_definition);
   // static void GenerateRootSchemasMetaIncrement(pb::coordinator_internal::SchemaInternal &root_schema,
   //                                              pb::coordinator_internal::SchemaInternal &meta_schema,
   //                                              pb::coordinator_internal::SchemaInternal &dingo_schema,
@@ -164,11 +167,12 @@ class CoordinatorControl : public MetaControl {
   void GetLeaderLocation(pb::common::Location &leader_location) override;
 
   // create region
-  // in: resource_tag
+  // in: resource_tag, ttl of table in seconds, engine and value columns of table
   // out: new region id
   int CreateRegion(const std::string &region_name, const std::string &resource_tag, int32_t replica_num,
-                   pb::common::Range region_range, uint64_t schema_id, uint64_t table_id, uint64_t &new_region_id,
-                   pb::coordinator_internal::MetaIncrement &meta_increment) override;
+                   pb::common::Range region_range, uint64_t schema_id, uint64_t table_id, uint64_t ttl,
+                   pb::common::Engine engine, const std::vector<pb::common::ColumnSchema> &columns,
+                   uint64_t &new_region_id, pb::coordinator_internal::MetaIncrement &meta_increment) override;
 
   // drop region
   // in:  region_id
@@ -214,6 +218,21 @@ class CoordinatorControl : public MetaControl {
   // get regionmap
   void GetRegionMap(pb::common::RegionMap &region_map) override;
 
+  // record dead ranges reclaimed by store, drop dead ranges reclaimed by all normal stores or reused by live region
+  void UpdateDeadRanges(uint64_t store_id, const std::vector<uint64_t> &reclaimed_ids,
+                        pb::coordinator_internal::MetaIncrement &meta_increment);
+
+  // replace region flow of store by its heartbeat, metrics of region not in region map are ignored
+  void UpdateRegionMetrics(uint64_t store_id, const std::vector<pb::common::RegionMetrics> &region_metrics);
+
+  // get region flow summed over stores, for find hot region
+  void GetRegionMetrics(std::vector<pb::common::RegionMetrics> &region_metrics);
+
+  // get key ranges of deleted regions only if changed since self_epoch
+  // return: present dead range epoch
+  uint64_t GetDeadRanges(uint64_t self_epoch,
+                         google::protobuf::RepeatedPtrField<pb::coordinator::DeadRange> &dead_ranges);
+
   // get schemas
   void GetSchemas(uint64_t schema_id, std::vector<pb::meta::Schema> &schemas) override;
 
@@ -239,12 +258,24 @@ class CoordinatorControl : public MetaControl {
 
   // on_apply callback
   // leader do need update next_xx_id, so leader call this function with update_ids=false
-  void ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement &meta_increment, bool update_ids) override;
+  int ApplyMetaIncrement(pb::coordinator_internal::MetaIncrement &meta_increment, bool update_ids) override;
 
   // get next id/epoch
   uint64_t GetNextId(const pb::coordinator_internal::IdEpochType &key,
                      pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // clear leased id blocks, called on leader change
+  void ResetIdLeases();
+
+  // generate count timestamps, the first one is set to start_timestamp
+  // if the timestamps are not covered by committed tso window, a window update is added to meta_increment,
+  // and the response must be sent after meta_increment is committed by raft
+  int GenTso(uint64_t count, pb::coordinator::TsoTimestamp &start_timestamp,
+             pb::coordinator_internal::MetaIncrement &meta_increment);
+
+  // physical time is covered by committed tso window or not
+  bool IsTsoCommitted(int64_t physical);
+
   // get present id/epoch
   uint64_t GetPresentId(const pb::coordinator_internal::IdEpochType &key);
 
@@ -278,6 +309,15 @@ class CoordinatorControl : public MetaControl {
   std::map<uint64_t, pb::common::Region> region_map_;
   MetaMapStorage<pb::common::Region> *region_meta_;
 
+  // deleted regions, stores reclaim data in their ranges
+  std::map<uint64_t, pb::common::Region> deleted_region_map_;
+  MetaMapStorage<pb::common::Region> *deleted_region_meta_;
+  // deleted region id -> stores reclaimed it, not persisted, stores report again after leader change
+  std::map<uint64_t, std::set<uint64_t>> dead_range_reclaimed_stores_;
+
+  // region id -> store id -> region flow on that store, not persisted, refreshed by every store heartbeat
+  std::map<uint64_t, std::map<uint64_t, pb::common::RegionMetrics>> region_metrics_map_;
+
   // tables
   // TableInternal is combination of Table & TableDefinition
   std::map<uint64_t, pb::coordinator_internal::TableInternal> table_map_;
@@ -288,6 +328,27 @@ class CoordinatorControl : public MetaControl {
   std::map<uint64_t, pb::coordinator_internal::IdEpochInternal> id_epoch_map_;
   MetaMapStorage<pb::coordinator_internal::IdEpochInternal> *id_epoch_meta_;
 
+  // leased id blocks of leader, only live in memory
+  // id_epoch_map_ holds the high-water mark, ids in (next_id, end_id] can be allocated without raft
+  // once an increment carrying end_id is applied, before that each increment using the block carries end_id
+  struct IdLease {
+    uint64_t next_id;
+    uint64_t end_id;
+    bool persisted;
+  };
+  std::map<uint64_t, IdLease> id_lease_map_;
+
+  // timestamp oracle, protected by tso_mutex_ instead of control_mutex_
+  void ResetTso();
+  void UpdateTsoWindow(int64_t window_end);
+  bthread_mutex_t tso_mutex_;
+  int64_t tso_physical_;
+  int64_t tso_logical_;
+  // committed upper bound of physical time, timestamps below it can be returned directly
+  int64_t tso_saved_end_;
+  // requested upper bound of physical time, maybe not committed
+  int64_t tso_pending_end_;
+
   // root schema write to raft
   bool root_schema_writed_to_raft_;
 
@@ -25,6 +25,7 @@
 #include "butil/strings/stringprintf.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
+#include "proto/meta.pb.h"
 
 namespace dingodb {
 
@@ -42,21 +43,33 @@ class CoordinatorInteraction {
   void NextLeader(int leader_index);
 
   template <typename Request, typename Response>
-  butil::Status SendRequest(const std::string& api_name, const Request& request, Response& response);
+  butil::Status SendRequest(const std::string& api_name, const Request& request, Response& response) {
+    return SendRequest(pb::coordinator::CoordinatorService::descriptor(), api_name, request, response);
+  }
+
+  // Meta service is served by coordinator too.
+  template <typename Request, typename Response>
+  butil::Status SendMetaRequest(const std::string& api_name, const Request& request, Response& response) {
+    return SendRequest(pb::meta::MetaService::descriptor(), api_name, request, response);
+  }
 
   CoordinatorInteraction(const CoordinatorInteraction&) = delete;
   const CoordinatorInteraction& operator=(const CoordinatorInteraction&) = delete;
 
  private:
+  template <typename Request, typename Response>
+  butil::Status SendRequest(const ::google::protobuf::ServiceDescriptor* service_desc, const std::string& api_name,
+                            const Request& request, Response& response);
+
   std::atomic<int> leader_index_;
   std::vector<butil::EndPoint> endpoints_;
   std::vector<std::unique_ptr<brpc::Channel> > channels_;
 };
 
 template <typename Request, typename Response>
-butil::Status CoordinatorInteraction::SendRequest(const std::string& api_name, const Request& request,
+butil::Status CoordinatorInteraction::SendRequest(const ::google::protobuf::ServiceDescriptor* service_desc,
+                                                  const std::string& api_name, const Request& request,
                                                   Response& response) {
-  const ::google::protobuf::ServiceDescriptor* service_desc = pb::coordinator::CoordinatorService::descriptor();
   const ::google::protobuf::MethodDescriptor* method = service_desc->FindMethodByName(api_name);
 
   LOG(INFO) << "send request to coordinator api " << api_name;
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/tso_client.h"
+
+#include "common/constant.h"
+#include "proto/coordinator.pb.h"
+
+namespace dingodb {
+
+TsoClient::TsoClient(std::shared_ptr<CoordinatorInteraction> coordinator_interaction)
+    : coordinator_interaction_(coordinator_interaction), fetching_(false) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+}
+
+TsoClient::~TsoClient() {
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+uint64_t TsoClient::ComposeTs(int64_t physical, int64_t logical) {
+  return (static_cast<uint64_t>(physical) << Constant::kTsoLogicalBits) + static_cast<uint64_t>(logical);
+}
+
+int64_t TsoClient::ExtractPhysical(uint64_t timestamp) {
+  return static_cast<int64_t>(timestamp >> Constant::kTsoLogicalBits);
+}
+
+void TsoClient::FetchBatch(std::shared_ptr<TsoBatch> batch) {
+  pb::coordinator::TsoRequest request;
+  pb::coordinator::TsoResponse response;
+  request.set_count(batch->count);
+
+  batch->status = coordinator_interaction_->SendRequest("Tso", request, response);
+  if (!batch->status.ok()) {
+    LOG(ERROR) << "Fetch tso failed, count: " << batch->count << " errcode: " << batch->status.error_code() << " "
+               << batch->status.error_str();
+    return;
+  }
+
+  batch->start_timestamp = ComposeTs(response.start_timestamp().physical(), response.start_timestamp().logical());
+}
+
+butil::Status TsoClient::GetTimestamp(uint64_t& timestamp) {
+  bthread_mutex_lock(&mutex_);
+  if (pending_batch_ == nullptr || pending_batch_->count + 1 >= static_cast<uint64_t>(Constant::kTsoMaxLogical)) {
+    pending_batch_ = std::make_shared<TsoBatch>();
+  }
+  auto batch = pending_batch_;
+  uint64_t index = batch->count++;
+
+  while (!batch->done) {
+    if (fetching_) {
+      bthread_cond_wait(&cond_, &mutex_);
+      continue;
+    }
+
+    // Become the fetcher of own batch, later callers join a new batch.
+    fetching_ = true;
+    auto sending_batch = batch;
+    if (pending_batch_ == batch) {
+      pending_batch_ = nullptr;
+    }
+    bthread_mutex_unlock(&mutex_);
+
+    FetchBatch(sending_batch);
+
+    bthread_mutex_lock(&mutex_);
+    sending_batch->done = true;
+    fetching_ = false;
+    bthread_cond_broadcast(&cond_);
+  }
+  bthread_mutex_unlock(&mutex_);
+
+  if (!batch->status.ok()) {
+    return batch->status;
+  }
+
+  // Logical part of one batch never overflow, so timestamps of the batch are continuous.
+  timestamp = batch->start_timestamp + index;
+  return butil::Status();
+}
+
+}  // namespace dingodb
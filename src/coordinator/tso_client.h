@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_TSO_CLIENT_H_
+#define DINGODB_COORDINATOR_TSO_CLIENT_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "bthread/bthread.h"
+#include "butil/status.h"
+#include "coordinator/coordinator_interaction.h"
+
+namespace dingodb {
+
+// Fetch timestamps from coordinator tso.
+// Concurrent callers are merged into one batch, one rpc serves the whole batch.
+class TsoClient {
+ public:
+  TsoClient(std::shared_ptr<CoordinatorInteraction> coordinator_interaction);
+  ~TsoClient();
+
+  // Compose hybrid timestamp to uint64, (physical << kTsoLogicalBits) + logical
+  static uint64_t ComposeTs(int64_t physical, int64_t logical);
+  static int64_t ExtractPhysical(uint64_t timestamp);
+
+  butil::Status GetTimestamp(uint64_t& timestamp);
+
+  TsoClient(const TsoClient&) = delete;
+  const TsoClient& operator=(const TsoClient&) = delete;
+
+ private:
+  struct TsoBatch {
+    uint64_t count = 0;
+    bool done = false;
+    butil::Status status;
+    uint64_t start_timestamp = 0;
+  };
+
+  void FetchBatch(std::shared_ptr<TsoBatch> batch);
+
+  std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  // There is a caller sending rpc for one batch.
+  bool fetching_;
+  // Callers arriving while fetching join this batch.
+  std::shared_ptr<TsoBatch> pending_batch_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_TSO_CLIENT_H_
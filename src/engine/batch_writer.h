@@ -0,0 +1,204 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_BATCH_WRITER_H_
+#define DINGODB_ENGINE_BATCH_WRITER_H_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "butil/strings/stringprintf.h"
+#include "engine/raw_engine.h"
+#include "glog/logging.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+// Writer of raw engines on a store with a locking write batch, e.g. MemTable, ColumnStore and XdpStore.
+// Store::WriteBatch holds the store lock during its lifetime and reads its own writes,
+// so check and write of put if absent and compare and set are atomic.
+// Commit() return false if nothing is written.
+template <typename Store>
+class BatchWriter : public RawEngine::Writer {
+ public:
+  using WriteBatch = typename Store::WriteBatch;
+
+  BatchWriter(std::shared_ptr<Store> store) : store_(store) {}
+  ~BatchWriter() override = default;
+
+  butil::Status KvPut(const pb::common::KeyValue& kv) override {
+    if (kv.key().empty()) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    batch.Put(kv.key(), kv.value());
+    return Commit(batch);
+  }
+
+  butil::Status KvBatchPut(const std::vector<pb::common::KeyValue>& kvs) override {
+    if (kvs.empty() || HasEmptyKey(kvs)) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    for (const auto& kv : kvs) {
+      batch.Put(kv.key(), kv.value());
+    }
+    return Commit(batch);
+  }
+
+  butil::Status KvBatchPutAndDelete(const std::vector<pb::common::KeyValue>& kv_puts,
+                                    const std::vector<pb::common::KeyValue>& kv_deletes) override {
+    if ((kv_puts.empty() && kv_deletes.empty()) || HasEmptyKey(kv_puts) || HasEmptyKey(kv_deletes)) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    for (const auto& kv : kv_puts) {
+      batch.Put(kv.key(), kv.value());
+    }
+    for (const auto& kv : kv_deletes) {
+      batch.Delete(kv.key());
+    }
+    return Commit(batch);
+  }
+
+  butil::Status KvPutIfAbsent(const pb::common::KeyValue& kv) override {
+    if (kv.key().empty()) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    std::string old_value;
+    if (batch.Get(kv.key(), old_value)) {
+      return butil::Status(pb::error::EKEY_EXIST, "Key exist");
+    }
+    batch.Put(kv.key(), kv.value());
+    return Commit(batch);
+  }
+
+  // Check and write in one batch, atomic put nothing if any key exists.
+  butil::Status KvBatchPutIfAbsent(const std::vector<pb::common::KeyValue>& kvs, std::vector<std::string>& put_keys,
+                                   bool is_atomic) override {
+    if (kvs.empty() || HasEmptyKey(kvs)) {
+      LOG(ERROR) << butil::StringPrintf("empty key not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    std::string old_value;
+    if (is_atomic) {
+      std::set<std::string> keys;
+      for (const auto& kv : kvs) {
+        if (!keys.insert(kv.key()).second || batch.Get(kv.key(), old_value)) {
+          put_keys.clear();
+          return butil::Status(pb::error::EKEY_EXIST, "Key exist");
+        }
+      }
+    }
+
+    for (const auto& kv : kvs) {
+      if (!is_atomic && batch.Get(kv.key(), old_value)) {
+        continue;
+      }
+      batch.Put(kv.key(), kv.value());
+      put_keys.push_back(kv.key());
+    }
+    auto status = Commit(batch);
+    if (!status.ok()) {
+      put_keys.clear();
+    }
+    return status;
+  }
+
+  // Empty expected value also match absent key.
+  butil::Status KvCompareAndSet(const pb::common::KeyValue& kv, const std::string& value) override {
+    if (kv.key().empty()) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    std::string old_value;
+    bool found = batch.Get(kv.key(), old_value);
+    if (!found && !kv.value().empty()) {
+      return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+    }
+    if (kv.value() != old_value) {
+      LOG(WARNING) << butil::StringPrintf("compare and set value is not equal");
+      return butil::Status(pb::error::EINTERNAL, "Value is not equal");
+    }
+
+    batch.Put(kv.key(), value);
+    return Commit(batch);
+  }
+
+  butil::Status KvDelete(const std::string& key) override {
+    if (key.empty()) {
+      LOG(ERROR) << butil::StringPrintf("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    batch.Delete(key);
+    return Commit(batch);
+  }
+
+  butil::Status KvDeleteRange(const pb::common::Range& range) override {
+    if (range.start_key().empty()) {
+      LOG(ERROR) << butil::StringPrintf("begin_key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    if (range.end_key().empty()) {
+      LOG(ERROR) << butil::StringPrintf("end_key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+
+    WriteBatch batch(store_.get());
+    batch.DeleteRange(range.start_key(), range.end_key());
+    return Commit(batch);
+  }
+
+ private:
+  static bool HasEmptyKey(const std::vector<pb::common::KeyValue>& kvs) {
+    for (const auto& kv : kvs) {
+      if (kv.key().empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static butil::Status Commit(WriteBatch& batch) {
+    if (!batch.Commit()) {
+      return butil::Status(pb::error::EINTERNAL, "Commit write batch failed");
+    }
+    return butil::Status();
+  }
+
+  std::shared_ptr<Store> store_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_BATCH_WRITER_H_
@@ -0,0 +1,581 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/column_chunk.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dingodb {
+
+static const size_t kInt64Size = 8;
+
+static void PutVarint64(std::string& buf, uint64_t value) {
+  while (value >= 0x80) {
+    buf.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<char>(value));
+}
+
+// Only accept the shortest encoding, so decoded value encodes back to the same bytes.
+static bool GetVarint64(const char*& p, const char* limit, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift <= 63 && p < limit; shift += 7) {
+    uint64_t byte = static_cast<unsigned char>(*p++);
+    value |= (byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return byte != 0 || shift == 0;
+    }
+  }
+  return false;
+}
+
+static uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static void PutBytes(std::string& buf, const std::string_view& value) {
+  PutVarint64(buf, value.size());
+  buf.append(value.data(), value.size());
+}
+
+static std::string_view GetBytes(const char*& p, const char* limit) {
+  uint64_t size = 0;
+  if (!GetVarint64(p, limit, size) || size > static_cast<uint64_t>(limit - p)) {
+    p = limit;
+    return std::string_view();
+  }
+  std::string_view value(p, size);
+  p += size;
+  return value;
+}
+
+static bool MatchBytes(const std::string& value, const ColumnPredicate& predicate) {
+  return value >= predicate.bytes_min && (predicate.bytes_max.empty() || value <= predicate.bytes_max);
+}
+
+std::string ColumnarRow::Encode(const ColumnarSchema& schema, const std::vector<ColumnValue>& row) {
+  std::string buf;
+  for (size_t i = 0; i < schema.size(); ++i) {
+    if (i >= row.size() || row[i].is_null) {
+      buf.push_back(0);
+      continue;
+    }
+
+    buf.push_back(1);
+    if (schema[i].type() == pb::common::COLUMN_TYPE_INT64) {
+      uint64_t value = static_cast<uint64_t>(row[i].int_value);
+      for (int j = kInt64Size - 1; j >= 0; --j) {
+        buf.push_back(static_cast<char>((value >> (j * 8)) & 0xFF));
+      }
+    } else {
+      PutBytes(buf, row[i].bytes_value);
+    }
+  }
+  return buf;
+}
+
+bool ColumnarRow::Decode(const ColumnarSchema& schema, const std::string_view& value, std::vector<ColumnValue>& row) {
+  row.resize(schema.size());
+  const char* p = value.data();
+  const char* limit = value.data() + value.size();
+  for (size_t i = 0; i < schema.size(); ++i) {
+    if (p >= limit || static_cast<unsigned char>(*p) > 1) {
+      return false;
+    }
+    row[i].is_null = (*p++ == 0);
+    row[i].int_value = 0;
+    row[i].bytes_value.clear();
+    if (row[i].is_null) {
+      continue;
+    }
+
+    if (schema[i].type() == pb::common::COLUMN_TYPE_INT64) {
+      if (static_cast<size_t>(limit - p) < kInt64Size) {
+        return false;
+      }
+      uint64_t int_value = 0;
+      for (size_t j = 0; j < kInt64Size; ++j) {
+        int_value = (int_value << 8) | static_cast<unsigned char>(*p++);
+      }
+      row[i].int_value = static_cast<int64_t>(int_value);
+    } else {
+      uint64_t size = 0;
+      if (!GetVarint64(p, limit, size) || size > static_cast<uint64_t>(limit - p)) {
+        return false;
+      }
+      row[i].bytes_value.assign(p, size);
+      p += size;
+    }
+  }
+  return p == limit;
+}
+
+void ColumnVector::Clear() {
+  ints.clear();
+  bytes.clear();
+  nulls.clear();
+}
+
+void ColumnVector::Append(const ColumnValue& value) {
+  nulls.push_back(value.is_null ? 1 : 0);
+  if (type == pb::common::COLUMN_TYPE_INT64) {
+    ints.push_back(value.is_null ? 0 : value.int_value);
+  } else {
+    bytes.push_back(value.is_null ? std::string() : value.bytes_value);
+  }
+}
+
+void ColumnVector::Append(const ColumnVector& other, size_t i) {
+  nulls.push_back(other.nulls[i]);
+  if (type == pb::common::COLUMN_TYPE_INT64) {
+    ints.push_back(other.ints[i]);
+  } else {
+    bytes.push_back(other.bytes[i]);
+  }
+}
+
+ColumnValue ColumnVector::Get(size_t i) const {
+  ColumnValue value;
+  value.is_null = IsNull(i);
+  if (type == pb::common::COLUMN_TYPE_INT64) {
+    value.int_value = ints[i];
+  } else {
+    value.bytes_value = bytes[i];
+  }
+  return value;
+}
+
+bool ColumnVector::Match(size_t i, const ColumnPredicate& predicate) const {
+  if (IsNull(i)) {
+    return false;
+  }
+  if (type == pb::common::COLUMN_TYPE_INT64) {
+    return ints[i] >= predicate.int_min && ints[i] <= predicate.int_max;
+  }
+  return MatchBytes(bytes[i], predicate);
+}
+
+std::shared_ptr<const ColumnChunk> ColumnChunk::Build(const ColumnVector& values) {
+  auto chunk = std::shared_ptr<ColumnChunk>(new ColumnChunk());
+  chunk->type_ = values.type;
+  chunk->row_count_ = values.Size();
+  if (std::find(values.nulls.begin(), values.nulls.end(), 1) != values.nulls.end()) {
+    chunk->nulls_ = values.nulls;
+  }
+
+  for (size_t i = 0; i < values.Size(); ++i) {
+    if (values.IsNull(i)) {
+      continue;
+    }
+    if (chunk->type_ == pb::common::COLUMN_TYPE_INT64) {
+      chunk->int_min_ = chunk->has_value_ ? std::min(chunk->int_min_, values.ints[i]) : values.ints[i];
+      chunk->int_max_ = chunk->has_value_ ? std::max(chunk->int_max_, values.ints[i]) : values.ints[i];
+    } else if (!chunk->has_value_) {
+      chunk->bytes_min_ = values.bytes[i];
+      chunk->bytes_max_ = values.bytes[i];
+    } else if (values.bytes[i] < chunk->bytes_min_) {
+      chunk->bytes_min_ = values.bytes[i];
+    } else if (values.bytes[i] > chunk->bytes_max_) {
+      chunk->bytes_max_ = values.bytes[i];
+    }
+    chunk->has_value_ = true;
+  }
+
+  // Keep the smallest encoding, plain wins a tie for cheaper decoding.
+  std::vector<Encoding> encodings;
+  if (chunk->type_ == pb::common::COLUMN_TYPE_INT64) {
+    encodings = {Encoding::kPlain, Encoding::kDelta, Encoding::kRle};
+  } else {
+    encodings = {Encoding::kPlain, Encoding::kDelta, Encoding::kDictionary, Encoding::kRle};
+  }
+  for (auto encoding : encodings) {
+    std::string data = chunk->type_ == pb::common::COLUMN_TYPE_INT64 ? EncodeInts(values.ints, encoding)
+                                                                      : EncodeBytes(values.bytes, encoding);
+    if (encoding == Encoding::kPlain || data.size() < chunk->data_.size()) {
+      chunk->data_ = std::move(data);
+      chunk->encoding_ = encoding;
+    }
+  }
+
+  return chunk;
+}
+
+std::string ColumnChunk::EncodeInts(const std::vector<int64_t>& values, Encoding encoding) {
+  std::string buf;
+  switch (encoding) {
+    case Encoding::kPlain:
+      buf.resize(values.size() * kInt64Size);
+      if (!values.empty()) {
+        memcpy(buf.data(), values.data(), buf.size());
+      }
+      break;
+    case Encoding::kDelta: {
+      uint64_t prev = 0;
+      for (auto value : values) {
+        PutVarint64(buf, ZigZagEncode(static_cast<int64_t>(static_cast<uint64_t>(value) - prev)));
+        prev = static_cast<uint64_t>(value);
+      }
+      break;
+    }
+    case Encoding::kRle:
+      for (size_t i = 0, j = 0; i < values.size(); i = j) {
+        for (j = i + 1; j < values.size() && values[j] == values[i]; ++j) {
+        }
+        PutVarint64(buf, ZigZagEncode(values[i]));
+        PutVarint64(buf, j - i);
+      }
+      break;
+    default:
+      break;
+  }
+  return buf;
+}
+
+std::string ColumnChunk::EncodeBytes(const std::vector<std::string>& values, Encoding encoding) {
+  std::string buf;
+  switch (encoding) {
+    case Encoding::kPlain:
+      for (const auto& value : values) {
+        PutBytes(buf, value);
+      }
+      break;
+    case Encoding::kDictionary: {
+      // Sorted dictionary, order of codes is the order of values.
+      std::map<std::string_view, uint64_t> dictionary;
+      for (const auto& value : values) {
+        dictionary.emplace(value, 0);
+      }
+      PutVarint64(buf, dictionary.size());
+      uint64_t code = 0;
+      for (auto& [value, value_code] : dictionary) {
+        PutBytes(buf, value);
+        value_code = code++;
+      }
+      for (const auto& value : values) {
+        PutVarint64(buf, dictionary[value]);
+      }
+      break;
+    }
+    case Encoding::kRle:
+      for (size_t i = 0, j = 0; i < values.size(); i = j) {
+        for (j = i + 1; j < values.size() && values[j] == values[i]; ++j) {
+        }
+        PutBytes(buf, values[i]);
+        PutVarint64(buf, j - i);
+      }
+      break;
+    case Encoding::kDelta: {
+      std::string_view prev;
+      for (const auto& value : values) {
+        size_t shared = 0;
+        size_t max_shared = std::min(prev.size(), value.size());
+        while (shared < max_shared && prev[shared] == value[shared]) {
+          ++shared;
+        }
+        PutVarint64(buf, shared);
+        PutBytes(buf, std::string_view(value).substr(shared));
+        prev = value;
+      }
+      break;
+    }
+  }
+  return buf;
+}
+
+void ColumnChunk::DecodeInts(std::vector<int64_t>& values) const {
+  values.resize(row_count_);
+  const char* p = data_.data();
+  const char* limit = data_.data() + data_.size();
+  uint64_t raw = 0;
+  switch (encoding_) {
+    case Encoding::kPlain:
+      if (row_count_ > 0) {
+        memcpy(values.data(), data_.data(), row_count_ * kInt64Size);
+      }
+      break;
+    case Encoding::kDelta: {
+      uint64_t prev = 0;
+      for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, raw); ++i) {
+        prev += static_cast<uint64_t>(ZigZagDecode(raw));
+        values[i] = static_cast<int64_t>(prev);
+      }
+      break;
+    }
+    case Encoding::kRle:
+      for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, raw);) {
+        int64_t value = ZigZagDecode(raw);
+        uint64_t run = 0;
+        GetVarint64(p, limit, run);
+        size_t end = std::min(row_count_, i + static_cast<size_t>(run));
+        std::fill(values.begin() + i, values.begin() + end, value);
+        i = end;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void ColumnChunk::DecodeBytes(std::vector<std::string>& values) const {
+  values.assign(row_count_, std::string());
+  const char* p = data_.data();
+  const char* limit = data_.data() + data_.size();
+  switch (encoding_) {
+    case Encoding::kPlain:
+      for (size_t i = 0; i < row_count_; ++i) {
+        values[i] = GetBytes(p, limit);
+      }
+      break;
+    case Encoding::kDictionary: {
+      uint64_t size = 0;
+      GetVarint64(p, limit, size);
+      std::vector<std::string_view> dictionary(size);
+      for (auto& value : dictionary) {
+        value = GetBytes(p, limit);
+      }
+      uint64_t code = 0;
+      for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, code); ++i) {
+        values[i] = code < dictionary.size() ? dictionary[code] : std::string_view();
+      }
+      break;
+    }
+    case Encoding::kRle:
+      for (size_t i = 0; i < row_count_ && p < limit;) {
+        std::string_view value = GetBytes(p, limit);
+        uint64_t run = 0;
+        GetVarint64(p, limit, run);
+        size_t end = std::min(row_count_, i + static_cast<size_t>(run));
+        for (; i < end; ++i) {
+          values[i] = value;
+        }
+      }
+      break;
+    case Encoding::kDelta: {
+      uint64_t shared = 0;
+      for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, shared); ++i) {
+        std::string_view suffix = GetBytes(p, limit);
+        if (i > 0) {
+          values[i].assign(values[i - 1], 0, shared);
+        }
+        values[i].append(suffix.data(), suffix.size());
+      }
+      break;
+    }
+  }
+}
+
+void ColumnChunk::Decode(ColumnVector& values) const {
+  values.Clear();
+  values.type = type_;
+  if (nulls_.empty()) {
+    values.nulls.assign(row_count_, 0);
+  } else {
+    values.nulls = nulls_;
+  }
+
+  if (type_ == pb::common::COLUMN_TYPE_INT64) {
+    DecodeInts(values.ints);
+  } else {
+    DecodeBytes(values.bytes);
+  }
+}
+
+bool ColumnChunk::MayMatch(const ColumnPredicate& predicate) const {
+  if (!has_value_) {
+    return false;
+  }
+  if (type_ == pb::common::COLUMN_TYPE_INT64) {
+    return int_max_ >= predicate.int_min && int_min_ <= predicate.int_max;
+  }
+  return bytes_max_ >= predicate.bytes_min && (predicate.bytes_max.empty() || bytes_min_ <= predicate.bytes_max);
+}
+
+void ColumnChunk::ApplyNulls(std::vector<uint8_t>& selection) const {
+  for (size_t i = 0; i < nulls_.size(); ++i) {
+    selection[i] &= static_cast<uint8_t>(nulls_[i] ^ 1);
+  }
+}
+
+void ColumnChunk::Filter(const ColumnPredicate& predicate, std::vector<uint8_t>& selection) const {
+  selection.resize(row_count_, 1);
+  if (!MayMatch(predicate)) {
+    std::fill(selection.begin(), selection.end(), 0);
+    return;
+  }
+
+  const char* p = data_.data();
+  const char* limit = data_.data() + data_.size();
+  if (type_ == pb::common::COLUMN_TYPE_INT64 && encoding_ == Encoding::kRle) {
+    uint64_t raw = 0;
+    for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, raw);) {
+      int64_t value = ZigZagDecode(raw);
+      uint64_t run = 0;
+      GetVarint64(p, limit, run);
+      size_t end = std::min(row_count_, i + static_cast<size_t>(run));
+      if (value < predicate.int_min || value > predicate.int_max) {
+        std::fill(selection.begin() + i, selection.begin() + end, 0);
+      }
+      i = end;
+    }
+  } else if (type_ == pb::common::COLUMN_TYPE_INT64) {
+    std::vector<int64_t> values;
+    DecodeInts(values);
+    // Branch free, compiler vectorize it.
+    const int64_t min = predicate.int_min;
+    const int64_t max = predicate.int_max;
+    for (size_t i = 0; i < row_count_; ++i) {
+      selection[i] &= static_cast<uint8_t>((values[i] >= min) & (values[i] <= max));
+    }
+  } else if (encoding_ == Encoding::kDictionary) {
+    uint64_t size = 0;
+    GetVarint64(p, limit, size);
+    std::vector<uint8_t> matches(size);
+    for (auto& match : matches) {
+      match = MatchBytes(std::string(GetBytes(p, limit)), predicate) ? 1 : 0;
+    }
+    uint64_t code = 0;
+    for (size_t i = 0; i < row_count_ && GetVarint64(p, limit, code); ++i) {
+      selection[i] &= code < matches.size() ? matches[code] : 0;
+    }
+  } else if (encoding_ == Encoding::kRle) {
+    for (size_t i = 0; i < row_count_ && p < limit;) {
+      bool match = MatchBytes(std::string(GetBytes(p, limit)), predicate);
+      uint64_t run = 0;
+      GetVarint64(p, limit, run);
+      size_t end = std::min(row_count_, i + static_cast<size_t>(run));
+      if (!match) {
+        std::fill(selection.begin() + i, selection.begin() + end, 0);
+      }
+      i = end;
+    }
+  } else {
+    std::vector<std::string> values;
+    DecodeBytes(values);
+    for (size_t i = 0; i < row_count_; ++i) {
+      selection[i] &= MatchBytes(values[i], predicate) ? 1 : 0;
+    }
+  }
+
+  ApplyNulls(selection);
+}
+
+std::shared_ptr<const RowGroup> RowGroup::Build(std::shared_ptr<const ColumnarSchema> schema,
+                                                const std::vector<pb::common::KeyValue>& rows) {
+  auto group = std::shared_ptr<RowGroup>(new RowGroup());
+  group->row_count_ = rows.size();
+
+  ColumnVector keys;
+  for (const auto& row : rows) {
+    keys.nulls.push_back(0);
+    keys.bytes.push_back(row.key());
+  }
+  group->key_chunk_ = ColumnChunk::Build(keys);
+
+  // Split into columns only if every value is of schema layout.
+  std::vector<ColumnVector> columns;
+  if (schema != nullptr && !schema->empty()) {
+    columns.resize(schema->size());
+    for (size_t i = 0; i < schema->size(); ++i) {
+      columns[i].type = schema->at(i).type();
+    }
+
+    std::vector<ColumnValue> values;
+    for (const auto& row : rows) {
+      if (!ColumnarRow::Decode(*schema, row.value(), values)) {
+        columns.clear();
+        break;
+      }
+      for (size_t i = 0; i < values.size(); ++i) {
+        columns[i].Append(values[i]);
+      }
+    }
+  }
+
+  if (!columns.empty()) {
+    group->schema_ = schema;
+  } else {
+    columns.resize(1);
+    for (const auto& row : rows) {
+      columns[0].nulls.push_back(0);
+      columns[0].bytes.push_back(row.value());
+    }
+  }
+
+  for (const auto& column : columns) {
+    group->columns_.push_back(ColumnChunk::Build(column));
+  }
+  return group;
+}
+
+size_t RowGroup::ByteSize() const {
+  size_t size = key_chunk_->ByteSize();
+  for (const auto& column : columns_) {
+    size += column->ByteSize();
+  }
+  return size;
+}
+
+void RowGroup::DecodeKeys(std::vector<std::string>& keys) const {
+  ColumnVector values;
+  key_chunk_->Decode(values);
+  keys = std::move(values.bytes);
+}
+
+void RowGroup::DecodeRows(std::vector<pb::common::KeyValue>& rows) const {
+  std::vector<std::string> keys;
+  DecodeKeys(keys);
+
+  std::vector<ColumnVector> columns(columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    columns_[i]->Decode(columns[i]);
+  }
+
+  rows.resize(row_count_);
+  std::vector<ColumnValue> values(columns.size());
+  for (size_t i = 0; i < row_count_; ++i) {
+    rows[i].set_key(std::move(keys[i]));
+    if (IsRaw()) {
+      rows[i].set_value(std::move(columns[0].bytes[i]));
+      continue;
+    }
+    for (size_t j = 0; j < columns.size(); ++j) {
+      values[j] = columns[j].Get(i);
+    }
+    rows[i].set_value(ColumnarRow::Encode(*schema_, values));
+  }
+}
+
+void RowGroup::DecodeValue(size_t index, std::string& value) const {
+  std::vector<ColumnValue> values(columns_.size());
+  ColumnVector column;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    columns_[i]->Decode(column);
+    values[i] = column.Get(index);
+  }
+  value = IsRaw() ? values[0].bytes_value : ColumnarRow::Encode(*schema_, values);
+}
+
+}  // namespace dingodb
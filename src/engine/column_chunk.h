@@ -0,0 +1,164 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_COLUMN_CHUNK_H_
+#define DINGODB_ENGINE_COLUMN_CHUNK_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+using ColumnarSchema = std::vector<pb::common::ColumnSchema>;
+
+// One column of a row, int_value for COLUMN_TYPE_INT64 and bytes_value for COLUMN_TYPE_BYTES.
+struct ColumnValue {
+  bool is_null = true;
+  int64_t int_value = 0;
+  std::string bytes_value;
+};
+
+// Value layout of ENG_COLUMNAR table, columns in schema order, every column is
+// flag(1 byte, 0 is null, 1 is not null) + int64(8 bytes big endian) or bytes(varint32 length + data).
+class ColumnarRow {
+ public:
+  static std::string Encode(const ColumnarSchema& schema, const std::vector<ColumnValue>& row);
+  // Return false if value is not of schema layout.
+  static bool Decode(const ColumnarSchema& schema, const std::string_view& value, std::vector<ColumnValue>& row);
+};
+
+// Closed range predicate on one column, null never match.
+struct ColumnPredicate {
+  uint32_t column = 0;
+  int64_t int_min = std::numeric_limits<int64_t>::min();
+  int64_t int_max = std::numeric_limits<int64_t>::max();
+  std::string bytes_min;
+  std::string bytes_max;  // empty is unbounded
+};
+
+// Decoded values of one column, null slot holds 0 or empty bytes.
+struct ColumnVector {
+  pb::common::ColumnType type = pb::common::COLUMN_TYPE_BYTES;
+  std::vector<int64_t> ints;
+  std::vector<std::string> bytes;
+  std::vector<uint8_t> nulls;  // 1 is null
+
+  size_t Size() const { return nulls.size(); }
+  bool IsNull(size_t i) const { return nulls[i] != 0; }
+
+  void Clear();
+  void Append(const ColumnValue& value);
+  void Append(const ColumnVector& other, size_t i);
+  ColumnValue Get(size_t i) const;
+
+  bool Match(size_t i, const ColumnPredicate& predicate) const;
+};
+
+// Encoded values of one column in a row group, keeps min max of not null values.
+// The smallest one of the encodings available for the column type is chosen when building.
+class ColumnChunk {
+ public:
+  enum class Encoding : uint8_t {
+    kPlain = 0,
+    kDictionary = 1,  // bytes only, distinct values + varint code of every row
+    kRle = 2,         // (value, varint run length) of every run
+    kDelta = 3,       // int64: zigzag varint delta to previous, bytes: shared prefix length with previous + suffix
+  };
+
+  static std::shared_ptr<const ColumnChunk> Build(const ColumnVector& values);
+
+  pb::common::ColumnType Type() const { return type_; }
+  Encoding GetEncoding() const { return encoding_; }
+  size_t RowCount() const { return row_count_; }
+  size_t ByteSize() const { return data_.size() + nulls_.size(); }
+
+  // False if all values are null.
+  bool HasValue() const { return has_value_; }
+  int64_t IntMin() const { return int_min_; }
+  int64_t IntMax() const { return int_max_; }
+  const std::string& BytesMin() const { return bytes_min_; }
+  const std::string& BytesMax() const { return bytes_max_; }
+
+  void Decode(ColumnVector& values) const;
+
+  // False if no value of chunk can match, decided by min max.
+  bool MayMatch(const ColumnPredicate& predicate) const;
+  // And predicate into selection, dictionary and runs are evaluated once instead of every row.
+  void Filter(const ColumnPredicate& predicate, std::vector<uint8_t>& selection) const;
+
+ private:
+  ColumnChunk() = default;
+
+  static std::string EncodeInts(const std::vector<int64_t>& values, Encoding encoding);
+  static std::string EncodeBytes(const std::vector<std::string>& values, Encoding encoding);
+  void DecodeInts(std::vector<int64_t>& values) const;
+  void DecodeBytes(std::vector<std::string>& values) const;
+  void ApplyNulls(std::vector<uint8_t>& selection) const;
+
+  pb::common::ColumnType type_ = pb::common::COLUMN_TYPE_BYTES;
+  Encoding encoding_ = Encoding::kPlain;
+  size_t row_count_ = 0;
+  std::string data_;
+  std::vector<uint8_t> nulls_;  // empty if no null
+
+  bool has_value_ = false;
+  int64_t int_min_ = 0;
+  int64_t int_max_ = 0;
+  std::string bytes_min_;
+  std::string bytes_max_;
+};
+
+// Rows of one key range sorted by key, the key column and every value column are encoded separately.
+// Values of schema layout are split into columns, otherwise the group is raw and keeps the whole
+// value in one bytes column.
+class RowGroup {
+ public:
+  static std::shared_ptr<const RowGroup> Build(std::shared_ptr<const ColumnarSchema> schema,
+                                               const std::vector<pb::common::KeyValue>& rows);
+
+  size_t RowCount() const { return row_count_; }
+  const std::string& MinKey() const { return key_chunk_->BytesMin(); }
+  const std::string& MaxKey() const { return key_chunk_->BytesMax(); }
+  size_t ByteSize() const;
+
+  bool IsRaw() const { return schema_ == nullptr; }
+  const std::shared_ptr<const ColumnarSchema>& Schema() const { return schema_; }
+
+  const ColumnChunk& KeyChunk() const { return *key_chunk_; }
+  const ColumnChunk& Column(size_t i) const { return *columns_[i]; }
+  size_t ColumnCount() const { return columns_.size(); }
+
+  void DecodeKeys(std::vector<std::string>& keys) const;
+  // Decode whole rows, value of schema layout is encoded back from columns.
+  void DecodeRows(std::vector<pb::common::KeyValue>& rows) const;
+  void DecodeValue(size_t index, std::string& value) const;
+
+ private:
+  RowGroup() = default;
+
+  size_t row_count_ = 0;
+  std::shared_ptr<const ColumnarSchema> schema_;
+  std::shared_ptr<const ColumnChunk> key_chunk_;
+  std::vector<std::shared_ptr<const ColumnChunk> > columns_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_COLUMN_CHUNK_H_
@@ -0,0 +1,556 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/column_store.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+void ColumnarSchemaMap::Set(const pb::common::Range& range, const ColumnarSchema& schema) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  schemas_[range.start_key()] = Entry{range.end_key(), std::make_shared<const ColumnarSchema>(schema)};
+}
+
+void ColumnarSchemaMap::Remove(const pb::common::Range& range) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto it = schemas_.find(range.start_key());
+  if (it != schemas_.end() && it->second.end_key == range.end_key()) {
+    schemas_.erase(it);
+  }
+}
+
+std::shared_ptr<const ColumnarSchema> ColumnarSchemaMap::Find(const std::string& key) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = schemas_.upper_bound(key);
+  if (it == schemas_.begin()) {
+    return nullptr;
+  }
+  --it;
+  if (!it->second.end_key.empty() && key >= it->second.end_key) {
+    return nullptr;
+  }
+  return it->second.schema;
+}
+
+static bool MatchValue(pb::common::ColumnType type, const ColumnValue& value, const ColumnPredicate& predicate) {
+  if (value.is_null) {
+    return false;
+  }
+  if (type == pb::common::COLUMN_TYPE_INT64) {
+    return value.int_value >= predicate.int_min && value.int_value <= predicate.int_max;
+  }
+  return value.bytes_value >= predicate.bytes_min &&
+         (predicate.bytes_max.empty() || value.bytes_value <= predicate.bytes_max);
+}
+
+static bool InRange(const std::string& key, const std::string& start_key, const std::string& end_key) {
+  return key >= start_key && (end_key.empty() || key < end_key);
+}
+
+ColumnStore::ColumnStore(std::shared_ptr<ColumnarSchemaMap> schemas, size_t flush_rows, size_t group_rows)
+    : schemas_(schemas),
+      flush_rows_(flush_rows),
+      group_rows_(group_rows),
+      groups_(std::make_shared<const RowGroups>()),
+      byte_size_(0),
+      row_count_(0),
+      group_count_(0) {}
+
+ColumnStore::View ColumnStore::GetView() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return View{groups_, std::make_shared<const Buffer>(buffer_)};
+}
+
+ColumnStore::View ColumnStore::GetView(const std::string& start_key, const std::string& end_key) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto begin = buffer_.lower_bound(start_key);
+  auto end = end_key.empty() ? buffer_.end() : buffer_.lower_bound(end_key);
+  if (end_key.empty() || start_key < end_key) {
+    return View{groups_, std::make_shared<const Buffer>(begin, end)};
+  }
+  return View{groups_, std::make_shared<const Buffer>()};
+}
+
+ColumnStore::RowGroups::const_iterator ColumnStore::FindGroup(const RowGroups& groups, const std::string& key) {
+  return std::lower_bound(groups.begin(), groups.end(), key,
+                          [](const std::shared_ptr<const RowGroup>& group, const std::string& key) {
+                            return group->MaxKey() < key;
+                          });
+}
+
+bool ColumnStore::GetFromGroups(const RowGroups& groups, const std::string& key, std::string& value) {
+  auto it = FindGroup(groups, key);
+  if (it == groups.end() || (*it)->MinKey() > key) {
+    return false;
+  }
+
+  std::vector<std::string> keys;
+  (*it)->DecodeKeys(keys);
+  auto key_it = std::lower_bound(keys.begin(), keys.end(), key);
+  if (key_it == keys.end() || *key_it != key) {
+    return false;
+  }
+  (*it)->DecodeValue(key_it - keys.begin(), value);
+  return true;
+}
+
+bool ColumnStore::Get(const std::string& key, std::string& value) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = buffer_.find(key);
+  if (it != buffer_.end()) {
+    if (it->second.has_value()) {
+      value = it->second.value();
+    }
+    return it->second.has_value();
+  }
+  return GetFromGroups(*groups_, key, value);
+}
+
+bool ColumnStore::Get(const View& view, const std::string& key, std::string& value) {
+  auto it = view.buffer->find(key);
+  if (it != view.buffer->end()) {
+    if (it->second.has_value()) {
+      value = it->second.value();
+    }
+    return it->second.has_value();
+  }
+  return GetFromGroups(*view.groups, key, value);
+}
+
+// Groups not touched by buffer are filtered by min max and predicates on encoded chunks, only selected rows
+// of requested columns are decoded. Groups with buffered keys are merged row by row.
+bool ColumnStore::ScanColumns(const View& view, const std::string& start_key, const std::string& end_key,
+                              const std::vector<uint32_t>& columns, const std::vector<ColumnPredicate>& predicates,
+                              ColumnBatch& batch) const {
+  batch.keys.clear();
+  batch.columns.assign(columns.size(), ColumnVector());
+
+  bool typed = false;
+  auto check_schema = [&](const ColumnarSchema& schema) -> bool {
+    for (auto column : columns) {
+      if (column >= schema.size()) {
+        return false;
+      }
+    }
+    for (const auto& predicate : predicates) {
+      if (predicate.column >= schema.size()) {
+        return false;
+      }
+    }
+    for (size_t j = 0; j < columns.size(); ++j) {
+      if (!typed) {
+        batch.columns[j].type = schema[columns[j]].type();
+      } else if (batch.columns[j].type != schema[columns[j]].type()) {
+        return false;
+      }
+    }
+    typed = true;
+    return true;
+  };
+
+  std::vector<ColumnValue> row;
+  auto append_buffered = [&](const Buffer::value_type& entry) -> bool {
+    if (!entry.second.has_value()) {
+      return true;
+    }
+    auto schema = schemas_->Find(entry.first);
+    if (schema == nullptr || !check_schema(*schema) || !ColumnarRow::Decode(*schema, entry.second.value(), row)) {
+      return false;
+    }
+    for (const auto& predicate : predicates) {
+      if (!MatchValue(schema->at(predicate.column).type(), row[predicate.column], predicate)) {
+        return true;
+      }
+    }
+    batch.keys.push_back(entry.first);
+    for (size_t j = 0; j < columns.size(); ++j) {
+      batch.columns[j].Append(row[columns[j]]);
+    }
+    return true;
+  };
+
+  const auto& buffer = *view.buffer;
+  auto buffer_iter = buffer.lower_bound(start_key);
+  auto buffer_end = end_key.empty() ? buffer.end() : buffer.lower_bound(end_key);
+  if (!end_key.empty() && start_key >= end_key) {
+    buffer_end = buffer_iter;
+  }
+
+  const auto& groups = *view.groups;
+  for (auto it = FindGroup(groups, start_key); it != groups.end(); ++it) {
+    const auto& group = **it;
+    if (!end_key.empty() && group.MinKey() >= end_key) {
+      break;
+    }
+    for (; buffer_iter != buffer_end && buffer_iter->first < group.MinKey(); ++buffer_iter) {
+      if (!append_buffered(*buffer_iter)) {
+        return false;
+      }
+    }
+    if (group.IsRaw() || !check_schema(*group.Schema())) {
+      return false;
+    }
+
+    std::vector<std::string> keys;
+    bool touched = buffer_iter != buffer_end && buffer_iter->first <= group.MaxKey();
+    if (!touched) {
+      bool may_match = true;
+      for (const auto& predicate : predicates) {
+        may_match = may_match && group.Column(predicate.column).MayMatch(predicate);
+      }
+      if (!may_match) {
+        continue;
+      }
+
+      std::vector<uint8_t> selection(group.RowCount(), 1);
+      for (const auto& predicate : predicates) {
+        group.Column(predicate.column).Filter(predicate, selection);
+      }
+      if (std::find(selection.begin(), selection.end(), 1) == selection.end()) {
+        continue;
+      }
+
+      group.DecodeKeys(keys);
+      if (group.MinKey() < start_key || (!end_key.empty() && group.MaxKey() >= end_key)) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+          selection[i] &= InRange(keys[i], start_key, end_key) ? 1 : 0;
+        }
+      }
+
+      std::vector<ColumnVector> values(columns.size());
+      for (size_t j = 0; j < columns.size(); ++j) {
+        group.Column(columns[j]).Decode(values[j]);
+      }
+      for (size_t i = 0; i < group.RowCount(); ++i) {
+        if (selection[i] == 0) {
+          continue;
+        }
+        batch.keys.push_back(std::move(keys[i]));
+        for (size_t j = 0; j < columns.size(); ++j) {
+          batch.columns[j].Append(values[j], i);
+        }
+      }
+      continue;
+    }
+
+    // Buffered keys overwrite rows of group.
+    group.DecodeKeys(keys);
+    std::map<uint32_t, ColumnVector> values;
+    for (auto column : columns) {
+      group.Column(column).Decode(values[column]);
+    }
+    for (const auto& predicate : predicates) {
+      if (values.find(predicate.column) == values.end()) {
+        group.Column(predicate.column).Decode(values[predicate.column]);
+      }
+    }
+
+    for (size_t i = 0; i < group.RowCount(); ++i) {
+      for (; buffer_iter != buffer_end && buffer_iter->first < keys[i]; ++buffer_iter) {
+        if (!append_buffered(*buffer_iter)) {
+          return false;
+        }
+      }
+      if (buffer_iter != buffer_end && buffer_iter->first == keys[i]) {
+        if (!append_buffered(*buffer_iter++)) {
+          return false;
+        }
+        continue;
+      }
+      if (!InRange(keys[i], start_key, end_key)) {
+        continue;
+      }
+
+      bool match = true;
+      for (const auto& predicate : predicates) {
+        match = match && values[predicate.column].Match(i, predicate);
+      }
+      if (match) {
+        batch.keys.push_back(std::move(keys[i]));
+        for (size_t j = 0; j < columns.size(); ++j) {
+          batch.columns[j].Append(values[columns[j]], i);
+        }
+      }
+    }
+  }
+
+  for (; buffer_iter != buffer_end; ++buffer_iter) {
+    if (!append_buffered(*buffer_iter)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ColumnStore::Flush() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  FlushLocked();
+}
+
+void ColumnStore::Compact(const std::string& start_key, const std::string& end_key) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  FlushLocked();
+
+  auto groups = std::make_shared<RowGroups>();
+  std::vector<pb::common::KeyValue> pending;
+  std::vector<pb::common::KeyValue> rows;
+  for (const auto& group : *groups_) {
+    if (group->MaxKey() >= start_key && (end_key.empty() || group->MinKey() < end_key)) {
+      group->DecodeRows(rows);
+      std::move(rows.begin(), rows.end(), std::back_inserter(pending));
+      continue;
+    }
+    Pack(pending, *groups);
+    groups->push_back(group);
+  }
+  Pack(pending, *groups);
+
+  Publish(groups);
+}
+
+void ColumnStore::Pack(std::vector<pb::common::KeyValue>& rows, RowGroups& groups) const {
+  if (rows.empty()) {
+    return;
+  }
+
+  size_t begin = 0;
+  auto schema = schemas_->Find(rows[0].key());
+  for (size_t i = 1; i <= rows.size(); ++i) {
+    auto row_schema = i < rows.size() ? schemas_->Find(rows[i].key()) : nullptr;
+    if (i == rows.size() || i - begin == group_rows_ || row_schema != schema) {
+      std::vector<pb::common::KeyValue> group_rows(std::make_move_iterator(rows.begin() + begin),
+                                                   std::make_move_iterator(rows.begin() + i));
+      groups.push_back(RowGroup::Build(schema, group_rows));
+      begin = i;
+      schema = row_schema;
+    }
+  }
+  rows.clear();
+}
+
+// Only groups containing buffered keys are decoded and rebuilt, others are shared with the old list.
+void ColumnStore::FlushLocked() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  auto groups = std::make_shared<RowGroups>();
+  std::vector<pb::common::KeyValue> pending;
+  auto push_buffered = [&pending](const Buffer::value_type& entry) {
+    if (entry.second.has_value()) {
+      pb::common::KeyValue kv;
+      kv.set_key(entry.first);
+      kv.set_value(entry.second.value());
+      pending.emplace_back(std::move(kv));
+    }
+  };
+
+  auto buffer_iter = buffer_.begin();
+  std::vector<pb::common::KeyValue> rows;
+  for (const auto& group : *groups_) {
+    for (; buffer_iter != buffer_.end() && buffer_iter->first < group->MinKey(); ++buffer_iter) {
+      push_buffered(*buffer_iter);
+    }
+    if (buffer_iter == buffer_.end() || buffer_iter->first > group->MaxKey()) {
+      Pack(pending, *groups);
+      groups->push_back(group);
+      continue;
+    }
+
+    group->DecodeRows(rows);
+    for (auto& row : rows) {
+      for (; buffer_iter != buffer_.end() && buffer_iter->first < row.key(); ++buffer_iter) {
+        push_buffered(*buffer_iter);
+      }
+      if (buffer_iter != buffer_.end() && buffer_iter->first == row.key()) {
+        push_buffered(*buffer_iter++);
+        continue;
+      }
+      pending.emplace_back(std::move(row));
+    }
+  }
+  for (; buffer_iter != buffer_.end(); ++buffer_iter) {
+    push_buffered(*buffer_iter);
+  }
+  Pack(pending, *groups);
+
+  buffer_.clear();
+  Publish(groups);
+}
+
+void ColumnStore::DeleteRangeLocked(const std::string& start_key, const std::string& end_key) {
+  if (!end_key.empty() && start_key >= end_key) {
+    return;
+  }
+  buffer_.erase(buffer_.lower_bound(start_key), end_key.empty() ? buffer_.end() : buffer_.lower_bound(end_key));
+
+  bool changed = false;
+  auto groups = std::make_shared<RowGroups>();
+  std::vector<pb::common::KeyValue> pending;
+  std::vector<pb::common::KeyValue> rows;
+  for (const auto& group : *groups_) {
+    if (group->MaxKey() < start_key || (!end_key.empty() && group->MinKey() >= end_key)) {
+      Pack(pending, *groups);
+      groups->push_back(group);
+      continue;
+    }
+
+    changed = true;
+    if (group->MinKey() >= start_key && (end_key.empty() || group->MaxKey() < end_key)) {
+      continue;
+    }
+    group->DecodeRows(rows);
+    for (auto& row : rows) {
+      if (!InRange(row.key(), start_key, end_key)) {
+        pending.emplace_back(std::move(row));
+      }
+    }
+  }
+  Pack(pending, *groups);
+
+  if (changed) {
+    Publish(groups);
+  }
+}
+
+void ColumnStore::Publish(std::shared_ptr<const RowGroups> groups) {
+  int64_t byte_size = 0;
+  int64_t row_count = 0;
+  for (const auto& group : *groups) {
+    byte_size += group->ByteSize();
+    row_count += group->RowCount();
+  }
+  groups_ = groups;
+
+  byte_size_.store(byte_size, std::memory_order_relaxed);
+  row_count_.store(row_count, std::memory_order_relaxed);
+  group_count_.store(groups->size(), std::memory_order_relaxed);
+}
+
+ColumnStore::Iterator::Iterator(View view, const std::string& start_key, const std::string& end_key)
+    : view_(view),
+      end_key_(end_key),
+      group_index_(FindGroup(*view.groups, start_key) - view.groups->begin()),
+      row_index_(0),
+      buffer_iter_(view_.buffer->lower_bound(start_key)),
+      valid_(false),
+      from_buffer_(false),
+      same_key_(false),
+      key_(nullptr),
+      value_(nullptr) {
+  LoadGroup();
+  row_index_ = std::lower_bound(rows_.begin(), rows_.end(), start_key,
+                                [](const pb::common::KeyValue& row, const std::string& key) {
+                                  return row.key() < key;
+                                }) -
+               rows_.begin();
+  Settle();
+}
+
+void ColumnStore::Iterator::Next() {
+  if (from_buffer_) {
+    ++buffer_iter_;
+    if (same_key_) {
+      ++row_index_;
+    }
+  } else {
+    ++row_index_;
+  }
+  Settle();
+}
+
+void ColumnStore::Iterator::LoadGroup() {
+  const auto& groups = *view_.groups;
+  while (row_index_ >= rows_.size() && group_index_ < groups.size()) {
+    const auto& group = groups[group_index_++];
+    if (!end_key_.empty() && group->MinKey() >= end_key_) {
+      group_index_ = groups.size();
+      rows_.clear();
+      break;
+    }
+    group->DecodeRows(rows_);
+    row_index_ = 0;
+  }
+}
+
+// Buffered key wins the same key of group, deleted key is skipped.
+void ColumnStore::Iterator::Settle() {
+  while (true) {
+    LoadGroup();
+    bool has_row = row_index_ < rows_.size();
+    bool has_buffered = buffer_iter_ != view_.buffer->end();
+    if (!has_row && !has_buffered) {
+      valid_ = false;
+      return;
+    }
+
+    from_buffer_ = has_buffered && (!has_row || buffer_iter_->first <= rows_[row_index_].key());
+    same_key_ = from_buffer_ && has_row && buffer_iter_->first == rows_[row_index_].key();
+    if (from_buffer_ && !buffer_iter_->second.has_value()) {
+      ++buffer_iter_;
+      if (same_key_) {
+        ++row_index_;
+      }
+      continue;
+    }
+
+    if (from_buffer_) {
+      key_ = &buffer_iter_->first;
+      value_ = &buffer_iter_->second.value();
+    } else {
+      key_ = &rows_[row_index_].key();
+      value_ = &rows_[row_index_].value();
+    }
+    valid_ = end_key_.empty() || *key_ < end_key_;
+    return;
+  }
+}
+
+ColumnStore::WriteBatch::WriteBatch(ColumnStore* store) : store_(store), lock_(store->mutex_) {}
+
+ColumnStore::WriteBatch::~WriteBatch() {
+  if (store_->buffer_.size() >= store_->flush_rows_) {
+    store_->FlushLocked();
+  }
+}
+
+bool ColumnStore::WriteBatch::Get(const std::string& key, std::string& value) {
+  auto it = store_->buffer_.find(key);
+  if (it != store_->buffer_.end()) {
+    if (it->second.has_value()) {
+      value = it->second.value();
+    }
+    return it->second.has_value();
+  }
+  return GetFromGroups(*store_->groups_, key, value);
+}
+
+void ColumnStore::WriteBatch::Put(const std::string& key, const std::string& value) { store_->buffer_[key] = value; }
+
+void ColumnStore::WriteBatch::Delete(const std::string& key) { store_->buffer_[key] = std::nullopt; }
+
+void ColumnStore::WriteBatch::DeleteRange(const std::string& start_key, const std::string& end_key) {
+  store_->DeleteRangeLocked(start_key, end_key);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,191 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_COLUMN_STORE_H_
+#define DINGODB_ENGINE_COLUMN_STORE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "engine/column_chunk.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Schema of key ranges, key out of all ranges has no schema.
+class ColumnarSchemaMap {
+ public:
+  ColumnarSchemaMap() = default;
+  ~ColumnarSchemaMap() = default;
+
+  void Set(const pb::common::Range& range, const ColumnarSchema& schema);
+  void Remove(const pb::common::Range& range);
+  std::shared_ptr<const ColumnarSchema> Find(const std::string& key) const;
+
+ private:
+  struct Entry {
+    std::string end_key;
+    std::shared_ptr<const ColumnarSchema> schema;
+  };
+
+  mutable std::shared_mutex mutex_;
+  // start_key -> entry
+  std::map<std::string, Entry> schemas_;
+};
+
+// Selected rows of a column scan, columns are in the order of requested columns.
+struct ColumnBatch {
+  std::vector<std::string> keys;
+  std::vector<ColumnVector> columns;
+
+  size_t Size() const { return keys.size(); }
+};
+
+// Column oriented key value of one column family.
+// Writes go to a small sorted buffer, which is merged into row groups when it is full. Row groups are
+// sorted and not overlapped, every one is immutable and shared by readers, a merge publishes a new
+// group list and rewrites only the groups containing buffered keys.
+// Point reads decode a whole group, the store is made for scans of a few columns.
+class ColumnStore {
+ public:
+  // nullopt value is a delete.
+  using Buffer = std::map<std::string, std::optional<std::string> >;
+  using RowGroups = std::vector<std::shared_ptr<const RowGroup> >;
+
+  ColumnStore(std::shared_ptr<ColumnarSchemaMap> schemas, size_t flush_rows, size_t group_rows);
+  ~ColumnStore() = default;
+
+  ColumnStore(const ColumnStore&) = delete;
+  ColumnStore& operator=(const ColumnStore&) = delete;
+
+  // Consistent read view, row groups are shared and buffer is copied.
+  struct View {
+    std::shared_ptr<const RowGroups> groups;
+    std::shared_ptr<const Buffer> buffer;
+  };
+
+  // View of all keys, or only buffered keys in [start_key, end_key) are copied.
+  View GetView() const;
+  View GetView(const std::string& start_key, const std::string& end_key) const;
+
+  // Read latest or at view. Return false when key not exists.
+  bool Get(const std::string& key, std::string& value) const;
+  static bool Get(const View& view, const std::string& key, std::string& value);
+
+  // Scan columns of rows in [start_key, end_key) matching all predicates, return false if any row in range
+  // is not of columnar layout or column index is out of schema.
+  bool ScanColumns(const View& view, const std::string& start_key, const std::string& end_key,
+                   const std::vector<uint32_t>& columns, const std::vector<ColumnPredicate>& predicates,
+                   ColumnBatch& batch) const;
+
+  // Merge buffer into row groups.
+  void Flush();
+  // Rebuild row groups overlapped with [start_key, end_key), small groups are merged.
+  void Compact(const std::string& start_key, const std::string& end_key);
+
+  int64_t ApproximateBytes() const { return byte_size_.load(std::memory_order_relaxed); }
+  int64_t ApproximateRows() const { return row_count_.load(std::memory_order_relaxed); }
+  int64_t RowGroupCount() const { return group_count_.load(std::memory_order_relaxed); }
+
+  // Iterate keys of a view in order, key and value are valid until iterator moves.
+  class Iterator {
+   public:
+    Iterator(View view, const std::string& start_key, const std::string& end_key);
+    ~Iterator() = default;
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    bool Valid() const { return valid_; }
+    void Next();
+
+    const std::string& key() const { return *key_; }
+    const std::string& value() const { return *value_; }
+
+   private:
+    void LoadGroup();
+    void Settle();
+
+    View view_;
+    std::string end_key_;
+    size_t group_index_;
+    std::vector<pb::common::KeyValue> rows_;
+    size_t row_index_;
+    Buffer::const_iterator buffer_iter_;
+
+    bool valid_;
+    bool from_buffer_;
+    bool same_key_;
+    const std::string* key_;
+    const std::string* value_;
+  };
+
+  // Hold the write lock, buffer is merged at destruction if it is full. Conditional writes read and write in
+  // one batch to be atomic.
+  class WriteBatch {
+   public:
+    explicit WriteBatch(ColumnStore* store);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+
+    // Read latest, include writes of this batch.
+    bool Get(const std::string& key, std::string& value);
+    void Put(const std::string& key, const std::string& value);
+    void Delete(const std::string& key);
+    // Delete [start_key, end_key).
+    void DeleteRange(const std::string& start_key, const std::string& end_key);
+
+    // Writes are applied at once, nothing to do.
+    bool Commit() { return true; }
+
+   private:
+    ColumnStore* store_;
+    std::unique_lock<std::shared_mutex> lock_;
+  };
+
+ private:
+  static bool GetFromGroups(const RowGroups& groups, const std::string& key, std::string& value);
+  // First group whose max key >= key.
+  static RowGroups::const_iterator FindGroup(const RowGroups& groups, const std::string& key);
+
+  // Cut sorted rows into row groups, a group holds rows of one schema.
+  void Pack(std::vector<pb::common::KeyValue>& rows, RowGroups& groups) const;
+  void FlushLocked();
+  void DeleteRangeLocked(const std::string& start_key, const std::string& end_key);
+  void Publish(std::shared_ptr<const RowGroups> groups);
+
+  std::shared_ptr<ColumnarSchemaMap> schemas_;
+  const size_t flush_rows_;
+  const size_t group_rows_;
+
+  mutable std::shared_mutex mutex_;
+  std::shared_ptr<const RowGroups> groups_;
+  Buffer buffer_;
+
+  std::atomic<int64_t> byte_size_;
+  std::atomic<int64_t> row_count_;
+  std::atomic<int64_t> group_count_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_COLUMN_STORE_H_
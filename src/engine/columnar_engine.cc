@@ -0,0 +1,60 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/columnar_engine.h"
+
+#include <vector>
+
+#include "server/server.h"
+
+namespace dingodb {
+
+ColumnarEngine::ColumnarEngine(std::shared_ptr<RawColumnarEngine> engine)
+    : RaftKvEngine(engine), columnar_engine_(engine) {}
+
+std::string ColumnarEngine::GetName() { return pb::common::Engine_Name(pb::common::ENG_COLUMNAR); }
+
+pb::common::Engine ColumnarEngine::GetID() { return pb::common::ENG_COLUMNAR; }
+
+butil::Status ColumnarEngine::AddRegion(std::shared_ptr<Context> ctx, std::shared_ptr<pb::common::Region> region) {
+  columnar_engine_->SetSchema(region->range(), ColumnarSchema(region->columns().begin(), region->columns().end()));
+
+  auto status = RaftKvEngine::AddRegion(ctx, region);
+  if (!status.ok()) {
+    columnar_engine_->RemoveSchema(region->range());
+  }
+  return status;
+}
+
+butil::Status ColumnarEngine::DestroyRegion(std::shared_ptr<Context> ctx, uint64_t region_id) {
+  // Region meta is gone after destroyed, read the range first.
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(region_id);
+  auto status = RaftKvEngine::DestroyRegion(ctx, region_id);
+  if (status.ok() && region != nullptr) {
+    columnar_engine_->RemoveSchema(region->range());
+  }
+  return status;
+}
+
+butil::Status ColumnarEngine::KvScanColumns(std::shared_ptr<Context> ctx, const std::string& start_key,
+                                            const std::string& end_key, const std::vector<uint32_t>& columns,
+                                            const std::vector<ColumnPredicate>& predicates, ColumnBatch& batch) {
+  auto reader = std::dynamic_pointer_cast<RawColumnarEngine::Reader>(columnar_engine_->NewReader(ctx->CfName()));
+  if (reader == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  return reader->KvScanColumns(nullptr, start_key, end_key, columns, predicates, batch);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_COLUMNAR_ENGINE_H_
+#define DINGODB_ENGINE_COLUMNAR_ENGINE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/column_store.h"
+#include "engine/raft_kv_engine.h"
+#include "engine/raw_columnar_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Engine of ENG_COLUMNAR tables, regions are replicated by raft as RaftKvEngine and applied to
+// RawColumnarEngine. Value columns of region are registered before its raft node starts.
+class ColumnarEngine : public RaftKvEngine {
+ public:
+  ColumnarEngine(std::shared_ptr<RawColumnarEngine> engine);
+  ~ColumnarEngine() override = default;
+
+  std::string GetName() override;
+  pb::common::Engine GetID() override;
+
+  butil::Status AddRegion(std::shared_ptr<Context> ctx, std::shared_ptr<pb::common::Region> region) override;
+  butil::Status DestroyRegion(std::shared_ptr<Context> ctx, uint64_t region_id) override;
+
+  // Scan columns of rows in [start_key, end_key) of ctx column family, read on local replica.
+  butil::Status KvScanColumns(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
+                              const std::vector<uint32_t>& columns, const std::vector<ColumnPredicate>& predicates,
+                              ColumnBatch& batch);
+
+ private:
+  std::shared_ptr<RawColumnarEngine> columnar_engine_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_COLUMNAR_ENGINE_H_
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/dead_range.h"
+
+#include <algorithm>
+
+#include "engine/mvcc.h"
+
+namespace dingodb {
+
+std::mutex DeadRange::mutex_;
+std::shared_ptr<const DeadRange::RangeMap> DeadRange::range_map_ = std::make_shared<const DeadRange::RangeMap>();
+std::shared_ptr<const DeadRange::RangeMap> DeadRange::mvcc_range_map_ = std::make_shared<const DeadRange::RangeMap>();
+
+std::shared_ptr<const DeadRange::RangeMap> DeadRange::Build(const std::vector<pb::common::Range>& ranges) {
+  std::vector<std::pair<std::string, std::string>> sorted_ranges;
+  sorted_ranges.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (range.start_key() < range.end_key()) {
+      sorted_ranges.emplace_back(range.start_key(), range.end_key());
+    }
+  }
+  std::sort(sorted_ranges.begin(), sorted_ranges.end());
+
+  // Merge overlapped or adjacent ranges.
+  auto range_map = std::make_shared<RangeMap>();
+  for (auto& [start_key, end_key] : sorted_ranges) {
+    if (!range_map->empty()) {
+      auto last = std::prev(range_map->end());
+      if (start_key <= last->second) {
+        last->second = std::max(last->second, end_key);
+        continue;
+      }
+    }
+    range_map->emplace(std::move(start_key), std::move(end_key));
+  }
+
+  return range_map;
+}
+
+bool DeadRange::Contains(const RangeMap& range_map, const std::string_view& key) {
+  if (range_map.empty()) {
+    return false;
+  }
+
+  // The last range start not greater than key.
+  auto it = range_map.upper_bound(key);
+  if (it == range_map.begin()) {
+    return false;
+  }
+  --it;
+
+  return key < it->second;
+}
+
+void DeadRange::Update(const std::vector<pb::common::Range>& ranges) {
+  std::vector<pb::common::Range> mvcc_ranges;
+  mvcc_ranges.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    pb::common::Range mvcc_range;
+    mvcc_range.set_start_key(Mvcc::EncodeKeyPrefix(range.start_key()));
+    mvcc_range.set_end_key(Mvcc::EncodeKeyPrefix(range.end_key()));
+    mvcc_ranges.push_back(std::move(mvcc_range));
+  }
+
+  auto range_map = Build(ranges);
+  auto mvcc_range_map = Build(mvcc_ranges);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  range_map_ = range_map;
+  mvcc_range_map_ = mvcc_range_map;
+}
+
+std::shared_ptr<const DeadRange::RangeMap> DeadRange::Get() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return range_map_;
+}
+
+std::shared_ptr<const DeadRange::RangeMap> DeadRange::GetMvcc() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return mvcc_range_map_;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_DEAD_RANGE_H_
+#define DINGODB_ENGINE_DEAD_RANGE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Key ranges of dropped tables and regions, data in them is dropped by compaction filter.
+// Ranges are merged to a sorted map without overlap(start_key -> end_key), lookup is a binary search.
+// Compaction filter hold an immutable map for one compaction, update only swap the map.
+class DeadRange {
+ public:
+  using RangeMap = std::map<std::string, std::string, std::less<>>;
+
+  static std::shared_ptr<const RangeMap> Build(const std::vector<pb::common::Range>& ranges);
+  static bool Contains(const RangeMap& range_map, const std::string_view& key);
+
+  // Replace all dead ranges.
+  static void Update(const std::vector<pb::common::Range>& ranges);
+  static std::shared_ptr<const RangeMap> Get();
+  // Same ranges with mvcc encoded keys, for mvcc column family.
+  static std::shared_ptr<const RangeMap> GetMvcc();
+
+ private:
+  static std::mutex mutex_;
+  static std::shared_ptr<const RangeMap> range_map_;
+  static std::shared_ptr<const RangeMap> mvcc_range_map_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_DEAD_RANGE_H_
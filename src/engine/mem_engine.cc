@@ -16,22 +16,10 @@
 
 namespace dingodb {
 
-MemEngine::MemEngine() {}
+MemEngine::MemEngine(std::shared_ptr<RawEngine> engine) : RaftKvEngine(engine) {}
 
-bool MemEngine::Init(std::shared_ptr<Config> config) {
-  LOG(INFO) << "Init MemEngine...";
-  return true;
-}
-
-std::string MemEngine::GetName() { return "MEM_ENGINE"; }
+std::string MemEngine::GetName() { return pb::common::Engine_Name(pb::common::ENG_MEMORY); }
 
 pb::common::Engine MemEngine::GetID() { return pb::common::ENG_MEMORY; }
 
-butil::Status MemEngine::Write(std::shared_ptr<Context> ctx, const WriteData& write_data) { return butil::Status(); }
-butil::Status MemEngine::AsyncWrite(std::shared_ptr<Context> ctx, const WriteData& write_data, WriteCb_t cb) {
-  return butil::Status();
-}
-
-std::shared_ptr<Engine::Reader> MemEngine::NewReader(const std::string& cf_name) { return nullptr; }
-
 }  // namespace dingodb
@@ -15,34 +15,25 @@
 #ifndef DINGODB_ENGINE_MEM_ENGINE_H_
 #define DINGODB_ENGINE_MEM_ENGINE_H_
 
-#include <map>
-#include <shared_mutex>
+#include <memory>
+#include <string>
 
-#include "common/context.h"
-#include "engine/engine.h"
-#include "proto/error.pb.h"
-#include "proto/store.pb.h"
+#include "engine/raft_kv_engine.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
 
 namespace dingodb {
 
-class MemEngine : public Engine {
+// Engine of ENG_MEMORY tables, regions are replicated by raft as RaftKvEngine and applied to RawMemEngine.
+class MemEngine : public RaftKvEngine {
  public:
-  MemEngine();
+  MemEngine(std::shared_ptr<RawEngine> engine);
+  ~MemEngine() override = default;
 
-  bool Init(std::shared_ptr<Config> config);
   std::string GetName() override;
   pb::common::Engine GetID() override;
-
-  butil::Status Write(std::shared_ptr<Context> ctx, const WriteData& write_data) override;
-  butil::Status AsyncWrite(std::shared_ptr<Context> ctx, const WriteData& write_data, WriteCb_t cb) override;
-
-  std::shared_ptr<Engine::Reader> NewReader(const std::string& cf_name) override;
-
- private:
-  std::shared_mutex mutex_;
-  std::map<std::string, std::string> store_;
 };
 
 }  // namespace dingodb
 
-#endif
+#endif  // DINGODB_ENGINE_MEM_ENGINE_H_
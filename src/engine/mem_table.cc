@@ -0,0 +1,417 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/mem_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+struct MemTable::Version {
+  Version(uint64_t seq, bool deleted, const std::string& value) : seq(seq), deleted(deleted), value(value) {}
+
+  uint64_t seq;
+  bool deleted;
+  std::string value;
+  // Older version.
+  std::atomic<Version*> next{nullptr};
+};
+
+struct MemTable::Node {
+  Node(const std::string& key, int height) : key(key), height(height), next(new std::atomic<Node*>[height]) {
+    for (int i = 0; i < height; ++i) {
+      next[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  std::string key;
+  int height;
+  // Only touched by writer.
+  bool removed = false;
+  // Newest version first.
+  std::atomic<Version*> versions{nullptr};
+  std::unique_ptr<std::atomic<Node*>[]> next;
+};
+
+int64_t MemTable::MemoryOf(const Version* version) { return sizeof(*version) + version->value.size(); }
+
+int64_t MemTable::MemoryOf(const Node* node) {
+  return sizeof(*node) + node->key.size() + node->height * sizeof(std::atomic<Node*>);
+}
+
+MemTable::ReadGuard::ReadGuard(MemTable* table) : table_(table) {
+  for (;;) {
+    uint64_t epoch = table_->epoch_.load();
+    slot_ = epoch & 1;
+    table_->readers_[slot_].fetch_add(1);
+    // Epoch changed before entering, the slot may be reclaiming.
+    if (table_->epoch_.load() == epoch) {
+      break;
+    }
+    table_->readers_[slot_].fetch_sub(1);
+  }
+}
+
+MemTable::ReadGuard::~ReadGuard() { table_->readers_[slot_].fetch_sub(1); }
+
+MemTable::MemTable()
+    : head_(new Node("", kMaxHeight)),
+      max_height_(1),
+      last_sequence_(1),
+      memory_usage_(0),
+      random_(0xdeadbeef),
+      deferred_seq_(0),
+      epoch_(0) {
+  readers_[0] = 0;
+  readers_[1] = 0;
+}
+
+MemTable::~MemTable() {
+  Node* node = head_;
+  while (node != nullptr) {
+    Node* next = node->next[0].load(std::memory_order_relaxed);
+    FreeNode(node);
+    node = next;
+  }
+  for (int i = 0; i < 2; ++i) {
+    for (auto* version : retired_versions_[i]) {
+      FreeVersion(version);
+    }
+    for (auto* retired_node : retired_nodes_[i]) {
+      FreeNode(retired_node);
+    }
+  }
+}
+
+uint64_t MemTable::AcquireSnapshot() {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  uint64_t seq = LastSequence();
+  snapshots_.insert(seq);
+  return seq;
+}
+
+void MemTable::ReleaseSnapshot(uint64_t seq) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  auto it = snapshots_.find(seq);
+  if (it != snapshots_.end()) {
+    snapshots_.erase(it);
+  }
+}
+
+bool MemTable::Get(const std::string& key, uint64_t seq, std::string& value) {
+  ReadGuard guard(this);
+  if (seq > 0) {
+    return Lookup(key, seq, value);
+  }
+
+  // Versions of latest may be dropped by a later commit while looking up, retry then.
+  for (;;) {
+    uint64_t last_seq = LastSequence();
+    bool found = Lookup(key, last_seq, value);
+    if (LastSequence() == last_seq) {
+      return found;
+    }
+  }
+}
+
+bool MemTable::Lookup(const std::string& key, uint64_t seq, std::string& value) const {
+  Node* node = FindGreaterOrEqual(key, nullptr);
+  if (node == nullptr || node->key != key) {
+    return false;
+  }
+
+  Version* version = node->versions.load(std::memory_order_acquire);
+  while (version != nullptr && version->seq > seq) {
+    version = version->next.load(std::memory_order_acquire);
+  }
+  if (version == nullptr || version->deleted) {
+    return false;
+  }
+  value = version->value;
+  return true;
+}
+
+int MemTable::RandomHeight() {
+  // Branching 4, xorshift is enough.
+  int height = 1;
+  for (;;) {
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+    if (height >= kMaxHeight || (random_ & 3) != 0) {
+      break;
+    }
+    ++height;
+  }
+  return height;
+}
+
+MemTable::Node* MemTable::FindGreaterOrEqual(const std::string& key, Node** prev) const {
+  Node* node = head_;
+  int level = max_height_.load(std::memory_order_relaxed) - 1;
+  for (;;) {
+    Node* next = node->next[level].load(std::memory_order_acquire);
+    if (next != nullptr && next->key < key) {
+      node = next;
+      continue;
+    }
+    if (prev != nullptr) {
+      prev[level] = node;
+    }
+    if (level == 0) {
+      return next;
+    }
+    --level;
+  }
+}
+
+MemTable::Node* MemTable::InsertNode(const std::string& key, Node** prev) {
+  int height = RandomHeight();
+  int max_height = max_height_.load(std::memory_order_relaxed);
+  if (height > max_height) {
+    for (int i = max_height; i < height; ++i) {
+      prev[i] = head_;
+    }
+    // Reader see new height before the node only find null from head, that is fine.
+    max_height_.store(height, std::memory_order_relaxed);
+  }
+
+  Node* node = new Node(key, height);
+  memory_usage_.fetch_add(MemoryOf(node), std::memory_order_relaxed);
+  for (int i = 0; i < height; ++i) {
+    node->next[i].store(prev[i]->next[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    prev[i]->next[i].store(node, std::memory_order_release);
+  }
+  return node;
+}
+
+void MemTable::RemoveNode(Node* node) {
+  Node* prev[kMaxHeight];
+  Node* found = FindGreaterOrEqual(node->key, prev);
+  if (found != node) {
+    return;
+  }
+
+  // Next pointers of removed node are kept, readers on it can still move forward.
+  for (int i = 0; i < node->height; ++i) {
+    prev[i]->next[i].store(node->next[i].load(std::memory_order_relaxed), std::memory_order_release);
+  }
+  node->removed = true;
+  Retire(node);
+}
+
+void MemTable::Prune(const std::vector<Node*>& nodes, uint64_t seq) {
+  uint64_t min_seq = seq;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (!snapshots_.empty()) {
+      min_seq = std::min(min_seq, *snapshots_.begin());
+    }
+  }
+
+  if (!deferred_keys_.empty() && min_seq >= deferred_seq_) {
+    std::set<std::string> keys;
+    keys.swap(deferred_keys_);
+    for (const auto& key : keys) {
+      Node* node = FindGreaterOrEqual(key, nullptr);
+      if (node != nullptr && node->key == key) {
+        PruneNode(node, min_seq);
+      }
+    }
+  }
+
+  for (auto* node : nodes) {
+    if (!node->removed && !PruneNode(node, min_seq)) {
+      deferred_keys_.insert(node->key);
+      deferred_seq_ = seq;
+    }
+  }
+
+  TryReclaim();
+}
+
+bool MemTable::PruneNode(Node* node, uint64_t min_seq) {
+  Version* head = node->versions.load(std::memory_order_relaxed);
+  Version* version = head;
+  while (version != nullptr && version->seq > min_seq) {
+    version = version->next.load(std::memory_order_relaxed);
+  }
+
+  if (version != nullptr) {
+    Version* older = version->next.load(std::memory_order_relaxed);
+    version->next.store(nullptr, std::memory_order_release);
+    while (older != nullptr) {
+      Version* next = older->next.load(std::memory_order_relaxed);
+      Retire(older);
+      older = next;
+    }
+
+    if (version == head && head->deleted) {
+      RemoveNode(node);
+      return true;
+    }
+  }
+
+  return head->next.load(std::memory_order_relaxed) == nullptr && !head->deleted;
+}
+
+void MemTable::Retire(Version* version) { retired_versions_[epoch_.load() & 1].push_back(version); }
+
+void MemTable::Retire(Node* node) { retired_nodes_[epoch_.load() & 1].push_back(node); }
+
+// Retired in epoch e is freed when slot of e is drained after epoch moved to e + 1, readers entered
+// since e + 1 can not reach them.
+void MemTable::TryReclaim() {
+  uint64_t epoch = epoch_.load();
+  int prev_slot = (epoch + 1) & 1;
+  if (readers_[prev_slot].load() != 0) {
+    return;
+  }
+
+  for (auto* version : retired_versions_[prev_slot]) {
+    FreeVersion(version);
+  }
+  retired_versions_[prev_slot].clear();
+  for (auto* node : retired_nodes_[prev_slot]) {
+    FreeNode(node);
+  }
+  retired_nodes_[prev_slot].clear();
+
+  int slot = epoch & 1;
+  if (!retired_versions_[slot].empty() || !retired_nodes_[slot].empty()) {
+    epoch_.store(epoch + 1);
+  }
+}
+
+void MemTable::FreeVersion(Version* version) {
+  memory_usage_.fetch_sub(MemoryOf(version), std::memory_order_relaxed);
+  delete version;
+}
+
+void MemTable::FreeNode(Node* node) {
+  Version* version = node->versions.load(std::memory_order_relaxed);
+  while (version != nullptr) {
+    Version* next = version->next.load(std::memory_order_relaxed);
+    FreeVersion(version);
+    version = next;
+  }
+  memory_usage_.fetch_sub(MemoryOf(node), std::memory_order_relaxed);
+  delete node;
+}
+
+MemTable::Iterator::Iterator(MemTable* table, uint64_t seq)
+    : table_(table), guard_(table), seq_(seq), own_snapshot_(seq == 0), node_(nullptr), version_(nullptr) {
+  if (own_snapshot_) {
+    seq_ = table_->AcquireSnapshot();
+  }
+}
+
+MemTable::Iterator::~Iterator() {
+  if (own_snapshot_) {
+    table_->ReleaseSnapshot(seq_);
+  }
+}
+
+void MemTable::Iterator::SeekToFirst() {
+  node_ = table_->head_->next[0].load(std::memory_order_acquire);
+  SkipInvisible();
+}
+
+void MemTable::Iterator::Seek(const std::string& key) {
+  node_ = table_->FindGreaterOrEqual(key, nullptr);
+  SkipInvisible();
+}
+
+void MemTable::Iterator::Next() {
+  node_ = node_->next[0].load(std::memory_order_acquire);
+  SkipInvisible();
+}
+
+const std::string& MemTable::Iterator::key() const { return node_->key; }
+
+const std::string& MemTable::Iterator::value() const { return version_->value; }
+
+void MemTable::Iterator::SkipInvisible() {
+  for (; node_ != nullptr; node_ = node_->next[0].load(std::memory_order_acquire)) {
+    Version* version = node_->versions.load(std::memory_order_acquire);
+    while (version != nullptr && version->seq > seq_) {
+      version = version->next.load(std::memory_order_acquire);
+    }
+    if (version != nullptr && !version->deleted) {
+      version_ = version;
+      return;
+    }
+  }
+}
+
+MemTable::WriteBatch::WriteBatch(MemTable* table)
+    : table_(table), lock_(table->write_mutex_), seq_(table->LastSequence() + 1) {}
+
+MemTable::WriteBatch::~WriteBatch() {
+  if (written_nodes_.empty()) {
+    return;
+  }
+  table_->last_sequence_.store(seq_, std::memory_order_release);
+  table_->Prune(written_nodes_, seq_);
+}
+
+bool MemTable::WriteBatch::Get(const std::string& key, std::string& value) {
+  return table_->Lookup(key, std::numeric_limits<uint64_t>::max(), value);
+}
+
+void MemTable::WriteBatch::AddVersion(Node* node, bool deleted, const std::string& value) {
+  auto* version = new Version(seq_, deleted, value);
+  table_->memory_usage_.fetch_add(MemoryOf(version), std::memory_order_relaxed);
+  version->next.store(node->versions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  node->versions.store(version, std::memory_order_release);
+  written_nodes_.push_back(node);
+}
+
+void MemTable::WriteBatch::Put(const std::string& key, const std::string& value) {
+  Node* prev[kMaxHeight];
+  Node* node = table_->FindGreaterOrEqual(key, prev);
+  if (node == nullptr || node->key != key) {
+    node = table_->InsertNode(key, prev);
+  }
+  AddVersion(node, false, value);
+}
+
+void MemTable::WriteBatch::Delete(const std::string& key) {
+  Node* node = table_->FindGreaterOrEqual(key, nullptr);
+  if (node == nullptr || node->key != key) {
+    return;
+  }
+  Version* head = node->versions.load(std::memory_order_relaxed);
+  if (head != nullptr && !head->deleted) {
+    AddVersion(node, true, "");
+  }
+}
+
+void MemTable::WriteBatch::DeleteRange(const std::string& start_key, const std::string& end_key) {
+  for (Node* node = table_->FindGreaterOrEqual(start_key, nullptr); node != nullptr && node->key < end_key;
+       node = node->next[0].load(std::memory_order_relaxed)) {
+    Version* head = node->versions.load(std::memory_order_relaxed);
+    if (head != nullptr && !head->deleted) {
+      AddVersion(node, true, "");
+    }
+  }
+}
+
+}  // namespace dingodb
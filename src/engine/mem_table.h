@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_MEM_TABLE_H_
+#define DINGODB_ENGINE_MEM_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+// Ordered multi version key value in memory, indexed by a skiplist.
+// Readers are lock free, writers are serialized. All writes of a batch get one sequence and become
+// visible together, a reader at a sequence sees the newest version not newer than it.
+// Versions hidden from every snapshot are dropped after each write, their memory is freed once
+// no reader entered before the drop is still running (epoch based reclamation).
+class MemTable {
+ private:
+  struct Version;
+  struct Node;
+
+  // Memory retired while a guard lives is not freed.
+  class ReadGuard {
+   public:
+    explicit ReadGuard(MemTable* table);
+    ~ReadGuard();
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+   private:
+    MemTable* table_;
+    int slot_;
+  };
+
+ public:
+  MemTable();
+  ~MemTable();
+
+  MemTable(const MemTable&) = delete;
+  MemTable& operator=(const MemTable&) = delete;
+
+  // Sequence of the last committed batch, start from 1, 0 means latest in reads.
+  uint64_t LastSequence() const { return last_sequence_.load(std::memory_order_acquire); }
+
+  // Versions visible at the returned sequence are kept until it is released.
+  uint64_t AcquireSnapshot();
+  void ReleaseSnapshot(uint64_t seq);
+
+  // Read at snapshot seq, 0 is latest. Return false when key not exists.
+  bool Get(const std::string& key, uint64_t seq, std::string& value);
+
+  // Keys, values and versions in bytes, include not yet freed.
+  int64_t ApproximateMemoryUsage() const { return memory_usage_.load(std::memory_order_relaxed); }
+
+  // Iterate keys visible at a snapshot in order, key and value are valid until iterator moves.
+  class Iterator {
+   public:
+    // 0 seq is latest, a snapshot is held by the iterator.
+    Iterator(MemTable* table, uint64_t seq);
+    ~Iterator();
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    bool Valid() const { return node_ != nullptr; }
+    void SeekToFirst();
+    // First key >= key.
+    void Seek(const std::string& key);
+    void Next();
+
+    const std::string& key() const;
+    const std::string& value() const;
+
+   private:
+    void SkipInvisible();
+
+    MemTable* table_;
+    ReadGuard guard_;
+    uint64_t seq_;
+    bool own_snapshot_;
+    Node* node_;
+    Version* version_;
+  };
+
+  // Hold the write lock, writes are committed at destruction. Conditional writes read and write in
+  // one batch to be atomic.
+  class WriteBatch {
+   public:
+    explicit WriteBatch(MemTable* table);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+
+    // Read latest, include writes of this batch.
+    bool Get(const std::string& key, std::string& value);
+    void Put(const std::string& key, const std::string& value);
+    void Delete(const std::string& key);
+    // Delete [start_key, end_key).
+    void DeleteRange(const std::string& start_key, const std::string& end_key);
+
+    // Writes are applied at once, nothing to do.
+    bool Commit() { return true; }
+
+   private:
+    void AddVersion(Node* node, bool deleted, const std::string& value);
+
+    MemTable* table_;
+    std::unique_lock<std::mutex> lock_;
+    uint64_t seq_;
+    std::vector<Node*> written_nodes_;
+  };
+
+ private:
+  static const int kMaxHeight = 12;
+
+  int RandomHeight();
+  // First node >= key, fill prev of every level when prev is not null.
+  Node* FindGreaterOrEqual(const std::string& key, Node** prev) const;
+  Node* InsertNode(const std::string& key, Node** prev);
+  void RemoveNode(Node* node);
+  bool Lookup(const std::string& key, uint64_t seq, std::string& value) const;
+
+  // Called by writer after a batch committed.
+  void Prune(const std::vector<Node*>& nodes, uint64_t seq);
+  // Drop versions older than the newest one not newer than min_seq, remove node if it is deleted.
+  // Return false when versions or tombstone are still kept for snapshots.
+  bool PruneNode(Node* node, uint64_t min_seq);
+  void Retire(Version* version);
+  void Retire(Node* node);
+  void TryReclaim();
+  void FreeVersion(Version* version);
+  void FreeNode(Node* node);
+  static int64_t MemoryOf(const Version* version);
+  static int64_t MemoryOf(const Node* node);
+
+  Node* head_;
+  std::atomic<int> max_height_;
+  std::atomic<uint64_t> last_sequence_;
+  std::atomic<int64_t> memory_usage_;
+
+  std::mutex write_mutex_;
+  uint32_t random_;
+  // Keys keep versions for snapshots older than deferred_seq_, prune again when snapshots are released.
+  std::set<std::string> deferred_keys_;
+  uint64_t deferred_seq_;
+
+  std::mutex snapshot_mutex_;
+  std::multiset<uint64_t> snapshots_;
+
+  // Readers count in two epoch slots, retired memory of an epoch is freed when its slot is drained.
+  std::atomic<uint64_t> epoch_;
+  std::atomic<int64_t> readers_[2];
+  std::vector<Version*> retired_versions_[2];
+  std::vector<Node*> retired_nodes_[2];
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_MEM_TABLE_H_
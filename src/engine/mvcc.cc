@@ -0,0 +1,248 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/mvcc.h"
+
+#include <cstdint>
+#include <string>
+
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const size_t kEncGroupSize = 8;
+static const unsigned char kEncMarker = 0xFF;
+static const size_t kTsSize = 8;
+
+static const char kValuePutFlag = 'P';
+static const char kValueDeleteFlag = 'D';
+
+std::atomic<uint64_t> Mvcc::safe_point_(0);
+
+// Memcomparable bytes encoding, split to 8 bytes groups and every group follow a marker,
+// marker is 0xFF minus padding size, so encoded key keep the order and no key is prefix of another.
+std::string Mvcc::EncodeKeyPrefix(const std::string& user_key) {
+  std::string buf;
+  buf.reserve((user_key.size() / kEncGroupSize + 1) * (kEncGroupSize + 1) + kTsSize);
+
+  for (size_t i = 0; i <= user_key.size(); i += kEncGroupSize) {
+    size_t remain = user_key.size() - i;
+    size_t pad = 0;
+    if (remain >= kEncGroupSize) {
+      buf.append(user_key, i, kEncGroupSize);
+    } else {
+      pad = kEncGroupSize - remain;
+      buf.append(user_key, i, remain);
+      buf.append(pad, '\0');
+    }
+    buf.push_back(static_cast<char>(kEncMarker - pad));
+  }
+
+  return buf;
+}
+
+std::string Mvcc::EncodeKey(const std::string& user_key, uint64_t ts) {
+  std::string buf = EncodeKeyPrefix(user_key);
+
+  // Descending timestamp, the newest version come first.
+  uint64_t reverse_ts = ~ts;
+  for (int i = kTsSize - 1; i >= 0; --i) {
+    buf.push_back(static_cast<char>((reverse_ts >> (i * 8)) & 0xFF));
+  }
+
+  return buf;
+}
+
+bool Mvcc::SplitKey(const std::string_view& key, std::string_view& prefix, uint64_t& ts) {
+  if (key.size() < kEncGroupSize + 1 + kTsSize) {
+    return false;
+  }
+
+  prefix = key.substr(0, key.size() - kTsSize);
+
+  uint64_t reverse_ts = 0;
+  for (size_t i = key.size() - kTsSize; i < key.size(); ++i) {
+    reverse_ts = (reverse_ts << 8) | static_cast<unsigned char>(key[i]);
+  }
+  ts = ~reverse_ts;
+
+  return true;
+}
+
+bool Mvcc::DecodeKey(const std::string_view& key, std::string& user_key, uint64_t& ts) {
+  std::string_view prefix;
+  if (!SplitKey(key, prefix, ts)) {
+    return false;
+  }
+
+  user_key.clear();
+  size_t i = 0;
+  while (i + kEncGroupSize + 1 <= prefix.size()) {
+    size_t pad = kEncMarker - static_cast<unsigned char>(prefix[i + kEncGroupSize]);
+    if (pad > kEncGroupSize) {
+      return false;
+    }
+
+    user_key.append(prefix.data() + i, kEncGroupSize - pad);
+    i += kEncGroupSize + 1;
+    if (pad != 0) {
+      // The group with padding must be the last one.
+      return i == prefix.size();
+    }
+  }
+
+  return false;
+}
+
+std::string Mvcc::EncodeValue(const std::string& value, bool is_delete) {
+  std::string buf;
+  buf.reserve(value.size() + 1);
+  buf.push_back(is_delete ? kValueDeleteFlag : kValuePutFlag);
+  buf.append(value);
+
+  return buf;
+}
+
+bool Mvcc::IsDeleteValue(const std::string_view& value) { return value.empty() || value[0] == kValueDeleteFlag; }
+
+std::string_view Mvcc::DecodeValue(const std::string_view& value) {
+  return value.empty() ? value : value.substr(1);
+}
+
+void Mvcc::SetSafePoint(uint64_t ts) {
+  uint64_t old_ts = safe_point_.load();
+  // Safe point never go back.
+  while (ts > old_ts && !safe_point_.compare_exchange_weak(old_ts, ts)) {
+  }
+}
+
+uint64_t Mvcc::GetSafePoint() { return safe_point_.load(); }
+
+butil::Status MvccReader::KvGet(uint64_t ts, const std::string& key, std::string& value) {
+  if (key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  // Versions of key not newer than ts are in [EncodeKey(key, ts), EncodeKey(key, 0)].
+  std::string end_key = Mvcc::EncodeKey(key, 0);
+  end_key.push_back('\0');
+  auto iter = reader_->NewIterator(Mvcc::EncodeKey(key, ts), end_key);
+  if (iter == nullptr || !iter->HasNext()) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+
+  std::string encode_key;
+  std::string encode_value;
+  iter->GetKV(encode_key, encode_value);
+  if (Mvcc::IsDeleteValue(encode_value)) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+
+  value.assign(Mvcc::DecodeValue(encode_value));
+
+  return butil::Status();
+}
+
+butil::Status MvccReader::KvScan(uint64_t ts, const std::string& start_key, const std::string& end_key,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  if (start_key.empty() || end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key or end_key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto iter = reader_->NewIterator(Mvcc::EncodeKeyPrefix(start_key), Mvcc::EncodeKeyPrefix(end_key));
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  std::string last_prefix;
+  std::string encode_key;
+  std::string encode_value;
+  for (; iter->HasNext(); iter->Next()) {
+    iter->GetKV(encode_key, encode_value);
+
+    std::string_view prefix;
+    uint64_t version = 0;
+    if (!Mvcc::SplitKey(encode_key, prefix, version)) {
+      LOG(ERROR) << butil::StringPrintf("illegal mvcc key, size %lu", encode_key.size());
+      continue;
+    }
+
+    // Newer than read ts or older version of seen key.
+    if (version > ts || prefix == last_prefix) {
+      continue;
+    }
+    last_prefix = prefix;
+
+    if (Mvcc::IsDeleteValue(encode_value)) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    std::string user_key;
+    Mvcc::DecodeKey(encode_key, user_key, version);
+    kv.set_key(std::move(user_key));
+    kv.set_value(std::string(Mvcc::DecodeValue(encode_value)));
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status MvccReader::KvCount(uint64_t ts, const std::string& start_key, const std::string& end_key,
+                                  int64_t& count) {
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = KvScan(ts, start_key, end_key, kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  count = kvs.size();
+  return butil::Status();
+}
+
+butil::Status MvccWriter::KvPut(uint64_t ts, const pb::common::KeyValue& kv) {
+  pb::common::KeyValue mvcc_kv;
+  mvcc_kv.set_key(Mvcc::EncodeKey(kv.key(), ts));
+  mvcc_kv.set_value(Mvcc::EncodeValue(kv.value(), false));
+
+  return writer_->KvPut(mvcc_kv);
+}
+
+butil::Status MvccWriter::KvBatchPut(uint64_t ts, const std::vector<pb::common::KeyValue>& kvs) {
+  std::vector<pb::common::KeyValue> mvcc_kvs;
+  mvcc_kvs.reserve(kvs.size());
+  for (const auto& kv : kvs) {
+    pb::common::KeyValue mvcc_kv;
+    mvcc_kv.set_key(Mvcc::EncodeKey(kv.key(), ts));
+    mvcc_kv.set_value(Mvcc::EncodeValue(kv.value(), false));
+    mvcc_kvs.emplace_back(std::move(mvcc_kv));
+  }
+
+  return writer_->KvBatchPut(mvcc_kvs);
+}
+
+// Delete is a tombstone version, older versions are visible to reader before ts.
+butil::Status MvccWriter::KvDelete(uint64_t ts, const std::string& key) {
+  pb::common::KeyValue mvcc_kv;
+  mvcc_kv.set_key(Mvcc::EncodeKey(key, ts));
+  mvcc_kv.set_value(Mvcc::EncodeValue("", true));
+
+  return writer_->KvPut(mvcc_kv);
+}
+
+}  // namespace dingodb
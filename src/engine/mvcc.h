@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_MVCC_H_
+#define DINGODB_ENGINE_MVCC_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Mvcc key/value encoding.
+// key: memcomparable(user_key) + ~ts(8 bytes big endian), versions of one key are adjacent and newest first.
+// value: flag(1 byte) + user_value, flag distinguish put and delete.
+class Mvcc {
+ public:
+  static std::string EncodeKey(const std::string& user_key, uint64_t ts);
+  static bool DecodeKey(const std::string_view& key, std::string& user_key, uint64_t& ts);
+
+  // All versions of user_key start with this prefix.
+  static std::string EncodeKeyPrefix(const std::string& user_key);
+  // Split encoded key to encoded user key prefix and ts, not decode user key.
+  static bool SplitKey(const std::string_view& key, std::string_view& prefix, uint64_t& ts);
+
+  static std::string EncodeValue(const std::string& value, bool is_delete);
+  static bool IsDeleteValue(const std::string_view& value);
+  static std::string_view DecodeValue(const std::string_view& value);
+
+  // Versions not newer than safe point are only kept the newest one of each key.
+  static void SetSafePoint(uint64_t ts);
+  static uint64_t GetSafePoint();
+
+ private:
+  static std::atomic<uint64_t> safe_point_;
+};
+
+// Read user key at timestamp, see the newest version not newer than ts.
+class MvccReader {
+ public:
+  MvccReader(std::shared_ptr<RawEngine::Reader> reader) : reader_(reader) {}
+  ~MvccReader() = default;
+
+  butil::Status KvGet(uint64_t ts, const std::string& key, std::string& value);
+  butil::Status KvScan(uint64_t ts, const std::string& start_key, const std::string& end_key,
+                       std::vector<pb::common::KeyValue>& kvs);
+  butil::Status KvCount(uint64_t ts, const std::string& start_key, const std::string& end_key, int64_t& count);
+
+ private:
+  std::shared_ptr<RawEngine::Reader> reader_;
+};
+
+// Write user key with timestamp, old versions are kept until gc.
+class MvccWriter {
+ public:
+  MvccWriter(std::shared_ptr<RawEngine::Writer> writer) : writer_(writer) {}
+  ~MvccWriter() = default;
+
+  butil::Status KvPut(uint64_t ts, const pb::common::KeyValue& kv);
+  butil::Status KvBatchPut(uint64_t ts, const std::vector<pb::common::KeyValue>& kvs);
+  butil::Status KvDelete(uint64_t ts, const std::string& key);
+
+ private:
+  std::shared_ptr<RawEngine::Writer> writer_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_MVCC_H_
@@ -18,9 +18,12 @@
 
 #include "braft/raft.h"
 #include "butil/endpoint.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/synchronization.h"
 #include "config/config_manager.h"
+#include "engine/mvcc.h"
+#include "engine/ttl.h"
 #include "engine/write_data.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator_internal.pb.h"
@@ -29,6 +32,7 @@
 #include "raft/meta_state_machine.h"
 #include "raft/store_state_machine.h"
 #include "server/server.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
@@ -39,6 +43,8 @@ RaftKvEngine::~RaftKvEngine() = default;
 
 bool RaftKvEngine::Init(std::shared_ptr<Config> config) {
   LOG(INFO) << "Now=> Int Raft Kv Engine with config[" << config->ToString();
+  config_ = config;
+  raft_endpoint_ = Helper::GetEndPoint(config->GetString("raft.host"), config->GetInt("raft.port"));
   return true;
 }
 
@@ -50,12 +56,24 @@ bool RaftKvEngine::Recover() {
 
   auto ctx = std::make_shared<Context>();
   for (auto& it : regions) {
+    if (RegionEngine(*it.second) != GetID()) {
+      continue;
+    }
     AddRegion(ctx, it.second);
+    StoreMetrics::AddRegionMetrics(it.first);
   }
 
   return true;
 }
 
+pb::common::Engine RaftKvEngine::RegionEngine(const pb::common::Region& region) {
+  if (region.engine() == pb::common::ENG_MEMORY || region.engine() == pb::common::ENG_COLUMNAR ||
+      region.engine() == pb::common::ENG_XDP) {
+    return region.engine();
+  }
+  return pb::common::ENG_RAFT_STORE;
+}
+
 std::string RaftKvEngine::GetName() { return pb::common::Engine_Name(pb::common::ENG_RAFT_STORE); }
 
 pb::common::Engine RaftKvEngine::GetID() { return pb::common::ENG_RAFT_STORE; }
@@ -67,10 +85,10 @@ butil::Status RaftKvEngine::AddRegion(std::shared_ptr<Context> ctx, const std::s
   braft::StateMachine* state_machine = nullptr;
   state_machine = new StoreStateMachine(engine_);
 
-  std::shared_ptr<RaftNode> node = std::make_shared<RaftNode>(
-      ctx->ClusterRole(), region->id(), braft::PeerId(Server::GetInstance()->RaftEndpoint()), state_machine);
+  std::shared_ptr<RaftNode> node =
+      std::make_shared<RaftNode>(ctx->ClusterRole(), region->id(), braft::PeerId(raft_endpoint_), state_machine);
 
-  if (node->Init(Helper::FormatPeers(Helper::ExtractLocations(region->peers()))) != 0) {
+  if (node->Init(Helper::FormatPeers(Helper::ExtractLocations(region->peers())), config_) != 0) {
     node->Destroy();
     return butil::Status(pb::error::ERAFT_INIT, "Raft init failed");
   }
@@ -127,7 +145,6 @@ butil::Status RaftKvEngine::Write(std::shared_ptr<Context> ctx, const WriteData&
 
   ctx->EnableSyncMode();
   ctx->Cond()->IncreaseWait();
-  LOG(INFO) << "Wake up";
   if (!ctx->Status().ok()) {
     return ctx->Status();
   }
@@ -135,13 +152,11 @@ butil::Status RaftKvEngine::Write(std::shared_ptr<Context> ctx, const WriteData&
 }
 
 butil::Status RaftKvEngine::AsyncWrite(std::shared_ptr<Context> ctx, const WriteData& write_data, WriteCb_t cb) {
-  LOG(INFO) << "here 0001";
   auto node = raft_node_manager_->GetNode(ctx->RegionId());
   if (node == nullptr) {
     LOG(ERROR) << "Not found raft node " << ctx->RegionId();
     return butil::Status(pb::error::ERAFT_NOTNODE, "Not found node");
   }
-  LOG(INFO) << "here 0002";
 
   ctx->SetWriteCb(cb);
   return node->Commit(ctx, genRaftCmdRequest(ctx, write_data));
@@ -151,17 +166,37 @@ std::shared_ptr<Engine::Reader> RaftKvEngine::NewReader(const std::string& cf_na
   return std::make_shared<RaftKvEngine::Reader>(engine_->NewReader(cf_name));
 }
 
+// Read at ctx timestamp when it is set, not pin rocksdb snapshot.
+// Ttl column family hide expired values.
 butil::Status RaftKvEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) {
+  if (ctx->Ts() > 0) {
+    return MvccReader(reader_).KvGet(ctx->Ts(), key, value);
+  }
+  if (ctx->CfName() == Constant::kStoreTtlCF) {
+    return TtlReader(reader_).KvGet(key, value);
+  }
   return reader_->KvGet(key, value);
 }
 
 butil::Status RaftKvEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                            const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  if (ctx->Ts() > 0) {
+    return MvccReader(reader_).KvScan(ctx->Ts(), start_key, end_key, kvs);
+  }
+  if (ctx->CfName() == Constant::kStoreTtlCF) {
+    return TtlReader(reader_).KvScan(start_key, end_key, kvs);
+  }
   return reader_->KvScan(start_key, end_key, kvs);
 }
 
 butil::Status RaftKvEngine::Reader::KvCount(std::shared_ptr<Context> ctx, const std::string& start_key,
                                             const std::string& end_key, int64_t& count) {
+  if (ctx->Ts() > 0) {
+    return MvccReader(reader_).KvCount(ctx->Ts(), start_key, end_key, count);
+  }
+  if (ctx->CfName() == Constant::kStoreTtlCF) {
+    return TtlReader(reader_).KvCount(start_key, end_key, count);
+  }
   return reader_->KvCount(start_key, end_key, count);
 }
 
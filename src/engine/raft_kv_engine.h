@@ -17,6 +17,7 @@
 
 #include <memory>
 
+#include "butil/endpoint.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
 #include "proto/error.pb.h"
@@ -60,6 +61,11 @@ class RaftKvEngine : public Engine, public RaftControlAble {
 
   std::shared_ptr<Engine::Reader> NewReader(const std::string& cf_name) override;
 
+  std::shared_ptr<RaftNode> GetNode(uint64_t region_id) { return raft_node_manager_->GetNode(region_id); }
+
+  // Engine which the region belong to, decided by the table engine of region.
+  static pb::common::Engine RegionEngine(const pb::common::Region& region);
+
   class Reader : public Engine::Reader {
    public:
     Reader(std::shared_ptr<RawEngine::Reader> reader) : reader_(reader) {}
@@ -78,6 +84,9 @@ class RaftKvEngine : public Engine, public RaftControlAble {
  protected:
   std::shared_ptr<RawEngine> engine_;                   // NOLINT
   std::unique_ptr<RaftNodeManager> raft_node_manager_;  // NOLINT
+  // Raft node options and listen address of this engine, from config of Init.
+  std::shared_ptr<Config> config_;  // NOLINT
+  butil::EndPoint raft_endpoint_;   // NOLINT
 };
 
 }  // namespace dingodb
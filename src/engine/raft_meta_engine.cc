@@ -44,10 +44,7 @@ RaftMetaEngine::RaftMetaEngine(std::shared_ptr<RawEngine> engine, std::shared_pt
 
 RaftMetaEngine::~RaftMetaEngine() = default;
 
-bool RaftMetaEngine::Init(std::shared_ptr<Config> config) {
-  LOG(INFO) << "Now=> Int Raft Kv Engine with config[" << config->ToString() + "]";
-  return true;
-}
+bool RaftMetaEngine::Init(std::shared_ptr<Config> config) { return RaftKvEngine::Init(config); }
 
 bool RaftMetaEngine::Recover() { return true; }
 
@@ -58,10 +55,10 @@ butil::Status RaftMetaEngine::InitCoordinatorRegion(std::shared_ptr<Context> ctx
   // construct MetaStatMachine here
   braft::StateMachine* state_machine = new MetaStateMachine(engine_, meta_control_);
 
-  std::shared_ptr<RaftNode> node = std::make_shared<RaftNode>(
-      ctx->ClusterRole(), region->id(), braft::PeerId(Server::GetInstance()->RaftEndpoint()), state_machine);
+  std::shared_ptr<RaftNode> node =
+      std::make_shared<RaftNode>(ctx->ClusterRole(), region->id(), braft::PeerId(raft_endpoint_), state_machine);
 
-  if (node->Init(Helper::FormatPeers(Helper::ExtractLocations(region->peers()))) != 0) {
+  if (node->Init(Helper::FormatPeers(Helper::ExtractLocations(region->peers())), config_) != 0) {
     node->Destroy();
     return butil::Status(pb::error::ERAFT_INIT, "Raft init failed");
   }
@@ -0,0 +1,295 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raw_columnar_engine.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kColumnFamilies = "store.columnFamilies";
+static const std::string kFlushRows = "store.columnarFlushRows";
+static const std::string kGroupRows = "store.columnarGroupRows";
+
+static const int kDefaultFlushRows = 1024;
+static const int kDefaultGroupRows = 4096;
+
+class ColumnarIterator : public EngineIterator {
+ public:
+  ColumnarIterator(std::shared_ptr<ColumnStore> store, const std::string& start_key, const std::string& end_key)
+      : store_(store), iter_(store->GetView(), start_key, end_key) {}
+  ~ColumnarIterator() override = default;
+
+  bool HasNext() override { return iter_.Valid(); }
+
+  void Next() override { iter_.Next(); }
+
+  void GetKV(std::string& key, std::string& value) override {  // NOLINT
+    key = iter_.key();
+    value = iter_.value();
+  }
+
+  const std::string& GetName() const override { return name_; }
+  uint32_t GetID() override { return id_; }
+
+ private:
+  std::shared_ptr<ColumnStore> store_;
+  ColumnStore::Iterator iter_;
+
+  const std::string name_ = "ColumnarIterator";
+  uint32_t id_ = static_cast<uint32_t>(EnumEngineIterator::kColumnarIterator);
+};
+
+RawColumnarEngine::RawColumnarEngine() : schemas_(std::make_shared<ColumnarSchemaMap>()) {}
+
+RawColumnarEngine::~RawColumnarEngine() = default;
+
+bool RawColumnarEngine::Init(std::shared_ptr<Config> config) {
+  if (!config) {
+    LOG(ERROR) << butil::StringPrintf("config empty not support!");
+    return false;
+  }
+
+  std::vector<std::string> column_families = config->GetStringList(kColumnFamilies);
+  if (column_families.empty()) {
+    LOG(ERROR) << butil::StringPrintf("%s : empty. not found any column family", kColumnFamilies.c_str());
+    return false;
+  }
+
+  int flush_rows = config->GetInt(kFlushRows);
+  int group_rows = config->GetInt(kGroupRows);
+  flush_rows = flush_rows > 0 ? flush_rows : kDefaultFlushRows;
+  group_rows = group_rows > 0 ? group_rows : kDefaultGroupRows;
+
+  for (const auto& cf_name : column_families) {
+    stores_.emplace(cf_name, std::make_shared<ColumnStore>(schemas_, flush_rows, group_rows));
+    encoded_bytes_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                        butil::StringPrintf("dingo_columnar_engine_%s_bytes", cf_name.c_str()), 0));
+    row_counts_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                     butil::StringPrintf("dingo_columnar_engine_%s_rows", cf_name.c_str()), 0));
+  }
+
+  LOG(INFO) << butil::StringPrintf("Init RawColumnarEngine with %lu column families, flush rows %d group rows %d",
+                                   column_families.size(), flush_rows, group_rows);
+  return true;
+}
+
+std::string RawColumnarEngine::GetName() { return pb::common::RawEngine_Name(pb::common::RAW_ENG_COLUMNAR); }
+
+pb::common::RawEngine RawColumnarEngine::GetID() { return pb::common::RAW_ENG_COLUMNAR; }
+
+std::shared_ptr<Snapshot> RawColumnarEngine::GetSnapshot() {
+  std::map<std::string, ColumnStore::View> views;
+  for (const auto& [cf_name, store] : stores_) {
+    views.emplace(cf_name, store->GetView());
+  }
+  return std::make_shared<ColumnarSnapshot>(views);
+}
+
+// Views are released with the snapshot.
+void RawColumnarEngine::ReleaseSnapshot(std::shared_ptr<Snapshot> /*snapshot*/) {}
+
+void RawColumnarEngine::Flush(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store != nullptr) {
+    store->Flush();
+  }
+}
+
+butil::Status RawColumnarEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto writer = NewWriter(cf_name);
+  if (writer == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  return writer->KvDeleteRange(range);
+}
+
+butil::Status RawColumnarEngine::CompactRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  store->Compact(range.start_key(), range.end_key());
+  return butil::Status();
+}
+
+butil::Status RawColumnarEngine::IngestExternalFile(const std::string& /*cf_name*/,
+                                                    const std::vector<std::string>& /*files*/,
+                                                    const pb::common::Range& /*range*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Columnar engine not support ingest sst");
+}
+
+butil::Status RawColumnarEngine::SetOptions(const std::string& /*cf_name*/,
+                                            const std::map<std::string, std::string>& /*options*/,
+                                            std::vector<std::string>& /*need_reopen_options*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Columnar engine has no options");
+}
+
+void RawColumnarEngine::CollectStats() {
+  for (const auto& [cf_name, store] : stores_) {
+    encoded_bytes_[cf_name]->set_value(store->ApproximateBytes());
+    row_counts_[cf_name]->set_value(store->ApproximateRows());
+  }
+}
+
+std::shared_ptr<RawEngine::Reader> RawColumnarEngine::NewReader(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Reader>(store, cf_name);
+}
+
+std::shared_ptr<RawEngine::Writer> RawColumnarEngine::NewWriter(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Writer>(store);
+}
+
+void RawColumnarEngine::SetSchema(const pb::common::Range& range, const ColumnarSchema& schema) {
+  schemas_->Set(range, schema);
+}
+
+void RawColumnarEngine::RemoveSchema(const pb::common::Range& range) { schemas_->Remove(range); }
+
+std::shared_ptr<ColumnStore> RawColumnarEngine::GetStore(const std::string& cf_name) {
+  auto iter = stores_.find(cf_name);
+  if (iter == stores_.end()) {
+    LOG(ERROR) << butil::StringPrintf("column family %s not found", cf_name.c_str());
+    return nullptr;
+  }
+  return iter->second;
+}
+
+ColumnStore::View RawColumnarEngine::Reader::GetView(std::shared_ptr<dingodb::Snapshot> snapshot,
+                                                     const std::string& start_key, const std::string& end_key) const {
+  auto columnar_snapshot = std::dynamic_pointer_cast<ColumnarSnapshot>(snapshot);
+  if (columnar_snapshot != nullptr) {
+    const auto* view = columnar_snapshot->GetView(cf_name_);
+    if (view != nullptr) {
+      return *view;
+    }
+  }
+  return store_->GetView(start_key, end_key);
+}
+
+butil::Status RawColumnarEngine::Reader::KvGet(const std::string& key, std::string& value) {
+  return KvGet(nullptr, key, value);
+}
+
+butil::Status RawColumnarEngine::Reader::KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                                               std::string& value) {
+  if (key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto columnar_snapshot = std::dynamic_pointer_cast<ColumnarSnapshot>(snapshot);
+  const auto* view = columnar_snapshot != nullptr ? columnar_snapshot->GetView(cf_name_) : nullptr;
+  bool found = view != nullptr ? ColumnStore::Get(*view, key, value) : store_->Get(key, value);
+  if (!found) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+  return butil::Status();
+}
+
+butil::Status RawColumnarEngine::Reader::KvScan(const std::string& start_key, const std::string& end_key,
+                                                std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(nullptr, start_key, end_key, kvs);
+}
+
+butil::Status RawColumnarEngine::Reader::KvScan(std::shared_ptr<dingodb::Snapshot> snapshot,
+                                                const std::string& start_key, const std::string& end_key,
+                                                std::vector<pb::common::KeyValue>& kvs) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("begin_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  for (ColumnStore::Iterator iter(GetView(snapshot, start_key, end_key), start_key, end_key); iter.Valid();
+       iter.Next()) {
+    pb::common::KeyValue kv;
+    kv.set_key(iter.key());
+    kv.set_value(iter.value());
+
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawColumnarEngine::Reader::KvCount(const std::string& start_key, const std::string& end_key,
+                                                 int64_t& count) {
+  return KvCount(nullptr, start_key, end_key, count);
+}
+
+butil::Status RawColumnarEngine::Reader::KvCount(std::shared_ptr<dingodb::Snapshot> snapshot,
+                                                 const std::string& start_key, const std::string& end_key,
+                                                 int64_t& count) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  count = 0;
+  for (ColumnStore::Iterator iter(GetView(snapshot, start_key, end_key), start_key, end_key); iter.Valid();
+       iter.Next()) {
+    count++;
+  }
+
+  return butil::Status();
+}
+
+std::shared_ptr<EngineIterator> RawColumnarEngine::Reader::NewIterator(const std::string& start_key,
+                                                                       const std::string& end_key) {
+  return std::make_shared<ColumnarIterator>(store_, start_key, end_key);
+}
+
+butil::Status RawColumnarEngine::Reader::KvScanColumns(std::shared_ptr<dingodb::Snapshot> snapshot,
+                                                       const std::string& start_key, const std::string& end_key,
+                                                       const std::vector<uint32_t>& columns,
+                                                       const std::vector<ColumnPredicate>& predicates,
+                                                       ColumnBatch& batch) {
+  if (start_key.empty() || end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key or end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (!store_->ScanColumns(GetView(snapshot, start_key, end_key), start_key, end_key, columns, predicates, batch)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Range is not of columnar layout");
+  }
+  return butil::Status();
+}
+
+}  // namespace dingodb
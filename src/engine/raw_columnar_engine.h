@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAW_COLUMNAR_ENGINE_H_
+#define DINGODB_ENGINE_RAW_COLUMNAR_ENGINE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bvar/bvar.h"
+#include "config/config.h"
+#include "engine/batch_writer.h"
+#include "engine/column_chunk.h"
+#include "engine/column_store.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+
+namespace dingodb {
+
+// Column oriented RawEngine for ENG_COLUMNAR tables, every column family is a ColumnStore.
+// Values of a range with schema are split into column chunks, so scans of a few columns only decode
+// those columns. Nothing is persisted, regions on it are rebuilt from raft log after restart.
+class RawColumnarEngine : public RawEngine {
+ public:
+  RawColumnarEngine();
+  ~RawColumnarEngine() override;
+
+  RawColumnarEngine(const RawColumnarEngine& rhs) = delete;
+  RawColumnarEngine& operator=(const RawColumnarEngine& rhs) = delete;
+  RawColumnarEngine(RawColumnarEngine&& rhs) = delete;
+  RawColumnarEngine& operator=(RawColumnarEngine&& rhs) = delete;
+
+  // View of every column family.
+  class ColumnarSnapshot : public dingodb::Snapshot {
+   public:
+    ColumnarSnapshot(const std::map<std::string, ColumnStore::View>& views) : views_(views) {}
+    ~ColumnarSnapshot() override = default;
+
+    const ColumnStore::View* GetView(const std::string& cf_name) const {
+      auto it = views_.find(cf_name);
+      return it != views_.end() ? &it->second : nullptr;
+    }
+
+   private:
+    std::map<std::string, ColumnStore::View> views_;
+  };
+
+  class Reader : public RawEngine::Reader {
+   public:
+    Reader(std::shared_ptr<ColumnStore> store, const std::string& cf_name) : store_(store), cf_name_(cf_name) {}
+    ~Reader() override = default;
+    butil::Status KvGet(const std::string& key, std::string& value) override;
+    butil::Status KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                        std::string& value) override;
+
+    butil::Status KvScan(const std::string& start_key, const std::string& end_key,
+                         std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvScan(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                         const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+    butil::Status KvCount(const std::string& start_key, const std::string& end_key, int64_t& count) override;
+    butil::Status KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                          const std::string& end_key, int64_t& count) override;
+
+    std::shared_ptr<EngineIterator> NewIterator(const std::string& start_key, const std::string& end_key) override;
+
+    // Scan columns of rows in [start_key, end_key) matching all predicates, columns are indexes of schema.
+    butil::Status KvScanColumns(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                                const std::string& end_key, const std::vector<uint32_t>& columns,
+                                const std::vector<ColumnPredicate>& predicates, ColumnBatch& batch);
+
+    uint32_t GetID() { return static_cast<uint32_t>(EnumEngineReader::kColumnarReader); }
+
+   private:
+    ColumnStore::View GetView(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                              const std::string& end_key) const;
+
+    std::shared_ptr<ColumnStore> store_;
+    std::string cf_name_;
+  };
+
+  using Writer = BatchWriter<ColumnStore>;
+
+  bool Init(std::shared_ptr<Config> config) override;
+  std::string GetName() override;
+  pb::common::RawEngine GetID() override;
+
+  std::shared_ptr<Snapshot> GetSnapshot() override;
+  void ReleaseSnapshot(std::shared_ptr<Snapshot> snapshot) override;
+
+  // Merge buffered writes into row groups.
+  void Flush(const std::string& cf_name) override;
+  // Drop data in range directly.
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  // Rebuild row groups in range, small groups are merged.
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                   const pb::common::Range& range) override;
+
+  butil::Status SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                           std::vector<std::string>& need_reopen_options) override;  // NOLINT
+  void ReloadOptions(std::shared_ptr<Config> /*config*/) override {}
+
+  void CollectStats() override;
+
+  std::shared_ptr<RawEngine::Reader> NewReader(const std::string& cf_name) override;
+  std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name) override;
+
+  // Value columns of rows in range, set before any write of the range.
+  void SetSchema(const pb::common::Range& range, const ColumnarSchema& schema);
+  void RemoveSchema(const pb::common::Range& range);
+
+ private:
+  std::shared_ptr<ColumnStore> GetStore(const std::string& cf_name);
+
+  std::shared_ptr<ColumnarSchemaMap> schemas_;
+  std::map<std::string, std::shared_ptr<ColumnStore> > stores_;
+  // Encoded bytes and rows of row groups of every column family, prefix dingo_columnar_engine.
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > encoded_bytes_;
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > row_counts_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAW_COLUMNAR_ENGINE_H_
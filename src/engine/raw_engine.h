@@ -15,6 +15,7 @@
 #ifndef DINGODB_ENGINE_KV_ENGINE_H_
 #define DINGODB_ENGINE_KV_ENGINE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -77,6 +78,9 @@ class RawEngine {
     virtual butil::Status KvCount(const std::string& start_key, const std::string& end_key, int64_t& count) = 0;
     virtual butil::Status KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
                                   const std::string& end_key, int64_t& count) = 0;
+
+    // Iterate [start_key, end_key) without holding snapshot.
+    virtual std::shared_ptr<EngineIterator> NewIterator(const std::string& start_key, const std::string& end_key) = 0;
   };
 
   class Writer {
@@ -104,12 +108,32 @@ class RawEngine {
 
   virtual std::string GetName() = 0;
   virtual pb::common::RawEngine GetID() = 0;
+  // Data directory of engine, temporary files such as sst to ingest are put here, empty if not on disk.
+  virtual std::string GetDbPath() { return ""; }
 
   virtual std::shared_ptr<Snapshot> GetSnapshot() = 0;
   virtual void ReleaseSnapshot(std::shared_ptr<Snapshot>) = 0;
 
   virtual void Flush(const std::string& cf_name) = 0;
 
+  // Delete sst files fully in range, not through raft.
+  virtual butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) = 0;
+  virtual butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) = 0;
+
+  // Ingest sorted sst files built by SstFileWriter, file with key out of range is rejected.
+  virtual butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                           const pb::common::Range& range) = 0;
+
+  // Change options at runtime, empty cf_name is db options.
+  // Options can not change without reopen engine are not applied, return them by need_reopen_options.
+  virtual butil::Status SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                                   std::vector<std::string>& need_reopen_options) = 0;  // NOLINT
+  // Apply changed options of reloaded config.
+  virtual void ReloadOptions(std::shared_ptr<Config> config) = 0;
+
+  // Refresh engine metrics exposed by bvar.
+  virtual void CollectStats() {}
+
   virtual std::shared_ptr<Reader> NewReader(const std::string& cf_name) = 0;
   virtual std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name) = 0;
 
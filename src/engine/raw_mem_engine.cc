@@ -0,0 +1,266 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raw_mem_engine.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kColumnFamilies = "store.columnFamilies";
+
+class MemIterator : public EngineIterator {
+ public:
+  MemIterator(std::shared_ptr<MemTable> table, const std::string& start_key, const std::string& end_key)
+      : table_(table), iter_(table.get(), 0), end_key_(end_key) {
+    if (start_key.empty()) {
+      iter_.SeekToFirst();
+    } else {
+      iter_.Seek(start_key);
+    }
+  }
+  ~MemIterator() override = default;
+
+  bool HasNext() override { return iter_.Valid() && (end_key_.empty() || iter_.key() < end_key_); }
+
+  void Next() override { iter_.Next(); }
+
+  void GetKV(std::string& key, std::string& value) override {  // NOLINT
+    key = iter_.key();
+    value = iter_.value();
+  }
+
+  const std::string& GetName() const override { return name_; }
+  uint32_t GetID() override { return id_; }
+
+ private:
+  // Keep table alive while iterating.
+  std::shared_ptr<MemTable> table_;
+  MemTable::Iterator iter_;
+  std::string end_key_;
+  const std::string name_ = "MemIterator";
+  uint32_t id_ = static_cast<uint32_t>(EnumEngineIterator::kMemoryIterator);
+};
+
+RawMemEngine::RawMemEngine() = default;
+
+RawMemEngine::~RawMemEngine() = default;
+
+bool RawMemEngine::Init(std::shared_ptr<Config> config) {
+  if (!config) {
+    LOG(ERROR) << butil::StringPrintf("config empty not support!");
+    return false;
+  }
+
+  // Same column families as rocksdb, requests of all of them can be served.
+  std::vector<std::string> column_families = config->GetStringList(kColumnFamilies);
+  if (column_families.empty()) {
+    LOG(ERROR) << butil::StringPrintf("%s : empty. not found any column family", kColumnFamilies.c_str());
+    return false;
+  }
+
+  for (const auto& cf_name : column_families) {
+    tables_.emplace(cf_name, std::make_shared<MemTable>());
+    memory_usages_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                        butil::StringPrintf("dingo_mem_engine_%s_memory_bytes", cf_name.c_str()), 0));
+  }
+
+  LOG(INFO) << butil::StringPrintf("Init RawMemEngine with %lu column families", column_families.size());
+  return true;
+}
+
+std::string RawMemEngine::GetName() { return pb::common::RawEngine_Name(pb::common::RAW_ENG_MEMORY); }
+
+pb::common::RawEngine RawMemEngine::GetID() { return pb::common::RAW_ENG_MEMORY; }
+
+std::shared_ptr<Snapshot> RawMemEngine::GetSnapshot() {
+  std::map<std::string, uint64_t> seqs;
+  for (const auto& [cf_name, table] : tables_) {
+    seqs.emplace(cf_name, table->AcquireSnapshot());
+  }
+  return std::make_shared<MemSnapshot>(seqs);
+}
+
+void RawMemEngine::ReleaseSnapshot(std::shared_ptr<Snapshot> snapshot) {
+  auto mem_snapshot = std::dynamic_pointer_cast<MemSnapshot>(snapshot);
+  if (mem_snapshot == nullptr) {
+    return;
+  }
+  for (const auto& [cf_name, seq] : mem_snapshot->Sequences()) {
+    auto table = GetTable(cf_name);
+    if (table != nullptr) {
+      table->ReleaseSnapshot(seq);
+    }
+  }
+}
+
+butil::Status RawMemEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto writer = NewWriter(cf_name);
+  if (writer == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  return writer->KvDeleteRange(range);
+}
+
+butil::Status RawMemEngine::CompactRange(const std::string& cf_name, const pb::common::Range& /*range*/) {
+  if (GetTable(cf_name) == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  return butil::Status();
+}
+
+butil::Status RawMemEngine::IngestExternalFile(const std::string& /*cf_name*/,
+                                               const std::vector<std::string>& /*files*/,
+                                               const pb::common::Range& /*range*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Memory engine not support ingest sst");
+}
+
+butil::Status RawMemEngine::SetOptions(const std::string& /*cf_name*/,
+                                       const std::map<std::string, std::string>& /*options*/,
+                                       std::vector<std::string>& /*need_reopen_options*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Memory engine has no options");
+}
+
+void RawMemEngine::CollectStats() {
+  for (const auto& [cf_name, table] : tables_) {
+    memory_usages_[cf_name]->set_value(table->ApproximateMemoryUsage());
+  }
+}
+
+std::shared_ptr<RawEngine::Reader> RawMemEngine::NewReader(const std::string& cf_name) {
+  auto table = GetTable(cf_name);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Reader>(table, cf_name);
+}
+
+std::shared_ptr<RawEngine::Writer> RawMemEngine::NewWriter(const std::string& cf_name) {
+  auto table = GetTable(cf_name);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Writer>(table);
+}
+
+std::shared_ptr<MemTable> RawMemEngine::GetTable(const std::string& cf_name) {
+  auto iter = tables_.find(cf_name);
+  if (iter == tables_.end()) {
+    LOG(ERROR) << butil::StringPrintf("column family %s not found", cf_name.c_str());
+    return nullptr;
+  }
+  return iter->second;
+}
+
+uint64_t RawMemEngine::Reader::GetSequence(std::shared_ptr<dingodb::Snapshot> snapshot) const {
+  auto mem_snapshot = std::dynamic_pointer_cast<MemSnapshot>(snapshot);
+  return mem_snapshot != nullptr ? mem_snapshot->Sequence(cf_name_) : 0;
+}
+
+butil::Status RawMemEngine::Reader::KvGet(const std::string& key, std::string& value) {
+  return KvGet(nullptr, key, value);
+}
+
+butil::Status RawMemEngine::Reader::KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                                          std::string& value) {
+  if (key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (!table_->Get(key, GetSequence(snapshot), value)) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+  return butil::Status();
+}
+
+butil::Status RawMemEngine::Reader::KvScan(const std::string& start_key, const std::string& end_key,
+                                           std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(0, start_key, end_key, kvs);
+}
+
+butil::Status RawMemEngine::Reader::KvScan(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                                           const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(GetSequence(snapshot), start_key, end_key, kvs);
+}
+
+// 0 seq scan on a snapshot held by iterator.
+butil::Status RawMemEngine::Reader::KvScan(uint64_t seq, const std::string& start_key, const std::string& end_key,
+                                           std::vector<pb::common::KeyValue>& kvs) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("begin_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  MemTable::Iterator iter(table_.get(), seq);
+  for (iter.Seek(start_key); iter.Valid() && iter.key() < end_key; iter.Next()) {
+    pb::common::KeyValue kv;
+    kv.set_key(iter.key());
+    kv.set_value(iter.value());
+
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawMemEngine::Reader::KvCount(const std::string& start_key, const std::string& end_key,
+                                            int64_t& count) {
+  return KvCount(0, start_key, end_key, count);
+}
+
+butil::Status RawMemEngine::Reader::KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                                            const std::string& end_key, int64_t& count) {
+  return KvCount(GetSequence(snapshot), start_key, end_key, count);
+}
+
+butil::Status RawMemEngine::Reader::KvCount(uint64_t seq, const std::string& start_key, const std::string& end_key,
+                                            int64_t& count) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  MemTable::Iterator iter(table_.get(), seq);
+  for (iter.Seek(start_key), count = 0; iter.Valid() && iter.key() < end_key; iter.Next()) {
+    count++;
+  }
+
+  return butil::Status();
+}
+
+std::shared_ptr<EngineIterator> RawMemEngine::Reader::NewIterator(const std::string& start_key,
+                                                                  const std::string& end_key) {
+  return std::make_shared<MemIterator>(table_, start_key, end_key);
+}
+
+}  // namespace dingodb
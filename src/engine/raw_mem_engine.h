@@ -0,0 +1,126 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAW_MEM_ENGINE_H_
+#define DINGODB_ENGINE_RAW_MEM_ENGINE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bvar/bvar.h"
+#include "config/config.h"
+#include "engine/batch_writer.h"
+#include "engine/mem_table.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+
+namespace dingodb {
+
+// In-memory RawEngine, every column family is a MemTable. Nothing is persisted, regions on it
+// are rebuilt from raft log after restart.
+class RawMemEngine : public RawEngine {
+ public:
+  RawMemEngine();
+  ~RawMemEngine() override;
+
+  RawMemEngine(const RawMemEngine& rhs) = delete;
+  RawMemEngine& operator=(const RawMemEngine& rhs) = delete;
+  RawMemEngine(RawMemEngine&& rhs) = delete;
+  RawMemEngine& operator=(RawMemEngine&& rhs) = delete;
+
+  // Sequence of every column family.
+  class MemSnapshot : public dingodb::Snapshot {
+   public:
+    MemSnapshot(const std::map<std::string, uint64_t>& seqs) : seqs_(seqs) {}
+    ~MemSnapshot() override = default;
+
+    uint64_t Sequence(const std::string& cf_name) const {
+      auto it = seqs_.find(cf_name);
+      return it != seqs_.end() ? it->second : 0;
+    }
+    const std::map<std::string, uint64_t>& Sequences() const { return seqs_; }
+
+   private:
+    std::map<std::string, uint64_t> seqs_;
+  };
+
+  class Reader : public RawEngine::Reader {
+   public:
+    Reader(std::shared_ptr<MemTable> table, const std::string& cf_name) : table_(table), cf_name_(cf_name) {}
+    ~Reader() override = default;
+    butil::Status KvGet(const std::string& key, std::string& value) override;
+    butil::Status KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                        std::string& value) override;
+
+    butil::Status KvScan(const std::string& start_key, const std::string& end_key,
+                         std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvScan(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                         const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+    butil::Status KvCount(const std::string& start_key, const std::string& end_key, int64_t& count) override;
+    butil::Status KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                          const std::string& end_key, int64_t& count) override;
+
+    std::shared_ptr<EngineIterator> NewIterator(const std::string& start_key, const std::string& end_key) override;
+
+   private:
+    butil::Status KvScan(uint64_t seq, const std::string& start_key, const std::string& end_key,
+                         std::vector<pb::common::KeyValue>& kvs);
+    butil::Status KvCount(uint64_t seq, const std::string& start_key, const std::string& end_key, int64_t& count);
+    uint64_t GetSequence(std::shared_ptr<dingodb::Snapshot> snapshot) const;
+
+    std::shared_ptr<MemTable> table_;
+    std::string cf_name_;
+  };
+
+  using Writer = BatchWriter<MemTable>;
+
+  bool Init(std::shared_ptr<Config> config) override;
+  std::string GetName() override;
+  pb::common::RawEngine GetID() override;
+
+  std::shared_ptr<Snapshot> GetSnapshot() override;
+  void ReleaseSnapshot(std::shared_ptr<Snapshot> snapshot) override;
+
+  // Nothing to flush or compact.
+  void Flush(const std::string& cf_name) override {}
+  // Drop data in range directly.
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                   const pb::common::Range& range) override;
+
+  butil::Status SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                           std::vector<std::string>& need_reopen_options) override;  // NOLINT
+  void ReloadOptions(std::shared_ptr<Config> config) override {}
+
+  void CollectStats() override;
+
+  std::shared_ptr<RawEngine::Reader> NewReader(const std::string& cf_name) override;
+  std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name) override;
+
+ private:
+  std::shared_ptr<MemTable> GetTable(const std::string& cf_name);
+
+  std::map<std::string, std::shared_ptr<MemTable> > tables_;
+  // Memory usage of every column family, prefix dingo_mem_engine.
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > memory_usages_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAW_MEM_ENGINE_H_
@@ -14,6 +14,7 @@
 
 #include "engine/raw_rocks_engine.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
@@ -21,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -28,18 +30,29 @@
 #include <utility>
 #include <vector>
 
+#include "butil/strings/string_util.h"
 #include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+#include "common/constant.h"
 #include "config/config_manager.h"
+#include "engine/dead_range.h"
 #include "engine/engine.h"
+#include "engine/mvcc.h"
 #include "engine/raft_kv_engine.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_stats.h"
+#include "engine/ttl.h"
 #include "glog/logging.h"
 #include "proto/error.pb.h"
 #include "rocksdb/advanced_options.h"
 #include "rocksdb/cache.h"
+#include "rocksdb/compaction_filter.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
+#include "rocksdb/memtablerep.h"
 #include "rocksdb/slice.h"
+#include "rocksdb/sst_file_reader.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "rocksdb/write_batch.h"
@@ -97,12 +110,132 @@ class RocksIterator : public EngineIterator {
   std::string end_key_;
 };
 
+// Drop mvcc versions shadowed by a newer version which is not newer than gc safe point.
+// Keys arrive in order within one compaction, so versions of one user key are adjacent and newest first.
+// Versions in dead ranges are dropped too.
+class MvccGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit MvccGcCompactionFilter(uint64_t safe_point, std::shared_ptr<const DeadRange::RangeMap> dead_ranges)
+      : safe_point_(safe_point), dead_ranges_(dead_ranges) {}
+  ~MvccGcCompactionFilter() override = default;
+
+  bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& /*existing_value*/,
+              std::string* /*new_value*/, bool* /*value_changed*/) const override {
+    if (DeadRange::Contains(*dead_ranges_, key.ToStringView())) {
+      return true;
+    }
+
+    std::string_view prefix;
+    uint64_t ts = 0;
+    if (!Mvcc::SplitKey(key.ToStringView(), prefix, ts)) {
+      return false;
+    }
+
+    if (prefix != last_prefix_) {
+      last_prefix_ = prefix;
+      found_visible_ = false;
+    }
+
+    if (ts > safe_point_) {
+      return false;
+    }
+
+    // The newest version below safe point is kept, older ones are invisible to any reader.
+    if (found_visible_) {
+      return true;
+    }
+    found_visible_ = true;
+
+    return false;
+  }
+
+  const char* Name() const override { return "MvccGcCompactionFilter"; }
+
+ private:
+  uint64_t safe_point_;
+  std::shared_ptr<const DeadRange::RangeMap> dead_ranges_;
+  mutable std::string last_prefix_;
+  mutable bool found_visible_ = false;
+};
+
+class MvccGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& /*context*/) override {
+    return std::make_unique<MvccGcCompactionFilter>(Mvcc::GetSafePoint(), DeadRange::GetMvcc());
+  }
+
+  const char* Name() const override { return "MvccGcCompactionFilterFactory"; }
+};
+
+// Drop expired values of ttl column family, readers filter the expired ones not yet compacted.
+class TtlCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit TtlCompactionFilter(int64_t now, std::shared_ptr<const DeadRange::RangeMap> dead_ranges)
+      : now_(now), dead_ranges_(dead_ranges) {}
+  ~TtlCompactionFilter() override = default;
+
+  bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+              std::string* /*new_value*/, bool* /*value_changed*/) const override {
+    return Ttl::IsExpired(existing_value.ToStringView(), now_) ||
+           DeadRange::Contains(*dead_ranges_, key.ToStringView());
+  }
+
+  const char* Name() const override { return "TtlCompactionFilter"; }
+
+ private:
+  int64_t now_;
+  std::shared_ptr<const DeadRange::RangeMap> dead_ranges_;
+};
+
+class TtlCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& /*context*/) override {
+    return std::make_unique<TtlCompactionFilter>(butil::gettimeofday_ms(), DeadRange::Get());
+  }
+
+  const char* Name() const override { return "TtlCompactionFilterFactory"; }
+};
+
+// Drop data of dropped tables and regions, the dead ranges are pushed from coordinator.
+class DeadRangeCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit DeadRangeCompactionFilter(std::shared_ptr<const DeadRange::RangeMap> dead_ranges)
+      : dead_ranges_(dead_ranges) {}
+  ~DeadRangeCompactionFilter() override = default;
+
+  bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& /*existing_value*/,
+              std::string* /*new_value*/, bool* /*value_changed*/) const override {
+    return DeadRange::Contains(*dead_ranges_, key.ToStringView());
+  }
+
+  const char* Name() const override { return "DeadRangeCompactionFilter"; }
+
+ private:
+  std::shared_ptr<const DeadRange::RangeMap> dead_ranges_;
+};
+
+class DeadRangeCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& /*context*/) override {
+    return std::make_unique<DeadRangeCompactionFilter>(DeadRange::Get());
+  }
+
+  const char* Name() const override { return "DeadRangeCompactionFilterFactory"; }
+};
+
 static const std::string kDbPath = "store.dbPath";
 static const std::string kColumnFamilies = "store.columnFamilies";
 static const std::string kBaseColumnFamily = "store.base";
+static const std::string kMemoryBudget = "store.memoryBudget";
+static const std::string kWriteBufferRatio = "store.writeBufferRatio";
+static const std::string kBlockCacheType = "store.blockCacheType";
+static const std::string kPerfContextSampleRate = "store.perfContextSampleRate";
+static const std::string kDbOptions = "store.dbOptions";
 
 static const char* kBlockSize = "block_size";
-static const char* kBlockCache = "block_cache";
 static const char* kArenaBlockSize = "arena_block_size";
 static const char* kMinWriteBufferNumberToMerge = "min_write_buffer_number_to_merge";
 static const char* kMaxWriteBufferNumber = "max_write_buffer_number";
@@ -111,6 +244,126 @@ static const char* kWriteBufferSize = "write_buffer_size";
 static const char* kPrefixExtractor = "prefix_extractor";
 static const char* kMaxBytesForLevelBase = "max_bytes_for_level_base";
 static const char* kTargetFileSizeBase = "target_file_size_base";
+static const char* kVectorMemtable = "vector_memtable";
+static const char* kPrefixExtractorType = "prefix_extractor_type";
+static const char* kFilterPolicy = "filter_policy";
+static const char* kFilterBitsPerKey = "filter_bits_per_key";
+static const char* kWholeKeyFiltering = "whole_key_filtering";
+static const char* kPartitionFilters = "partition_filters";
+static const char* kCompressionPerLevel = "compression_per_level";
+static const char* kZstdMaxDictBytes = "zstd_max_dict_bytes";
+static const char* kEnableBlobFiles = "enable_blob_files";
+static const char* kMinBlobSize = "min_blob_size";
+static const char* kBlobFileSize = "blob_file_size";
+static const char* kBlobCompressionType = "blob_compression_type";
+static const char* kEnableBlobGarbageCollection = "enable_blob_garbage_collection";
+static const char* kBlobGarbageCollectionAgeCutoff = "blob_garbage_collection_age_cutoff";
+static const char* kBlobGarbageCollectionForceThreshold = "blob_garbage_collection_force_threshold";
+
+// Options of dingo self, build table factory or memtable factory, can not change without reopen.
+static const std::set<std::string> kReopenOptions = {
+    kBlockSize,          kPrefixExtractor,   kPrefixExtractorType, kVectorMemtable,      kFilterPolicy,
+    kFilterBitsPerKey,   kWholeKeyFiltering, kPartitionFilters,    kCompressionPerLevel, kZstdMaxDictBytes,
+};
+
+// Rocksdb options can not change on a live db, SetOptions/SetDBOptions reject them.
+static const std::set<std::string> kImmutableCfOptions = {
+    "comparator",
+    "merge_operator",
+    "compaction_filter",
+    "compaction_filter_factory",
+    "memtable_factory",
+    "table_factory",
+    "num_levels",
+    "min_write_buffer_number_to_merge",
+    "max_write_buffer_number_to_maintain",
+    "max_write_buffer_size_to_maintain",
+    "inplace_update_support",
+    "bloom_locality",
+    "compaction_style",
+    "compaction_pri",
+    "level_compaction_dynamic_level_bytes",
+    "optimize_filters_for_hits",
+    "force_consistency_checks",
+    "memtable_insert_with_hint_prefix_extractor",
+    "sst_partitioner_factory",
+    "blob_cache",
+    "persist_user_defined_timestamps",
+};
+
+static const std::set<std::string> kImmutableDbOptions = {
+    "create_if_missing",
+    "create_missing_column_families",
+    "error_if_exists",
+    "paranoid_checks",
+    "max_file_opening_threads",
+    "use_fsync",
+    "db_log_dir",
+    "wal_dir",
+    "table_cache_numshardbits",
+    "WAL_ttl_seconds",
+    "WAL_size_limit_MB",
+    "max_manifest_file_size",
+    "manifest_preallocation_size",
+    "allow_mmap_reads",
+    "allow_mmap_writes",
+    "use_direct_reads",
+    "use_direct_io_for_flush_and_compaction",
+    "allow_fallocate",
+    "is_fd_close_on_exec",
+    "advise_random_on_open",
+    "db_write_buffer_size",
+    "use_adaptive_mutex",
+    "enable_thread_tracking",
+    "enable_pipelined_write",
+    "unordered_write",
+    "allow_concurrent_memtable_write",
+    "enable_write_thread_adaptive_yield",
+    "write_thread_max_yield_usec",
+    "write_thread_slow_yield_usec",
+    "skip_stats_update_on_db_open",
+    "skip_checking_sst_file_sizes_on_db_open",
+    "wal_recovery_mode",
+    "allow_2pc",
+    "row_cache",
+    "manual_wal_flush",
+    "atomic_flush",
+    "two_write_queues",
+    "max_log_file_size",
+    "log_file_time_to_roll",
+    "keep_log_file_num",
+    "recycle_log_file_num",
+    "info_log_level",
+    "wal_compression",
+    "persist_stats_to_disk",
+    "best_efforts_recovery",
+    "max_bgerror_resume_count",
+    "bgerror_resume_retry_interval",
+    "allow_ingest_behind",
+    "avoid_unnecessary_blocking_io",
+    "fail_if_options_file_error",
+    "dump_malloc_stats",
+    "random_access_max_buffer_size",
+    "enforce_single_del_contracts",
+};
+
+// Partition size of index and filter when partition_filters enable.
+static const uint64_t kPartitionMetadataBlockSize = 4096;
+// Sample data size for training zstd dictionary, 100x dictionary size is recommend by rocksdb.
+static const int kZstdTrainBytesFactor = 100;
+
+// Memory budget of the store, used when not set in config.
+static const int kDefaultMemoryBudgetMb = 1024;
+static const int kDefaultWriteBufferRatio = 50;
+static const char* kHyperClockCache = "hyper_clock";
+// Usually the block size, hyper clock cache need it to size the table.
+static const size_t kHyperClockCacheEstimatedEntryCharge = 131072;
+
+// Bulk load mode lift write limits, l0 files pile up until the mode end.
+static const int kBulkLoadWriteBufferSizeFactor = 4;
+static const int kBulkLoadMaxWriteBufferNumber = 6;
+static const int kBulkLoadLevel0SlowdownWritesTrigger = 1024;
+static const int kBulkLoadLevel0StopWritesTrigger = 2048;
 
 RawRocksEngine::RawRocksEngine() : txn_db_(nullptr), column_familys_({}) {}
 
@@ -143,6 +396,10 @@ bool RawRocksEngine::Init(std::shared_ptr<Config> config) {
 
   SetColumnFamilyFromConfig(config, column_family);
 
+  InitMemoryBudget(config);
+
+  db_conf_ = config->GetStringMap(kDbOptions);
+  db_path_ = store_db_path_value;
   std::vector<rocksdb::ColumnFamilyHandle*> family_handles;
   bool ret = RocksdbInit(store_db_path_value, column_family, family_handles);
   if (!ret) {
@@ -152,6 +409,14 @@ bool RawRocksEngine::Init(std::shared_ptr<Config> config) {
 
   SetColumnFamilyHandle(column_family, family_handles);
 
+  std::map<std::string, rocksdb::ColumnFamilyHandle*> handles;
+  for (const auto& [cf_name, cf] : column_familys_) {
+    handles.emplace(cf_name, cf->GetHandle());
+  }
+  rocks_stats_ = std::make_shared<RocksStats>(txn_db_, statistics_, block_cache_, handles);
+
+  PerfContextSampler::SetSampleRate(config->GetInt(kPerfContextSampleRate));
+
   DLOG(INFO) << butil::StringPrintf("rocksdb::DB::Open : %s success!", store_db_path_value.c_str());
 
   return true;
@@ -179,6 +444,364 @@ void RawRocksEngine::Flush(const std::string& cf_name) {
   }
 }
 
+butil::Status RawRocksEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family");
+  }
+
+  rocksdb::Slice slice_begin(range.start_key());
+  rocksdb::Slice slice_end(range.end_key());
+  rocksdb::Status s =
+      rocksdb::DeleteFilesInRange(txn_db_.get(), column_family->GetHandle(), &slice_begin, &slice_end, false);
+  if (!s.ok()) {
+    LOG(ERROR) << butil::StringPrintf("rocksdb::DeleteFilesInRange failed : %s", s.ToString().c_str());
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawRocksEngine::CompactRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family");
+  }
+
+  rocksdb::CompactRangeOptions compact_options;
+  rocksdb::Slice slice_begin(range.start_key());
+  rocksdb::Slice slice_end(range.end_key());
+  rocksdb::Status s = txn_db_->CompactRange(compact_options, column_family->GetHandle(), &slice_begin, &slice_end);
+  if (!s.ok()) {
+    LOG(ERROR) << butil::StringPrintf("rocksdb::TransactionDB::CompactRange failed : %s", s.ToString().c_str());
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  return butil::Status();
+}
+
+// Check the first and last key of sst file, it is sorted.
+static butil::Status CheckSstFileRange(const std::string& file, const pb::common::Range& range) {
+  rocksdb::SstFileReader reader(rocksdb::Options{});
+  rocksdb::Status s = reader.Open(file);
+  if (!s.ok()) {
+    LOG(ERROR) << butil::StringPrintf("rocksdb::SstFileReader::Open %s failed : %s", file.c_str(),
+                                      s.ToString().c_str());
+    return butil::Status(pb::error::EINTERNAL, "Open sst file failed");
+  }
+
+  std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EINTERNAL, "Sst file is empty");
+  }
+  if (iter->key().ToStringView() < range.start_key()) {
+    return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "Sst key out of range");
+  }
+
+  iter->SeekToLast();
+  if (!range.end_key().empty() && iter->key().ToStringView() >= range.end_key()) {
+    return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "Sst key out of range");
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawRocksEngine::IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                                 const pb::common::Range& range) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found column family");
+  }
+
+  for (const auto& file : files) {
+    auto status = CheckSstFileRange(file, range);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // Files are private to this ingest, move instead of copy.
+  rocksdb::IngestExternalFileOptions ingest_options;
+  ingest_options.move_files = true;
+  rocksdb::Status s = txn_db_->IngestExternalFile(column_family->GetHandle(), files, ingest_options);
+  if (!s.ok()) {
+    LOG(ERROR) << butil::StringPrintf("rocksdb::TransactionDB::IngestExternalFile failed : %s", s.ToString().c_str());
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  return butil::Status();
+}
+
+void RawRocksEngine::CollectStats() {
+  if (rocks_stats_ != nullptr) {
+    rocks_stats_->Collect();
+  }
+}
+
+// Value of dingo option to rocksdb option string, blob_compression_type is a name as compression_per_level.
+static bool ToRocksOptionValue(const std::string& name, const std::string& value, std::string& rocks_value) {  // NOLINT
+  static const std::map<std::string, std::string> kCompressionNames = {
+      {"none", "kNoCompression"}, {"snappy", "kSnappyCompression"}, {"zlib", "kZlibCompression"},
+      {"lz4", "kLZ4Compression"}, {"lz4hc", "kLZ4HCCompression"},   {"zstd", "kZSTD"},
+  };
+
+  if (name != kBlobCompressionType) {
+    rocks_value = value;
+    return true;
+  }
+  auto iter = kCompressionNames.find(value);
+  if (iter == kCompressionNames.end()) {
+    return false;
+  }
+  rocks_value = iter->second;
+  return true;
+}
+
+// Known immutable options are returned by need_reopen_options without applying, the others are applied by one
+// rocksdb call which parses and validates all of them first, so either all are applied or none.
+butil::Status RawRocksEngine::SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                                         std::vector<std::string>& need_reopen_options) {
+  std::lock_guard<std::mutex> lock(options_mutex_);
+
+  if (cf_name.empty()) {
+    std::unordered_map<std::string, std::string> db_options;
+    for (const auto& [name, value] : options) {
+      if (kImmutableDbOptions.find(name) != kImmutableDbOptions.end()) {
+        need_reopen_options.push_back(name);
+        continue;
+      }
+      db_options.emplace(name, value);
+    }
+    if (db_options.empty()) {
+      return butil::Status();
+    }
+
+    rocksdb::Status s = txn_db_->SetDBOptions(db_options);
+    if (!s.ok()) {
+      LOG(ERROR) << butil::StringPrintf("set db options failed : %s", s.ToString().c_str());
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s.ToString());
+    }
+    for (const auto& [name, value] : db_options) {
+      db_conf_[name] = value;
+      LOG(INFO) << butil::StringPrintf("set db option %s=%s", name.c_str(), value.c_str());
+    }
+    return butil::Status();
+  }
+
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+  }
+
+  // In bulk load mode, the saved options take effect when mode end.
+  auto saved_options = bulk_load_saved_options_.find(cf_name);
+  std::unordered_map<std::string, std::string> cf_options;
+  std::map<std::string, std::string> bulk_load_deferred_options;
+  for (const auto& [name, value] : options) {
+    if (kReopenOptions.find(name) != kReopenOptions.end() ||
+        kImmutableCfOptions.find(name) != kImmutableCfOptions.end()) {
+      need_reopen_options.push_back(name);
+      continue;
+    }
+
+    if (saved_options != bulk_load_saved_options_.end() && saved_options->second.count(name) > 0) {
+      bulk_load_deferred_options.emplace(name, value);
+      continue;
+    }
+
+    std::string rocks_value;
+    if (!ToRocksOptionValue(name, value, rocks_value)) {
+      LOG(ERROR) << butil::StringPrintf("set cf %s option %s=%s failed : unknown value", cf_name.c_str(), name.c_str(),
+                                        value.c_str());
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Unknown option value");
+    }
+    cf_options.emplace(name, rocks_value);
+  }
+
+  if (!cf_options.empty()) {
+    rocksdb::Status s = txn_db_->SetOptions(column_family->GetHandle(), cf_options);
+    if (!s.ok()) {
+      LOG(ERROR) << butil::StringPrintf("set cf %s options failed : %s", cf_name.c_str(), s.ToString().c_str());
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s.ToString());
+    }
+  }
+
+  std::map<std::string, std::string> conf = column_family->GetConf();
+  for (const auto& [name, value] : options) {
+    if (cf_options.count(name) > 0 || bulk_load_deferred_options.count(name) > 0) {
+      conf[name] = value;
+      LOG(INFO) << butil::StringPrintf("set cf %s option %s=%s", cf_name.c_str(), name.c_str(), value.c_str());
+    }
+  }
+  for (const auto& [name, value] : bulk_load_deferred_options) {
+    saved_options->second[name] = value;
+  }
+  column_family->SetConf(conf);
+
+  return butil::Status();
+}
+
+// Only changed or added options are applied, removed option keep the current value.
+void RawRocksEngine::ReloadOptions(std::shared_ptr<Config> config) {
+  auto reload = [this](const std::string& cf_name, const std::map<std::string, std::string>& new_conf,
+                       const std::map<std::string, std::string>& conf) {
+    std::map<std::string, std::string> changed_options;
+    for (const auto& [name, value] : new_conf) {
+      auto it = conf.find(name);
+      if (it == conf.end() || it->second != value) {
+        changed_options.emplace(name, value);
+      }
+    }
+    if (changed_options.empty()) {
+      return;
+    }
+
+    std::vector<std::string> need_reopen_options;
+    auto status = SetOptions(cf_name, changed_options, need_reopen_options);
+    const char* target = cf_name.empty() ? "db" : cf_name.c_str();
+    if (!status.ok()) {
+      LOG(ERROR) << butil::StringPrintf("reload %s options failed : %s", target, status.error_cstr());
+    }
+    for (const auto& name : need_reopen_options) {
+      LOG(WARNING) << butil::StringPrintf("%s option %s need restart to take effect", target, name.c_str());
+    }
+  };
+
+  std::map<std::string, std::string> db_conf;
+  {
+    std::lock_guard<std::mutex> lock(options_mutex_);
+    db_conf = db_conf_;
+  }
+  reload("", config->GetStringMap(kDbOptions), db_conf);
+
+  const std::map<std::string, std::string>& base_cf_configuration = config->GetStringMap(kBaseColumnFamily);
+  for (const auto& [cf_name, column_family] : column_familys_) {
+    std::map<std::string, std::string> new_cf_configuration;
+    CreateNewMap(base_cf_configuration, config->GetStringMap("store." + cf_name), new_cf_configuration);
+    reload(cf_name, new_cf_configuration, column_family->GetConf());
+  }
+}
+
+rocksdb::DBOptions RawRocksEngine::GetDBOptions() { return txn_db_->GetDBOptions(); }
+
+rocksdb::ColumnFamilyOptions RawRocksEngine::GetCfOptions(const std::string& cf_name) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return rocksdb::ColumnFamilyOptions();
+  }
+  return txn_db_->GetOptions(column_family->GetHandle());
+}
+
+// Save the current mutable options, then lift write limits and stop auto compaction.
+// When the mode end, restore the options and compact the whole column family once in background.
+butil::Status RawRocksEngine::SetBulkLoadMode(const std::string& cf_name, bool enable) {
+  auto column_family = GetColumnFamily(cf_name);
+  if (column_family == nullptr) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Not found column family");
+  }
+
+  rocksdb::Status s;
+  {
+    std::lock_guard<std::mutex> lock(options_mutex_);
+    auto it = bulk_load_saved_options_.find(cf_name);
+    if (enable == (it != bulk_load_saved_options_.end())) {
+      return butil::Status();
+    }
+
+    if (enable) {
+      rocksdb::ColumnFamilyOptions cf_options = txn_db_->GetOptions(column_family->GetHandle());
+      std::unordered_map<std::string, std::string> saved_options = {
+          {"disable_auto_compactions", cf_options.disable_auto_compactions ? "true" : "false"},
+          {"write_buffer_size", std::to_string(cf_options.write_buffer_size)},
+          {"max_write_buffer_number", std::to_string(cf_options.max_write_buffer_number)},
+          {"level0_slowdown_writes_trigger", std::to_string(cf_options.level0_slowdown_writes_trigger)},
+          {"level0_stop_writes_trigger", std::to_string(cf_options.level0_stop_writes_trigger)},
+          {"soft_pending_compaction_bytes_limit", std::to_string(cf_options.soft_pending_compaction_bytes_limit)},
+          {"hard_pending_compaction_bytes_limit", std::to_string(cf_options.hard_pending_compaction_bytes_limit)},
+      };
+
+      std::unordered_map<std::string, std::string> bulk_load_options = {
+          {"disable_auto_compactions", "true"},
+          {"write_buffer_size", std::to_string(cf_options.write_buffer_size * kBulkLoadWriteBufferSizeFactor)},
+          {"max_write_buffer_number",
+           std::to_string(std::max(cf_options.max_write_buffer_number, kBulkLoadMaxWriteBufferNumber))},
+          {"level0_slowdown_writes_trigger", std::to_string(kBulkLoadLevel0SlowdownWritesTrigger)},
+          {"level0_stop_writes_trigger", std::to_string(kBulkLoadLevel0StopWritesTrigger)},
+          {"soft_pending_compaction_bytes_limit", "0"},
+          {"hard_pending_compaction_bytes_limit", "0"},
+      };
+
+      s = txn_db_->SetOptions(column_family->GetHandle(), bulk_load_options);
+      if (s.ok()) {
+        bulk_load_saved_options_.emplace(cf_name, std::move(saved_options));
+      }
+    } else {
+      s = txn_db_->SetOptions(column_family->GetHandle(), it->second);
+      if (s.ok()) {
+        bulk_load_saved_options_.erase(it);
+      }
+    }
+  }
+
+  if (!s.ok()) {
+    LOG(ERROR) << butil::StringPrintf("set bulk load mode %d of cf %s failed : %s", enable, cf_name.c_str(),
+                                      s.ToString().c_str());
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  // Full compaction is long, not hold options_mutex_ and not block the caller.
+  if (!enable) {
+    std::lock_guard<std::mutex> lock(bulk_load_compact_mutex_);
+    if (!bulk_load_compact_thread_.joinable()) {
+      bulk_load_compact_thread_ = std::thread(&RawRocksEngine::BulkLoadCompactWorker, this);
+    }
+    bulk_load_compact_cfs_.insert(cf_name);
+    bulk_load_compact_cond_.notify_one();
+  }
+
+  LOG(INFO) << butil::StringPrintf("set bulk load mode %d of cf %s", enable, cf_name.c_str());
+  return butil::Status();
+}
+
+// A column family queued again while being compacted is compacted once more, it may have new bulk loaded files.
+void RawRocksEngine::BulkLoadCompactWorker() {
+  for (;;) {
+    std::string cf_name;
+    {
+      std::unique_lock<std::mutex> lock(bulk_load_compact_mutex_);
+      bulk_load_compact_cond_.wait(lock,
+                                   [this]() { return bulk_load_compact_stopped_ || !bulk_load_compact_cfs_.empty(); });
+      if (bulk_load_compact_stopped_) {
+        break;
+      }
+      cf_name = *bulk_load_compact_cfs_.begin();
+      bulk_load_compact_cfs_.erase(bulk_load_compact_cfs_.begin());
+    }
+
+    auto column_family = GetColumnFamily(cf_name);
+    if (column_family == nullptr) {
+      continue;
+    }
+
+    rocksdb::CompactRangeOptions compact_options;
+    compact_options.exclusive_manual_compaction = false;
+    compact_options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForceOptimized;
+    rocksdb::Status s = txn_db_->CompactRange(compact_options, column_family->GetHandle(), nullptr, nullptr);
+    if (!s.ok()) {
+      LOG(ERROR) << butil::StringPrintf("compact cf %s after bulk load failed : %s", cf_name.c_str(),
+                                        s.ToString().c_str());
+      continue;
+    }
+    LOG(INFO) << butil::StringPrintf("compact cf %s after bulk load finished", cf_name.c_str());
+  }
+}
+
+bool RawRocksEngine::IsBulkLoadMode(const std::string& cf_name) {
+  std::lock_guard<std::mutex> lock(options_mutex_);
+  return bulk_load_saved_options_.find(cf_name) != bulk_load_saved_options_.end();
+}
+
 std::shared_ptr<RawEngine::Reader> RawRocksEngine::NewReader(const std::string& cf_name) {
   auto column_family = GetColumnFamily(cf_name);
   if (column_family == nullptr) {
@@ -197,6 +820,18 @@ std::shared_ptr<RawEngine::Writer> RawRocksEngine::NewWriter(const std::string&
 
 void RawRocksEngine::Close() {
   if (txn_db_) {
+    // Abort running compactions after bulk load, column family handles are destroyed below.
+    txn_db_->DisableManualCompaction();
+    {
+      std::lock_guard<std::mutex> lock(bulk_load_compact_mutex_);
+      bulk_load_compact_stopped_ = true;
+      bulk_load_compact_cfs_.clear();
+    }
+    bulk_load_compact_cond_.notify_all();
+    if (bulk_load_compact_thread_.joinable()) {
+      bulk_load_compact_thread_.join();
+    }
+
     for (const auto& [_, cf] : column_familys_) {
       txn_db_->DestroyColumnFamilyHandle(cf->GetHandle());
     }
@@ -268,12 +903,115 @@ void SetCfConfigurationElementWrapper(const RawRocksEngine::CfDefaultConf& defau
   }
 }
 
+void SetCfConfigurationElementWrapper(const RawRocksEngine::CfDefaultConf& default_conf,
+                                      const std::map<std::string, std::string>& cf_configuration, const char* name,
+                                      std::string& value) {  // NOLINT
+  if (auto iter = default_conf.find(name); iter != default_conf.end()) {
+    if (iter->second.has_value()) {
+      value = std::get<std::string>(iter->second.value());
+    }
+  }
+
+  if (auto iter = cf_configuration.find(name); iter != cf_configuration.end()) {
+    value = iter->second;
+  }
+}
+
+void SetCfConfigurationElementWrapper(const RawRocksEngine::CfDefaultConf& default_conf,
+                                      const std::map<std::string, std::string>& cf_configuration, const char* name,
+                                      double& value) {  // NOLINT
+  if (auto iter = default_conf.find(name); iter != default_conf.end()) {
+    if (iter->second.has_value()) {
+      value = std::get<double>(iter->second.value());
+    }
+  }
+
+  if (auto iter = cf_configuration.find(name); iter != cf_configuration.end()) {
+    try {
+      value = std::stod(iter->second);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << butil::StringPrintf("%s trans string to double failed : %s", iter->second.c_str(), e.what());
+    }
+  }
+}
+
+// compression name to rocksdb compression type, e.g. none lz4 zstd
+static bool ParseCompressionType(const std::string& name, rocksdb::CompressionType& type) {  // NOLINT
+  static const std::map<std::string, rocksdb::CompressionType> kCompressionTypes = {
+      {"none", rocksdb::CompressionType::kNoCompression},  {"snappy", rocksdb::CompressionType::kSnappyCompression},
+      {"zlib", rocksdb::CompressionType::kZlibCompression}, {"lz4", rocksdb::CompressionType::kLZ4Compression},
+      {"lz4hc", rocksdb::CompressionType::kLZ4HCCompression}, {"zstd", rocksdb::CompressionType::kZSTD},
+  };
+
+  auto iter = kCompressionTypes.find(name);
+  if (iter == kCompressionTypes.end()) {
+    return false;
+  }
+  type = iter->second;
+  return true;
+}
+
+// compression_per_level is a comma separated list, e.g. none,none,lz4,lz4,lz4,zstd,zstd
+static bool ParseCompressionPerLevel(const std::string& value,
+                                     std::vector<rocksdb::CompressionType>& compression_per_level) {  // NOLINT
+  std::vector<rocksdb::CompressionType> result;
+  std::string::size_type start = 0;
+  while (start <= value.size()) {
+    auto end = value.find(',', start);
+    if (end == std::string::npos) {
+      end = value.size();
+    }
+
+    std::string name;
+    butil::TrimWhitespaceASCII(value.substr(start, end - start), butil::TrimPositions::TRIM_ALL, &name);
+    rocksdb::CompressionType type;
+    if (!ParseCompressionType(name, type)) {
+      LOG(ERROR) << butil::StringPrintf("unknown compression type %s in %s", name.c_str(), value.c_str());
+      return false;
+    }
+    result.push_back(type);
+
+    start = end + 1;
+  }
+
+  compression_per_level.swap(result);
+  return true;
+}
+
+// One memory budget for the whole store, all column families share the block cache.
+// Memtables are charged to the block cache by the write buffer manager, so the cache
+// capacity is the total budget and memory can move between column families.
+void RawRocksEngine::InitMemoryBudget(std::shared_ptr<Config> config) {
+  int memory_budget_mb = config->GetInt(kMemoryBudget);
+  if (memory_budget_mb <= 0) {
+    memory_budget_mb = kDefaultMemoryBudgetMb;
+  }
+  int write_buffer_ratio = config->GetInt(kWriteBufferRatio);
+  if (write_buffer_ratio <= 0 || write_buffer_ratio >= 100) {
+    write_buffer_ratio = kDefaultWriteBufferRatio;
+  }
+
+  size_t capacity = static_cast<size_t>(memory_budget_mb) * 1024 * 1024;
+  size_t write_buffer_size = capacity / 100 * write_buffer_ratio;
+
+  std::string cache_type = config->GetString(kBlockCacheType);
+  if (cache_type == kHyperClockCache) {
+    rocksdb::HyperClockCacheOptions cache_options(capacity, kHyperClockCacheEstimatedEntryCharge);
+    block_cache_ = cache_options.MakeSharedCache();
+  } else {
+    block_cache_ = rocksdb::NewLRUCache(capacity);
+  }
+
+  write_buffer_manager_ = std::make_shared<rocksdb::WriteBufferManager>(write_buffer_size, block_cache_);
+
+  LOG(INFO) << butil::StringPrintf("memory budget %zu block cache type %s write buffer %zu", capacity,
+                                   cache_type == kHyperClockCache ? kHyperClockCache : "lru", write_buffer_size);
+}
+
 bool RawRocksEngine::InitCfConfig(const std::vector<std::string>& column_family) {
   CfDefaultConf dcf_default_conf;
   dcf_default_conf.emplace(kBlockSize, std::make_optional(static_cast<int64_t>(131072)));
 
-  dcf_default_conf.emplace(kBlockCache, std::make_optional(static_cast<int64_t>(67108864)));
-
   dcf_default_conf.emplace(kArenaBlockSize, std::make_optional(static_cast<int64_t>(67108864)));
 
   dcf_default_conf.emplace(kMinWriteBufferNumberToMerge, std::make_optional(static_cast<int64_t>(4)));
@@ -290,6 +1028,36 @@ bool RawRocksEngine::InitCfConfig(const std::vector<std::string>& column_family)
 
   dcf_default_conf.emplace(kTargetFileSizeBase, std::make_optional(static_cast<int64_t>(67108864)));
 
+  dcf_default_conf.emplace(kVectorMemtable, std::make_optional(static_cast<int64_t>(0)));
+
+  dcf_default_conf.emplace(kPrefixExtractorType, std::make_optional(std::string("capped")));
+
+  dcf_default_conf.emplace(kFilterPolicy, std::make_optional(std::string("bloom")));
+
+  dcf_default_conf.emplace(kFilterBitsPerKey, std::make_optional(10.0));
+
+  dcf_default_conf.emplace(kWholeKeyFiltering, std::make_optional(static_cast<int64_t>(1)));
+
+  dcf_default_conf.emplace(kPartitionFilters, std::make_optional(static_cast<int64_t>(0)));
+
+  dcf_default_conf.emplace(kCompressionPerLevel, std::make_optional(std::string("none,none,lz4,lz4,lz4,zstd,zstd")));
+
+  dcf_default_conf.emplace(kZstdMaxDictBytes, std::make_optional(static_cast<int64_t>(0)));
+
+  dcf_default_conf.emplace(kEnableBlobFiles, std::make_optional(static_cast<int64_t>(0)));
+
+  dcf_default_conf.emplace(kMinBlobSize, std::make_optional(static_cast<int64_t>(4096)));
+
+  dcf_default_conf.emplace(kBlobFileSize, std::make_optional(static_cast<int64_t>(268435456)));
+
+  dcf_default_conf.emplace(kBlobCompressionType, std::make_optional(std::string("lz4")));
+
+  dcf_default_conf.emplace(kEnableBlobGarbageCollection, std::make_optional(static_cast<int64_t>(1)));
+
+  dcf_default_conf.emplace(kBlobGarbageCollectionAgeCutoff, std::make_optional(0.25));
+
+  dcf_default_conf.emplace(kBlobGarbageCollectionForceThreshold, std::make_optional(1.0));
+
   for (const auto& cf_name : column_family) {
     std::map<std::string, std::string> conf;
     column_familys_.emplace(cf_name, std::make_shared<ColumnFamily>(cf_name, dcf_default_conf, conf));
@@ -299,8 +1067,9 @@ bool RawRocksEngine::InitCfConfig(const std::vector<std::string>& column_family)
 }
 
 // set cf config
-bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
+bool RawRocksEngine::SetCfConfiguration(const std::string& cf_name, const CfDefaultConf& default_conf,
                                         const std::map<std::string, std::string>& cf_configuration,
+                                        const std::shared_ptr<rocksdb::Cache>& block_cache,
                                         rocksdb::ColumnFamilyOptions* family_options) {
   rocksdb::ColumnFamilyOptions& cf_options = *family_options;
 
@@ -309,15 +1078,10 @@ bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
   // block_size
   SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlockSize, table_options.block_size);
 
-  // block_cache
-  {
-    size_t value = 0;
-
-    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlockCache, value);
-
-    auto cache = rocksdb::NewLRUCache(value);  // LRUcache
-    table_options.block_cache = cache;
-  }
+  // block_cache, shared by all column families, index and filter blocks are charged to it too
+  table_options.block_cache = block_cache;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.pin_l0_filter_and_index_blocks_in_cache = true;
 
   // arena_block_size
 
@@ -338,12 +1102,25 @@ bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
   // write_buffer_size
   SetCfConfigurationElementWrapper(default_conf, cf_configuration, kWriteBufferSize, cf_options.write_buffer_size);
 
-  // prefix_extractor
+  // prefix_extractor, prefix_extractor_type is fixed or capped, 0 length means no prefix extractor
   {
     size_t value = 0;
     SetCfConfigurationElementWrapper(default_conf, cf_configuration, kPrefixExtractor, value);
 
-    cf_options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(value));
+    std::string type;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kPrefixExtractorType, type);
+
+    if (value == 0) {
+      cf_options.prefix_extractor.reset();
+    } else if (type == "fixed") {
+      cf_options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(value));
+    } else {
+      if (type != "capped") {
+        LOG(ERROR) << butil::StringPrintf("cf %s unknown prefix extractor type %s, use capped", cf_name.c_str(),
+                                          type.c_str());
+      }
+      cf_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(value));
+    }
   }
 
   // max_bytes_for_level_base
@@ -354,25 +1131,119 @@ bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
   SetCfConfigurationElementWrapper(default_conf, cf_configuration, kTargetFileSizeBase,
                                    cf_options.target_file_size_base);
 
-  cf_options.compression_per_level = {
-      rocksdb::CompressionType::kNoCompression,  rocksdb::CompressionType::kNoCompression,
-      rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kLZ4Compression,
-      rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kZSTD,
-      rocksdb::CompressionType::kZSTD,
-  };
+  // vector_memtable, fast for sorted bulk writes but slow for read, memtable factory can not change at runtime
+  {
+    int value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kVectorMemtable, value);
+    if (value != 0) {
+      cf_options.memtable_factory.reset(new rocksdb::VectorRepFactory());
+    }
+  }
 
-  table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10.0, false));
-  table_options.whole_key_filtering = true;
+  // compression_per_level
+  {
+    std::string value;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kCompressionPerLevel, value);
 
-  cf_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(8));
+    if (!ParseCompressionPerLevel(value, cf_options.compression_per_level)) {
+      std::string default_value;
+      SetCfConfigurationElementWrapper(default_conf, {}, kCompressionPerLevel, default_value);
+      ParseCompressionPerLevel(default_value, cf_options.compression_per_level);
+    }
+  }
+
+  // zstd_max_dict_bytes, dictionary compression for zstd levels, 0 is disable
+  {
+    int value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kZstdMaxDictBytes, value);
+    if (value > 0) {
+      cf_options.compression_opts.max_dict_bytes = value;
+      cf_options.compression_opts.zstd_max_train_bytes = value * kZstdTrainBytesFactor;
+    }
+  }
+
+  // enable_blob_files, values not less than min_blob_size are written once to blob files, compaction only moves
+  // keys and blob references. Blob files of old ages are rewritten by compaction when garbage collection enable.
+  {
+    int value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kEnableBlobFiles, value);
+    cf_options.enable_blob_files = (value != 0);
+
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kMinBlobSize, cf_options.min_blob_size);
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlobFileSize, cf_options.blob_file_size);
+
+    std::string type;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlobCompressionType, type);
+    if (!ParseCompressionType(type, cf_options.blob_compression_type)) {
+      LOG(ERROR) << butil::StringPrintf("cf %s unknown blob compression type %s, use none", cf_name.c_str(),
+                                        type.c_str());
+      cf_options.blob_compression_type = rocksdb::CompressionType::kNoCompression;
+    }
+
+    value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kEnableBlobGarbageCollection, value);
+    cf_options.enable_blob_garbage_collection = (value != 0);
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlobGarbageCollectionAgeCutoff,
+                                     cf_options.blob_garbage_collection_age_cutoff);
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kBlobGarbageCollectionForceThreshold,
+                                     cf_options.blob_garbage_collection_force_threshold);
+
+    // Blobs are charged to the shared block cache as well.
+    cf_options.blob_cache = block_cache;
+  }
+
+  // filter_policy, bloom or ribbon or none
+  {
+    std::string type;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kFilterPolicy, type);
+
+    double bits_per_key = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kFilterBitsPerKey, bits_per_key);
+
+    if (type == "ribbon") {
+      table_options.filter_policy.reset(rocksdb::NewRibbonFilterPolicy(bits_per_key));
+    } else if (type == "none") {
+      table_options.filter_policy.reset();
+    } else {
+      if (type != "bloom") {
+        LOG(ERROR) << butil::StringPrintf("cf %s unknown filter policy %s, use bloom", cf_name.c_str(), type.c_str());
+      }
+      table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bits_per_key, false));
+    }
+  }
 
-  auto compressed_block_cache = rocksdb::NewLRUCache(1024 * 1024 * 1024);  // LRUcache
+  // whole_key_filtering
+  {
+    int value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kWholeKeyFiltering, value);
+    table_options.whole_key_filtering = (value != 0);
+  }
 
-  // table_options.block_cache_compressed.reset(compressed_block_cache);
+  // partition_filters, two level index and partitioned filter, only top level always stay in cache
+  {
+    int value = 0;
+    SetCfConfigurationElementWrapper(default_conf, cf_configuration, kPartitionFilters, value);
+    if (value != 0) {
+      table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.partition_filters = true;
+      table_options.metadata_block_size = kPartitionMetadataBlockSize;
+      table_options.cache_index_and_filter_blocks_with_high_priority = true;
+      table_options.pin_top_level_index_and_filter = true;
+    }
+  }
 
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   cf_options.table_factory.reset(table_factory);
 
+  // compaction_filter_factory
+  if (cf_name == Constant::kStoreMvccCF) {
+    cf_options.compaction_filter_factory = std::make_shared<MvccGcCompactionFilterFactory>();
+  } else if (cf_name == Constant::kStoreTtlCF) {
+    cf_options.compaction_filter_factory = std::make_shared<TtlCompactionFilterFactory>();
+  } else if (cf_name == Constant::kStoreDataCF) {
+    cf_options.compaction_filter_factory = std::make_shared<DeadRangeCompactionFilterFactory>();
+  }
+
   return true;
 }
 
@@ -413,8 +1284,8 @@ bool RawRocksEngine::RocksdbInit(const std::string& db_path, const std::vector<s
   std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
   for (const auto& column_family : column_family) {
     rocksdb::ColumnFamilyOptions family_options;
-    SetCfConfiguration(column_familys_[column_family]->GetDefaultConf(), column_familys_[column_family]->GetConf(),
-                       &family_options);
+    SetCfConfiguration(column_family, column_familys_[column_family]->GetDefaultConf(),
+                       column_familys_[column_family]->GetConf(), block_cache_, &family_options);
 
     column_families.push_back(rocksdb::ColumnFamilyDescriptor(column_family, family_options));
   }
@@ -422,8 +1293,30 @@ bool RawRocksEngine::RocksdbInit(const std::string& db_path, const std::vector<s
   rocksdb::DBOptions db_options;
   rocksdb::TransactionDBOptions txn_db_options;
 
+  // Any db option may be set at open, immutable ones included.
+  if (!db_conf_.empty()) {
+    rocksdb::ConfigOptions config_options;
+    std::unordered_map<std::string, std::string> db_conf(db_conf_.begin(), db_conf_.end());
+    rocksdb::Status s = rocksdb::GetDBOptionsFromMap(config_options, db_options, db_conf, &db_options);
+    if (!s.ok()) {
+      LOG(ERROR) << butil::StringPrintf("%s illegal : %s", kDbOptions.c_str(), s.ToString().c_str());
+      return false;
+    }
+  }
+
   db_options.create_if_missing = true;
   db_options.create_missing_column_families = true;
+  db_options.write_buffer_manager = write_buffer_manager_;
+
+  statistics_ = rocksdb::CreateDBStatistics();
+  db_options.statistics = statistics_;
+
+  // Vector memtable not support concurrent insert.
+  for (const auto& column_family : column_families) {
+    if (!column_family.options.memtable_factory->IsInsertConcurrentlySupported()) {
+      db_options.allow_concurrent_memtable_write = false;
+    }
+  }
 
   rocksdb::TransactionDB* txn_db;
   rocksdb::Status s =
@@ -536,6 +1429,7 @@ butil::Status RawRocksEngine::Reader::KvGet(std::shared_ptr<dingodb::Snapshot> s
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
+  PerfContextSampler perf_context_sampler(PerfContextOp::kGet);
   rocksdb::ReadOptions read_option;
   read_option.snapshot = std::dynamic_pointer_cast<RocksSnapshot>(snapshot)->InnerSnapshot();
   rocksdb::PinnableSlice pinnable_slice;
@@ -570,6 +1464,7 @@ butil::Status RawRocksEngine::Reader::KvScan(std::shared_ptr<dingodb::Snapshot>
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
+  PerfContextSampler perf_context_sampler(PerfContextOp::kScan);
   rocksdb::ReadOptions read_option;
   read_option.snapshot = std::dynamic_pointer_cast<RocksSnapshot>(snapshot)->InnerSnapshot();
 
@@ -618,12 +1513,23 @@ butil::Status RawRocksEngine::Reader::KvCount(std::shared_ptr<dingodb::Snapshot>
   return butil::Status();
 }
 
+std::shared_ptr<EngineIterator> RawRocksEngine::Reader::NewIterator(const std::string& start_key,
+                                                                    const std::string& end_key) {
+  rocksdb::ReadOptions read_options;
+  // range may cross prefix extractor boundary
+  read_options.total_order_seek = true;
+
+  return std::make_shared<RocksIterator>(txn_db_->NewIterator(read_options, column_family_->GetHandle()), start_key,
+                                         end_key);
+}
+
 butil::Status RawRocksEngine::Writer::KvPut(const pb::common::KeyValue& kv) {
   if (kv.key().empty()) {
     LOG(ERROR) << butil::StringPrintf("key empty  not support");
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
+  PerfContextSampler perf_context_sampler(PerfContextOp::kWrite);
   rocksdb::WriteOptions write_options;
   rocksdb::Status s =
       txn_db_->Put(write_options, column_family_->GetHandle(), rocksdb::Slice(kv.key()), rocksdb::Slice(kv.value()));
@@ -657,6 +1563,7 @@ butil::Status RawRocksEngine::Writer::KvBatchPut(const std::vector<pb::common::K
     }
   }
 
+  PerfContextSampler perf_context_sampler(PerfContextOp::kWrite);
   rocksdb::WriteOptions write_options;
   rocksdb::Status s = txn_db_->Write(write_options, &batch);
   if (!s.ok()) {
@@ -698,13 +1605,14 @@ butil::Status RawRocksEngine::Writer::KvBatchPutAndDelete(const std::vector<pb::
   }
 
   for (const auto& kv : kv_deletes) {
-    rocksdb::Status s = batch.Delete(column_family_->GetHandle(), kv.key(), kv.value());
+    rocksdb::Status s = batch.Delete(column_family_->GetHandle(), kv.key());
     if (!s.ok()) {
-      LOG(ERROR) << butil::StringPrintf("rocksdb::WriteBatch::Put failed : %s", s.ToString().c_str());
+      LOG(ERROR) << butil::StringPrintf("rocksdb::WriteBatch::Delete failed : %s", s.ToString().c_str());
       return butil::Status(pb::error::EINTERNAL, "Internal error");
     }
   }
 
+  PerfContextSampler perf_context_sampler(PerfContextOp::kWrite);
   rocksdb::WriteOptions write_options;
   rocksdb::Status s = txn_db_->Write(write_options, &batch);
   if (!s.ok()) {
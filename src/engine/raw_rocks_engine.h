@@ -15,16 +15,22 @@
 #ifndef DINGODB_ENGINE_ROCKS_KV_ENGINE_H_
 #define DINGODB_ENGINE_ROCKS_KV_ENGINE_H_
 
+#include <condition_variable>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 #include "config/config.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_stats.h"
 #include "engine/snapshot.h"
 #include "openssl/core_dispatch.h"
 #include "rocksdb/cache.h"
@@ -37,6 +43,7 @@
 #include "rocksdb/status.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/transaction_db.h"
+#include "rocksdb/write_buffer_manager.h"
 
 namespace dingodb {
 
@@ -121,6 +128,8 @@ class RawRocksEngine : public RawEngine {
     butil::Status KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
                           const std::string& end_key, int64_t& count) override;
 
+    std::shared_ptr<EngineIterator> NewIterator(const std::string& start_key, const std::string& end_key) override;
+
    private:
     std::shared_ptr<rocksdb::TransactionDB> txn_db_;
     std::shared_ptr<ColumnFamily> column_family_;
@@ -155,11 +164,30 @@ class RawRocksEngine : public RawEngine {
   bool Init(std::shared_ptr<Config> config) override;
   std::string GetName() override;
   pb::common::RawEngine GetID() override;
+  std::string GetDbPath() override { return db_path_; }
 
   std::shared_ptr<Snapshot> GetSnapshot() override;
   void ReleaseSnapshot(std::shared_ptr<Snapshot>) override;
 
   void Flush(const std::string& cf_name) override;
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                   const pb::common::Range& range) override;
+
+  butil::Status SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                           std::vector<std::string>& need_reopen_options) override;  // NOLINT
+  void ReloadOptions(std::shared_ptr<Config> config) override;
+
+  // Current options of rocksdb, not the dingo options of config.
+  rocksdb::DBOptions GetDBOptions();
+  rocksdb::ColumnFamilyOptions GetCfOptions(const std::string& cf_name);
+
+  void CollectStats() override;
+
+  // Bulk load mode for huge sorted writes through regular write path, switch at runtime.
+  butil::Status SetBulkLoadMode(const std::string& cf_name, bool enable);
+  bool IsBulkLoadMode(const std::string& cf_name);
 
   std::shared_ptr<RawEngine::Reader> NewReader(const std::string& cf_name);
   std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name);
@@ -167,17 +195,24 @@ class RawRocksEngine : public RawEngine {
  private:
   void Close();
 
+  // Compact column families queued after bulk load mode end, one at a time.
+  void BulkLoadCompactWorker();
+
   std::shared_ptr<ColumnFamily> GetColumnFamily(const std::string& cf_name);
 
   bool InitCfConfig(const std::vector<std::string>& column_family);
 
+  void InitMemoryBudget(std::shared_ptr<Config> config);
+
   // destroy rocksdb need
   rocksdb::Options db_options_;
+  std::string db_path_;
   std::shared_ptr<rocksdb::TransactionDB> txn_db_;
 
   // set cf config
-  static bool SetCfConfiguration(const CfDefaultConf& default_conf,
+  static bool SetCfConfiguration(const std::string& cf_name, const CfDefaultConf& default_conf,
                                  const std::map<std::string, std::string>& cf_configuration,
+                                 const std::shared_ptr<rocksdb::Cache>& block_cache,
                                  rocksdb::ColumnFamilyOptions* family_options);
 
   // set default column family if not exist. rockdb not allow no default
@@ -197,6 +232,27 @@ class RawRocksEngine : public RawEngine {
   void SetColumnFamilyFromConfig(const std::shared_ptr<Config>& config, const std::vector<std::string>& column_family);
 
   std::map<std::string, std::shared_ptr<ColumnFamily> > column_familys_;
+
+  std::shared_ptr<rocksdb::Statistics> statistics_;
+  std::shared_ptr<RocksStats> rocks_stats_;
+
+  // Shared by all column families, memtables are charged to block cache.
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+  std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager_;
+
+  // Protect runtime options change.
+  std::mutex options_mutex_;
+  // Db options of config and runtime change, compared on reload.
+  std::map<std::string, std::string> db_conf_;
+  // Options before bulk load mode, restore when mode end.
+  std::map<std::string, std::unordered_map<std::string, std::string> > bulk_load_saved_options_;
+
+  // Column families to compact after bulk load mode end, worker start at first use and joined when close.
+  std::mutex bulk_load_compact_mutex_;
+  std::condition_variable bulk_load_compact_cond_;
+  std::set<std::string> bulk_load_compact_cfs_;
+  bool bulk_load_compact_stopped_ = false;
+  std::thread bulk_load_compact_thread_;
 };
 
 }  // namespace dingodb
@@ -0,0 +1,340 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raw_xdp_engine.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kColumnFamilies = "store.columnFamilies";
+static const std::string kXdpPath = "store.xdpPath";
+static const std::string kXdpFileSize = "store.xdpFileSize";
+static const std::string kXdpMergeRatio = "store.xdpMergeRatio";
+static const std::string kXdpSyncWrite = "store.xdpSyncWrite";
+
+static const int kDefaultFileSizeMb = 256;
+static const int kDefaultMergeRatio = 50;
+
+class XdpIterator : public EngineIterator {
+ public:
+  XdpIterator(std::shared_ptr<XdpStore> store, const std::string& start_key, const std::string& end_key)
+      : store_(store), iter_(store->GetView(start_key, end_key), start_key, end_key) {}
+  ~XdpIterator() override = default;
+
+  bool HasNext() override { return iter_.Valid(); }
+
+  void Next() override { iter_.Next(); }
+
+  void GetKV(std::string& key, std::string& value) override {  // NOLINT
+    key = iter_.key();
+    value = iter_.value();
+  }
+
+  const std::string& GetName() const override { return name_; }
+  uint32_t GetID() override { return id_; }
+
+ private:
+  std::shared_ptr<XdpStore> store_;
+  XdpStore::Iterator iter_;
+
+  const std::string name_ = "XdpIterator";
+  uint32_t id_ = static_cast<uint32_t>(EnumEngineIterator::kXdpIterator);
+};
+
+RawXdpEngine::RawXdpEngine() : merge_ratio_(kDefaultMergeRatio) {}
+
+RawXdpEngine::~RawXdpEngine() {
+  {
+    std::lock_guard<std::mutex> lock(merge_mutex_);
+    merge_stopped_ = true;
+  }
+  merge_cond_.notify_all();
+  if (merge_thread_.joinable()) {
+    merge_thread_.join();
+  }
+}
+
+bool RawXdpEngine::Init(std::shared_ptr<Config> config) {
+  if (!config) {
+    LOG(ERROR) << butil::StringPrintf("config empty not support!");
+    return false;
+  }
+
+  std::vector<std::string> column_families = config->GetStringList(kColumnFamilies);
+  if (column_families.empty()) {
+    LOG(ERROR) << butil::StringPrintf("%s : empty. not found any column family", kColumnFamilies.c_str());
+    return false;
+  }
+
+  std::string path = config->GetString(kXdpPath);
+  if (path.empty()) {
+    LOG(ERROR) << butil::StringPrintf("%s : empty. not found xdp path", kXdpPath.c_str());
+    return false;
+  }
+
+  int file_size_mb = config->GetInt(kXdpFileSize);
+  int merge_ratio = config->GetInt(kXdpMergeRatio);
+  file_size_mb = file_size_mb > 0 ? file_size_mb : kDefaultFileSizeMb;
+  merge_ratio_ = merge_ratio > 0 ? merge_ratio : kDefaultMergeRatio;
+
+  for (const auto& cf_name : column_families) {
+    XdpStore::Options options;
+    options.path = path + "/" + cf_name;
+    options.max_file_size = static_cast<uint64_t>(file_size_mb) * 1024 * 1024;
+    options.sync_write = config->GetInt(kXdpSyncWrite) != 0;
+
+    auto store = std::make_shared<XdpStore>(options);
+    if (!store->Open()) {
+      LOG(ERROR) << butil::StringPrintf("Open xdp store %s failed", options.path.c_str());
+      return false;
+    }
+    stores_.emplace(cf_name, store);
+    total_bytes_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                      butil::StringPrintf("dingo_xdp_engine_%s_bytes", cf_name.c_str()), 0));
+    garbage_bytes_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                        butil::StringPrintf("dingo_xdp_engine_%s_garbage_bytes", cf_name.c_str()), 0));
+    key_counts_.emplace(cf_name, std::make_unique<bvar::Status<int64_t> >(
+                                     butil::StringPrintf("dingo_xdp_engine_%s_keys", cf_name.c_str()), 0));
+  }
+
+  LOG(INFO) << butil::StringPrintf("Init RawXdpEngine with %lu column families, path %s file size %dMB merge ratio %d",
+                                   column_families.size(), path.c_str(), file_size_mb, merge_ratio_);
+  return true;
+}
+
+std::string RawXdpEngine::GetName() { return pb::common::RawEngine_Name(pb::common::RAW_ENG_XDP); }
+
+pb::common::RawEngine RawXdpEngine::GetID() { return pb::common::RAW_ENG_XDP; }
+
+std::shared_ptr<Snapshot> RawXdpEngine::GetSnapshot() {
+  std::map<std::string, XdpStore::View> views;
+  for (const auto& [cf_name, store] : stores_) {
+    views.emplace(cf_name, store->GetView());
+  }
+  return std::make_shared<XdpSnapshot>(views);
+}
+
+// Views are released with the snapshot.
+void RawXdpEngine::ReleaseSnapshot(std::shared_ptr<Snapshot> /*snapshot*/) {}
+
+void RawXdpEngine::Flush(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store != nullptr) {
+    store->Sync();
+  }
+}
+
+butil::Status RawXdpEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  auto writer = NewWriter(cf_name);
+  if (writer == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  return writer->KvDeleteRange(range);
+}
+
+butil::Status RawXdpEngine::CompactRange(const std::string& cf_name, const pb::common::Range& /*range*/) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return butil::Status(pb::error::ESTORE_INVALID_CF, "Invalid column family");
+  }
+  if (!store->Merge()) {
+    return butil::Status(pb::error::EINTERNAL, "Merge xdp store failed");
+  }
+  return butil::Status();
+}
+
+butil::Status RawXdpEngine::IngestExternalFile(const std::string& /*cf_name*/,
+                                               const std::vector<std::string>& /*files*/,
+                                               const pb::common::Range& /*range*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Xdp engine not support ingest sst");
+}
+
+butil::Status RawXdpEngine::SetOptions(const std::string& /*cf_name*/,
+                                       const std::map<std::string, std::string>& /*options*/,
+                                       std::vector<std::string>& /*need_reopen_options*/) {
+  return butil::Status(pb::error::ENOT_SUPPORT, "Xdp engine has no options");
+}
+
+void RawXdpEngine::CollectStats() {
+  for (const auto& [cf_name, store] : stores_) {
+    total_bytes_[cf_name]->set_value(store->TotalBytes());
+    garbage_bytes_[cf_name]->set_value(store->TotalBytes() - store->LiveBytes());
+    key_counts_[cf_name]->set_value(store->KeyCount());
+  }
+}
+
+void RawXdpEngine::MergeIfNeeded() {
+  for (const auto& [cf_name, store] : stores_) {
+    if (store->NeedMerge(merge_ratio_) && !store->Merge()) {
+      LOG(ERROR) << butil::StringPrintf("Merge xdp column family %s failed", cf_name.c_str());
+    }
+  }
+}
+
+void RawXdpEngine::ScheduleMerge() {
+  std::lock_guard<std::mutex> lock(merge_mutex_);
+  if (merge_stopped_) {
+    return;
+  }
+  if (!merge_thread_.joinable()) {
+    merge_thread_ = std::thread(&RawXdpEngine::MergeWorker, this);
+  }
+  merge_pending_ = true;
+  merge_cond_.notify_one();
+}
+
+// Schedules during a merge are folded into one more round.
+void RawXdpEngine::MergeWorker() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(merge_mutex_);
+      merge_cond_.wait(lock, [this]() { return merge_stopped_ || merge_pending_; });
+      if (merge_stopped_) {
+        break;
+      }
+      merge_pending_ = false;
+    }
+    MergeIfNeeded();
+  }
+}
+
+std::shared_ptr<RawEngine::Reader> RawXdpEngine::NewReader(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Reader>(store, cf_name);
+}
+
+std::shared_ptr<RawEngine::Writer> RawXdpEngine::NewWriter(const std::string& cf_name) {
+  auto store = GetStore(cf_name);
+  if (store == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<Writer>(store);
+}
+
+std::shared_ptr<XdpStore> RawXdpEngine::GetStore(const std::string& cf_name) {
+  auto iter = stores_.find(cf_name);
+  if (iter == stores_.end()) {
+    LOG(ERROR) << butil::StringPrintf("column family %s not found", cf_name.c_str());
+    return nullptr;
+  }
+  return iter->second;
+}
+
+XdpStore::View RawXdpEngine::Reader::GetView(std::shared_ptr<dingodb::Snapshot> snapshot,
+                                             const std::string& start_key, const std::string& end_key) const {
+  auto xdp_snapshot = std::dynamic_pointer_cast<XdpSnapshot>(snapshot);
+  if (xdp_snapshot != nullptr) {
+    const auto* view = xdp_snapshot->GetView(cf_name_);
+    if (view != nullptr) {
+      return *view;
+    }
+  }
+  return store_->GetView(start_key, end_key);
+}
+
+butil::Status RawXdpEngine::Reader::KvGet(const std::string& key, std::string& value) {
+  return KvGet(nullptr, key, value);
+}
+
+butil::Status RawXdpEngine::Reader::KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                                          std::string& value) {
+  if (key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto xdp_snapshot = std::dynamic_pointer_cast<XdpSnapshot>(snapshot);
+  const auto* view = xdp_snapshot != nullptr ? xdp_snapshot->GetView(cf_name_) : nullptr;
+  bool found = view != nullptr ? XdpStore::Get(*view, key, value) : store_->Get(key, value);
+  if (!found) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+  return butil::Status();
+}
+
+butil::Status RawXdpEngine::Reader::KvScan(const std::string& start_key, const std::string& end_key,
+                                           std::vector<pb::common::KeyValue>& kvs) {
+  return KvScan(nullptr, start_key, end_key, kvs);
+}
+
+butil::Status RawXdpEngine::Reader::KvScan(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                                           const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("begin_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  for (XdpStore::Iterator iter(GetView(snapshot, start_key, end_key), start_key, end_key); iter.Valid();
+       iter.Next()) {
+    pb::common::KeyValue kv;
+    kv.set_key(iter.key());
+    kv.set_value(iter.value());
+
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawXdpEngine::Reader::KvCount(const std::string& start_key, const std::string& end_key,
+                                            int64_t& count) {
+  return KvCount(nullptr, start_key, end_key, count);
+}
+
+// Count keys of keydir, values are not read.
+butil::Status RawXdpEngine::Reader::KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                                            const std::string& end_key, int64_t& count) {
+  if (start_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  if (end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("end_key empty  not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  count = 0;
+  auto view = GetView(snapshot, start_key, end_key);
+  if (start_key < end_key) {
+    count = std::distance(view.keydir->lower_bound(start_key), view.keydir->lower_bound(end_key));
+  }
+
+  return butil::Status();
+}
+
+std::shared_ptr<EngineIterator> RawXdpEngine::Reader::NewIterator(const std::string& start_key,
+                                                                  const std::string& end_key) {
+  return std::make_shared<XdpIterator>(store_, start_key, end_key);
+}
+
+}  // namespace dingodb
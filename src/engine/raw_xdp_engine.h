@@ -0,0 +1,147 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAW_XDP_ENGINE_H_
+#define DINGODB_ENGINE_RAW_XDP_ENGINE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bvar/bvar.h"
+#include "config/config.h"
+#include "engine/batch_writer.h"
+#include "engine/raw_engine.h"
+#include "engine/snapshot.h"
+#include "engine/xdp_store.h"
+
+namespace dingodb {
+
+// Append only RawEngine for ENG_XDP tables, every column family is a bitcask style XdpStore in a
+// directory of store.xdpPath. A read is one keydir lookup and one read of a data file, a write is one
+// append, so value size does not amplify writes. Garbage of sealed files is reclaimed by merge.
+class RawXdpEngine : public RawEngine {
+ public:
+  RawXdpEngine();
+  ~RawXdpEngine() override;
+
+  RawXdpEngine(const RawXdpEngine& rhs) = delete;
+  RawXdpEngine& operator=(const RawXdpEngine& rhs) = delete;
+  RawXdpEngine(RawXdpEngine&& rhs) = delete;
+  RawXdpEngine& operator=(RawXdpEngine&& rhs) = delete;
+
+  // View of every column family.
+  class XdpSnapshot : public dingodb::Snapshot {
+   public:
+    XdpSnapshot(const std::map<std::string, XdpStore::View>& views) : views_(views) {}
+    ~XdpSnapshot() override = default;
+
+    const XdpStore::View* GetView(const std::string& cf_name) const {
+      auto it = views_.find(cf_name);
+      return it != views_.end() ? &it->second : nullptr;
+    }
+
+   private:
+    std::map<std::string, XdpStore::View> views_;
+  };
+
+  class Reader : public RawEngine::Reader {
+   public:
+    Reader(std::shared_ptr<XdpStore> store, const std::string& cf_name) : store_(store), cf_name_(cf_name) {}
+    ~Reader() override = default;
+    butil::Status KvGet(const std::string& key, std::string& value) override;
+    butil::Status KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
+                        std::string& value) override;
+
+    butil::Status KvScan(const std::string& start_key, const std::string& end_key,
+                         std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvScan(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                         const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+
+    butil::Status KvCount(const std::string& start_key, const std::string& end_key, int64_t& count) override;
+    butil::Status KvCount(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                          const std::string& end_key, int64_t& count) override;
+
+    std::shared_ptr<EngineIterator> NewIterator(const std::string& start_key, const std::string& end_key) override;
+
+    uint32_t GetID() { return static_cast<uint32_t>(EnumEngineReader::kXdpReader); }
+
+   private:
+    // Range of latest keys, or all keys of snapshot.
+    XdpStore::View GetView(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& start_key,
+                           const std::string& end_key) const;
+
+    std::shared_ptr<XdpStore> store_;
+    std::string cf_name_;
+  };
+
+  using Writer = BatchWriter<XdpStore>;
+
+  bool Init(std::shared_ptr<Config> config) override;
+  std::string GetName() override;
+  pb::common::RawEngine GetID() override;
+
+  std::shared_ptr<Snapshot> GetSnapshot() override;
+  void ReleaseSnapshot(std::shared_ptr<Snapshot> snapshot) override;
+
+  // Sync active data file.
+  void Flush(const std::string& cf_name) override;
+  // Write tombstones of range, space is reclaimed by merge.
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  // Merge the column family, range is ignored.
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range) override;
+  butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files,
+                                   const pb::common::Range& range) override;
+
+  butil::Status SetOptions(const std::string& cf_name, const std::map<std::string, std::string>& options,
+                           std::vector<std::string>& need_reopen_options) override;  // NOLINT
+  void ReloadOptions(std::shared_ptr<Config> /*config*/) override {}
+
+  void CollectStats() override;
+
+  std::shared_ptr<RawEngine::Reader> NewReader(const std::string& cf_name) override;
+  std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name) override;
+
+  // Merge column families whose garbage ratio of sealed files reach store.xdpMergeRatio.
+  void MergeIfNeeded();
+  // Wake merge worker to run MergeIfNeeded, called by crontab which must not block on a long merge.
+  void ScheduleMerge();
+
+ private:
+  std::shared_ptr<XdpStore> GetStore(const std::string& cf_name);
+  void MergeWorker();
+
+  int merge_ratio_;
+  std::map<std::string, std::shared_ptr<XdpStore> > stores_;
+  // Data file bytes, garbage bytes and keys of every column family, prefix dingo_xdp_engine.
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > total_bytes_;
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > garbage_bytes_;
+  std::map<std::string, std::unique_ptr<bvar::Status<int64_t> > > key_counts_;
+
+  // Merge worker start at first schedule and joined when destroy.
+  std::mutex merge_mutex_;
+  std::condition_variable merge_cond_;
+  bool merge_pending_ = false;
+  bool merge_stopped_ = false;
+  std::thread merge_thread_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAW_XDP_ENGINE_H_
@@ -0,0 +1,238 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/rocks_stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
+
+namespace dingodb {
+
+static const char* kStatsPrefix = "dingo_rocksdb";
+
+static const std::vector<std::pair<uint32_t, const char*>> kTickers = {
+    {rocksdb::BLOCK_CACHE_HIT, "block_cache_hit"},
+    {rocksdb::BLOCK_CACHE_MISS, "block_cache_miss"},
+    {rocksdb::BLOCK_CACHE_INDEX_MISS, "block_cache_index_miss"},
+    {rocksdb::BLOCK_CACHE_FILTER_MISS, "block_cache_filter_miss"},
+    {rocksdb::BLOCK_CACHE_DATA_MISS, "block_cache_data_miss"},
+    {rocksdb::BLOOM_FILTER_USEFUL, "bloom_filter_useful"},
+    {rocksdb::MEMTABLE_HIT, "memtable_hit"},
+    {rocksdb::MEMTABLE_MISS, "memtable_miss"},
+    {rocksdb::STALL_MICROS, "stall_micros"},
+    {rocksdb::COMPACT_READ_BYTES, "compact_read_bytes"},
+    {rocksdb::COMPACT_WRITE_BYTES, "compact_write_bytes"},
+    {rocksdb::FLUSH_WRITE_BYTES, "flush_write_bytes"},
+    {rocksdb::BYTES_WRITTEN, "bytes_written"},
+    {rocksdb::BYTES_READ, "bytes_read"},
+    {rocksdb::NUMBER_KEYS_WRITTEN, "number_keys_written"},
+    {rocksdb::NUMBER_KEYS_READ, "number_keys_read"},
+    {rocksdb::WAL_FILE_BYTES, "wal_file_bytes"},
+};
+
+static const std::vector<std::pair<uint32_t, const char*>> kHistograms = {
+    {rocksdb::DB_GET, "db_get_micros"},
+    {rocksdb::DB_WRITE, "db_write_micros"},
+    {rocksdb::DB_SEEK, "db_seek_micros"},
+    {rocksdb::WRITE_STALL, "write_stall_micros"},
+    {rocksdb::COMPACTION_TIME, "compaction_micros"},
+    {rocksdb::FLUSH_TIME, "flush_micros"},
+};
+
+// Int properties of every column family.
+static const std::vector<std::string> kProperties = {
+    rocksdb::DB::Properties::kCurSizeAllMemTables,
+    rocksdb::DB::Properties::kSizeAllMemTables,
+    rocksdb::DB::Properties::kNumImmutableMemTable,
+    rocksdb::DB::Properties::kEstimateNumKeys,
+    rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+    rocksdb::DB::Properties::kLiveSstFilesSize,
+    rocksdb::DB::Properties::kTotalBlobFileSize,
+    rocksdb::DB::Properties::kLiveBlobFileSize,
+    rocksdb::DB::Properties::kLiveBlobFileGarbageSize,
+};
+
+// rocksdb.cur-size-all-mem-tables -> <cf>_cur_size_all_mem_tables
+static std::string PropertyStatusName(const std::string& cf_name, const std::string& property) {
+  std::string name = property.substr(property.find('.') + 1);
+  std::replace(name.begin(), name.end(), '-', '_');
+  return cf_name + "_" + name;
+}
+
+RocksStats::RocksStats(std::shared_ptr<rocksdb::TransactionDB> txn_db, std::shared_ptr<rocksdb::Statistics> statistics,
+                       std::shared_ptr<rocksdb::Cache> block_cache,
+                       const std::map<std::string, rocksdb::ColumnFamilyHandle*>& family_handles)
+    : txn_db_(txn_db),
+      statistics_(statistics),
+      block_cache_(block_cache),
+      last_block_cache_hit_(0),
+      last_block_cache_miss_(0),
+      block_cache_hit_ratio_(kStatsPrefix, "block_cache_hit_ratio", 0),
+      block_cache_usage_(kStatsPrefix, "block_cache_usage", 0),
+      block_cache_pinned_usage_(kStatsPrefix, "block_cache_pinned_usage", 0) {
+  for (const auto& [ticker, name] : kTickers) {
+    tickers_.emplace_back(ticker, std::make_unique<bvar::Status<int64_t>>(kStatsPrefix, name, 0));
+  }
+
+  for (const auto& [type, name] : kHistograms) {
+    HistogramStatus histogram;
+    histogram.type = type;
+    histogram.p50 = std::make_unique<bvar::Status<double>>(kStatsPrefix, std::string(name) + "_p50", 0);
+    histogram.p99 = std::make_unique<bvar::Status<double>>(kStatsPrefix, std::string(name) + "_p99", 0);
+    histogram.max = std::make_unique<bvar::Status<double>>(kStatsPrefix, std::string(name) + "_max", 0);
+    histograms_.push_back(std::move(histogram));
+  }
+
+  for (const auto& [cf_name, handle] : family_handles) {
+    for (const auto& property : kProperties) {
+      PropertyStatus property_status;
+      property_status.handle = handle;
+      property_status.property = property;
+      property_status.value =
+          std::make_unique<bvar::Status<int64_t>>(kStatsPrefix, PropertyStatusName(cf_name, property), 0);
+      properties_.push_back(std::move(property_status));
+    }
+  }
+}
+
+void RocksStats::Collect() {
+  if (statistics_ != nullptr) {
+    for (auto& [ticker, status] : tickers_) {
+      status->set_value(static_cast<int64_t>(statistics_->getTickerCount(ticker)));
+    }
+
+    for (auto& histogram : histograms_) {
+      rocksdb::HistogramData data;
+      statistics_->histogramData(histogram.type, &data);
+      histogram.p50->set_value(data.median);
+      histogram.p99->set_value(data.percentile99);
+      histogram.max->set_value(static_cast<double>(data.max));
+    }
+
+    uint64_t hit = statistics_->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+    uint64_t miss = statistics_->getTickerCount(rocksdb::BLOCK_CACHE_MISS);
+    uint64_t total = (hit - last_block_cache_hit_) + (miss - last_block_cache_miss_);
+    if (total > 0) {
+      block_cache_hit_ratio_.set_value(static_cast<double>(hit - last_block_cache_hit_) / total);
+    }
+    last_block_cache_hit_ = hit;
+    last_block_cache_miss_ = miss;
+  }
+
+  if (block_cache_ != nullptr) {
+    block_cache_usage_.set_value(static_cast<int64_t>(block_cache_->GetUsage()));
+    block_cache_pinned_usage_.set_value(static_cast<int64_t>(block_cache_->GetPinnedUsage()));
+  }
+
+  for (auto& property : properties_) {
+    uint64_t value = 0;
+    if (txn_db_->GetIntProperty(property.handle, property.property, &value)) {
+      property.value->set_value(static_cast<int64_t>(value));
+    }
+  }
+}
+
+struct PerfContextField {
+  const char* name;
+  uint64_t rocksdb::PerfContext::*field;
+  // Time field is nanos, record as micros.
+  bool is_time;
+};
+
+static const std::vector<std::vector<PerfContextField>> kPerfContextFields = {
+    // kGet
+    {
+        {"get_snapshot", &rocksdb::PerfContext::get_snapshot_time, true},
+        {"get_from_memtable", &rocksdb::PerfContext::get_from_memtable_time, true},
+        {"get_from_output_files", &rocksdb::PerfContext::get_from_output_files_time, true},
+        {"block_read", &rocksdb::PerfContext::block_read_time, true},
+        {"block_read_count", &rocksdb::PerfContext::block_read_count, false},
+    },
+    // kScan
+    {
+        {"seek_internal_seek", &rocksdb::PerfContext::seek_internal_seek_time, true},
+        {"block_read", &rocksdb::PerfContext::block_read_time, true},
+        {"block_read_count", &rocksdb::PerfContext::block_read_count, false},
+        {"internal_key_skipped_count", &rocksdb::PerfContext::internal_key_skipped_count, false},
+        {"internal_delete_skipped_count", &rocksdb::PerfContext::internal_delete_skipped_count, false},
+    },
+    // kWrite
+    {
+        {"write_wal", &rocksdb::PerfContext::write_wal_time, true},
+        {"write_memtable", &rocksdb::PerfContext::write_memtable_time, true},
+        {"write_delay", &rocksdb::PerfContext::write_delay_time, true},
+        {"write_pre_and_post_process", &rocksdb::PerfContext::write_pre_and_post_process_time, true},
+        {"key_lock_wait", &rocksdb::PerfContext::key_lock_wait_time, true},
+    },
+};
+
+static const char* kPerfContextOpNames[] = {"get", "scan", "write"};
+
+// Recorders are created at first sample, same order with kPerfContextFields.
+static std::vector<std::unique_ptr<bvar::IntRecorder>>& GetPerfContextRecorders(PerfContextOp op) {
+  static std::vector<std::vector<std::unique_ptr<bvar::IntRecorder>>>* recorders = [] {
+    auto* recorders = new std::vector<std::vector<std::unique_ptr<bvar::IntRecorder>>>(kPerfContextFields.size());
+    for (size_t i = 0; i < kPerfContextFields.size(); ++i) {
+      for (const auto& field : kPerfContextFields[i]) {
+        std::string name = std::string("perf_") + kPerfContextOpNames[i] + "_" + field.name;
+        auto recorder = std::make_unique<bvar::IntRecorder>();
+        recorder->expose_as(kStatsPrefix, name);
+        (*recorders)[i].push_back(std::move(recorder));
+      }
+    }
+    return recorders;
+  }();
+
+  return (*recorders)[static_cast<int>(op)];
+}
+
+std::atomic<int> PerfContextSampler::sample_rate_{0};
+
+PerfContextSampler::PerfContextSampler(PerfContextOp op) : op_(op), sampled_(false) {
+  int sample_rate = sample_rate_.load(std::memory_order_relaxed);
+  if (sample_rate == 0 || butil::fast_rand_less_than(sample_rate) != 0) {
+    return;
+  }
+
+  sampled_ = true;
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+  rocksdb::get_perf_context()->Reset();
+}
+
+PerfContextSampler::~PerfContextSampler() {
+  if (!sampled_) {
+    return;
+  }
+
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+
+  const auto& fields = kPerfContextFields[static_cast<int>(op_)];
+  auto& recorders = GetPerfContextRecorders(op_);
+  const rocksdb::PerfContext* perf_context = rocksdb::get_perf_context();
+  for (size_t i = 0; i < fields.size(); ++i) {
+    uint64_t value = perf_context->*(fields[i].field);
+    *recorders[i] << static_cast<int64_t>(fields[i].is_time ? value / 1000 : value);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROCKS_STATS_H_
+#define DINGODB_ENGINE_ROCKS_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bvar/bvar.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/utilities/transaction_db.h"
+
+namespace dingodb {
+
+// Export rocksdb tickers, histograms, block cache usage and column family properties as bvar,
+// show in brpc /vars page with prefix dingo_rocksdb. Collect is called by crontab.
+class RocksStats {
+ public:
+  RocksStats(std::shared_ptr<rocksdb::TransactionDB> txn_db, std::shared_ptr<rocksdb::Statistics> statistics,
+             std::shared_ptr<rocksdb::Cache> block_cache,
+             const std::map<std::string, rocksdb::ColumnFamilyHandle*>& family_handles);
+  ~RocksStats() = default;
+
+  RocksStats(const RocksStats&) = delete;
+  const RocksStats& operator=(const RocksStats&) = delete;
+
+  void Collect();
+
+ private:
+  struct HistogramStatus {
+    uint32_t type;
+    std::unique_ptr<bvar::Status<double>> p50;
+    std::unique_ptr<bvar::Status<double>> p99;
+    std::unique_ptr<bvar::Status<double>> max;
+  };
+
+  struct PropertyStatus {
+    rocksdb::ColumnFamilyHandle* handle;
+    std::string property;
+    std::unique_ptr<bvar::Status<int64_t>> value;
+  };
+
+  std::shared_ptr<rocksdb::TransactionDB> txn_db_;
+  std::shared_ptr<rocksdb::Statistics> statistics_;
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+
+  std::vector<std::pair<uint32_t, std::unique_ptr<bvar::Status<int64_t>>>> tickers_;
+  std::vector<HistogramStatus> histograms_;
+  std::vector<PropertyStatus> properties_;
+
+  // Hit ratio between two collects, not since start.
+  uint64_t last_block_cache_hit_;
+  uint64_t last_block_cache_miss_;
+  bvar::Status<double> block_cache_hit_ratio_;
+  bvar::Status<int64_t> block_cache_usage_;
+  bvar::Status<int64_t> block_cache_pinned_usage_;
+};
+
+enum class PerfContextOp {
+  kGet = 0,
+  kScan = 1,
+  kWrite = 2,
+};
+
+// Sample 1 of sample rate engine requests, record rocksdb perf context of the request to bvar,
+// e.g. dingo_rocksdb_perf_get_block_read. Perf context is thread local, rocksdb call not yield bthread.
+class PerfContextSampler {
+ public:
+  explicit PerfContextSampler(PerfContextOp op);
+  ~PerfContextSampler();
+
+  PerfContextSampler(const PerfContextSampler&) = delete;
+  const PerfContextSampler& operator=(const PerfContextSampler&) = delete;
+
+  // 0 is disable.
+  static void SetSampleRate(int sample_rate) { sample_rate_.store(sample_rate > 0 ? sample_rate : 0); }
+
+ private:
+  static std::atomic<int> sample_rate_;
+
+  PerfContextOp op_;
+  bool sampled_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROCKS_STATS_H_
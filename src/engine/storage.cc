@@ -14,13 +14,17 @@
 
 #include "engine/storage.h"
 
+#include "butil/time.h"
 #include "common/constant.h"
 #include "common/helper.h"
+#include "engine/columnar_engine.h"
+#include "engine/ttl.h"
 #include "engine/write_data.h"
+#include "glog/logging.h"
 
 namespace dingodb {
 
-Storage::Storage(std::shared_ptr<Engine> engine) : engine_(engine) {}
+Storage::Storage(const std::map<pb::common::Engine, std::shared_ptr<Engine> >& engines) : engines_(engines) {}
 
 Storage::~Storage() = default;
 
@@ -28,9 +32,24 @@ Snapshot* Storage::GetSnapshot() { return nullptr; }
 
 void Storage::ReleaseSnapshot() {}
 
+std::shared_ptr<Engine> Storage::GetEngine(std::shared_ptr<Context> ctx) {
+  auto it = engines_.find(ctx->EngineId());
+  if (it == engines_.end()) {
+    LOG(ERROR) << "Not found engine " << pb::common::Engine_Name(ctx->EngineId()) << " of region "
+               << ctx->RegionId();
+    return nullptr;
+  }
+  return it->second;
+}
+
 butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                              std::vector<pb::common::KeyValue>& kvs) {
-  auto reader = engine_->NewReader(Constant::kStoreDataCF);
+  auto engine = GetEngine(ctx);
+  if (engine == nullptr) {
+    return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not found engine");
+  }
+
+  auto reader = engine->NewReader(ctx->CfName());
   for (auto& key : keys) {
     std::string value;
     auto status = reader->KvGet(ctx, key, value);
@@ -47,33 +66,91 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
   return butil::Status();
 }
 
+// Ttl values are encoded on leader, so all replicas have the same expire time.
+static void EncodeTtlValues(std::shared_ptr<Context> ctx, int64_t now, std::vector<pb::common::KeyValue>& kvs) {
+  int64_t expire_time = Ttl::CalcExpireTime(ctx->Ttl(), now);
+  for (auto& kv : kvs) {
+    kv.set_value(Ttl::EncodeValue(kv.value(), expire_time));
+  }
+}
+
 butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) {
+  auto engine = GetEngine(ctx);
+  if (engine == nullptr) {
+    return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not found engine");
+  }
+
   WriteData write_data;
   std::shared_ptr<PutDatum> datum = std::make_shared<PutDatum>();
   datum->cf_name = ctx->CfName();
   datum->kvs = std::move(kvs);
+  if (ctx->CfName() == Constant::kStoreTtlCF) {
+    EncodeTtlValues(ctx, butil::gettimeofday_ms(), datum->kvs);
+  }
+  datum->ts = ctx->Ts();
   write_data.AddDatums(std::static_pointer_cast<DatumAble>(datum));
 
-  return engine_->AsyncWrite(ctx, write_data, [ctx](butil::Status status) {
-    LOG(INFO) << "here 003";
+  return engine->AsyncWrite(ctx, write_data, [ctx](butil::Status status) {
     if (!status.ok()) {
       Helper::SetPbMessageError(status, ctx->Response());
     }
   });
 }
 
-butil::Status Storage::KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) {
+butil::Status Storage::KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
+                                     bool is_atomic) {
+  auto engine = GetEngine(ctx);
+  if (engine == nullptr) {
+    return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not found engine");
+  }
+
   WriteData write_data;
   std::shared_ptr<PutIfAbsentDatum> datum = std::make_shared<PutIfAbsentDatum>();
   datum->cf_name = ctx->CfName();
   datum->kvs = kvs;
+  datum->is_atomic = is_atomic;
+  if (ctx->CfName() == Constant::kStoreTtlCF) {
+    datum->expire_check_time = butil::gettimeofday_ms();
+    EncodeTtlValues(ctx, datum->expire_check_time, datum->kvs);
+  }
+  write_data.AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+  return engine->AsyncWrite(ctx, write_data, [ctx](butil::Status status) {
+    if (!status.ok()) {
+      Helper::SetPbMessageError(status, ctx->Response());
+    }
+  });
+}
+
+butil::Status Storage::KvScanColumns(std::shared_ptr<Context> ctx, const pb::common::Range& range,
+                                     const std::vector<uint32_t>& columns,
+                                     const std::vector<ColumnPredicate>& predicates, ColumnBatch& batch) {
+  auto engine = std::dynamic_pointer_cast<ColumnarEngine>(GetEngine(ctx));
+  if (engine == nullptr) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support column scan of table not columnar");
+  }
+
+  return engine->KvScanColumns(ctx, range.start_key(), range.end_key(), columns, predicates, batch);
+}
+
+butil::Status Storage::KvIngestSst(std::shared_ptr<Context> ctx, std::string& sst, const pb::common::Range& range) {
+  auto engine = GetEngine(ctx);
+  if (engine == nullptr) {
+    return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not found engine");
+  }
+
+  WriteData write_data;
+  std::shared_ptr<IngestSstDatum> datum = std::make_shared<IngestSstDatum>();
+  datum->cf_name = ctx->CfName();
+  datum->sst = std::move(sst);
+  datum->range = range;
   write_data.AddDatums(std::static_pointer_cast<DatumAble>(datum));
 
-  return engine_->AsyncWrite(ctx, write_data, [ctx](butil::Status status) {
+  return engine->AsyncWrite(ctx, write_data, [ctx](butil::Status status) {
     if (!status.ok()) {
       Helper::SetPbMessageError(status, ctx->Response());
     }
   });
 }
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
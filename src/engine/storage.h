@@ -15,7 +15,10 @@
 #ifndef DINGODB_ENGINE_STORAGE_H_
 #define DINGODB_ENGINE_STORAGE_H_
 
+#include <map>
+
 #include "common/context.h"
+#include "engine/column_store.h"
 #include "engine/engine.h"
 #include "engine/raft_kv_engine.h"
 #include "memory"
@@ -24,9 +27,10 @@
 
 namespace dingodb {
 
+// Entry of region data requests, every request is routed to the engine of its region table.
 class Storage {
  public:
-  Storage(std::shared_ptr<Engine> engine);
+  Storage(const std::map<pb::common::Engine, std::shared_ptr<Engine> >& engines);
   ~Storage();
 
   Snapshot* GetSnapshot();
@@ -37,10 +41,23 @@ class Storage {
 
   butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs);
 
-  butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs);
+  // Not atomic puts absent keys only, put keys are replied in KvBatchPutIfAbsentResponse.
+  butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
+                              bool is_atomic);
+
+  // Column scan of ENG_COLUMNAR region, ENOT_SUPPORT for other engines.
+  butil::Status KvScanColumns(std::shared_ptr<Context> ctx, const pb::common::Range& range,
+                              const std::vector<uint32_t>& columns, const std::vector<ColumnPredicate>& predicates,
+                              ColumnBatch& batch);
+
+  // Bulk load sst file to region, sst is moved.
+  butil::Status KvIngestSst(std::shared_ptr<Context> ctx, std::string& sst, const pb::common::Range& range);
 
  private:
-  std::shared_ptr<Engine> engine_;
+  // Engine of context, nullptr when the engine is not created in this store.
+  std::shared_ptr<Engine> GetEngine(std::shared_ptr<Context> ctx);
+
+  std::map<pb::common::Engine, std::shared_ptr<Engine> > engines_;
 };
 
 }  // namespace dingodb
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/ttl.h"
+
+#include <cstdint>
+#include <string>
+
+#include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const size_t kExpireTimeSize = 8;
+
+std::string Ttl::EncodeValue(const std::string& value, int64_t expire_time) {
+  std::string buf;
+  buf.reserve(kExpireTimeSize + value.size());
+
+  uint64_t expire = static_cast<uint64_t>(expire_time);
+  for (int i = kExpireTimeSize - 1; i >= 0; --i) {
+    buf.push_back(static_cast<char>((expire >> (i * 8)) & 0xFF));
+  }
+  buf.append(value);
+
+  return buf;
+}
+
+int64_t Ttl::DecodeExpireTime(const std::string_view& value) {
+  if (value.size() < kExpireTimeSize) {
+    return 0;
+  }
+
+  uint64_t expire = 0;
+  for (size_t i = 0; i < kExpireTimeSize; ++i) {
+    expire = (expire << 8) | static_cast<unsigned char>(value[i]);
+  }
+
+  return static_cast<int64_t>(expire);
+}
+
+std::string_view Ttl::DecodeValue(const std::string_view& value) {
+  return value.size() < kExpireTimeSize ? std::string_view() : value.substr(kExpireTimeSize);
+}
+
+bool Ttl::IsExpired(const std::string_view& value, int64_t now) {
+  int64_t expire_time = DecodeExpireTime(value);
+  return expire_time > 0 && expire_time <= now;
+}
+
+int64_t Ttl::CalcExpireTime(uint64_t ttl, int64_t now) {
+  return ttl == 0 ? 0 : now + static_cast<int64_t>(ttl) * 1000;
+}
+
+butil::Status TtlReader::KvGet(const std::string& key, std::string& value) {
+  std::string encode_value;
+  auto status = reader_->KvGet(key, encode_value);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Expired value wait compaction to remove.
+  if (Ttl::IsExpired(encode_value, butil::gettimeofday_ms())) {
+    return butil::Status(pb::error::EKEY_NOTFOUND, "Not found");
+  }
+
+  value.assign(Ttl::DecodeValue(encode_value));
+
+  return butil::Status();
+}
+
+butil::Status TtlReader::KvScan(const std::string& start_key, const std::string& end_key,
+                                std::vector<pb::common::KeyValue>& kvs) {
+  if (start_key.empty() || end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key or end_key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto iter = reader_->NewIterator(start_key, end_key);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  int64_t now = butil::gettimeofday_ms();
+  std::string key;
+  std::string encode_value;
+  for (; iter->HasNext(); iter->Next()) {
+    iter->GetKV(key, encode_value);
+    if (Ttl::IsExpired(encode_value, now)) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(std::string(Ttl::DecodeValue(encode_value)));
+    kvs.emplace_back(std::move(kv));
+  }
+
+  return butil::Status();
+}
+
+butil::Status TtlReader::KvCount(const std::string& start_key, const std::string& end_key, int64_t& count) {
+  if (start_key.empty() || end_key.empty()) {
+    LOG(ERROR) << butil::StringPrintf("start_key or end_key empty not support");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  auto iter = reader_->NewIterator(start_key, end_key);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Internal error");
+  }
+
+  int64_t now = butil::gettimeofday_ms();
+  std::string key;
+  std::string encode_value;
+  for (count = 0; iter->HasNext(); iter->Next()) {
+    iter->GetKV(key, encode_value);
+    if (!Ttl::IsExpired(encode_value, now)) {
+      count++;
+    }
+  }
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TTL_H_
+#define DINGODB_ENGINE_TTL_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Ttl value encoding.
+// value: expire_time(8 bytes big endian, ms) + user_value, expire_time 0 is never expire.
+class Ttl {
+ public:
+  static std::string EncodeValue(const std::string& value, int64_t expire_time);
+  static int64_t DecodeExpireTime(const std::string_view& value);
+  static std::string_view DecodeValue(const std::string_view& value);
+
+  static bool IsExpired(const std::string_view& value, int64_t now);
+
+  // Expire time of value write at now, ttl is in seconds.
+  static int64_t CalcExpireTime(uint64_t ttl, int64_t now);
+};
+
+// Read ttl column family, expired values are not visible.
+class TtlReader {
+ public:
+  TtlReader(std::shared_ptr<RawEngine::Reader> reader) : reader_(reader) {}
+  ~TtlReader() = default;
+
+  butil::Status KvGet(const std::string& key, std::string& value);
+  butil::Status KvScan(const std::string& start_key, const std::string& end_key,
+                       std::vector<pb::common::KeyValue>& kvs);
+  butil::Status KvCount(const std::string& start_key, const std::string& end_key, int64_t& count);
+
+ private:
+  std::shared_ptr<RawEngine::Reader> reader_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TTL_H_
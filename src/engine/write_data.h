@@ -21,7 +21,7 @@ namespace dingodb {
 
 using WriteCb_t = std::function<void(butil::Status)>;
 
-enum class DatumType { PUT = 0, PUTIFABSENT = 1, CREATESCHEMA = 2 };
+enum class DatumType { PUT = 0, PUTIFABSENT = 1, CREATESCHEMA = 2, INGESTSST = 3 };
 
 class DatumAble {
  public:
@@ -38,6 +38,7 @@ struct PutDatum : public DatumAble {
 
     request->set_cmd_type(pb::raft::CmdType::PUT);
     pb::raft::PutRequest* put_request = request->mutable_put();
+    put_request->set_ts(ts);
     for (auto kv : kvs) {
       put_request->set_cf_name(cf_name);
       put_request->add_kvs()->CopyFrom(kv);
@@ -50,6 +51,8 @@ struct PutDatum : public DatumAble {
 
   std::string cf_name;
   std::vector<pb::common::KeyValue> kvs;
+  // Mvcc write timestamp, 0 is not versioned.
+  uint64_t ts = 0;
 };
 
 struct PutIfAbsentDatum : public DatumAble {
@@ -60,6 +63,8 @@ struct PutIfAbsentDatum : public DatumAble {
 
     request->set_cmd_type(pb::raft::CmdType::PUTIFABSENT);
     pb::raft::PutIfAbsentRequest* put_if_absent_request = request->mutable_put_if_absent();
+    put_if_absent_request->set_expire_check_time(expire_check_time);
+    put_if_absent_request->set_allow_partial(!is_atomic);
     for (auto kv : kvs) {
       put_if_absent_request->set_cf_name(cf_name);
       put_if_absent_request->add_kvs()->CopyFrom(kv);
@@ -72,6 +77,33 @@ struct PutIfAbsentDatum : public DatumAble {
 
   std::string cf_name;
   std::vector<pb::common::KeyValue> kvs;
+  // Ttl values expired before this time are treated as absent.
+  int64_t expire_check_time = 0;
+  // Put nothing when any key exists, else put absent keys only.
+  bool is_atomic = true;
+};
+
+struct IngestSstDatum : public DatumAble {
+  DatumType GetType() { return DatumType::INGESTSST; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::INGESTSST);
+    pb::raft::IngestSstRequest* ingest_sst_request = request->mutable_ingest_sst();
+    ingest_sst_request->set_cf_name(cf_name);
+    ingest_sst_request->set_sst(std::move(sst));
+    ingest_sst_request->mutable_range()->CopyFrom(range);
+
+    return request;
+  }
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  // Sst file content.
+  std::string sst;
+  pb::common::Range range;
 };
 
 struct CreateSchemaDatum : public DatumAble {
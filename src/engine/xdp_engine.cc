@@ -0,0 +1,25 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/xdp_engine.h"
+
+namespace dingodb {
+
+XdpEngine::XdpEngine(std::shared_ptr<RawEngine> engine) : RaftKvEngine(engine) {}
+
+std::string XdpEngine::GetName() { return pb::common::Engine_Name(pb::common::ENG_XDP); }
+
+pb::common::Engine XdpEngine::GetID() { return pb::common::ENG_XDP; }
+
+}  // namespace dingodb
@@ -0,0 +1,39 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_XDP_ENGINE_H_
+#define DINGODB_ENGINE_XDP_ENGINE_H_
+
+#include <memory>
+#include <string>
+
+#include "engine/raft_kv_engine.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Engine of ENG_XDP tables, regions are replicated by raft as RaftKvEngine and applied to RawXdpEngine.
+class XdpEngine : public RaftKvEngine {
+ public:
+  XdpEngine(std::shared_ptr<RawEngine> engine);
+  ~XdpEngine() override = default;
+
+  std::string GetName() override;
+  pb::common::Engine GetID() override;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_XDP_ENGINE_H_
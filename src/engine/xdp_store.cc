@@ -0,0 +1,874 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/xdp_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "butil/crc32c.h"
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+namespace {
+
+enum RecordType : uint8_t {
+  kRecordPut = 0,
+  kRecordDelete = 1,
+};
+
+// Hint entry: seq(8) + key_size(4) + value_size(4) + value_offset(8) + key, file ends with crc32c(4) of entries.
+const size_t kHintHeaderSize = 24;
+// Buffered bytes of merge output before written.
+const size_t kMergeBufferSize = 1024 * 1024;
+
+void PutFixed32(std::string& buf, uint32_t value) {
+  char data[4];
+  for (int i = 0; i < 4; ++i) {
+    data[i] = static_cast<char>((value >> (i * 8)) & 0xff);
+  }
+  buf.append(data, 4);
+}
+
+void PutFixed64(std::string& buf, uint64_t value) {
+  char data[8];
+  for (int i = 0; i < 8; ++i) {
+    data[i] = static_cast<char>((value >> (i * 8)) & 0xff);
+  }
+  buf.append(data, 8);
+}
+
+uint32_t DecodeFixed32(const char* data) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+  }
+  return value;
+}
+
+uint64_t DecodeFixed64(const char* data) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+  }
+  return value;
+}
+
+void EncodeRecord(uint64_t seq, RecordType type, const std::string& key, const std::string& value,
+                  std::string& buf) {
+  size_t start = buf.size();
+  buf.append(4, '\0');
+  PutFixed64(buf, seq);
+  buf.push_back(static_cast<char>(type));
+  PutFixed32(buf, key.size());
+  PutFixed32(buf, value.size());
+  buf.append(key);
+  buf.append(value);
+  uint32_t crc = butil::crc32c::Value(buf.data() + start + 4, buf.size() - start - 4);
+  for (int i = 0; i < 4; ++i) {
+    buf[start + i] = static_cast<char>((crc >> (i * 8)) & 0xff);
+  }
+}
+
+struct Record {
+  uint64_t offset;
+  uint64_t seq;
+  RecordType type;
+  std::string key;
+  uint64_t value_offset;
+  uint32_t value_size;
+};
+
+// Decode record at offset, false at end of data, bad checksum or truncated record.
+bool DecodeRecord(const char* data, uint64_t size, uint64_t offset, size_t header_size, Record& record) {
+  if (size - offset < header_size) {
+    return false;
+  }
+  const char* p = data + offset;
+  uint32_t key_size = DecodeFixed32(p + 13);
+  uint32_t value_size = DecodeFixed32(p + 17);
+  uint64_t record_size = static_cast<uint64_t>(header_size) + key_size + value_size;
+  if (size - offset < record_size) {
+    return false;
+  }
+  if (butil::crc32c::Value(p + 4, record_size - 4) != DecodeFixed32(p)) {
+    return false;
+  }
+  uint8_t type = static_cast<uint8_t>(p[12]);
+  if (type != kRecordPut && type != kRecordDelete) {
+    return false;
+  }
+  record.offset = offset;
+  record.seq = DecodeFixed64(p + 4);
+  record.type = static_cast<RecordType>(type);
+  record.key.assign(p + header_size, key_size);
+  record.value_offset = offset + header_size + key_size;
+  record.value_size = value_size;
+  return true;
+}
+
+bool ReadFile(const std::string& path, std::string& content) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  content.clear();
+  char buf[64 * 1024];
+  while (true) {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return false;
+    }
+    if (n == 0) {
+      break;
+    }
+    content.append(buf, n);
+  }
+  close(fd);
+  return true;
+}
+
+}  // namespace
+
+XdpDataFile::XdpDataFile(const std::string& path, uint32_t id, int fd, uint64_t size)
+    : path_(path), id_(id), fd_(fd), size_(size), data_(nullptr), sealed_(false), obsolete_(false) {}
+
+XdpDataFile::~XdpDataFile() {
+  const char* data = data_.load();
+  if (data != nullptr) {
+    munmap(const_cast<char*>(data), size_.load());
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+  if (obsolete_) {
+    unlink(path_.c_str());
+  }
+}
+
+std::shared_ptr<XdpDataFile> XdpDataFile::Create(const std::string& path, uint32_t id) {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    LOG(ERROR) << butil::StringPrintf("Create xdp data file %s failed, errno: %d", path.c_str(), errno);
+    return nullptr;
+  }
+  return std::shared_ptr<XdpDataFile>(new XdpDataFile(path, id, fd, 0));
+}
+
+std::shared_ptr<XdpDataFile> XdpDataFile::OpenSealed(const std::string& path, uint32_t id) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG(ERROR) << butil::StringPrintf("Open xdp data file %s failed, errno: %d", path.c_str(), errno);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    LOG(ERROR) << butil::StringPrintf("Stat xdp data file %s failed, errno: %d", path.c_str(), errno);
+    close(fd);
+    return nullptr;
+  }
+  std::shared_ptr<XdpDataFile> file(new XdpDataFile(path, id, fd, st.st_size));
+  if (!file->Seal()) {
+    return nullptr;
+  }
+  return file;
+}
+
+bool XdpDataFile::Append(const std::string& data, uint64_t& offset) {
+  offset = size_.load(std::memory_order_relaxed);
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = pwrite(fd_, data.data() + written, data.size() - written, offset + written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << butil::StringPrintf("Write xdp data file %s failed, errno: %d", path_.c_str(), errno);
+      Truncate(offset);
+      return false;
+    }
+    written += n;
+  }
+  size_.store(offset + data.size(), std::memory_order_release);
+  return true;
+}
+
+bool XdpDataFile::Truncate(uint64_t size) {
+  size_.store(size, std::memory_order_release);
+  if (ftruncate(fd_, size) != 0) {
+    LOG(ERROR) << butil::StringPrintf("Truncate xdp data file %s failed, errno: %d", path_.c_str(), errno);
+    return false;
+  }
+  return true;
+}
+
+bool XdpDataFile::Remove() {
+  if (unlink(path_.c_str()) != 0 && errno != ENOENT) {
+    LOG(ERROR) << butil::StringPrintf("Remove xdp data file %s failed, errno: %d", path_.c_str(), errno);
+    return false;
+  }
+  return true;
+}
+
+bool XdpDataFile::Sync() {
+  if (fdatasync(fd_) != 0) {
+    LOG(ERROR) << butil::StringPrintf("Sync xdp data file %s failed, errno: %d", path_.c_str(), errno);
+    return false;
+  }
+  return true;
+}
+
+bool XdpDataFile::Seal() {
+  uint64_t size = size_.load();
+  if (size > 0) {
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      LOG(ERROR) << butil::StringPrintf("Map xdp data file %s failed, errno: %d", path_.c_str(), errno);
+      return false;
+    }
+    madvise(data, size, MADV_RANDOM);
+    data_.store(static_cast<const char*>(data), std::memory_order_release);
+  }
+  sealed_.store(true, std::memory_order_release);
+  return true;
+}
+
+bool XdpDataFile::Read(uint64_t offset, size_t size, std::string& data) const {
+  if (offset + size > Size()) {
+    return false;
+  }
+  const char* mapped = Data();
+  if (mapped != nullptr) {
+    data.assign(mapped + offset, size);
+    return true;
+  }
+  data.resize(size);
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pread(fd_, data.data() + done, size - done, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      LOG(ERROR) << butil::StringPrintf("Read xdp data file %s failed, errno: %d", path_.c_str(), errno);
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+XdpStore::XdpStore(const Options& options)
+    : options_(options), next_file_id_(1), next_seq_(1), total_bytes_(0), live_bytes_(0), key_count_(0) {}
+
+std::string XdpStore::DataFilePath(uint32_t id) const {
+  return butil::StringPrintf("%s/%09u.data", options_.path.c_str(), id);
+}
+
+std::string XdpStore::HintFilePath(uint32_t id) const {
+  return butil::StringPrintf("%s/%09u.hint", options_.path.c_str(), id);
+}
+
+bool XdpStore::Open() {
+  std::error_code ec;
+  std::filesystem::create_directories(options_.path, ec);
+  if (ec) {
+    LOG(ERROR) << butil::StringPrintf("Create xdp path %s failed, %s", options_.path.c_str(), ec.message().c_str());
+    return false;
+  }
+
+  std::vector<uint32_t> ids;
+  for (const auto& entry : std::filesystem::directory_iterator(options_.path, ec)) {
+    const auto& path = entry.path();
+    if (path.extension() == ".tmp") {
+      // Hint file of an unfinished merge.
+      std::filesystem::remove(path, ec);
+    } else if (path.extension() == ".data") {
+      ids.push_back(static_cast<uint32_t>(std::strtoul(path.stem().c_str(), nullptr, 10)));
+    }
+  }
+  if (ec) {
+    LOG(ERROR) << butil::StringPrintf("List xdp path %s failed, %s", options_.path.c_str(), ec.message().c_str());
+    return false;
+  }
+  std::sort(ids.begin(), ids.end());
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::map<std::string, uint64_t> tombstones;
+  uint64_t max_seq = 0;
+  for (auto id : ids) {
+    next_file_id_ = std::max(next_file_id_, id + 1);
+    auto file = XdpDataFile::OpenSealed(DataFilePath(id), id);
+    if (file == nullptr) {
+      return false;
+    }
+    if (file->Size() == 0) {
+      file->MarkObsolete();
+      unlink(HintFilePath(id).c_str());
+      continue;
+    }
+    files_[id] = file;
+    if (!Load(file, tombstones, max_seq)) {
+      return false;
+    }
+  }
+  next_seq_ = max_seq + 1;
+
+  uint32_t id = next_file_id_++;
+  active_file_ = XdpDataFile::Create(DataFilePath(id), id);
+  if (active_file_ == nullptr) {
+    return false;
+  }
+  files_[id] = active_file_;
+
+  int64_t total_bytes = 0;
+  for (const auto& [id, file] : files_) {
+    total_bytes += file->Size();
+  }
+  int64_t live_bytes = 0;
+  for (const auto& [key, location] : keydir_) {
+    live_bytes += RecordSize(key, location);
+    file_live_bytes_[location.file_id] += RecordSize(key, location);
+  }
+  total_bytes_ = total_bytes;
+  live_bytes_ = live_bytes;
+  key_count_ = keydir_.size();
+
+  LOG(INFO) << butil::StringPrintf("Open xdp store %s, files: %lu keys: %lu total bytes: %ld live bytes: %ld",
+                                   options_.path.c_str(), files_.size(), keydir_.size(), total_bytes, live_bytes);
+  return true;
+}
+
+bool XdpStore::Load(std::shared_ptr<XdpDataFile> file, std::map<std::string, uint64_t>& tombstones,
+                    uint64_t& max_seq) {
+  auto apply_put = [&](const std::string& key, const Location& location) {
+    max_seq = std::max(max_seq, location.seq);
+    auto tombstone = tombstones.find(key);
+    if (tombstone != tombstones.end() && tombstone->second > location.seq) {
+      return;
+    }
+    auto it = keydir_.find(key);
+    if (it == keydir_.end()) {
+      keydir_.emplace(key, location);
+    } else if (it->second.seq <= location.seq) {
+      it->second = location;
+    }
+  };
+
+  // Hint file is only written by merge, holds every put record of the data file.
+  std::string hint;
+  if (ReadFile(HintFilePath(file->Id()), hint) && hint.size() >= 4 &&
+      butil::crc32c::Value(hint.data(), hint.size() - 4) == DecodeFixed32(hint.data() + hint.size() - 4)) {
+    size_t offset = 0;
+    size_t size = hint.size() - 4;
+    bool valid = true;
+    while (offset < size) {
+      if (size - offset < kHintHeaderSize) {
+        valid = false;
+        break;
+      }
+      const char* p = hint.data() + offset;
+      Location location;
+      location.file_id = file->Id();
+      location.seq = DecodeFixed64(p);
+      uint32_t key_size = DecodeFixed32(p + 8);
+      location.value_size = DecodeFixed32(p + 12);
+      location.value_offset = DecodeFixed64(p + 16);
+      if (size - offset - kHintHeaderSize < key_size || location.value_offset + location.value_size > file->Size()) {
+        valid = false;
+        break;
+      }
+      apply_put(std::string(p + kHintHeaderSize, key_size), location);
+      offset += kHintHeaderSize + key_size;
+    }
+    if (valid) {
+      return true;
+    }
+  }
+
+  const char* data = file->Data();
+  uint64_t size = file->Size();
+  uint64_t offset = 0;
+  Record record;
+  while (offset < size && DecodeRecord(data, size, offset, kRecordHeaderSize, record)) {
+    if (record.type == kRecordPut) {
+      apply_put(record.key, Location{file->Id(), record.value_size, record.value_offset, record.seq});
+    } else {
+      max_seq = std::max(max_seq, record.seq);
+      auto it = keydir_.find(record.key);
+      if (it != keydir_.end() && it->second.seq < record.seq) {
+        keydir_.erase(it);
+      }
+      auto& tombstone = tombstones[record.key];
+      tombstone = std::max(tombstone, record.seq);
+    }
+    offset = record.value_offset + record.value_size;
+  }
+  if (offset < size) {
+    // Tail of a crashed write.
+    LOG(WARNING) << butil::StringPrintf("Xdp data file %s is broken at offset %lu of size %lu",
+                                        file->Path().c_str(), offset, size);
+  }
+  return true;
+}
+
+XdpStore::View XdpStore::GetView() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return View{std::make_shared<const Keydir>(keydir_), files_};
+}
+
+XdpStore::View XdpStore::GetView(const std::string& start_key, const std::string& end_key) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto begin = keydir_.lower_bound(start_key);
+  auto end = end_key.empty() ? keydir_.end() : keydir_.lower_bound(end_key);
+  if (!end_key.empty() && end_key <= start_key) {
+    end = begin;
+  }
+  return View{std::make_shared<const Keydir>(begin, end), files_};
+}
+
+bool XdpStore::ReadValue(const DataFiles& files, const Location& location, std::string& value) {
+  auto it = files.find(location.file_id);
+  if (it == files.end()) {
+    return false;
+  }
+  return it->second->Read(location.value_offset, location.value_size, value);
+}
+
+bool XdpStore::Get(const std::string& key, std::string& value) const {
+  Location location;
+  std::shared_ptr<XdpDataFile> file;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = keydir_.find(key);
+    if (it == keydir_.end()) {
+      return false;
+    }
+    location = it->second;
+    auto file_it = files_.find(location.file_id);
+    if (file_it == files_.end()) {
+      return false;
+    }
+    file = file_it->second;
+  }
+  return file->Read(location.value_offset, location.value_size, value);
+}
+
+bool XdpStore::Get(const View& view, const std::string& key, std::string& value) {
+  auto it = view.keydir->find(key);
+  if (it == view.keydir->end()) {
+    return false;
+  }
+  return ReadValue(view.files, it->second, value);
+}
+
+bool XdpStore::Sync() {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return active_file_->Sync();
+}
+
+bool XdpStore::NeedMerge(int ratio) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  int64_t total_bytes = 0;
+  int64_t live_bytes = 0;
+  for (const auto& [id, file] : files_) {
+    if (file == active_file_) {
+      continue;
+    }
+    total_bytes += file->Size();
+    auto it = file_live_bytes_.find(id);
+    if (it != file_live_bytes_.end()) {
+      live_bytes += it->second;
+    }
+  }
+  int64_t garbage_bytes = total_bytes - live_bytes;
+  return total_bytes > 0 && garbage_bytes * 100 >= ratio * total_bytes;
+}
+
+void XdpStore::AddLocation(const std::string& key, const Location& location) {
+  live_bytes_.fetch_add(RecordSize(key, location), std::memory_order_relaxed);
+  file_live_bytes_[location.file_id] += RecordSize(key, location);
+}
+
+void XdpStore::RemoveLocation(const std::string& key, const Location& location) {
+  live_bytes_.fetch_sub(RecordSize(key, location), std::memory_order_relaxed);
+  file_live_bytes_[location.file_id] -= RecordSize(key, location);
+}
+
+bool XdpStore::AppendLocked(const std::string& records, uint64_t& offset, uint32_t& file_id) {
+  if (active_file_->Size() > 0 && active_file_->Size() + records.size() > options_.max_file_size) {
+    if (!active_file_->Sync() || !active_file_->Seal()) {
+      return false;
+    }
+    uint32_t id = next_file_id_;
+    auto file = XdpDataFile::Create(DataFilePath(id), id);
+    if (file == nullptr) {
+      return false;
+    }
+    ++next_file_id_;
+    active_file_ = file;
+    files_[id] = file;
+  }
+  if (!active_file_->Append(records, offset)) {
+    return false;
+  }
+  // Records not synced are not applied, drop them so later records do not follow unreferenced ones.
+  if (options_.sync_write && !active_file_->Sync()) {
+    active_file_->Truncate(offset);
+    return false;
+  }
+  file_id = active_file_->Id();
+  total_bytes_.fetch_add(records.size(), std::memory_order_relaxed);
+  return true;
+}
+
+bool XdpStore::WriteHint(uint32_t id, const std::string& hint) {
+  std::string content = hint;
+  PutFixed32(content, butil::crc32c::Value(content.data(), content.size()));
+
+  std::string path = HintFilePath(id);
+  std::string tmp_path = path + ".tmp";
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    LOG(ERROR) << butil::StringPrintf("Create xdp hint file %s failed, errno: %d", tmp_path.c_str(), errno);
+    return false;
+  }
+  size_t written = 0;
+  while (written < content.size()) {
+    ssize_t n = write(fd, content.data() + written, content.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      LOG(ERROR) << butil::StringPrintf("Write xdp hint file %s failed, errno: %d", tmp_path.c_str(), errno);
+      close(fd);
+      unlink(tmp_path.c_str());
+      return false;
+    }
+    written += n;
+  }
+  if (fdatasync(fd) != 0 || close(fd) != 0 || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << butil::StringPrintf("Finish xdp hint file %s failed, errno: %d", path.c_str(), errno);
+    unlink(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool XdpStore::Merge() {
+  std::lock_guard<std::mutex> merge_lock(merge_mutex_);
+
+  std::vector<std::shared_ptr<XdpDataFile> > inputs;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& [id, file] : files_) {
+      if (file != active_file_) {
+        inputs.push_back(file);
+      }
+    }
+  }
+  if (inputs.empty()) {
+    return true;
+  }
+
+  struct Move {
+    std::string key;
+    Location from;
+    Location to;
+  };
+  std::vector<Move> moves;
+  // Smallest sequence of every input file.
+  std::vector<std::pair<uint64_t, std::shared_ptr<XdpDataFile> > > removes;
+  std::vector<std::shared_ptr<XdpDataFile> > outputs;
+  std::shared_ptr<XdpDataFile> output;
+  std::string buffer;
+  std::string hint;
+
+  auto flush_output = [&]() -> bool {
+    uint64_t offset = 0;
+    bool ret = buffer.empty() || output->Append(buffer, offset);
+    buffer.clear();
+    return ret;
+  };
+  auto finish_output = [&]() -> bool {
+    if (output == nullptr) {
+      return true;
+    }
+    if (!flush_output() || !output->Sync() || !output->Seal() || !WriteHint(output->Id(), hint)) {
+      return false;
+    }
+    outputs.push_back(output);
+    output = nullptr;
+    hint.clear();
+    return true;
+  };
+  auto abort_merge = [&]() -> bool {
+    if (output != nullptr) {
+      outputs.push_back(output);
+    }
+    for (auto& file : outputs) {
+      file->MarkObsolete();
+      unlink(HintFilePath(file->Id()).c_str());
+    }
+    return false;
+  };
+
+  for (const auto& file : inputs) {
+    const char* data = file->Data();
+    uint64_t size = file->Size();
+    uint64_t offset = 0;
+    uint64_t min_seq = UINT64_MAX;
+    Record record;
+    while (offset < size && DecodeRecord(data, size, offset, kRecordHeaderSize, record)) {
+      uint64_t record_size = record.value_offset + record.value_size - offset;
+      offset += record_size;
+      min_seq = std::min(min_seq, record.seq);
+      // Tombstones are dropped, all older records of the key are in merged files.
+      if (record.type != kRecordPut) {
+        continue;
+      }
+      {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = keydir_.find(record.key);
+        if (it == keydir_.end() || it->second.file_id != file->Id() ||
+            it->second.value_offset != record.value_offset) {
+          continue;
+        }
+      }
+
+      if (output != nullptr && output->Size() + buffer.size() + record_size > options_.max_file_size) {
+        if (!finish_output()) {
+          return abort_merge();
+        }
+      }
+      if (output == nullptr) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        uint32_t id = next_file_id_;
+        output = XdpDataFile::Create(DataFilePath(id), id);
+        if (output == nullptr) {
+          return abort_merge();
+        }
+        ++next_file_id_;
+      }
+
+      Location to;
+      to.file_id = output->Id();
+      to.seq = record.seq;
+      to.value_size = record.value_size;
+      to.value_offset = output->Size() + buffer.size() + kRecordHeaderSize + record.key.size();
+      buffer.append(data + record.offset, record_size);
+
+      PutFixed64(hint, to.seq);
+      PutFixed32(hint, record.key.size());
+      PutFixed32(hint, to.value_size);
+      PutFixed64(hint, to.value_offset);
+      hint.append(record.key);
+
+      Location from{file->Id(), record.value_size, record.value_offset, record.seq};
+      moves.push_back(Move{std::move(record.key), from, to});
+
+      if (buffer.size() >= kMergeBufferSize && !flush_output()) {
+        return abort_merge();
+      }
+    }
+    removes.emplace_back(min_seq, file);
+  }
+  if (!finish_output()) {
+    return abort_merge();
+  }
+
+  int64_t input_bytes = 0;
+  int64_t output_bytes = 0;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& move : moves) {
+      auto it = keydir_.find(move.key);
+      // Key is rewritten or deleted during merge, the copy is garbage.
+      if (it != keydir_.end() && it->second.file_id == move.from.file_id &&
+          it->second.value_offset == move.from.value_offset) {
+        RemoveLocation(it->first, move.from);
+        it->second = move.to;
+        AddLocation(it->first, move.to);
+      }
+    }
+    for (const auto& file : outputs) {
+      files_[file->Id()] = file;
+      output_bytes += file->Size();
+    }
+    for (const auto& file : inputs) {
+      files_.erase(file->Id());
+      file_live_bytes_.erase(file->Id());
+      input_bytes += file->Size();
+    }
+    total_bytes_.fetch_add(output_bytes - input_bytes, std::memory_order_relaxed);
+  }
+
+  // Tombstones are dropped, a crash while removing inputs must not leave a put whose tombstone file is removed.
+  // Tombstones are only in files never merged, whose records are newer than every merged record, so removing in
+  // order of smallest sequence removes older puts of a key before its tombstone. Files left by a failure are
+  // loaded and merged again after restart.
+  std::sort(removes.begin(), removes.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  for (const auto& [min_seq, file] : removes) {
+    unlink(HintFilePath(file->Id()).c_str());
+    if (!file->Remove()) {
+      break;
+    }
+  }
+
+  LOG(INFO) << butil::StringPrintf("Merge xdp store %s, files: %lu to %lu bytes: %ld to %ld", options_.path.c_str(),
+                                   inputs.size(), outputs.size(), input_bytes, output_bytes);
+  return true;
+}
+
+XdpStore::Iterator::Iterator(View view, const std::string& start_key, const std::string& end_key)
+    : view_(std::move(view)) {
+  iter_ = view_.keydir->lower_bound(start_key);
+  end_ = end_key.empty() ? view_.keydir->end() : view_.keydir->lower_bound(end_key);
+  if (!end_key.empty() && end_key <= start_key) {
+    iter_ = end_;
+  }
+  ReadValue();
+}
+
+void XdpStore::Iterator::Next() {
+  ++iter_;
+  ReadValue();
+}
+
+void XdpStore::Iterator::ReadValue() {
+  value_.clear();
+  if (iter_ != end_ && !XdpStore::ReadValue(view_.files, iter_->second, value_)) {
+    LOG(ERROR) << butil::StringPrintf("Read xdp value failed, file: %u offset: %lu", iter_->second.file_id,
+                                      iter_->second.value_offset);
+  }
+}
+
+XdpStore::WriteBatch::WriteBatch(XdpStore* store) : store_(store), lock_(store->mutex_) {}
+
+XdpStore::WriteBatch::~WriteBatch() = default;
+
+bool XdpStore::WriteBatch::Get(const std::string& key, std::string& value) {
+  auto it = writes_.find(key);
+  if (it != writes_.end()) {
+    if (!it->second.has_value()) {
+      return false;
+    }
+    value = it->second.value();
+    return true;
+  }
+  auto keydir_it = store_->keydir_.find(key);
+  if (keydir_it == store_->keydir_.end()) {
+    return false;
+  }
+  return ReadValue(store_->files_, keydir_it->second, value);
+}
+
+void XdpStore::WriteBatch::Put(const std::string& key, const std::string& value) { writes_[key] = value; }
+
+void XdpStore::WriteBatch::Delete(const std::string& key) { writes_[key] = std::nullopt; }
+
+void XdpStore::WriteBatch::DeleteRange(const std::string& start_key, const std::string& end_key) {
+  if (!end_key.empty() && end_key <= start_key) {
+    return;
+  }
+  const auto& keydir = store_->keydir_;
+  auto end = end_key.empty() ? keydir.end() : keydir.lower_bound(end_key);
+  for (auto it = keydir.lower_bound(start_key); it != end; ++it) {
+    writes_[it->first] = std::nullopt;
+  }
+  auto write_end = end_key.empty() ? writes_.end() : writes_.lower_bound(end_key);
+  for (auto it = writes_.lower_bound(start_key); it != write_end; ++it) {
+    it->second = std::nullopt;
+  }
+}
+
+bool XdpStore::WriteBatch::Commit() {
+  auto& keydir = store_->keydir_;
+
+  struct Entry {
+    const std::string* key;
+    const std::optional<std::string>* value;
+    uint64_t seq;
+    uint64_t value_offset;
+  };
+  std::vector<Entry> entries;
+  entries.reserve(writes_.size());
+  std::string records;
+  uint64_t seq = store_->next_seq_;
+  for (const auto& [key, value] : writes_) {
+    // Tombstone is only needed when an older record exists.
+    if (!value.has_value() && keydir.find(key) == keydir.end()) {
+      continue;
+    }
+    uint64_t value_offset = records.size() + kRecordHeaderSize + key.size();
+    EncodeRecord(seq, value.has_value() ? kRecordPut : kRecordDelete, key, value.has_value() ? value.value() : "",
+                 records);
+    entries.push_back(Entry{&key, &value, seq++, value_offset});
+  }
+  if (entries.empty()) {
+    return true;
+  }
+
+  uint64_t offset = 0;
+  uint32_t file_id = 0;
+  if (!store_->AppendLocked(records, offset, file_id)) {
+    return false;
+  }
+  store_->next_seq_ = seq;
+
+  for (const auto& entry : entries) {
+    auto it = keydir.find(*entry.key);
+    if (it != keydir.end()) {
+      store_->RemoveLocation(it->first, it->second);
+    }
+    if (!entry.value->has_value()) {
+      keydir.erase(it);
+      continue;
+    }
+    Location location{file_id, static_cast<uint32_t>(entry.value->value().size()), offset + entry.value_offset,
+                      entry.seq};
+    if (it == keydir.end()) {
+      it = keydir.emplace(*entry.key, location).first;
+    } else {
+      it->second = location;
+    }
+    store_->AddLocation(it->first, location);
+  }
+  store_->key_count_.store(keydir.size(), std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace dingodb
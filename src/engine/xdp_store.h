@@ -0,0 +1,229 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_XDP_STORE_H_
+#define DINGODB_ENGINE_XDP_STORE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+// Append only data file. The writable one is read by pread, sealed ones are mapped and read from memory.
+class XdpDataFile {
+ public:
+  ~XdpDataFile();
+
+  XdpDataFile(const XdpDataFile&) = delete;
+  XdpDataFile& operator=(const XdpDataFile&) = delete;
+
+  // Create an empty writable file.
+  static std::shared_ptr<XdpDataFile> Create(const std::string& path, uint32_t id);
+  // Open an existing file as sealed.
+  static std::shared_ptr<XdpDataFile> OpenSealed(const std::string& path, uint32_t id);
+
+  uint32_t Id() const { return id_; }
+  const std::string& Path() const { return path_; }
+  uint64_t Size() const { return size_.load(std::memory_order_acquire); }
+  bool IsSealed() const { return sealed_.load(std::memory_order_acquire); }
+
+  // Write at end of file, return offset of data. Partly written data is dropped on failure.
+  bool Append(const std::string& data, uint64_t& offset);
+  bool Sync();
+  // Drop data from size to end of writable file.
+  bool Truncate(uint64_t size);
+  // Stop writing, map the whole file.
+  bool Seal();
+
+  bool Read(uint64_t offset, size_t size, std::string& data) const;
+  // Content of sealed file, nullptr if the file is empty or not sealed.
+  const char* Data() const { return data_.load(std::memory_order_acquire); }
+
+  // File is removed when the last reader releases it.
+  void MarkObsolete() { obsolete_ = true; }
+  // Remove file at once, it is still readable by holders.
+  bool Remove();
+
+ private:
+  XdpDataFile(const std::string& path, uint32_t id, int fd, uint64_t size);
+
+  std::string path_;
+  uint32_t id_;
+  int fd_;
+  std::atomic<uint64_t> size_;
+  std::atomic<const char*> data_;
+  std::atomic<bool> sealed_;
+  std::atomic<bool> obsolete_;
+};
+
+// Bitcask style key value of one column family.
+// Every write is appended to the active data file as a record, and an in memory keydir maps every
+// live key to the position of its latest value, so a read is one lookup and one read of the file.
+// Full active file is sealed and mapped. Merge rewrites live records of sealed files into new files
+// with hint files for fast recovery, then removes the old files. Keydir is rebuilt from hint and
+// data files at open, the record of the largest sequence wins.
+// Keydir is ordered, for range scan and delete range of regions.
+class XdpStore {
+ public:
+  struct Options {
+    std::string path;
+    uint64_t max_file_size = 256 * 1024 * 1024;
+    // fdatasync every write batch.
+    bool sync_write = false;
+  };
+
+  struct Location {
+    uint32_t file_id = 0;
+    uint32_t value_size = 0;
+    uint64_t value_offset = 0;
+    uint64_t seq = 0;
+  };
+
+  using Keydir = std::map<std::string, Location>;
+  using DataFiles = std::map<uint32_t, std::shared_ptr<XdpDataFile> >;
+
+  explicit XdpStore(const Options& options);
+  ~XdpStore() = default;
+
+  XdpStore(const XdpStore&) = delete;
+  XdpStore& operator=(const XdpStore&) = delete;
+
+  // Rebuild keydir from files of path.
+  bool Open();
+
+  // Consistent read view, keydir is copied and files are held.
+  struct View {
+    std::shared_ptr<const Keydir> keydir;
+    DataFiles files;
+  };
+
+  // View of all keys, or only keys in [start_key, end_key) are copied.
+  View GetView() const;
+  View GetView(const std::string& start_key, const std::string& end_key) const;
+
+  // Read latest or at view. Return false when key not exists.
+  bool Get(const std::string& key, std::string& value) const;
+  static bool Get(const View& view, const std::string& key, std::string& value);
+
+  // Rewrite live records of sealed files, return false on io error.
+  bool Merge();
+  // Garbage percent of sealed files is not less than ratio, active file is not merged so it is not counted.
+  bool NeedMerge(int ratio) const;
+  bool Sync();
+
+  int64_t TotalBytes() const { return total_bytes_.load(std::memory_order_relaxed); }
+  int64_t LiveBytes() const { return live_bytes_.load(std::memory_order_relaxed); }
+  int64_t KeyCount() const { return key_count_.load(std::memory_order_relaxed); }
+
+  // Iterate keys of a view in order, key and value are valid until iterator moves.
+  class Iterator {
+   public:
+    Iterator(View view, const std::string& start_key, const std::string& end_key);
+    ~Iterator() = default;
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    bool Valid() const { return iter_ != end_; }
+    void Next();
+
+    const std::string& key() const { return iter_->first; }
+    const std::string& value() const { return value_; }
+
+   private:
+    void ReadValue();
+
+    View view_;
+    Keydir::const_iterator iter_;
+    Keydir::const_iterator end_;
+    std::string value_;
+  };
+
+  // Hold the write lock, records of batch are appended in one write at commit. Conditional writes read and
+  // write in one batch to be atomic.
+  class WriteBatch {
+   public:
+    explicit WriteBatch(XdpStore* store);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+
+    // Read latest, include writes of this batch.
+    bool Get(const std::string& key, std::string& value);
+    void Put(const std::string& key, const std::string& value);
+    void Delete(const std::string& key);
+    // Delete [start_key, end_key), every deleted key writes a tombstone.
+    void DeleteRange(const std::string& start_key, const std::string& end_key);
+
+    // Write records and apply them to keydir, return false on io error and nothing is applied.
+    // Batch not committed is discarded at destruction.
+    bool Commit();
+
+   private:
+    XdpStore* store_;
+    std::unique_lock<std::shared_mutex> lock_;
+    // nullopt value is a delete.
+    std::map<std::string, std::optional<std::string> > writes_;
+  };
+
+ private:
+  // Record: crc32c(4) + seq(8) + type(1) + key_size(4) + value_size(4) + key + value, crc covers the rest.
+  static const size_t kRecordHeaderSize = 21;
+
+  static size_t RecordSize(const std::string& key, const Location& location) {
+    return kRecordHeaderSize + key.size() + location.value_size;
+  }
+  static bool ReadValue(const DataFiles& files, const Location& location, std::string& value);
+
+  std::string DataFilePath(uint32_t id) const;
+  std::string HintFilePath(uint32_t id) const;
+
+  // Load records of a data file, from its hint file if exists.
+  bool Load(std::shared_ptr<XdpDataFile> file, std::map<std::string, uint64_t>& tombstones, uint64_t& max_seq);
+  // Append encoded records to active file, seal and create file when it is full.
+  bool AppendLocked(const std::string& records, uint64_t& offset, uint32_t& file_id);
+  bool WriteHint(uint32_t id, const std::string& hint);
+  void AddLocation(const std::string& key, const Location& location);
+  void RemoveLocation(const std::string& key, const Location& location);
+
+  const Options options_;
+
+  mutable std::shared_mutex mutex_;
+  Keydir keydir_;
+  DataFiles files_;
+  // Live record bytes of every data file.
+  std::map<uint32_t, int64_t> file_live_bytes_;
+  std::shared_ptr<XdpDataFile> active_file_;
+  uint32_t next_file_id_;
+  uint64_t next_seq_;
+
+  // Only one merge at a time.
+  std::mutex merge_mutex_;
+
+  std::atomic<int64_t> total_bytes_;
+  std::atomic<int64_t> live_bytes_;
+  std::atomic<int64_t> key_count_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_XDP_STORE_H_
@@ -56,4 +56,17 @@ bool MetaWriter::Delete(const std::string& key) {
   return true;
 }
 
+bool MetaWriter::PutAndDelete(const std::vector<pb::common::KeyValue>& kvs_put,
+                              const std::vector<pb::common::KeyValue>& kvs_delete) {
+  LOG(INFO) << "PutAndDelete meta data, put key nums: " << kvs_put.size() << " delete key nums: " << kvs_delete.size();
+  auto writer = engine_->NewWriter(Constant::kStoreMetaCF);
+  auto status = writer->KvBatchPutAndDelete(kvs_put, kvs_delete);
+  if (!status.ok()) {
+    LOG(ERROR) << "Meta batch put and delete failed, errcode: " << status.error_code() << " " << status.error_str();
+    return false;
+  }
+
+  return true;
+}
+
 }  // namespace dingodb
@@ -31,6 +31,9 @@ class MetaWriter {
   bool Put(std::shared_ptr<pb::common::KeyValue> kv);
   bool Put(std::vector<pb::common::KeyValue> kvs);
   bool Delete(const std::string &key);
+  // put and delete in one atomic write batch
+  bool PutAndDelete(const std::vector<pb::common::KeyValue> &kvs_put,
+                    const std::vector<pb::common::KeyValue> &kvs_delete);
 
   MetaWriter(const MetaWriter &) = delete;
   const MetaWriter &operator=(const MetaWriter &) = delete;
@@ -18,7 +18,7 @@
 
 #include "braft/util.h"
 #include "butil/strings/stringprintf.h"
-#include "common/helper.h"
+#include "common/logging.h"
 #include "coordinator/coordinator_control.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
@@ -49,7 +49,9 @@ void MetaStateMachine::HandleMetaProcess(bool is_leader, const pb::raft::RaftCmd
   // CoordinatorControl* controller = dynamic_cast<CoordinatorControl*>(meta_control_);
   if (raft_cmd.requests_size() > 0) {
     auto meta_increment = raft_cmd.requests(0).meta_req().meta_increment();
-    meta_control_->ApplyMetaIncrement(meta_increment, is_leader);
+    if (meta_control_->ApplyMetaIncrement(meta_increment, is_leader) < 0) {
+      LOG(ERROR) << butil::StringPrintf("apply meta increment failed, region[%ld]", raft_cmd.header().region_id());
+    }
   }
 }
 
@@ -69,9 +71,9 @@ void MetaStateMachine::on_apply(braft::Iterator& iter) {
       CHECK(raft_cmd.ParseFromZeroCopyStream(&wrapper));
     }
 
-    std::string str_raft_cmd = Helper::MessageToJsonString(raft_cmd);
-    LOG(INFO) << butil::StringPrintf("raft apply log on region[%ld-term:%ld-index:%ld] cmd:[%s]",
-                                     raft_cmd.header().region_id(), iter.term(), iter.index(), str_raft_cmd.c_str());
+    DINGO_LOG_EVERY_SECOND(INFO) << butil::StringPrintf("raft apply log on region[%ld-term:%ld-index:%ld]",
+                                                        raft_cmd.header().region_id(), iter.term(), iter.index())
+                                 << " cmd:[" << ProtoJson(raft_cmd) << "]";
     DispatchRequest(is_leader, raft_cmd);
   }
 }
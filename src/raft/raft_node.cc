@@ -16,9 +16,9 @@
 
 #include "butil/strings/stringprintf.h"
 #include "common/helper.h"
-#include "config/config_manager.h"
 #include "proto/common.pb.h"
 #include "raft/store_state_machine.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
@@ -33,7 +33,7 @@ RaftNode::~RaftNode() {
 }
 
 // init_conf: 127.0.0.1:8201:0,127.0.0.1:8202:0,127.0.0.1:8203:0
-int RaftNode::Init(const std::string& init_conf) {
+int RaftNode::Init(const std::string& init_conf, std::shared_ptr<Config> config) {
   LOG(INFO) << "raft init node_id: " << node_id_ << " init_conf: " << init_conf;
   braft::NodeOptions node_options;
   if (node_options.initial_conf.parse_from(init_conf) != 0) {
@@ -41,8 +41,6 @@ int RaftNode::Init(const std::string& init_conf) {
     return -1;
   }
 
-  auto config = ConfigManager::GetInstance()->GetConfig(role_);
-
   node_options.election_timeout_ms = config->GetInt("raft.electionTimeout");
   node_options.fsm = fsm_;
   node_options.node_owns_fsm = false;
@@ -73,6 +71,16 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
   butil::IOBufAsZeroCopyOutputStream wrapper(&data);
   raft_cmd->SerializeToZeroCopyStream(&wrapper);
 
+  int64_t now_us = butil::gettimeofday_us();
+  StoreMetrics::write_queue_latency << now_us - ctx->StartTimeUs();
+  ctx->SetProposeTimeUs(now_us);
+
+  auto trace = Trace::IsSampled() ? std::make_shared<Trace>(ctx->StartTimeUs()) : nullptr;
+  if (trace != nullptr) {
+    trace->Mark(Trace::kPropose);
+    ctx->SetTrace(trace);
+  }
+
   braft::Task task;
   task.data = &data;
   task.done = new StoreClosure(ctx, raft_cmd);
@@ -108,4 +116,8 @@ void RaftNode::ChangePeers(const std::vector<pb::common::Peer>& peers, braft::Cl
 
 butil::Status RaftNode::ResetPeers(const braft::Configuration& new_peers) { return node_->reset_peers(new_peers); }
 
+int RaftNode::TransferLeadershipTo(const braft::PeerId& peer) { return node_->transfer_leadership_to(peer); }
+
+void RaftNode::GetStatus(braft::NodeStatus* status) { node_->get_status(status); }
+
 }  // namespace dingodb
@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "common/context.h"
+#include "config/config.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
@@ -33,7 +34,8 @@ class RaftNode {
   RaftNode(pb::common::ClusterRole role, uint64_t node_id, braft::PeerId peer_id, braft::StateMachine* fsm);
   ~RaftNode();
 
-  int Init(const std::string& init_conf);
+  // Raft path and timeouts are read from config, each node of one process may has its own.
+  int Init(const std::string& init_conf, std::shared_ptr<Config> config);
   void Destroy();
 
   butil::Status Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd);
@@ -50,6 +52,10 @@ class RaftNode {
   void RemovePeer(const braft::PeerId& peer, braft::Closure* done);
   void ChangePeers(const std::vector<pb::common::Peer>& peers, braft::Closure* done);
   butil::Status ResetPeers(const braft::Configuration& new_peers);
+  int TransferLeadershipTo(const braft::PeerId& peer);
+
+  // Include committed and applied index, for observing replication lag.
+  void GetStatus(braft::NodeStatus* status);
 
  private:
   pb::common::ClusterRole role_;
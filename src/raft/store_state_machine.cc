@@ -14,16 +14,25 @@
 
 #include "raft/store_state_machine.h"
 
+#include <cstdio>
+#include <fstream>
+
 #include "braft/util.h"
 #include "butil/strings/stringprintf.h"
+#include "common/constant.h"
 #include "common/helper.h"
+#include "common/logging.h"
+#include "engine/mvcc.h"
+#include "engine/ttl.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
+#include "proto/store.pb.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
 void StoreClosure::Run() {
-  LOG(INFO) << "Closure run...";
+  int64_t start_time_us = butil::gettimeofday_us();
 
   brpc::ClosureGuard done_guard(ctx_->IsSyncMode() ? nullptr : ctx_->Done());
   if (!status().ok()) {
@@ -41,6 +50,23 @@ void StoreClosure::Run() {
       ctx_->WriteCb()(ctx_->Status());
     }
   }
+
+  done_guard.reset(nullptr);
+  int64_t now_us = butil::gettimeofday_us();
+  StoreMetrics::write_respond_latency << now_us - start_time_us;
+
+  int64_t elapsed_us = now_us - ctx_->StartTimeUs();
+  if (SlowRequestLog::IsSlow(elapsed_us)) {
+    auto trace = ctx_->GetTrace();
+    if (trace != nullptr) {
+      trace->Mark(Trace::kRespond);
+    }
+    std::string cmd_type =
+        request_->requests_size() > 0 ? pb::raft::CmdType_Name(request_->requests(0).cmd_type()) : "";
+    SlowRequestLog::Record(butil::StringPrintf("region[%lu] cmd[%s] elapsed %ldus %s", ctx_->RegionId(),
+                                               cmd_type.c_str(), elapsed_us,
+                                               trace != nullptr ? trace->ToString().c_str() : "not traced"));
+  }
 }
 
 StoreStateMachine::StoreStateMachine(std::shared_ptr<RawEngine> engine)
@@ -59,6 +85,9 @@ void StoreStateMachine::DispatchRequest(
       case pb::raft::CmdType::DELETERANGE:
         HandleDeleteRangeRequest(done, req.delete_range());
         break;
+      case pb::raft::CmdType::INGESTSST:
+        HandleIngestSstRequest(done, raft_cmd.header().region_id(), req.ingest_sst());
+        break;
       default:
         LOG(ERROR) << "Unknown raft cmd type " << req.cmd_type();
     }
@@ -67,10 +96,12 @@ void StoreStateMachine::DispatchRequest(
 
 void StoreStateMachine::HandlePutRequest(StoreClosure* done,
                                          const pb::raft::PutRequest& request) {
-  LOG(INFO) << "handlePutRequest ...";
   butil::Status status;
   auto writer = engine_->NewWriter(request.cf_name());
-  if (request.kvs().size() == 1) {
+  if (request.ts() > 0) {
+    MvccWriter mvcc_writer(writer);
+    status = mvcc_writer.KvBatchPut(request.ts(), Helper::PbRepeatedToVector(request.kvs()));
+  } else if (request.kvs().size() == 1) {
     status = writer->KvPut(request.kvs().Get(0));
   } else {
     status = writer->KvBatchPut(Helper::PbRepeatedToVector(request.kvs()));
@@ -86,22 +117,62 @@ void StoreStateMachine::HandlePutRequest(StoreClosure* done,
 
 void StoreStateMachine::HandlePutIfAbsentRequest(
     StoreClosure* done, const pb::raft::PutIfAbsentRequest& request) {
-  LOG(INFO) << "handlePutIfAbsentRequest ...";
-
   butil::Status status;
   auto writer = engine_->NewWriter(request.cf_name());
-  if (request.kvs().size() == 1) {
+
+  // Expired value is absent. Judge by leader time so all replicas get the same result.
+  // Absent and expired keys are put in one write batch, so the expired value is never deleted without the new
+  // value being put. Apply is serial in region, no other write can interleave.
+  std::vector<std::string> put_keys;
+  bool is_atomic = !request.allow_partial();
+  bool handled = false;
+  if (request.cf_name() == Constant::kStoreTtlCF) {
+    auto reader = engine_->NewReader(request.cf_name());
+    std::vector<pb::common::KeyValue> absent_kvs;
+    bool has_live = false;
+    for (const auto& kv : request.kvs()) {
+      std::string value;
+      if (reader->KvGet(kv.key(), value).ok() && !Ttl::IsExpired(value, request.expire_check_time())) {
+        has_live = true;
+      } else {
+        absent_kvs.push_back(kv);
+      }
+    }
+
+    // Atomic request with a live key fails in the writer below.
+    if (!has_live || !is_atomic) {
+      handled = true;
+      if (!absent_kvs.empty()) {
+        status = writer->KvBatchPut(absent_kvs);
+      }
+      if (status.ok()) {
+        for (const auto& kv : absent_kvs) {
+          put_keys.push_back(kv.key());
+        }
+      }
+    }
+  }
+
+  if (!handled && request.kvs().size() == 1) {
     status = writer->KvPutIfAbsent(request.kvs().Get(0));
-  } else {
-    std::vector<std::string> put_keys;
-    status = writer->KvBatchPutIfAbsent(
-        Helper::PbRepeatedToVector(request.kvs()), put_keys, true);
+    if (status.ok()) {
+      put_keys.push_back(request.kvs().Get(0).key());
+    }
+  } else if (!handled) {
+    status = writer->KvBatchPutIfAbsent(Helper::PbRepeatedToVector(request.kvs()), put_keys, is_atomic);
   }
 
   if (done != nullptr) {
     std::shared_ptr<Context> ctx = done->GetCtx();
     if (ctx) {
       ctx->SetStatus(status);
+      // Only batch response carry put keys.
+      auto* response = dynamic_cast<pb::store::KvBatchPutIfAbsentResponse*>(ctx->Response());
+      if (response != nullptr && status.ok()) {
+        for (const auto& key : put_keys) {
+          response->add_put_keys(key);
+        }
+      }
     }
   }
 }
@@ -128,8 +199,39 @@ void StoreStateMachine::HandleDeleteRangeRequest(
   }
 }
 
+// Every replica write sst to local file of its raw engine then ingest it,
+// apply is serial in region so file name not conflict.
+void StoreStateMachine::HandleIngestSstRequest(StoreClosure* done, uint64_t region_id,
+                                               const pb::raft::IngestSstRequest& request) {
+  LOG(INFO) << "HandleIngestSstRequest ...";
+
+  butil::Status status;
+  std::string db_path = engine_->GetDbPath();
+  if (db_path.empty()) {
+    status = butil::Status(pb::error::ENOT_SUPPORT, "Engine not support ingest sst");
+  } else {
+    std::string file_path = butil::StringPrintf("%s/ingest_%lu.sst", db_path.c_str(), region_id);
+    std::ofstream file(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(request.sst().data(), request.sst().size());
+    file.close();
+    if (!file) {
+      LOG(ERROR) << butil::StringPrintf("write sst file %s failed", file_path.c_str());
+      status = butil::Status(pb::error::EINTERNAL, "Write sst file failed");
+    } else {
+      status = engine_->IngestExternalFile(request.cf_name(), {file_path}, request.range());
+    }
+    std::remove(file_path.c_str());
+  }
+
+  if (done != nullptr) {
+    std::shared_ptr<Context> ctx = done->GetCtx();
+    if (ctx) {
+      ctx->SetStatus(status);
+    }
+  }
+}
+
 void StoreStateMachine::on_apply(braft::Iterator& iter) {
-  LOG(INFO) << "on_apply...";
   for (; iter.valid(); iter.next()) {
     braft::AsyncClosureGuard done_guard(iter.done());
 
@@ -142,12 +244,31 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       CHECK(raft_cmd.ParseFromZeroCopyStream(&wrapper));
     }
 
-    std::string str_raft_cmd = Helper::MessageToJsonString(raft_cmd);
-    LOG(INFO) << butil::StringPrintf(
-        "raft apply log on region[%ld-term:%ld-index:%ld] cmd:[%s]",
-        raft_cmd.header().region_id(), iter.term(), iter.index(),
-        str_raft_cmd.c_str());
-    DispatchRequest(dynamic_cast<StoreClosure*>(iter.done()), raft_cmd);
+    // Every write pass here, json is only formatted when the log is emitted.
+    // Sst content is too large to log.
+    if (raft_cmd.requests_size() > 0 && raft_cmd.requests(0).has_ingest_sst()) {
+      LOG(INFO) << butil::StringPrintf("raft apply log on region[%ld-term:%ld-index:%ld] cmd:[ingest sst size %lu]",
+                                       raft_cmd.header().region_id(), iter.term(), iter.index(),
+                                       raft_cmd.requests(0).ingest_sst().sst().size());
+    } else {
+      DINGO_LOG_EVERY_SECOND(INFO) << butil::StringPrintf("raft apply log on region[%ld-term:%ld-index:%ld]",
+                                                          raft_cmd.header().region_id(), iter.term(), iter.index())
+                                   << " cmd:[" << ProtoJson(raft_cmd) << "]";
+    }
+    StoreClosure* store_closure = dynamic_cast<StoreClosure*>(iter.done());
+    int64_t start_time_us = butil::gettimeofday_us();
+    auto trace = store_closure != nullptr ? store_closure->GetCtx()->GetTrace() : nullptr;
+    if (store_closure != nullptr && store_closure->GetCtx()->ProposeTimeUs() > 0) {
+      StoreMetrics::write_raft_latency << start_time_us - store_closure->GetCtx()->ProposeTimeUs();
+    }
+    if (trace != nullptr) {
+      trace->Mark(Trace::kApply);
+    }
+    DispatchRequest(store_closure, raft_cmd);
+    StoreMetrics::write_apply_latency << butil::gettimeofday_us() - start_time_us;
+    if (trace != nullptr) {
+      trace->Mark(Trace::kApplied);
+    }
   }
 }
 
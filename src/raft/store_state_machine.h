@@ -60,6 +60,7 @@ class StoreStateMachine : public braft::StateMachine {
   void HandlePutRequest(StoreClosure* done, const dingodb::pb::raft::PutRequest& request);
   void HandlePutIfAbsentRequest(StoreClosure* done, const dingodb::pb::raft::PutIfAbsentRequest& request);
   void HandleDeleteRangeRequest(StoreClosure* done, const pb::raft::DeleteRangeRequest& request);
+  void HandleIngestSstRequest(StoreClosure* done, uint64_t region_id, const pb::raft::IngestSstRequest& request);
 
  private:
   std::shared_ptr<RawEngine> engine_;
@@ -0,0 +1,319 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/client.h"
+
+#include <numeric>
+
+#include "brpc/callback.h"
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/strings/stringprintf.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+namespace sdk {
+
+namespace {
+
+// Sub batch of one region.
+template <typename Request, typename Response>
+struct RegionCall {
+  std::shared_ptr<const RegionRoute> route;
+  std::shared_ptr<brpc::Channel> channel;
+  std::vector<size_t> indexes;
+  Request request;
+  Response response;
+  brpc::Controller cntl;
+};
+
+}  // namespace
+
+bool Client::Init(const Options& options) {
+  options_ = options;
+
+  coordinator_interaction_ = std::make_shared<CoordinatorInteraction>();
+  if (!coordinator_interaction_->Init(options.coordinator_addrs)) {
+    LOG(ERROR) << "Init coordinator interaction failed, addrs: " << options.coordinator_addrs;
+    return false;
+  }
+
+  meta_cache_ = std::make_shared<MetaCache>(coordinator_interaction_);
+
+  return true;
+}
+
+template <typename Request, typename Response>
+butil::Status Client::SendRequest(const pb::meta::DingoCommonId& table_id, const std::string& key,
+                                  StoreMethod<Request, Response> method, Request& request, Response& response,
+                                  bool idempotent) {
+  butil::Status status;
+  for (int retry = 0; retry <= options_.max_retry; ++retry) {
+    if (retry > 0) {
+      bthread_usleep(options_.retry_interval_ms * 1000L);
+    }
+
+    std::shared_ptr<const RegionRoute> route;
+    status = meta_cache_->Lookup(table_id, key, route);
+    if (!status.ok()) {
+      continue;
+    }
+
+    auto channel = route->has_leader ? GetChannel(route->leader) : nullptr;
+    if (channel == nullptr) {
+      status = butil::Status(pb::error::ERAFT_NOTLEADER, "Not found leader of region");
+      meta_cache_->Invalidate(table_id.entity_id(), route);
+      continue;
+    }
+
+    request.set_region_id(route->region_id);
+    response.Clear();
+
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(options_.timeout_ms);
+    pb::store::StoreService_Stub stub(channel.get());
+    (stub.*method)(&cntl, &request, &response, nullptr);
+    if (cntl.Failed()) {
+      LOG(WARNING) << butil::StringPrintf("Send request to region %lu failed, error: %d %s", route->region_id,
+                                          cntl.ErrorCode(), cntl.ErrorText().c_str());
+      meta_cache_->Invalidate(table_id.entity_id(), route);
+      if (!idempotent) {
+        return butil::Status(pb::error::EUNKNOWN_RESULT, cntl.ErrorText());
+      }
+      status = butil::Status(cntl.ErrorCode(), cntl.ErrorText());
+      continue;
+    }
+
+    if (response.error().errcode() == pb::error::OK) {
+      return butil::Status();
+    }
+
+    status = butil::Status(response.error().errcode(), response.error().errmsg());
+    if (!IsRetriable(response.error().errcode())) {
+      return status;
+    }
+    meta_cache_->Invalidate(table_id.entity_id(), route);
+  }
+
+  return status;
+}
+
+template <typename Request, typename Response>
+butil::Status Client::SendBatchRequest(const pb::meta::DingoCommonId& table_id, size_t count,
+                                       const std::function<const std::string&(size_t)>& key_of,
+                                       StoreMethod<Request, Response> method,
+                                       const std::function<void(const std::vector<size_t>&, Request&)>& fill,
+                                       const std::function<void(const Response&)>& collect, bool idempotent) {
+  std::vector<size_t> pending(count);
+  std::iota(pending.begin(), pending.end(), 0);
+
+  butil::Status status;
+  for (int retry = 0; retry <= options_.max_retry && !pending.empty(); ++retry) {
+    if (retry > 0) {
+      bthread_usleep(options_.retry_interval_ms * 1000L);
+    }
+
+    // Split keys by region.
+    std::vector<size_t> failed;
+    std::map<uint64_t, std::unique_ptr<RegionCall<Request, Response> > > calls;
+    for (auto index : pending) {
+      std::shared_ptr<const RegionRoute> route;
+      auto lookup_status = meta_cache_->Lookup(table_id, key_of(index), route);
+      if (!lookup_status.ok()) {
+        status = lookup_status;
+        failed.push_back(index);
+        continue;
+      }
+
+      auto& call = calls[route->region_id];
+      if (call == nullptr) {
+        call = std::make_unique<RegionCall<Request, Response> >();
+        call->route = route;
+      }
+      call->indexes.push_back(index);
+    }
+
+    // Send sub batches asynchronously, then wait all of them.
+    for (auto& [region_id, call] : calls) {
+      call->channel = call->route->has_leader ? GetChannel(call->route->leader) : nullptr;
+      if (call->channel == nullptr) {
+        continue;
+      }
+
+      fill(call->indexes, call->request);
+      call->request.set_region_id(region_id);
+      call->cntl.set_timeout_ms(options_.timeout_ms);
+      pb::store::StoreService_Stub stub(call->channel.get());
+      (stub.*method)(&call->cntl, &call->request, &call->response, brpc::DoNothing());
+    }
+    for (auto& [region_id, call] : calls) {
+      if (call->channel != nullptr) {
+        brpc::Join(call->cntl.call_id());
+      }
+    }
+
+    butil::Status error_status;
+    butil::Status unknown_status;
+    for (auto& [region_id, call] : calls) {
+      if (call->channel == nullptr) {
+        status = butil::Status(pb::error::ERAFT_NOTLEADER, "Not found leader of region");
+      } else if (call->cntl.Failed()) {
+        LOG(WARNING) << butil::StringPrintf("Send request to region %lu failed, error: %d %s", region_id,
+                                            call->cntl.ErrorCode(), call->cntl.ErrorText().c_str());
+        status = butil::Status(call->cntl.ErrorCode(), call->cntl.ErrorText());
+        if (!idempotent) {
+          meta_cache_->Invalidate(table_id.entity_id(), call->route);
+          unknown_status = butil::Status(pb::error::EUNKNOWN_RESULT, call->cntl.ErrorText());
+          continue;
+        }
+      } else if (call->response.error().errcode() != pb::error::OK) {
+        status = butil::Status(call->response.error().errcode(), call->response.error().errmsg());
+        if (!IsRetriable(call->response.error().errcode())) {
+          error_status = status;
+          continue;
+        }
+      } else {
+        collect(call->response);
+        continue;
+      }
+
+      meta_cache_->Invalidate(table_id.entity_id(), call->route);
+      failed.insert(failed.end(), call->indexes.begin(), call->indexes.end());
+    }
+
+    // Other regions may be written already.
+    if (!unknown_status.ok()) {
+      return unknown_status;
+    }
+    if (!error_status.ok()) {
+      return error_status;
+    }
+
+    pending.swap(failed);
+  }
+
+  return pending.empty() ? butil::Status() : status;
+}
+
+butil::Status Client::KvGet(const pb::meta::DingoCommonId& table_id, const std::string& key, std::string& value,
+                            uint64_t ts) {
+  pb::store::KvGetRequest request;
+  pb::store::KvGetResponse response;
+  request.set_key(key);
+  request.set_ts(ts);
+
+  auto status = SendRequest(table_id, key, &pb::store::StoreService_Stub::KvGet, request, response);
+  if (status.ok()) {
+    value = response.value();
+  }
+
+  return status;
+}
+
+butil::Status Client::KvBatchGet(const pb::meta::DingoCommonId& table_id, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs, uint64_t ts) {
+  kvs.clear();
+  return SendBatchRequest<pb::store::KvBatchGetRequest, pb::store::KvBatchGetResponse>(
+      table_id, keys.size(), [&](size_t index) -> const std::string& { return keys[index]; },
+      &pb::store::StoreService_Stub::KvBatchGet,
+      [&](const std::vector<size_t>& indexes, pb::store::KvBatchGetRequest& request) {
+        request.set_ts(ts);
+        for (auto index : indexes) {
+          request.add_keys(keys[index]);
+        }
+      },
+      [&](const pb::store::KvBatchGetResponse& response) {
+        kvs.insert(kvs.end(), response.kvs().begin(), response.kvs().end());
+      });
+}
+
+butil::Status Client::KvPut(const pb::meta::DingoCommonId& table_id, const pb::common::KeyValue& kv, uint64_t ts) {
+  pb::store::KvPutRequest request;
+  pb::store::KvPutResponse response;
+  request.mutable_kv()->CopyFrom(kv);
+  request.set_ts(ts);
+
+  return SendRequest(table_id, kv.key(), &pb::store::StoreService_Stub::KvPut, request, response);
+}
+
+butil::Status Client::KvBatchPut(const pb::meta::DingoCommonId& table_id, const std::vector<pb::common::KeyValue>& kvs,
+                                 uint64_t ts) {
+  return SendBatchRequest<pb::store::KvBatchPutRequest, pb::store::KvBatchPutResponse>(
+      table_id, kvs.size(), [&](size_t index) -> const std::string& { return kvs[index].key(); },
+      &pb::store::StoreService_Stub::KvBatchPut,
+      [&](const std::vector<size_t>& indexes, pb::store::KvBatchPutRequest& request) {
+        request.set_ts(ts);
+        for (auto index : indexes) {
+          request.add_kvs()->CopyFrom(kvs[index]);
+        }
+      },
+      [](const pb::store::KvBatchPutResponse& /*response*/) {});
+}
+
+butil::Status Client::KvPutIfAbsent(const pb::meta::DingoCommonId& table_id, const pb::common::KeyValue& kv) {
+  pb::store::KvPutIfAbsentRequest request;
+  pb::store::KvPutIfAbsentResponse response;
+  request.mutable_kv()->CopyFrom(kv);
+
+  return SendRequest(table_id, kv.key(), &pb::store::StoreService_Stub::KvPutIfAbsent, request, response, false);
+}
+
+butil::Status Client::KvBatchPutIfAbsent(const pb::meta::DingoCommonId& table_id,
+                                         const std::vector<pb::common::KeyValue>& kvs,
+                                         std::vector<std::string>& put_keys, bool is_atomic) {
+  put_keys.clear();
+  return SendBatchRequest<pb::store::KvBatchPutIfAbsentRequest, pb::store::KvBatchPutIfAbsentResponse>(
+      table_id, kvs.size(), [&](size_t index) -> const std::string& { return kvs[index].key(); },
+      &pb::store::StoreService_Stub::KvBatchPutIfAbsent,
+      [&](const std::vector<size_t>& indexes, pb::store::KvBatchPutIfAbsentRequest& request) {
+        request.set_allow_partial(!is_atomic);
+        for (auto index : indexes) {
+          request.add_kvs()->CopyFrom(kvs[index]);
+        }
+      },
+      [&](const pb::store::KvBatchPutIfAbsentResponse& response) {
+        put_keys.insert(put_keys.end(), response.put_keys().begin(), response.put_keys().end());
+      },
+      false);
+}
+
+std::shared_ptr<brpc::Channel> Client::GetChannel(const butil::EndPoint& endpoint) {
+  std::lock_guard<std::mutex> lock(channel_mutex_);
+
+  auto it = channels_.find(endpoint);
+  if (it != channels_.end()) {
+    return it->second;
+  }
+
+  brpc::ChannelOptions options;
+  options.timeout_ms = options_.timeout_ms;
+  auto channel = std::make_shared<brpc::Channel>();
+  if (channel->Init(endpoint, &options) != 0) {
+    LOG(ERROR) << butil::StringPrintf("Init channel failed, %s:%d", butil::ip2str(endpoint.ip).c_str(),
+                                      endpoint.port);
+    return nullptr;
+  }
+  channels_[endpoint] = channel;
+
+  return channel;
+}
+
+bool Client::IsRetriable(int error_code) {
+  return error_code == pb::error::ERAFT_NOTLEADER || error_code == pb::error::ERAFT_NOTNODE ||
+         error_code == pb::error::EREGION_NOT_FOUND || error_code == pb::error::EKEY_OUT_OF_RANGE;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
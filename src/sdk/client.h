@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_CLIENT_H_
+#define DINGODB_SDK_CLIENT_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "coordinator/coordinator_interaction.h"
+#include "proto/common.pb.h"
+#include "proto/meta.pb.h"
+#include "proto/store.pb.h"
+#include "sdk/meta_cache.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Key value client of tables.
+// Requests are routed by the region cache, batch requests are split by region and the sub batch of every
+// region is sent to its leader in parallel. When a store replies not leader or region moved, or the rpc
+// fails, the table is fetched again and the failed keys are retried. Put if absent is not idempotent, a failed
+// rpc of it may be applied, so it is not retried and EUNKNOWN_RESULT is returned.
+// Batch writes are atomic per region, not across regions.
+class Client {
+ public:
+  struct Options {
+    // 127.0.0.1:22001,127.0.0.1:22002,127.0.0.1:22003
+    std::string coordinator_addrs;
+    int timeout_ms = 500;
+    int max_retry = 3;
+    int retry_interval_ms = 100;
+  };
+
+  Client() = default;
+  ~Client() = default;
+
+  Client(const Client&) = delete;
+  Client& operator=(const Client&) = delete;
+
+  bool Init(const Options& options);
+
+  // ts is mvcc timestamp, 0 is not versioned.
+  butil::Status KvGet(const pb::meta::DingoCommonId& table_id, const std::string& key, std::string& value,
+                      uint64_t ts = 0);
+  // Found kvs are not in order of keys.
+  butil::Status KvBatchGet(const pb::meta::DingoCommonId& table_id, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs, uint64_t ts = 0);
+
+  butil::Status KvPut(const pb::meta::DingoCommonId& table_id, const pb::common::KeyValue& kv, uint64_t ts = 0);
+  butil::Status KvBatchPut(const pb::meta::DingoCommonId& table_id, const std::vector<pb::common::KeyValue>& kvs,
+                           uint64_t ts = 0);
+
+  butil::Status KvPutIfAbsent(const pb::meta::DingoCommonId& table_id, const pb::common::KeyValue& kv);
+  // is_atomic puts nothing in a region when any key of it exists, else only absent keys are put.
+  // put_keys are keys written, also filled on error, since other regions may be written already.
+  butil::Status KvBatchPutIfAbsent(const pb::meta::DingoCommonId& table_id,
+                                   const std::vector<pb::common::KeyValue>& kvs, std::vector<std::string>& put_keys,
+                                   bool is_atomic = true);
+
+  std::shared_ptr<MetaCache> GetMetaCache() { return meta_cache_; }
+
+ private:
+  template <typename Request, typename Response>
+  using StoreMethod = void (pb::store::StoreService_Stub::*)(google::protobuf::RpcController*, const Request*,
+                                                             Response*, google::protobuf::Closure*);
+
+  // Send request of one key to leader of its region.
+  // Request not idempotent is only retried on errors which mean it is not applied.
+  template <typename Request, typename Response>
+  butil::Status SendRequest(const pb::meta::DingoCommonId& table_id, const std::string& key,
+                            StoreMethod<Request, Response> method, Request& request, Response& response,
+                            bool idempotent = true);
+
+  // Split count keys by region, then build and send a request for every region in parallel.
+  // fill adds the keys of indexes to request, collect takes the succeeded responses.
+  template <typename Request, typename Response>
+  butil::Status SendBatchRequest(const pb::meta::DingoCommonId& table_id, size_t count,
+                                 const std::function<const std::string&(size_t)>& key_of,
+                                 StoreMethod<Request, Response> method,
+                                 const std::function<void(const std::vector<size_t>&, Request&)>& fill,
+                                 const std::function<void(const Response&)>& collect, bool idempotent = true);
+
+  std::shared_ptr<brpc::Channel> GetChannel(const butil::EndPoint& endpoint);
+
+  // Error can be recovered by fetching route again.
+  static bool IsRetriable(int error_code);
+
+  Options options_;
+  std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
+  std::shared_ptr<MetaCache> meta_cache_;
+
+  std::mutex channel_mutex_;
+  std::map<butil::EndPoint, std::shared_ptr<brpc::Channel> > channels_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+
+#endif  // DINGODB_SDK_CLIENT_H_
@@ -0,0 +1,138 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sdk/meta_cache.h"
+
+#include <mutex>
+
+#include "butil/strings/stringprintf.h"
+#include "common/helper.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+namespace sdk {
+
+MetaCache::MetaCache(std::shared_ptr<CoordinatorInteraction> coordinator_interaction)
+    : coordinator_interaction_(coordinator_interaction) {}
+
+butil::Status MetaCache::Lookup(const pb::meta::DingoCommonId& table_id, const std::string& key,
+                                std::shared_ptr<const RegionRoute>& route) {
+  if (!Find(table_id.entity_id(), key, route)) {
+    auto status = Refresh(table_id);
+    if (!status.ok()) {
+      return status;
+    }
+    if (!Find(table_id.entity_id(), key, route)) {
+      return butil::Status(pb::error::EREGION_NOT_FOUND, "Table is invalidated");
+    }
+  }
+
+  if (route == nullptr) {
+    return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "Not found region of key");
+  }
+
+  return butil::Status();
+}
+
+butil::Status MetaCache::Refresh(const pb::meta::DingoCommonId& table_id) {
+  if (coordinator_interaction_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not init coordinator interaction");
+  }
+
+  pb::meta::GetTableRequest request;
+  pb::meta::GetTableResponse response;
+  request.mutable_table_id()->CopyFrom(table_id);
+
+  auto status = coordinator_interaction_->SendMetaRequest("GetTable", request, response);
+  if (!status.ok()) {
+    LOG(ERROR) << butil::StringPrintf("Get table %lu failed, error: %d %s", table_id.entity_id(),
+                                      status.error_code(), status.error_cstr());
+    return status;
+  }
+
+  if (!Update(response.table())) {
+    LOG(ERROR) << butil::StringPrintf("Not found region of table %lu", table_id.entity_id());
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region of table");
+  }
+
+  return butil::Status();
+}
+
+void MetaCache::Invalidate(uint64_t table_id, const std::shared_ptr<const RegionRoute>& route) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+
+  auto it = tables_.find(table_id);
+  if (it == tables_.end()) {
+    return;
+  }
+
+  auto region_it = it->second.find(route->start_key);
+  if (region_it != it->second.end() && region_it->second == route) {
+    LOG(INFO) << butil::StringPrintf("Invalidate table %lu, region %lu", table_id, route->region_id);
+    tables_.erase(it);
+  }
+}
+
+bool MetaCache::Update(const pb::meta::Table& table) {
+  Regions regions;
+  for (const auto& part : table.parts()) {
+    auto route = std::make_shared<RegionRoute>();
+    route->region_id = part.id().entity_id();
+    route->start_key = part.range().start_key();
+    route->end_key = part.range().end_key();
+    route->has_leader = !part.leader().host().empty() && part.leader().port() != 0;
+    if (route->has_leader) {
+      route->leader = Helper::LocationToEndPoint(part.leader());
+    }
+
+    regions[route->start_key] = route;
+  }
+
+  if (regions.empty()) {
+    return false;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  tables_[table.id().entity_id()] = std::move(regions);
+
+  return true;
+}
+
+bool MetaCache::Find(uint64_t table_id, const std::string& key, std::shared_ptr<const RegionRoute>& route) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+
+  route = nullptr;
+  auto it = tables_.find(table_id);
+  if (it == tables_.end()) {
+    return false;
+  }
+
+  // Last region starts not after key.
+  auto region_it = it->second.upper_bound(key);
+  if (region_it == it->second.begin()) {
+    return true;
+  }
+  --region_it;
+
+  const auto& region = region_it->second;
+  if (region->end_key.empty() || key < region->end_key) {
+    route = region;
+  }
+
+  return true;
+}
+
+}  // namespace sdk
+}  // namespace dingodb
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SDK_META_CACHE_H_
+#define DINGODB_SDK_META_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "coordinator/coordinator_interaction.h"
+#include "proto/meta.pb.h"
+
+namespace dingodb {
+namespace sdk {
+
+// Route of one region of table.
+struct RegionRoute {
+  uint64_t region_id = 0;
+  // Empty end_key is unbounded.
+  std::string start_key;
+  std::string end_key;
+  butil::EndPoint leader;
+  bool has_leader = false;
+};
+
+// Cache regions of tables fetched from MetaService::GetTable.
+// Regions of a table are ordered by start key, a key is routed by binary search. A table is fetched
+// at first use, and dropped by Invalidate when a store replies region moved or leader changed, the
+// next lookup fetches it again.
+class MetaCache {
+ public:
+  explicit MetaCache(std::shared_ptr<CoordinatorInteraction> coordinator_interaction);
+  ~MetaCache() = default;
+
+  MetaCache(const MetaCache&) = delete;
+  MetaCache& operator=(const MetaCache&) = delete;
+
+  // Find region of key, fetch table when it is not cached.
+  butil::Status Lookup(const pb::meta::DingoCommonId& table_id, const std::string& key,
+                       std::shared_ptr<const RegionRoute>& route);
+
+  // Fetch table and replace its regions.
+  butil::Status Refresh(const pb::meta::DingoCommonId& table_id);
+  // Drop table when route is still cached, a newer fetch by other callers is kept.
+  void Invalidate(uint64_t table_id, const std::shared_ptr<const RegionRoute>& route);
+
+  // Replace regions of table, return false when table has no region.
+  bool Update(const pb::meta::Table& table);
+
+ private:
+  using Regions = std::map<std::string, std::shared_ptr<const RegionRoute> >;
+
+  // Region of key in cached table, nullptr when key has no region. Return false when table is not cached.
+  bool Find(uint64_t table_id, const std::string& key, std::shared_ptr<const RegionRoute>& route);
+
+  std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
+
+  std::shared_mutex mutex_;
+  // table_id: start_key -> region
+  std::map<uint64_t, Regions> tables_;
+};
+
+}  // namespace sdk
+}  // namespace dingodb
+
+#endif  // DINGODB_SDK_META_CACHE_H_
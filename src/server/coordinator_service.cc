@@ -22,6 +22,7 @@
 
 #include "brpc/controller.h"
 #include "common/constant.h"
+#include "common/logging.h"
 #include "coordinator/coordinator_closure.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -49,9 +50,8 @@ void CoordinatorServiceImpl::CreateStore(google::protobuf::RpcController *contro
                                          pb::coordinator::CreateStoreResponse *response,
                                          google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
-  auto format_request = Helper::MessageToJsonString(*request);
   auto is_leader = this->coordinator_control_->IsLeader();
-  LOG(INFO) << "Receive Create Store Request: IsLeader:" << is_leader << ", Request: " << format_request;
+  LOG(INFO) << "Receive Create Store Request: IsLeader:" << is_leader << ", Request: " << ProtoJson(*request);
 
   if (!is_leader) {
     return RedirectResponse(response);
@@ -92,9 +92,9 @@ void CoordinatorServiceImpl::StoreHeartbeat(google::protobuf::RpcController *con
                                             pb::coordinator::StoreHeartbeatResponse *response,
                                             google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
-  auto format_request = Helper::MessageToJsonString(*request);
   auto is_leader = this->coordinator_control_->IsLeader();
-  LOG(INFO) << "Receive Store Heartbeat Request, IsLeader:" << is_leader << ", Request:" << format_request;
+  DINGO_LOG_EVERY_SECOND(INFO) << "Receive Store Heartbeat Request, IsLeader:" << is_leader
+                               << ", Request:" << ProtoJson(*request);
 
   if (!is_leader) {
     pb::common::Location leader_location;
@@ -113,12 +113,22 @@ void CoordinatorServiceImpl::StoreHeartbeat(google::protobuf::RpcController *con
 
   // update region map
   std::vector<pb::common::Region> regions;
-  regions.resize(request->regions_size());
+  regions.reserve(request->regions_size());
   for (int i = 0; i < request->regions_size(); i++) {
     regions.push_back(request->regions(i));
   }
   uint64_t const new_regionmap_epoch = this->coordinator_control_->UpdateRegionMap(regions, meta_increment);
 
+  // drop dead ranges reclaimed by all stores
+  std::vector<uint64_t> reclaimed_ids(request->reclaimed_dead_range_ids().begin(),
+                                      request->reclaimed_dead_range_ids().end());
+  this->coordinator_control_->UpdateDeadRanges(request->store().id(), reclaimed_ids, meta_increment);
+
+  // update region flow
+  std::vector<pb::common::RegionMetrics> region_metrics(request->region_metrics().begin(),
+                                                        request->region_metrics().end());
+  this->coordinator_control_->UpdateRegionMetrics(request->store().id(), region_metrics);
+
   // prepare for raft process
   CoordinatorClosure<pb::coordinator::StoreHeartbeatRequest, pb::coordinator::StoreHeartbeatResponse>
       *meta_create_store_closure =
@@ -151,9 +161,9 @@ void CoordinatorServiceImpl::GetStoreMap(google::protobuf::RpcController * /*con
                                          google::protobuf::Closure *done) {
   brpc::ClosureGuard const done_guard(done);
 
-  auto format_request = Helper::MessageToJsonString(*request);
   auto is_leader = this->coordinator_control_->IsLeader();
-  LOG(INFO) << "Receive Get StoreMap Request, IsLeader:" << is_leader << ", Request:" << format_request;
+  DINGO_LOG_EVERY_SECOND(INFO) << "Receive Get StoreMap Request, IsLeader:" << is_leader
+                               << ", Request:" << ProtoJson(*request);
 
   if (!is_leader) {
     RedirectResponse(response);
@@ -172,9 +182,9 @@ void CoordinatorServiceImpl::GetRegionMap(google::protobuf::RpcController * /*co
                                           google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  auto format_request = Helper::MessageToJsonString(*request);
   auto is_leader = this->coordinator_control_->IsLeader();
-  LOG(INFO) << "Receive Get RegionMap Request, IsLeader:" << is_leader << ", Request:" << format_request;
+  DINGO_LOG_EVERY_SECOND(INFO) << "Receive Get RegionMap Request, IsLeader:" << is_leader
+                               << ", Request:" << ProtoJson(*request);
 
   if (!is_leader) {
     RedirectResponse(response);
@@ -186,6 +196,12 @@ void CoordinatorServiceImpl::GetRegionMap(google::protobuf::RpcController * /*co
 
   response->mutable_regionmap()->CopyFrom(regionmap);
   response->set_epoch(regionmap.epoch());
+
+  std::vector<pb::common::RegionMetrics> region_metrics;
+  this->coordinator_control_->GetRegionMetrics(region_metrics);
+  for (auto &metrics : region_metrics) {
+    *response->add_region_metrics() = metrics;
+  }
 }
 
 void CoordinatorServiceImpl::GetCoordinatorMap(google::protobuf::RpcController * /*controller*/,
@@ -193,8 +209,7 @@ void CoordinatorServiceImpl::GetCoordinatorMap(google::protobuf::RpcController *
                                                pb::coordinator::GetCoordinatorMapResponse *response,
                                                google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
-  auto format_request = Helper::MessageToJsonString(*request);
-  LOG(INFO) << "Receive Get CoordinatorMap Request:" << format_request;
+  DINGO_LOG_EVERY_SECOND(INFO) << "Receive Get CoordinatorMap Request:" << ProtoJson(*request);
 
   uint64_t epoch;
   pb::common::Location leader_location;
@@ -204,4 +219,47 @@ void CoordinatorServiceImpl::GetCoordinatorMap(google::protobuf::RpcController *
   response->set_epoch(epoch);
 }
 
+// Tso is on the read path, do not log every request
+void CoordinatorServiceImpl::Tso(google::protobuf::RpcController *controller, const pb::coordinator::TsoRequest *request,
+                                 pb::coordinator::TsoResponse *response, google::protobuf::Closure *done) {
+  brpc::ClosureGuard done_guard(done);
+
+  if (!this->coordinator_control_->IsLeader()) {
+    return RedirectResponse(response);
+  }
+
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  pb::coordinator::TsoTimestamp start_timestamp;
+  if (this->coordinator_control_->GenTso(request->count(), start_timestamp, meta_increment) < 0) {
+    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+    response->mutable_error()->set_errmsg("Tso count is illegal");
+    return;
+  }
+
+  response->mutable_start_timestamp()->CopyFrom(start_timestamp);
+  response->set_count(request->count());
+
+  // timestamps are covered by committed window
+  if (meta_increment.idepochs_size() == 0) {
+    return;
+  }
+
+  // prepare for raft process
+  CoordinatorClosure<pb::coordinator::TsoRequest, pb::coordinator::TsoResponse> *meta_tso_closure =
+      new CoordinatorClosure<pb::coordinator::TsoRequest, pb::coordinator::TsoResponse>(
+          request, response, done_guard.release(), this->coordinator_control_);
+
+  std::shared_ptr<Context> const ctx =
+      std::make_shared<Context>(static_cast<brpc::Controller *>(controller), meta_tso_closure);
+  ctx->SetRegionId(Constant::kCoordinatorRegionId);
+
+  // this is a async operation will be block by closure
+  auto status = engine_->MetaPut(ctx, meta_increment);
+  if (!status.ok()) {
+    LOG(ERROR) << "Tso window MetaPut failed, errcode: " << status.error_code() << " " << status.error_str();
+    meta_tso_closure->Run();
+    delete meta_tso_closure;
+  }
+}
+
 }  // namespace dingodb
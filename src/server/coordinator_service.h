@@ -61,6 +61,9 @@ class CoordinatorServiceImpl : public pb::coordinator::CoordinatorService {
                          pb::coordinator::GetCoordinatorMapResponse* response,
                          google::protobuf::Closure* done) override;
 
+  void Tso(google::protobuf::RpcController* controller, const pb::coordinator::TsoRequest* request,
+           pb::coordinator::TsoResponse* response, google::protobuf::Closure* done) override;
+
  private:
   std::shared_ptr<CoordinatorControl> coordinator_control_;
   std::shared_ptr<Engine> engine_;
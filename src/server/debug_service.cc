@@ -0,0 +1,38 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "server/debug_service.h"
+
+#include "butil/iobuf.h"
+#include "common/trace.h"
+
+namespace dingodb {
+
+void SlowRequestServiceImpl::default_method(google::protobuf::RpcController* controller,
+                                            const pb::debug::HttpRequest* /*request*/,
+                                            pb::debug::HttpResponse* /*response*/, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+
+  cntl->http_response().set_content_type("text/plain");
+  butil::IOBufBuilder os;
+  auto requests = SlowRequestLog::GetRecent();
+  os << "recent " << requests.size() << " slow requests, newest last\n";
+  for (const auto& request : requests) {
+    os << request << '\n';
+  }
+  os.move_to(cntl->response_attachment());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,35 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DEBUG_SERVICE_H_
+#define DINGODB_DEBUG_SERVICE_H_
+
+#include "brpc/controller.h"
+#include "brpc/server.h"
+#include "proto/debug.pb.h"
+
+namespace dingodb {
+
+// Show recent slow requests as text, registered at /slow_requests.
+class SlowRequestServiceImpl : public pb::debug::SlowRequestService {
+ public:
+  SlowRequestServiceImpl() = default;
+
+  void default_method(google::protobuf::RpcController* controller, const pb::debug::HttpRequest* request,
+                      pb::debug::HttpResponse* response, google::protobuf::Closure* done) override;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DEBUG_SERVICE_H_
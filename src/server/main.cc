@@ -24,6 +24,7 @@
 #include "proto/coordinator.pb.h"
 #include "proto/store.pb.h"
 #include "server/coordinator_service.h"
+#include "server/debug_service.h"
 #include "server/meta_service.h"
 #include "server/server.h"
 #include "server/store_service.h"
@@ -100,6 +101,7 @@ int main(int argc, char *argv[]) {
   dingodb::CoordinatorServiceImpl coordinator_service;
   dingodb::MetaServiceImpl meta_service;
   dingodb::StoreServiceImpl store_service;
+  dingodb::SlowRequestServiceImpl slow_request_service;
 
   brpc::Server brpc_server;
   brpc::Server raft_server;
@@ -146,6 +148,10 @@ int main(int argc, char *argv[]) {
       LOG(ERROR) << "InitCoordinatorInteraction failed!";
       return -1;
     }
+    if (!dingo_server->InitTsoClient()) {
+      LOG(ERROR) << "InitTsoClient failed!";
+      return -1;
+    }
     if (!dingo_server->ValiateCoordinator()) {
       LOG(ERROR) << "ValiateCoordinator failed!";
       return -1;
@@ -158,16 +164,29 @@ int main(int argc, char *argv[]) {
       LOG(ERROR) << "InitStoreMetaManager failed!";
       return -1;
     }
+    if (!dingo_server->InitStoreControl()) {
+      LOG(ERROR) << "InitStoreControl failed!";
+      return -1;
+    }
     if (!dingo_server->InitCrontabManager()) {
       LOG(ERROR) << "InitCrontabManager failed!";
       return -1;
     }
+    if (!dingo_server->InitTrace()) {
+      LOG(ERROR) << "InitTrace failed!";
+      return -1;
+    }
 
     store_service.set_storage(dingo_server->GetStorage());
     if (brpc_server.AddService(&store_service, brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
       LOG(ERROR) << "Fail to add store service!";
       return -1;
     }
+    if (brpc_server.AddService(&slow_request_service, brpc::SERVER_DOESNT_OWN_SERVICE,
+                               "/slow_requests => default_method") != 0) {
+      LOG(ERROR) << "Fail to add slow request service!";
+      return -1;
+    }
 
     // raft server
     if (braft::add_service(&raft_server, dingo_server->RaftEndpoint()) != 0) {
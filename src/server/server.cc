@@ -22,26 +22,38 @@
 #include "braft/util.h"
 #include "butil/endpoint.h"
 #include "butil/files/file_path.h"
+#include "butil/files/file_util.h"
 #include "butil/strings/stringprintf.h"
 #include "common/constant.h"
 #include "common/helper.h"
+#include "common/logging.h"
+#include "common/trace.h"
 #include "config/config.h"
 #include "config/config_manager.h"
 #include "coordinator/coordinator_control.h"
+#include "engine/columnar_engine.h"
 #include "engine/engine.h"
 #include "engine/mem_engine.h"
 #include "engine/raft_kv_engine.h"
 #include "engine/raft_meta_engine.h"
+#include "engine/raw_columnar_engine.h"
+#include "engine/raw_mem_engine.h"
 #include "engine/raw_rocks_engine.h"
+#include "engine/raw_xdp_engine.h"
 #include "engine/rocks_engine.h"
+#include "engine/xdp_engine.h"
 #include "meta/meta_reader.h"
 #include "meta/meta_writer.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "store/heartbeat.h"
+#include "store/mvcc_gc.h"
 
 namespace dingodb {
 
+// Glog default, used when log.logBufSecs not set.
+static const int kDefaultLogBufSecs = 30;
+
 void Server::SetRole(pb::common::ClusterRole role) { role_ = role; }
 
 Server* Server::GetInstance() { return Singleton<Server>::get(); }
@@ -53,14 +65,47 @@ bool Server::InitConfig(const std::string& filename) {
   }
 
   ConfigManager::GetInstance()->Register(role_, config);
+
+  config_filename_ = filename;
+  butil::File::Info file_info;
+  if (butil::GetFileInfo(butil::FilePath(filename), &file_info)) {
+    config_modified_time_ = file_info.last_modified;
+  }
   return true;
 }
 
+void Server::WatchConfig() {
+  butil::File::Info file_info;
+  if (!butil::GetFileInfo(butil::FilePath(config_filename_), &file_info)) {
+    LOG(WARNING) << "Get config file info failed, file: " << config_filename_;
+    return;
+  }
+  if (file_info.last_modified == config_modified_time_) {
+    return;
+  }
+  config_modified_time_ = file_info.last_modified;
+
+  auto config = ConfigManager::GetInstance()->GetConfig(role_);
+  try {
+    config->ReloadFile(config_filename_);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Reload config failed, file: " << config_filename_ << " exception: " << e.what();
+    return;
+  }
+  LOG(INFO) << "Reload config file: " << config_filename_;
+
+  for (auto& [_, raw_engine] : raw_engines_) {
+    raw_engine->ReloadOptions(config);
+  }
+}
+
 bool Server::InitLog() {
   auto config = ConfigManager::GetInstance()->GetConfig(role_);
   FLAGS_log_dir = config->GetString("log.logPath");
   LOG(INFO) << "log_dir: " << FLAGS_log_dir;
-  FLAGS_logbufsecs = 0;
+  // Info log is buffered and flushed every logBufSecs, warning and above flush at once.
+  int log_buf_secs = config->GetInt("log.logBufSecs");
+  FLAGS_logbufsecs = log_buf_secs >= 0 ? log_buf_secs : kDefaultLogBufSecs;
 
   auto role_name = pb::common::ClusterRole_Name(role_);
   const std::string program_name = butil::StringPrintf("./%s", role_name.c_str());
@@ -74,6 +119,12 @@ bool Server::InitLog() {
   google::SetLogDestination(google::GLOG_FATAL,
                             butil::StringPrintf("%s/%s.fatal.log.", FLAGS_log_dir.c_str(), role_name.c_str()).c_str());
 
+  // Write log file in background thread, 0 is sync write.
+  int async_buffer_size = config->GetInt("log.asyncBufferSize");
+  if (async_buffer_size > 0) {
+    AsyncLogger::Install(static_cast<size_t>(async_buffer_size) * 1024 * 1024);
+  }
+
   return true;
 }
 
@@ -86,13 +137,21 @@ bool Server::InitServerID() {
 bool Server::InitRawEngines() {
   auto config = ConfigManager::GetInstance()->GetConfig(role_);
 
-  std::shared_ptr<RawEngine> rock_engine = std::make_shared<RawRocksEngine>();
-  if (!rock_engine->Init(config)) {
-    LOG(ERROR) << "Init RawRocksEngine Failed with Config[" << config->ToString();
-    return false;
+  std::vector<std::shared_ptr<RawEngine>> raw_engines = {std::make_shared<RawRocksEngine>()};
+  // Data of ENG_MEMORY, ENG_COLUMNAR and ENG_XDP tables.
+  if (role_ == pb::common::ClusterRole::STORE) {
+    raw_engines.push_back(std::make_shared<RawMemEngine>());
+    raw_engines.push_back(std::make_shared<RawColumnarEngine>());
+    raw_engines.push_back(std::make_shared<RawXdpEngine>());
   }
 
-  raw_engines_.insert(std::make_pair(rock_engine->GetID(), rock_engine));
+  for (const auto& raw_engine : raw_engines) {
+    if (!raw_engine->Init(config)) {
+      LOG(ERROR) << "Init " << raw_engine->GetName() << " failed with Config[" << config->ToString() << "]";
+      return false;
+    }
+    raw_engines_.insert(std::make_pair(raw_engine->GetID(), raw_engine));
+  }
   return true;
 }
 
@@ -123,13 +182,28 @@ bool Server::InitEngines() {
     raft_kv_engine = std::make_shared<RaftMetaEngine>(raw_engine, coordinator_control_);
   } else {
     raft_kv_engine = std::make_shared<RaftKvEngine>(raw_engine);
-    if (!raft_kv_engine->Init(config)) {
-      LOG(ERROR) << "Init RaftKvEngine failed with Config[" << config->ToString() << "]";
-      return false;
-    }
+  }
+  if (!raft_kv_engine->Init(config)) {
+    LOG(ERROR) << "Init " << raft_kv_engine->GetName() << " failed with Config[" << config->ToString() << "]";
+    return false;
   }
 
   engines_.insert(std::make_pair(raft_kv_engine->GetID(), raft_kv_engine));
+
+  if (role_ == pb::common::ClusterRole::STORE) {
+    std::vector<std::shared_ptr<Engine>> engines = {
+        std::make_shared<MemEngine>(raw_engines_[pb::common::RAW_ENG_MEMORY]),
+        std::make_shared<ColumnarEngine>(
+            std::dynamic_pointer_cast<RawColumnarEngine>(raw_engines_[pb::common::RAW_ENG_COLUMNAR])),
+        std::make_shared<XdpEngine>(raw_engines_[pb::common::RAW_ENG_XDP])};
+    for (const auto& engine : engines) {
+      if (!engine->Init(config)) {
+        LOG(ERROR) << "Init " << engine->GetName() << " failed with Config[" << config->ToString() << "]";
+        return false;
+      }
+      engines_.insert(std::make_pair(engine->GetID(), engine));
+    }
+  }
   return true;
 }
 
@@ -186,8 +260,13 @@ bool Server::InitCoordinatorInteraction() {
   return coordinator_interaction_->Init(config->GetString("cluster.coordinators"));
 }
 
+bool Server::InitTsoClient() {
+  tso_client_ = std::make_shared<TsoClient>(coordinator_interaction_);
+  return true;
+}
+
 bool Server::InitStorage() {
-  storage_ = std::make_shared<Storage>(engines_[pb::common::ENG_RAFT_STORE]);
+  storage_ = std::make_shared<Storage>(engines_);
   return true;
 }
 
@@ -211,12 +290,79 @@ bool Server::InitCrontabManager() {
 
   crontab_manager_->AddAndRunCrontab(crontab);
 
+  // Add mvcc gc safe point crontab
+  std::shared_ptr<Crontab> mvcc_gc_crontab = std::make_shared<Crontab>();
+  mvcc_gc_crontab->name_ = "MVCC_GC";
+  int mvcc_gc_interval = config->GetInt("store.mvccGcInterval");
+  mvcc_gc_crontab->interval_ = mvcc_gc_interval > 0 ? mvcc_gc_interval : 60000;
+  mvcc_gc_crontab->func_ = MvccGc::UpdateSafePoint;
+  mvcc_gc_crontab->arg_ = tso_client_.get();
+
+  crontab_manager_->AddAndRunCrontab(mvcc_gc_crontab);
+
+  // Add engine stats crontab, export rocksdb and memory engine metrics to bvar
+  int collect_stats_interval = config->GetInt("store.collectStatsInterval");
+  if (collect_stats_interval > 0) {
+    std::shared_ptr<Crontab> collect_stats_crontab = std::make_shared<Crontab>();
+    collect_stats_crontab->name_ = "COLLECT_STATS";
+    collect_stats_crontab->interval_ = collect_stats_interval * 1000;
+    collect_stats_crontab->func_ = [](void*) {
+      for (int type = pb::common::RawEngine_MIN; type <= pb::common::RawEngine_MAX; ++type) {
+        auto raw_engine = Server::GetInstance()->GetRawEngine(static_cast<pb::common::RawEngine>(type));
+        if (raw_engine != nullptr) {
+          raw_engine->CollectStats();
+        }
+      }
+    };
+    collect_stats_crontab->arg_ = nullptr;
+
+    crontab_manager_->AddAndRunCrontab(collect_stats_crontab);
+  }
+
+  // Add xdp merge crontab, reclaim garbage of ENG_XDP data files
+  int xdp_merge_interval = config->GetInt("store.xdpMergeInterval");
+  if (xdp_merge_interval > 0 && GetRawEngine(pb::common::RAW_ENG_XDP) != nullptr) {
+    std::shared_ptr<Crontab> xdp_merge_crontab = std::make_shared<Crontab>();
+    xdp_merge_crontab->name_ = "XDP_MERGE";
+    xdp_merge_crontab->interval_ = xdp_merge_interval;
+    xdp_merge_crontab->func_ = [](void*) {
+      auto xdp_engine =
+          std::dynamic_pointer_cast<RawXdpEngine>(Server::GetInstance()->GetRawEngine(pb::common::RAW_ENG_XDP));
+      if (xdp_engine != nullptr) {
+        xdp_engine->ScheduleMerge();
+      }
+    };
+    xdp_merge_crontab->arg_ = nullptr;
+
+    crontab_manager_->AddAndRunCrontab(xdp_merge_crontab);
+  }
+
+  // Add config watch crontab, apply changed engine options without restart
+  int config_watch_interval = config->GetInt("store.configWatchInterval");
+  if (config_watch_interval > 0) {
+    std::shared_ptr<Crontab> config_watch_crontab = std::make_shared<Crontab>();
+    config_watch_crontab->name_ = "CONFIG_WATCH";
+    config_watch_crontab->interval_ = config_watch_interval;
+    config_watch_crontab->func_ = [](void*) { Server::GetInstance()->WatchConfig(); };
+    config_watch_crontab->arg_ = nullptr;
+
+    crontab_manager_->AddAndRunCrontab(config_watch_crontab);
+  }
+
+  return true;
+}
+
+bool Server::InitTrace() {
+  auto config = ConfigManager::GetInstance()->GetConfig(role_);
+  Trace::SetSampleRate(config->GetInt("store.traceSampleRate"));
+  SlowRequestLog::Init(config->GetString("log.logPath") + "/slow_request.log",
+                       config->GetInt("store.slowRequestThreshold"));
   return true;
 }
 
 bool Server::InitStoreControl() {
   store_control_ = std::make_shared<StoreControl>();
-  return store_control_ != nullptr;
+  return store_control_->Init();
 }
 
 bool Server::Recover() {
@@ -242,6 +388,10 @@ bool Server::Recover() {
 
 void Server::Destroy() {
   crontab_manager_->Destroy();
+  if (store_control_ != nullptr) {
+    store_control_->Destroy();
+  }
+  AsyncLogger::UninstallAll();
   google::ShutdownGoogleLogging();
 }
 
@@ -16,11 +16,14 @@
 #define DINGODB_STORE_SERVER_H_
 
 #include <memory>
+#include <string>
 
 #include "brpc/channel.h"
+#include "butil/time.h"
 #include "common/meta_control.h"
 #include "coordinator/coordinator_control.h"
 #include "coordinator/coordinator_interaction.h"
+#include "coordinator/tso_client.h"
 #include "crontab/crontab.h"
 #include "engine/raw_engine.h"
 #include "engine/storage.h"
@@ -43,6 +46,9 @@ class Server {
   // Init config.
   bool InitConfig(const std::string& filename);
 
+  // Reload config file when modified, apply mutable engine options.
+  void WatchConfig();
+
   // Init log.
   bool InitLog();
 
@@ -61,6 +67,9 @@ class Server {
   // Init coordinator interaction
   bool InitCoordinatorInteraction();
 
+  // Init tso client, must after coordinator interaction
+  bool InitTsoClient();
+
   // Init storage engine.
   bool InitStorage();
 
@@ -70,6 +79,9 @@ class Server {
   // Init crontab heartbeat
   bool InitCrontabManager();
 
+  // Init write trace sampling and slow request log
+  bool InitTrace();
+
   // Init store control
   bool InitStoreControl();
 
@@ -89,12 +101,18 @@ class Server {
   void SetRaftEndpoint(const butil::EndPoint& endpoint) { raft_endpoint_ = endpoint; }
 
   std::shared_ptr<CoordinatorInteraction> GetCoordinatorInteraction() { return coordinator_interaction_; }
+  std::shared_ptr<TsoClient> GetTsoClient() { return tso_client_; }
 
   std::shared_ptr<Engine> GetEngine(pb::common::Engine type) {
     auto it = engines_.find(type);
     return (it != engines_.end()) ? it->second : nullptr;
   }
 
+  std::shared_ptr<RawEngine> GetRawEngine(pb::common::RawEngine type) {
+    auto it = raw_engines_.find(type);
+    return (it != raw_engines_.end()) ? it->second : nullptr;
+  }
+
   std::shared_ptr<Storage> GetStorage() { return storage_; }
   std::shared_ptr<StoreMetaManager> GetStoreMetaManager() { return store_meta_manager_; }
   std::shared_ptr<CrontabManager> GetCrontabManager() { return crontab_manager_; }
@@ -115,6 +133,9 @@ class Server {
   // represent store's identity, provided by coordinator.
   // read from store config file.
   uint64_t id_;
+  // Config file path and last modified time, for watch config.
+  std::string config_filename_;
+  butil::Time config_modified_time_;
   // Role, include store/coordinator
   pb::common::ClusterRole role_;
   // Service ip and port.
@@ -124,6 +145,8 @@ class Server {
 
   // coordinator interaction
   std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
+  // fetch timestamp from coordinator tso
+  std::shared_ptr<TsoClient> tso_client_;
 
   // All store engine, include MemEngine/RaftKvEngine/RocksEngine
   std::map<pb::common::Engine, std::shared_ptr<Engine> > engines_;
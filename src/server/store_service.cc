@@ -17,18 +17,43 @@
 #include "common/constant.h"
 #include "common/context.h"
 #include "common/helper.h"
+#include "common/logging.h"
+#include "config/config_manager.h"
+#include "engine/column_chunk.h"
+#include "engine/column_store.h"
+#include "engine/raft_kv_engine.h"
+#include "engine/raw_rocks_engine.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
+// Latency of store rpc, from request received to response sent.
+static bvar::LatencyRecorder g_add_region_latency("dingo_store_service", "add_region");
+static bvar::LatencyRecorder g_change_region_latency("dingo_store_service", "change_region");
+static bvar::LatencyRecorder g_destroy_region_latency("dingo_store_service", "destroy_region");
+static bvar::LatencyRecorder g_kv_get_latency("dingo_store_service", "kv_get");
+static bvar::LatencyRecorder g_kv_batch_get_latency("dingo_store_service", "kv_batch_get");
+static bvar::LatencyRecorder g_kv_put_latency("dingo_store_service", "kv_put");
+static bvar::LatencyRecorder g_kv_batch_put_latency("dingo_store_service", "kv_batch_put");
+static bvar::LatencyRecorder g_kv_put_if_absent_latency("dingo_store_service", "kv_put_if_absent");
+static bvar::LatencyRecorder g_kv_batch_put_if_absent_latency("dingo_store_service", "kv_batch_put_if_absent");
+static bvar::LatencyRecorder g_kv_ingest_sst_latency("dingo_store_service", "kv_ingest_sst");
+static bvar::LatencyRecorder g_kv_batch_put_rows_latency("dingo_store_service", "kv_batch_put_rows");
+static bvar::LatencyRecorder g_kv_scan_columns_latency("dingo_store_service", "kv_scan_columns");
+
+static const std::string kMaxIngestSstSize = "store.maxIngestSstSize";
+static const int64_t kDefaultMaxIngestSstSize = 32;  // MB
+
 StoreServiceImpl::StoreServiceImpl() = default;
 
 void StoreServiceImpl::AddRegion(google::protobuf::RpcController* controller,
                                  const dingodb::pb::store::AddRegionRequest* request,
                                  dingodb::pb::store::AddRegionResponse* response, google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_add_region_latency, done);
   brpc::ClosureGuard done_guard(done);
   LOG(INFO) << "AddRegion request...";
 
@@ -47,6 +72,7 @@ void StoreServiceImpl::ChangeRegion(google::protobuf::RpcController* controller,
                                     const pb::store::ChangeRegionRequest* request,
                                     pb::store::ChangeRegionResponse* response, google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_change_region_latency, done);
   brpc::ClosureGuard done_guard(done);
   LOG(INFO) << "ChangeRegion request...";
 
@@ -65,6 +91,7 @@ void StoreServiceImpl::DestroyRegion(google::protobuf::RpcController* controller
                                      dingodb::pb::store::DestroyRegionResponse* response,
                                      google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_destroy_region_latency, done);
   brpc::ClosureGuard done_guard(done);
   LOG(INFO) << "DestroyRegion request...";
 
@@ -78,6 +105,102 @@ void StoreServiceImpl::DestroyRegion(google::protobuf::RpcController* controller
   }
 }
 
+void StoreServiceImpl::SetEngineOptions(google::protobuf::RpcController* /*controller*/,
+                                        const pb::store::SetEngineOptionsRequest* request,
+                                        pb::store::SetEngineOptionsResponse* response,
+                                        google::protobuf::Closure* done) {
+  brpc::ClosureGuard done_guard(done);
+  LOG(INFO) << "SetEngineOptions request: " << request->ShortDebugString();
+
+  auto raw_engine = Server::GetInstance()->GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  std::map<std::string, std::string> options(request->options().begin(), request->options().end());
+  std::vector<std::string> need_reopen_options;
+  butil::Status status;
+  if (raw_engine == nullptr) {
+    status = butil::Status(pb::error::ENOT_SUPPORT, "Not found rocksdb engine");
+  } else {
+    status = raw_engine->SetOptions(request->cf_name(), options, need_reopen_options);
+  }
+  if (!status.ok()) {
+    auto* mut_err = response->mutable_error();
+    mut_err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    mut_err->set_errmsg(status.error_str());
+  }
+
+  for (const auto& name : need_reopen_options) {
+    response->add_need_reopen_options(name);
+  }
+}
+
+void StoreServiceImpl::SetBulkLoadMode(google::protobuf::RpcController* /*controller*/,
+                                       const pb::store::SetBulkLoadModeRequest* request,
+                                       pb::store::SetBulkLoadModeResponse* response, google::protobuf::Closure* done) {
+  brpc::ClosureGuard done_guard(done);
+  LOG(INFO) << "SetBulkLoadMode request: " << request->ShortDebugString();
+
+  auto raw_engine =
+      std::dynamic_pointer_cast<RawRocksEngine>(Server::GetInstance()->GetRawEngine(pb::common::RAW_ENG_ROCKSDB));
+  butil::Status status;
+  if (raw_engine == nullptr) {
+    status = butil::Status(pb::error::ENOT_SUPPORT, "Not found rocksdb engine");
+  } else {
+    status = raw_engine->SetBulkLoadMode(request->cf_name(), request->enable());
+  }
+  if (!status.ok()) {
+    auto* mut_err = response->mutable_error();
+    mut_err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    mut_err->set_errmsg(status.error_str());
+  }
+}
+
+static uint64_t KvsSize(const google::protobuf::RepeatedPtrField<pb::common::KeyValue>& kvs) {
+  uint64_t size = 0;
+  for (const auto& kv : kvs) {
+    size += kv.key().size() + kv.value().size();
+  }
+  return size;
+}
+
+// Choose engine and column family of region data, engine is the table engine of region.
+// Versioned request go to mvcc and table with ttl go to ttl.
+void SetContextColumnFamily(std::shared_ptr<Context> ctx, uint64_t ts) {
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(ctx->RegionId());
+  if (region != nullptr) {
+    ctx->SetEngineId(RaftKvEngine::RegionEngine(*region));
+  }
+
+  ctx->SetTs(ts);
+  if (ts > 0) {
+    ctx->SetCfName(Constant::kStoreMvccCF);
+    return;
+  }
+
+  if (region != nullptr && region->ttl() > 0) {
+    ctx->SetCfName(Constant::kStoreTtlCF);
+    ctx->SetTtl(region->ttl());
+    return;
+  }
+
+  ctx->SetCfName(Constant::kStoreDataCF);
+}
+
+// Mvcc gc and ttl expiry only run on rocksdb, versioned request and ttl table are not supported by other engines.
+butil::Status ValidateRegionColumnFamily(uint64_t region_id, uint64_t ts) {
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(region_id);
+  if (region == nullptr || RaftKvEngine::RegionEngine(*region) == pb::common::ENG_RAFT_STORE) {
+    return butil::Status();
+  }
+
+  if (ts > 0) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support versioned request to table not on rocksdb");
+  }
+  if (region->ttl() > 0) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support ttl table not on rocksdb");
+  }
+
+  return butil::Status();
+}
+
 butil::Status ValidateKvGetRequest(const dingodb::pb::store::KvGetRequest* request) {
   // Check is exist region.
   if (!Server::GetInstance()->GetStoreMetaManager()->IsExistRegion(request->region_id())) {
@@ -88,15 +211,16 @@ butil::Status ValidateKvGetRequest(const dingodb::pb::store::KvGetRequest* reque
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), request->ts());
 }
 
 void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
                              const dingodb::pb::store::KvGetRequest* request,
                              dingodb::pb::store::KvGetResponse* response, google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_get_latency, done);
   brpc::ClosureGuard done_guard(done);
-  LOG(INFO) << "KvGet request: " << request->key();
+  DINGO_LOG_EVERY_SECOND(INFO) << "KvGet request: " << request->key();
 
   butil::Status status = ValidateKvGetRequest(request);
   if (!status.ok()) {
@@ -106,14 +230,12 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
     return;
   }
 
-  LOG(INFO) << "address: " << (void*)request->key().data();
-
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, request->ts());
   std::vector<std::string> keys;
   auto mut_request = const_cast<dingodb::pb::store::KvGetRequest*>(request);
   keys.emplace_back(std::move(*mut_request->release_key()));
-  LOG(INFO) << "address: " << (void*)(keys.begin()->data());
 
   std::vector<pb::common::KeyValue> kvs;
   status = storage_->KvGet(ctx, keys, kvs);
@@ -126,6 +248,7 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
   if (kvs.size() > 0) {
     response->set_value(kvs[0].value());
   }
+  StoreMetrics::RecordRegionRead(request->region_id(), response->value().size());
 }
 
 butil::Status ValidateKvBatchGetRequest(const dingodb::pb::store::KvBatchGetRequest* request) {
@@ -140,15 +263,16 @@ butil::Status ValidateKvBatchGetRequest(const dingodb::pb::store::KvBatchGetRequ
     }
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), request->ts());
 }
 
 void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
                                   const pb::store::KvBatchGetRequest* request, pb::store::KvBatchGetResponse* response,
                                   google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_batch_get_latency, done);
   brpc::ClosureGuard done_guard(done);
-  LOG(INFO) << "KvBatchGet request";
+  DINGO_LOG_EVERY_SECOND(INFO) << "KvBatchGet request, keys size: " << request->keys_size();
 
   butil::Status status = ValidateKvBatchGetRequest(request);
   if (!status.ok()) {
@@ -159,7 +283,8 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
   }
 
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, request->ts());
 
   std::vector<pb::common::KeyValue> kvs;
   auto mut_request = const_cast<dingodb::pb::store::KvBatchGetRequest*>(request);
@@ -172,6 +297,7 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
   }
 
   Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+  StoreMetrics::RecordRegionRead(request->region_id(), KvsSize(response->kvs()));
 }
 
 butil::Status ValidateKvPutRequest(const dingodb::pb::store::KvPutRequest* request) {
@@ -184,15 +310,16 @@ butil::Status ValidateKvPutRequest(const dingodb::pb::store::KvPutRequest* reque
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), request->ts());
 }
 
 void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
                              const dingodb::pb::store::KvPutRequest* request,
                              dingodb::pb::store::KvPutResponse* response, google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_put_latency, done);
   brpc::ClosureGuard done_guard(done);
-  LOG(INFO) << "KvPut request: " << request->kv().key();
+  DINGO_LOG_EVERY_SECOND(INFO) << "KvPut request: " << request->kv().key();
 
   butil::Status status = ValidateKvPutRequest(request);
   if (!status.ok()) {
@@ -203,7 +330,9 @@ void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
   }
 
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, request->ts());
+  StoreMetrics::RecordRegionWrite(request->region_id(), request->kv().key().size() + request->kv().value().size());
   auto mut_request = const_cast<dingodb::pb::store::KvPutRequest*>(request);
   std::vector<pb::common::KeyValue> kvs;
   kvs.emplace_back(std::move(*mut_request->release_kv()));
@@ -228,13 +357,14 @@ butil::Status ValidateKvBatchPutRequest(const dingodb::pb::store::KvBatchPutRequ
     }
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), request->ts());
 }
 
 void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
                                   const pb::store::KvBatchPutRequest* request, pb::store::KvBatchPutResponse* response,
                                   google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_batch_put_latency, done);
   brpc::ClosureGuard done_guard(done);
 
   butil::Status status = ValidateKvBatchPutRequest(request);
@@ -246,7 +376,9 @@ void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
   }
 
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, request->ts());
+  StoreMetrics::RecordRegionWrite(request->region_id(), KvsSize(request->kvs()));
   auto mut_request = const_cast<dingodb::pb::store::KvBatchPutRequest*>(request);
   status = storage_->KvPut(ctx, Helper::PbRepeatedToVector(mut_request->mutable_kvs()));
   if (!status.ok()) {
@@ -267,15 +399,16 @@ butil::Status ValidateKvPutIfAbsentRequest(const dingodb::pb::store::KvPutIfAbse
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), 0);
 }
 
 void StoreServiceImpl::KvPutIfAbsent(google::protobuf::RpcController* controller,
                                      const pb::store::KvPutIfAbsentRequest* request,
                                      pb::store::KvPutIfAbsentResponse* response, google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_put_if_absent_latency, done);
   brpc::ClosureGuard done_guard(done);
-  LOG(INFO) << "KvPutIfAbsent request: ";
+  DINGO_LOG_EVERY_SECOND(INFO) << "KvPutIfAbsent request: " << request->kv().key();
   butil::Status status = ValidateKvPutIfAbsentRequest(request);
   if (!status.ok()) {
     auto* err = response->mutable_error();
@@ -285,11 +418,13 @@ void StoreServiceImpl::KvPutIfAbsent(google::protobuf::RpcController* controller
   }
 
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, 0);
+  StoreMetrics::RecordRegionWrite(request->region_id(), request->kv().key().size() + request->kv().value().size());
   auto mut_request = const_cast<dingodb::pb::store::KvPutIfAbsentRequest*>(request);
   std::vector<pb::common::KeyValue> kvs;
   kvs.emplace_back(std::move(*mut_request->release_kv()));
-  status = storage_->KvPutIfAbsent(ctx, kvs);
+  status = storage_->KvPutIfAbsent(ctx, kvs, true);
   if (!status.ok()) {
     auto* err = response->mutable_error();
     err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
@@ -310,7 +445,7 @@ butil::Status ValidateKvBatchPutIfAbsentRequest(const dingodb::pb::store::KvBatc
     }
   }
 
-  return butil::Status();
+  return ValidateRegionColumnFamily(request->region_id(), 0);
 }
 
 void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* controller,
@@ -318,8 +453,9 @@ void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* contr
                                           pb::store::KvBatchPutIfAbsentResponse* response,
                                           google::protobuf::Closure* done) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_batch_put_if_absent_latency, done);
   brpc::ClosureGuard done_guard(done);
-  LOG(INFO) << "KvBatchPutIfAbsent request: ";
+  DINGO_LOG_EVERY_SECOND(INFO) << "KvBatchPutIfAbsent request, kvs size: " << request->kvs_size();
 
   butil::Status status = ValidateKvBatchPutIfAbsentRequest(request);
   if (!status.ok()) {
@@ -330,10 +466,77 @@ void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* contr
   }
 
   std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
-  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, 0);
+  StoreMetrics::RecordRegionWrite(request->region_id(), KvsSize(request->kvs()));
 
   auto mut_request = const_cast<dingodb::pb::store::KvBatchPutIfAbsentRequest*>(request);
-  status = storage_->KvPutIfAbsent(ctx, Helper::PbRepeatedToVector(mut_request->mutable_kvs()));
+  bool is_atomic = !request->allow_partial();
+  status = storage_->KvPutIfAbsent(ctx, Helper::PbRepeatedToVector(mut_request->mutable_kvs()), is_atomic);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    brpc::ClosureGuard done_guard(done);
+  }
+}
+
+butil::Status ValidateKvIngestSstRequest(const dingodb::pb::store::KvIngestSstRequest* request,
+                                         std::shared_ptr<pb::common::Region> region) {
+  // Check is exist region.
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region");
+  }
+
+  // Values of ttl table carry expire time, sst built by client not.
+  if (region->ttl() > 0) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support ingest sst to ttl table");
+  }
+
+  if (RaftKvEngine::RegionEngine(*region) != pb::common::ENG_RAFT_STORE) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support ingest sst to table not on rocksdb");
+  }
+
+  if (request->sst().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Sst is empty");
+  }
+
+  // Sst content is carried by raft log to every replica, large sst must be split by client.
+  auto config = ConfigManager::GetInstance()->GetConfig(pb::common::ClusterRole::STORE);
+  int64_t max_sst_size = config->GetInt(kMaxIngestSstSize);
+  max_sst_size = (max_sst_size > 0 ? max_sst_size : kDefaultMaxIngestSstSize) * 1024 * 1024;
+  if (static_cast<int64_t>(request->sst().size()) > max_sst_size) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         butil::StringPrintf("Sst size %lu exceed limit %ld", request->sst().size(), max_sst_size));
+  }
+
+  return butil::Status();
+}
+
+void StoreServiceImpl::KvIngestSst(google::protobuf::RpcController* controller,
+                                   const pb::store::KvIngestSstRequest* request,
+                                   pb::store::KvIngestSstResponse* response, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_ingest_sst_latency, done);
+  brpc::ClosureGuard done_guard(done);
+  LOG(INFO) << "KvIngestSst request, sst size: " << request->sst().size();
+
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(request->region_id());
+  butil::Status status = ValidateKvIngestSstRequest(request, region);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    return;
+  }
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
+  ctx->SetRegionId(request->region_id()).SetCfName(Constant::kStoreDataCF);
+  ctx->SetEngineId(RaftKvEngine::RegionEngine(*region));
+
+  StoreMetrics::RecordRegionWrite(request->region_id(), request->sst().size());
+  auto mut_request = const_cast<dingodb::pb::store::KvIngestSstRequest*>(request);
+  status = storage_->KvIngestSst(ctx, *mut_request->mutable_sst(), region->range());
   if (!status.ok()) {
     auto* err = response->mutable_error();
     err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
@@ -342,6 +545,199 @@ void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* contr
   }
 }
 
+butil::Status ValidateColumnarRegion(std::shared_ptr<pb::common::Region> region) {
+  // Check is exist region.
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region");
+  }
+
+  if (region->engine() != pb::common::ENG_COLUMNAR || region->columns().empty()) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support table without columns");
+  }
+
+  return ValidateRegionColumnFamily(region->id(), 0);
+}
+
+butil::Status ValidateKvBatchPutRowsRequest(const dingodb::pb::store::KvBatchPutRowsRequest* request,
+                                            std::shared_ptr<pb::common::Region> region) {
+  auto status = ValidateColumnarRegion(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (request->rows().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Rows is empty");
+  }
+
+  for (const auto& row : request->rows()) {
+    if (row.key().empty()) {
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    if (row.values_size() != region->columns_size()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           butil::StringPrintf("Row has %d values, table has %d columns", row.values_size(),
+                                               region->columns_size()));
+    }
+  }
+
+  return butil::Status();
+}
+
+static ColumnValue FromPbColumnValue(const pb::common::ColumnValue& pb_value) {
+  ColumnValue value;
+  value.is_null = pb_value.is_null();
+  value.int_value = pb_value.int_value();
+  value.bytes_value = pb_value.bytes_value();
+  return value;
+}
+
+// Rows are encoded here by region columns, the raft log carries plain kvs as KvBatchPut.
+void StoreServiceImpl::KvBatchPutRows(google::protobuf::RpcController* controller,
+                                      const pb::store::KvBatchPutRowsRequest* request,
+                                      pb::store::KvBatchPutRowsResponse* response, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_batch_put_rows_latency, done);
+  brpc::ClosureGuard done_guard(done);
+
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(request->region_id());
+  butil::Status status = ValidateKvBatchPutRowsRequest(request, region);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    return;
+  }
+
+  ColumnarSchema schema(region->columns().begin(), region->columns().end());
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(request->rows_size());
+  uint64_t write_bytes = 0;
+  std::vector<ColumnValue> values;
+  for (const auto& row : request->rows()) {
+    values.clear();
+    for (const auto& value : row.values()) {
+      values.push_back(FromPbColumnValue(value));
+    }
+    pb::common::KeyValue kv;
+    kv.set_key(row.key());
+    kv.set_value(ColumnarRow::Encode(schema, values));
+    write_bytes += kv.key().size() + kv.value().size();
+    kvs.push_back(std::move(kv));
+  }
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done_guard.release(), response);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, 0);
+  StoreMetrics::RecordRegionWrite(request->region_id(), write_bytes);
+  status = storage_->KvPut(ctx, kvs);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    brpc::ClosureGuard done_guard(done);
+  }
+}
+
+butil::Status ValidateKvScanColumnsRequest(const dingodb::pb::store::KvScanColumnsRequest* request,
+                                           std::shared_ptr<pb::common::Region> region) {
+  auto status = ValidateColumnarRegion(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  const auto& range = request->range();
+  if (range.start_key().empty() || range.end_key().empty()) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+  if (range.start_key() >= range.end_key()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Start key must be less than end key");
+  }
+  if (range.start_key() < region->range().start_key() || range.end_key() > region->range().end_key()) {
+    return butil::Status(pb::error::EKEY_OUT_OF_RANGE, "Range is out of region range");
+  }
+
+  for (auto column : request->columns()) {
+    if (static_cast<int>(column) >= region->columns_size()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, butil::StringPrintf("Invalid column %u", column));
+    }
+  }
+  for (const auto& predicate : request->predicates()) {
+    if (static_cast<int>(predicate.column()) >= region->columns_size()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           butil::StringPrintf("Invalid predicate column %u", predicate.column()));
+    }
+  }
+
+  return butil::Status();
+}
+
+// Not set bound is unbounded.
+static ColumnPredicate FromPbColumnPredicate(const pb::common::ColumnPredicate& pb_predicate) {
+  ColumnPredicate predicate;
+  predicate.column = pb_predicate.column();
+  if (pb_predicate.has_min()) {
+    predicate.int_min = pb_predicate.min().int_value();
+    predicate.bytes_min = pb_predicate.min().bytes_value();
+  }
+  if (pb_predicate.has_max()) {
+    predicate.int_max = pb_predicate.max().int_value();
+    predicate.bytes_max = pb_predicate.max().bytes_value();
+  }
+  return predicate;
+}
+
+void StoreServiceImpl::KvScanColumns(google::protobuf::RpcController* controller,
+                                     const pb::store::KvScanColumnsRequest* request,
+                                     pb::store::KvScanColumnsResponse* response, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  done = new LatencyClosure(g_kv_scan_columns_latency, done);
+  brpc::ClosureGuard done_guard(done);
+
+  auto region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(request->region_id());
+  butil::Status status = ValidateKvScanColumnsRequest(request, region);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    return;
+  }
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  ctx->SetRegionId(request->region_id());
+  SetContextColumnFamily(ctx, 0);
+
+  std::vector<uint32_t> columns(request->columns().begin(), request->columns().end());
+  std::vector<ColumnPredicate> predicates;
+  for (const auto& predicate : request->predicates()) {
+    predicates.push_back(FromPbColumnPredicate(predicate));
+  }
+
+  ColumnBatch batch;
+  status = storage_->KvScanColumns(ctx, request->range(), columns, predicates, batch);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    return;
+  }
+
+  uint64_t read_bytes = 0;
+  for (size_t i = 0; i < batch.Size(); ++i) {
+    auto* row = response->add_rows();
+    row->set_key(batch.keys[i]);
+    read_bytes += batch.keys[i].size();
+    for (const auto& column : batch.columns) {
+      auto value = column.Get(i);
+      auto* pb_value = row->add_values();
+      pb_value->set_is_null(value.is_null);
+      pb_value->set_int_value(value.int_value);
+      pb_value->set_bytes_value(value.bytes_value);
+      read_bytes += column.type == pb::common::COLUMN_TYPE_INT64 ? sizeof(int64_t) : value.bytes_value.size();
+    }
+  }
+  StoreMetrics::RecordRegionRead(request->region_id(), read_bytes);
+}
+
 void StoreServiceImpl::set_storage(std::shared_ptr<Storage> storage) { storage_ = storage; }
 
 }  // namespace dingodb
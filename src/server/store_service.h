@@ -35,6 +35,11 @@ class StoreServiceImpl : public pb::store::StoreService {
   void DestroyRegion(google::protobuf::RpcController* controller, const pb::store::DestroyRegionRequest* request,
                      pb::store::DestroyRegionResponse* response, google::protobuf::Closure* done);
 
+  void SetEngineOptions(google::protobuf::RpcController* controller, const pb::store::SetEngineOptionsRequest* request,
+                        pb::store::SetEngineOptionsResponse* response, google::protobuf::Closure* done);
+  void SetBulkLoadMode(google::protobuf::RpcController* controller, const pb::store::SetBulkLoadModeRequest* request,
+                       pb::store::SetBulkLoadModeResponse* response, google::protobuf::Closure* done);
+
   void KvGet(google::protobuf::RpcController* controller, const pb::store::KvGetRequest* request,
              pb::store::KvGetResponse* response, google::protobuf::Closure* done);
 
@@ -54,6 +59,15 @@ class StoreServiceImpl : public pb::store::StoreService {
                           const pb::store::KvBatchPutIfAbsentRequest* request,
                           pb::store::KvBatchPutIfAbsentResponse* response, google::protobuf::Closure* done);
 
+  void KvIngestSst(google::protobuf::RpcController* controller, const pb::store::KvIngestSstRequest* request,
+                   pb::store::KvIngestSstResponse* response, google::protobuf::Closure* done);
+
+  void KvBatchPutRows(google::protobuf::RpcController* controller, const pb::store::KvBatchPutRowsRequest* request,
+                      pb::store::KvBatchPutRowsResponse* response, google::protobuf::Closure* done);
+
+  void KvScanColumns(google::protobuf::RpcController* controller, const pb::store::KvScanColumnsRequest* request,
+                     pb::store::KvScanColumnsResponse* response, google::protobuf::Closure* done);
+
   void set_storage(std::shared_ptr<Storage> storage);
 
  private:
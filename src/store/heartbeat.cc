@@ -16,6 +16,7 @@
 
 #include "common/helper.h"
 #include "coordinator/coordinator_interaction.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
@@ -35,6 +36,16 @@ void Heartbeat::SendStoreHeartbeat(void* arg) {
     *region = *(it.second);
   }
 
+  for (auto& region_metrics : StoreMetrics::GetAllRegionMetrics()) {
+    *request.add_region_metrics() = region_metrics;
+  }
+
+  auto store_control = Server::GetInstance()->GetStoreControl();
+  request.set_self_dead_range_epoch(store_control->GetDeadRangeEpoch());
+  for (auto reclaimed_id : store_control->GetReclaimedDeadRanges()) {
+    request.add_reclaimed_dead_range_ids(reclaimed_id);
+  }
+
   pb::coordinator::StoreHeartbeatResponse response;
   auto status = coordinator_interaction->SendRequest("StoreHeartbeat", request, response);
   if (status.ok()) {
@@ -137,6 +148,12 @@ void Heartbeat::HandleStoreHeartbeatResponse(std::shared_ptr<dingodb::StoreMetaM
     std::shared_ptr<Context> ctx = std::make_shared<Context>();
     // store_control->DeleteRegion(ctx, region->id());
   }
+
+  // Reclaim data of dropped regions, dead ranges are only sent when changed.
+  if (response.dead_range_epoch() != store_control->GetDeadRangeEpoch()) {
+    store_control->SetDeadRanges(response.dead_range_epoch(), Helper::PbRepeatedToVector(response.dead_ranges()));
+  }
+  store_control->UpdateDeadRanges();
 }
 
 }  // namespace dingodb
\ No newline at end of file
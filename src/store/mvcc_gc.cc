@@ -0,0 +1,55 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/mvcc_gc.h"
+
+#include <cstdint>
+
+#include "config/config_manager.h"
+#include "coordinator/tso_client.h"
+#include "engine/mvcc.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+static const int64_t kDefaultMvccGcLifeTime = 600;  // s
+
+void MvccGc::UpdateSafePoint(void* arg) {
+  TsoClient* tso_client = static_cast<TsoClient*>(arg);
+
+  uint64_t now_ts = 0;
+  auto status = tso_client->GetTimestamp(now_ts);
+  if (!status.ok()) {
+    LOG(ERROR) << "Update mvcc safe point failed, get tso errcode: " << status.error_code() << " "
+               << status.error_str();
+    return;
+  }
+
+  auto config = ConfigManager::GetInstance()->GetConfig(pb::common::ClusterRole::STORE);
+  int64_t life_time = config->GetInt("store.mvccGcLifeTime");
+  if (life_time <= 0) {
+    life_time = kDefaultMvccGcLifeTime;
+  }
+
+  int64_t physical = TsoClient::ExtractPhysical(now_ts) - life_time * 1000;
+  if (physical <= 0) {
+    return;
+  }
+
+  uint64_t safe_point = TsoClient::ComposeTs(physical, 0);
+  Mvcc::SetSafePoint(safe_point);
+  LOG(INFO) << "Update mvcc safe point " << Mvcc::GetSafePoint();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,32 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_MVCC_GC_H_
+#define DINGODB_STORE_MVCC_GC_H_
+
+namespace dingodb {
+
+class MvccGc {
+ public:
+  MvccGc(){};
+  ~MvccGc(){};
+
+  // Advance mvcc gc safe point to tso now minus gc life time,
+  // old versions below safe point are dropped by compaction filter.
+  static void UpdateSafePoint(void* arg);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_MVCC_GC_H_
@@ -14,10 +14,19 @@
 
 #include "store/store_control.h"
 
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 
+#include "butil/strings/stringprintf.h"
+#include "common/constant.h"
 #include "common/helper.h"
+#include "engine/dead_range.h"
+#include "engine/mvcc.h"
 #include "server/server.h"
+#include "store/store_metrics.h"
 
 namespace dingodb {
 
@@ -27,6 +36,11 @@ butil::Status ValidateAddRegion(std::shared_ptr<StoreMetaManager> store_meta_man
     return butil::Status(pb::error::EREGION_ALREADY_EXIST, "Region already exist");
   }
 
+  // Ttl values only expire on rocksdb.
+  if (region->ttl() > 0 && RaftKvEngine::RegionEngine(*region) != pb::common::ENG_RAFT_STORE) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support ttl table not on rocksdb");
+  }
+
   return butil::Status();
 }
 
@@ -40,10 +54,13 @@ butil::Status StoreControl::AddRegion(std::shared_ptr<Context> ctx, std::shared_
   }
 
   // Add raft node
-  auto engine = std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(pb::common::ENG_RAFT_STORE));
+  auto engine =
+      std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(RaftKvEngine::RegionEngine(*region)));
   if (engine == nullptr) {
     return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not exist raft engine");
   }
+  // Before any data of region is written, dead range of a dropped region may cover it.
+  ReviveDeadRanges(region->range());
   status = engine->AddRegion(ctx, region);
   if (!status.ok()) {
     return status;
@@ -51,6 +68,7 @@ butil::Status StoreControl::AddRegion(std::shared_ptr<Context> ctx, std::shared_
 
   // Add region to store region meta manager
   store_meta_manager->AddRegion(region);
+  StoreMetrics::AddRegionMetrics(region->id());
   return butil::Status();
 }
 
@@ -71,7 +89,10 @@ butil::Status StoreControl::ChangeRegion(std::shared_ptr<Context> ctx, std::shar
     return peers;
   };
 
-  auto engine = std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(pb::common::ENG_RAFT_STORE));
+  // Use local region meta, region of command may not carry table engine.
+  auto local_region = Server::GetInstance()->GetStoreMetaManager()->GetRegion(region->id());
+  auto engine = std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(
+      RaftKvEngine::RegionEngine(local_region != nullptr ? *local_region : *region)));
   if (engine == nullptr) {
     return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not exist raft engine");
   }
@@ -85,7 +106,8 @@ butil::Status StoreControl::DeleteRegion(std::shared_ptr<Context> ctx, uint64_t
   // Check region status
 
   // Shutdown raft node
-  auto engine = std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(pb::common::ENG_RAFT_STORE));
+  auto engine_id = region != nullptr ? RaftKvEngine::RegionEngine(*region) : pb::common::ENG_RAFT_STORE;
+  auto engine = std::dynamic_pointer_cast<RaftKvEngine>(Server::GetInstance()->GetEngine(engine_id));
   if (engine == nullptr) {
     return butil::Status(pb::error::ESTORE_NOTEXIST_RAFTENGINE, "Not exist raft engine");
   }
@@ -99,8 +121,225 @@ butil::Status StoreControl::DeleteRegion(std::shared_ptr<Context> ctx, uint64_t
   store_meta_manager->DeleteRegion(region_id);
 
   // Free other resources
+  StoreMetrics::DeleteRegionMetrics(region_id);
 
   return butil::Status();
 }
 
+bool StoreControl::Init() {
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+  if (!stopped_) {
+    return true;
+  }
+  stopped_ = false;
+  reclaim_thread_ = std::thread(&StoreControl::ReclaimWorker, this);
+  return true;
+}
+
+void StoreControl::Destroy() {
+  {
+    std::lock_guard<std::mutex> lock(dead_range_mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  reclaim_cond_.notify_all();
+  reclaim_thread_.join();
+}
+
+uint64_t StoreControl::GetDeadRangeEpoch() {
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+  return dead_range_epoch_;
+}
+
+std::vector<uint64_t> StoreControl::GetReclaimedDeadRanges() {
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+  return std::vector<uint64_t>(reclaimed_dead_range_ids_.begin(), reclaimed_dead_range_ids_.end());
+}
+
+void StoreControl::SetDeadRanges(uint64_t epoch, const std::vector<pb::coordinator::DeadRange>& dead_ranges) {
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+  dead_range_epoch_ = epoch;
+  dead_ranges_.clear();
+  for (const auto& dead_range : dead_ranges) {
+    dead_ranges_[dead_range.id()] = dead_range.range();
+  }
+
+  // Dropped by coordinator, no need to report or reclaim.
+  auto erase_dropped = [this](std::set<uint64_t>& ids) {
+    for (auto it = ids.begin(); it != ids.end();) {
+      it = dead_ranges_.find(*it) == dead_ranges_.end() ? ids.erase(it) : std::next(it);
+    }
+  };
+  erase_dropped(pending_dead_range_ids_);
+  erase_dropped(reclaimed_dead_range_ids_);
+}
+
+static bool IsOverlap(const pb::common::Range& range, const pb::common::Range& other) {
+  return range.start_key() < other.end_key() && other.start_key() < range.end_key();
+}
+
+void StoreControl::UpdateDeadRanges() {
+  std::vector<pb::common::Range> live_ranges;
+  for (const auto& [_, region] : Server::GetInstance()->GetStoreMetaManager()->GetAllRegion()) {
+    live_ranges.push_back(region->range());
+  }
+  UpdateDeadRanges(live_ranges);
+}
+
+void StoreControl::UpdateDeadRanges(const std::vector<pb::common::Range>& live_ranges) {
+  auto is_live_range = [&live_ranges](const pb::common::Range& range) -> bool {
+    for (const auto& live_range : live_ranges) {
+      if (IsOverlap(range, live_range)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+
+  // Range still served by local region is not dead, coordinator view maybe newer than local.
+  std::set<uint64_t> active_ids;
+  std::vector<pb::common::Range> active_ranges;
+  for (const auto& [id, range] : dead_ranges_) {
+    if (!is_live_range(range)) {
+      active_ids.insert(id);
+      active_ranges.push_back(range);
+    }
+  }
+
+  if (active_ids != active_dead_range_ids_) {
+    DeadRange::Update(active_ranges);
+    active_dead_range_ids_.swap(active_ids);
+  }
+
+  bool has_new = false;
+  for (auto id : active_dead_range_ids_) {
+    if (reclaimed_dead_range_ids_.count(id) == 0 && pending_dead_range_ids_.insert(id).second) {
+      has_new = true;
+    }
+  }
+  if (has_new) {
+    reclaim_cond_.notify_one();
+  }
+}
+
+void StoreControl::ReviveDeadRanges(const pb::common::Range& range) {
+  std::lock_guard<std::mutex> lock(dead_range_mutex_);
+
+  bool revived = false;
+  std::vector<pb::common::Range> active_ranges;
+  for (auto it = active_dead_range_ids_.begin(); it != active_dead_range_ids_.end();) {
+    const auto& dead_range = dead_ranges_[*it];
+    if (IsOverlap(dead_range, range)) {
+      LOG(INFO) << "Revive dead range " << *it << " by new region " << Helper::StringToHex(range.start_key()) << " - "
+                << Helper::StringToHex(range.end_key());
+      pending_dead_range_ids_.erase(*it);
+      it = active_dead_range_ids_.erase(it);
+      revived = true;
+    } else {
+      active_ranges.push_back(dead_range);
+      ++it;
+    }
+  }
+
+  // Compaction started before keep the old ranges, it only reads files written before the region is added.
+  if (revived) {
+    DeadRange::Update(active_ranges);
+  }
+}
+
+// Caller hold dead_range_mutex_.
+bool StoreControl::IsActiveDeadRange(uint64_t id, const pb::common::Range& range) {
+  if (active_dead_range_ids_.count(id) == 0) {
+    return false;
+  }
+
+  auto store_meta_manager = Server::GetInstance()->GetStoreMetaManager();
+  if (store_meta_manager != nullptr) {
+    for (const auto& [_, region] : store_meta_manager->GetAllRegion()) {
+      if (IsOverlap(range, region->range())) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Reclaim is slow, run out of heartbeat and without holding dead_range_mutex_.
+void StoreControl::ReclaimWorker() {
+  for (;;) {
+    uint64_t id = 0;
+    pb::common::Range range;
+    {
+      std::unique_lock<std::mutex> lock(dead_range_mutex_);
+      reclaim_cond_.wait(lock, [this]() { return stopped_ || !pending_dead_range_ids_.empty(); });
+      if (stopped_) {
+        break;
+      }
+      id = *pending_dead_range_ids_.begin();
+      pending_dead_range_ids_.erase(pending_dead_range_ids_.begin());
+      if (active_dead_range_ids_.count(id) == 0) {
+        continue;
+      }
+      range = dead_ranges_[id];
+    }
+
+    if (!ReclaimRange(id, range)) {
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(dead_range_mutex_);
+    if (dead_ranges_.find(id) != dead_ranges_.end()) {
+      reclaimed_dead_range_ids_.insert(id);
+    }
+  }
+}
+
+bool StoreControl::ReclaimRange(uint64_t id, const pb::common::Range& range) {
+  pb::common::Range mvcc_range;
+  mvcc_range.set_start_key(Mvcc::EncodeKeyPrefix(range.start_key()));
+  mvcc_range.set_end_key(Mvcc::EncodeKeyPrefix(range.end_key()));
+
+  std::vector<std::pair<std::string, pb::common::Range> > cf_ranges = {
+      {Constant::kStoreDataCF, range}, {Constant::kStoreTtlCF, range}, {Constant::kStoreMvccCF, mvcc_range}};
+  // Dead region may be of any table engine.
+  for (auto type : {pb::common::RAW_ENG_ROCKSDB, pb::common::RAW_ENG_MEMORY, pb::common::RAW_ENG_COLUMNAR,
+                    pb::common::RAW_ENG_XDP}) {
+    auto raw_engine = Server::GetInstance()->GetRawEngine(type);
+    if (raw_engine == nullptr) {
+      continue;
+    }
+
+    for (const auto& [cf_name, cf_range] : cf_ranges) {
+      // Files are deleted regardless of compaction filter, check range is still dead under the lock which
+      // AddRegion revive range with, so no data of a new region is written in between.
+      butil::Status status;
+      {
+        std::lock_guard<std::mutex> lock(dead_range_mutex_);
+        if (!IsActiveDeadRange(id, range)) {
+          LOG(INFO) << "Skip reclaim revived dead range " << id;
+          return false;
+        }
+        status = raw_engine->DeleteFilesInRange(cf_name, cf_range);
+      }
+      // Xdp compact is a full merge, the delete range tombstones are reclaimed by xdp merge crontab.
+      if (status.ok() && type != pb::common::RAW_ENG_XDP) {
+        status = raw_engine->CompactRange(cf_name, cf_range);
+      }
+      if (!status.ok()) {
+        LOG(ERROR) << butil::StringPrintf("Reclaim dead range failed, engine %s cf %s error %s",
+                                          raw_engine->GetName().c_str(), cf_name.c_str(), status.error_cstr());
+      }
+    }
+  }
+
+  LOG(INFO) << "Reclaim dead range " << id << " " << Helper::StringToHex(range.start_key()) << " - "
+            << Helper::StringToHex(range.end_key());
+  return true;
+}
+
 }  // namespace dingodb
@@ -15,11 +15,21 @@
 #ifndef DINGODB_STORE_STORE_CONTROL_H_
 #define DINGODB_STORE_STORE_CONTROL_H_
 
+#include <condition_variable>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "butil/macros.h"
 #include "common/context.h"
 #include "proto/common.pb.h"
+#include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 
 namespace dingodb {
@@ -27,7 +37,11 @@ namespace dingodb {
 class StoreControl {
  public:
   StoreControl(){};
-  ~StoreControl(){};
+  ~StoreControl() { Destroy(); }
+
+  // Start background worker which reclaim dead ranges.
+  bool Init();
+  void Destroy();
 
   butil::Status AddRegion(std::shared_ptr<Context> ctx, std::shared_ptr<pb::common::Region> region);
   void AddRegions(std::shared_ptr<Context> ctx, std::vector<std::shared_ptr<pb::common::Region> > regions);
@@ -36,7 +50,37 @@ class StoreControl {
 
   butil::Status DeleteRegion(std::shared_ptr<Context> ctx, uint64_t region_id);
 
+  uint64_t GetDeadRangeEpoch();
+  // Reclaimed dead ranges still known by coordinator, reported in heartbeat until coordinator drop them.
+  std::vector<uint64_t> GetReclaimedDeadRanges();
+  // Replace dead ranges, coordinator only send them when epoch changed.
+  void SetDeadRanges(uint64_t epoch, const std::vector<pb::coordinator::DeadRange>& dead_ranges);
+  // Dead ranges not served by local region are visible to compaction filter, and queued to background worker.
+  void UpdateDeadRanges();
+  void UpdateDeadRanges(const std::vector<pb::common::Range>& live_ranges);
+  // A region added over dead ranges revive them at once, data of the region must survive until next heartbeat.
+  void ReviveDeadRanges(const pb::common::Range& range);
+
  private:
+  void ReclaimWorker();
+  // Delete files fully in range, then compact range to drop the rest by compaction filter.
+  // Return false if the range is revived by a local region before files are deleted.
+  bool ReclaimRange(uint64_t id, const pb::common::Range& range);
+  bool IsActiveDeadRange(uint64_t id, const pb::common::Range& range);
+
+  // Protect dead range members, background worker only hold it to check range and delete files.
+  std::mutex dead_range_mutex_;
+  std::condition_variable reclaim_cond_;
+  uint64_t dead_range_epoch_ = 0;
+  // Dead ranges from coordinator, deleted region id -> range.
+  std::map<uint64_t, pb::common::Range> dead_ranges_;
+  // Dead ranges not served by local region.
+  std::set<uint64_t> active_dead_range_ids_;
+  std::set<uint64_t> pending_dead_range_ids_;
+  std::set<uint64_t> reclaimed_dead_range_ids_;
+  bool stopped_ = true;
+  std::thread reclaim_thread_;
+
   DISALLOW_COPY_AND_ASSIGN(StoreControl);
 };
 
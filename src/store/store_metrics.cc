@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/store_metrics.h"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "butil/strings/stringprintf.h"
+#include "butil/time.h"
+
+namespace dingodb {
+
+bvar::LatencyRecorder StoreMetrics::write_queue_latency("dingo_store_write", "queue");
+bvar::LatencyRecorder StoreMetrics::write_raft_latency("dingo_store_write", "raft");
+bvar::LatencyRecorder StoreMetrics::write_apply_latency("dingo_store_write", "apply");
+bvar::LatencyRecorder StoreMetrics::write_respond_latency("dingo_store_write", "respond");
+
+std::shared_mutex StoreMetrics::mutex_;
+std::map<uint64_t, std::shared_ptr<RegionMetrics>> StoreMetrics::region_metrics_;
+
+RegionMetrics::RegionMetrics(uint64_t region_id)
+    : region_id_(region_id),
+      read_qps_(butil::StringPrintf("dingo_region_%lu", region_id), "read_qps", &read_count_),
+      read_bytes_per_second_(butil::StringPrintf("dingo_region_%lu", region_id), "read_bytes_per_second",
+                             &read_bytes_),
+      write_qps_(butil::StringPrintf("dingo_region_%lu", region_id), "write_qps", &write_count_),
+      write_bytes_per_second_(butil::StringPrintf("dingo_region_%lu", region_id), "write_bytes_per_second",
+                              &write_bytes_) {}
+
+void RegionMetrics::Get(pb::common::RegionMetrics& metrics) {
+  metrics.set_region_id(region_id_);
+  metrics.set_read_qps(read_qps_.get_value());
+  metrics.set_write_qps(write_qps_.get_value());
+  metrics.set_read_bytes_per_second(read_bytes_per_second_.get_value());
+  metrics.set_write_bytes_per_second(write_bytes_per_second_.get_value());
+}
+
+void StoreMetrics::AddRegionMetrics(uint64_t region_id) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (region_metrics_.find(region_id) == region_metrics_.end()) {
+    region_metrics_.emplace(region_id, std::make_shared<RegionMetrics>(region_id));
+  }
+}
+
+std::shared_ptr<RegionMetrics> StoreMetrics::GetRegionMetrics(uint64_t region_id) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = region_metrics_.find(region_id);
+  return it != region_metrics_.end() ? it->second : nullptr;
+}
+
+void StoreMetrics::RecordRegionRead(uint64_t region_id, uint64_t bytes) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics != nullptr) {
+    region_metrics->RecordRead(bytes);
+  }
+}
+
+void StoreMetrics::RecordRegionWrite(uint64_t region_id, uint64_t bytes) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics != nullptr) {
+    region_metrics->RecordWrite(bytes);
+  }
+}
+
+void StoreMetrics::DeleteRegionMetrics(uint64_t region_id) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  region_metrics_.erase(region_id);
+}
+
+std::vector<pb::common::RegionMetrics> StoreMetrics::GetAllRegionMetrics() {
+  std::vector<pb::common::RegionMetrics> all_metrics;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  for (const auto& [_, region_metrics] : region_metrics_) {
+    pb::common::RegionMetrics metrics;
+    region_metrics->Get(metrics);
+    all_metrics.push_back(metrics);
+  }
+
+  return all_metrics;
+}
+
+void LatencyClosure::Run() {
+  std::unique_ptr<LatencyClosure> self_guard(this);
+  done_->Run();
+  recorder_ << butil::gettimeofday_us() - start_time_us_;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_STORE_METRICS_H_
+#define DINGODB_STORE_STORE_METRICS_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "butil/time.h"
+#include "bvar/bvar.h"
+#include "google/protobuf/service.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Read and write flow of one region, show in /vars as dingo_region_<id>_*.
+class RegionMetrics {
+ public:
+  explicit RegionMetrics(uint64_t region_id);
+  ~RegionMetrics() = default;
+
+  RegionMetrics(const RegionMetrics&) = delete;
+  const RegionMetrics& operator=(const RegionMetrics&) = delete;
+
+  void RecordRead(uint64_t bytes) {
+    read_count_ << 1;
+    read_bytes_ << static_cast<int64_t>(bytes);
+  }
+  void RecordWrite(uint64_t bytes) {
+    write_count_ << 1;
+    write_bytes_ << static_cast<int64_t>(bytes);
+  }
+
+  void Get(pb::common::RegionMetrics& metrics);  // NOLINT
+
+ private:
+  uint64_t region_id_;
+  bvar::Adder<int64_t> read_count_;
+  bvar::Adder<int64_t> read_bytes_;
+  bvar::Adder<int64_t> write_count_;
+  bvar::Adder<int64_t> write_bytes_;
+  bvar::PerSecond<bvar::Adder<int64_t>> read_qps_;
+  bvar::PerSecond<bvar::Adder<int64_t>> read_bytes_per_second_;
+  bvar::PerSecond<bvar::Adder<int64_t>> write_qps_;
+  bvar::PerSecond<bvar::Adder<int64_t>> write_bytes_per_second_;
+};
+
+// Store latency and flow metrics.
+// Write stage latency in us:
+//   queue: request received to raft log proposed
+//   raft: proposed to applied on leader, include replicate and commit
+//   apply: write engine in state machine
+//   respond: applied to response sent
+class StoreMetrics {
+ public:
+  static bvar::LatencyRecorder write_queue_latency;
+  static bvar::LatencyRecorder write_raft_latency;
+  static bvar::LatencyRecorder write_apply_latency;
+  static bvar::LatencyRecorder write_respond_latency;
+
+  // Region metrics live from region add or recover to region delete,
+  // so request of unknown region id never create metrics.
+  static void AddRegionMetrics(uint64_t region_id);
+  // Return nullptr if region metrics not exist.
+  static std::shared_ptr<RegionMetrics> GetRegionMetrics(uint64_t region_id);
+  static void RecordRegionRead(uint64_t region_id, uint64_t bytes);
+  static void RecordRegionWrite(uint64_t region_id, uint64_t bytes);
+  static void DeleteRegionMetrics(uint64_t region_id);
+  static std::vector<pb::common::RegionMetrics> GetAllRegionMetrics();
+
+ private:
+  static std::shared_mutex mutex_;
+  static std::map<uint64_t, std::shared_ptr<RegionMetrics>> region_metrics_;
+};
+
+// Record rpc latency to recorder when the rpc done, include async write wait raft.
+class LatencyClosure : public google::protobuf::Closure {
+ public:
+  LatencyClosure(bvar::LatencyRecorder& recorder, google::protobuf::Closure* done)  // NOLINT
+      : recorder_(recorder), done_(done), start_time_us_(butil::gettimeofday_us()) {}
+  ~LatencyClosure() override = default;
+
+  void Run() override;
+
+ private:
+  bvar::LatencyRecorder& recorder_;
+  google::protobuf::Closure* done_;
+  int64_t start_time_us_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_STORE_METRICS_H_
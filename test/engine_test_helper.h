@@ -0,0 +1,62 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_TEST_ENGINE_TEST_HELPER_H_
+#define DINGODB_TEST_ENGINE_TEST_HELPER_H_
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "config/yaml_config.h"
+#include "proto/common.pb.h"
+
+// Fixtures shared by raw engine tests.
+
+static const std::string kDefaultCf = "default";
+
+inline dingodb::pb::common::KeyValue GenKv(const std::string& key, const std::string& value) {
+  dingodb::pb::common::KeyValue kv;
+  kv.set_key(key);
+  kv.set_value(value);
+  return kv;
+}
+
+// Fixed width key, so key order is the same as i order.
+inline std::string GenKey(int i) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "t%06d", i);
+  return buf;
+}
+
+// Store config with column family default and meta, extra is yaml lines under store, e.g. "  dbPath: ./db\n".
+inline std::shared_ptr<dingodb::Config> GenEngineConfig(const std::string& extra = "") {
+  auto config = std::make_shared<dingodb::YamlConfig>();
+  config->Load(
+      "store:\n"
+      "  columnFamilies:\n"
+      "    - default\n"
+      "    - meta\n" +
+      extra);
+  return config;
+}
+
+// Return nullptr if engine init failed.
+template <typename T>
+std::shared_ptr<T> NewRawEngine(const std::string& extra = "") {
+  auto engine = std::make_shared<T>();
+  return engine->Init(GenEngineConfig(extra)) ? engine : nullptr;
+}
+
+#endif  // DINGODB_TEST_ENGINE_TEST_HELPER_H_
@@ -0,0 +1,247 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/column_chunk.h"
+#include "engine/raw_columnar_engine.h"
+#include "engine_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+static dingodb::ColumnarSchema GenSchema() {
+  dingodb::ColumnarSchema schema(2);
+  schema[0].set_name("id");
+  schema[0].set_type(dingodb::pb::common::COLUMN_TYPE_INT64);
+  schema[1].set_name("city");
+  schema[1].set_type(dingodb::pb::common::COLUMN_TYPE_BYTES);
+  return schema;
+}
+
+static std::string GenRow(int64_t id, const std::string& city) {
+  std::vector<dingodb::ColumnValue> row(2);
+  row[0].is_null = false;
+  row[0].int_value = id;
+  row[1].is_null = city.empty();
+  row[1].bytes_value = city;
+  return dingodb::ColumnarRow::Encode(GenSchema(), row);
+}
+
+TEST(ColumnChunkTest, Encoding) {
+  dingodb::ColumnVector ints;
+  ints.type = dingodb::pb::common::COLUMN_TYPE_INT64;
+  for (int i = 0; i < 1000; ++i) {
+    ints.Append(dingodb::ColumnValue{false, 1000000 + i * 3, ""});
+  }
+  auto chunk = dingodb::ColumnChunk::Build(ints);
+  EXPECT_EQ(dingodb::ColumnChunk::Encoding::kDelta, chunk->GetEncoding());
+  EXPECT_EQ(1000000, chunk->IntMin());
+  EXPECT_EQ(1000000 + 999 * 3, chunk->IntMax());
+  EXPECT_LT(chunk->ByteSize(), 1000 * 8 / 4);
+
+  dingodb::ColumnVector decoded;
+  chunk->Decode(decoded);
+  EXPECT_EQ(ints.ints, decoded.ints);
+
+  dingodb::ColumnVector cities;
+  dingodb::ColumnVector runs;
+  runs.type = dingodb::pb::common::COLUMN_TYPE_INT64;
+  const std::vector<std::string> names = {"beijing", "shanghai", "shenzhen"};
+  for (int i = 0; i < 1000; ++i) {
+    cities.Append(dingodb::ColumnValue{false, 0, names[(i * 7) % 3]});
+    runs.Append(dingodb::ColumnValue{i % 100 == 0, i / 250, ""});
+  }
+  chunk = dingodb::ColumnChunk::Build(cities);
+  EXPECT_EQ(dingodb::ColumnChunk::Encoding::kDictionary, chunk->GetEncoding());
+  chunk->Decode(decoded);
+  EXPECT_EQ(cities.bytes, decoded.bytes);
+
+  chunk = dingodb::ColumnChunk::Build(runs);
+  EXPECT_EQ(dingodb::ColumnChunk::Encoding::kRle, chunk->GetEncoding());
+  chunk->Decode(decoded);
+  EXPECT_EQ(runs.ints, decoded.ints);
+  EXPECT_EQ(runs.nulls, decoded.nulls);
+}
+
+TEST(ColumnChunkTest, Filter) {
+  dingodb::ColumnVector cities;
+  cities.Append(dingodb::ColumnValue{false, 0, "beijing"});
+  cities.Append(dingodb::ColumnValue{true, 0, ""});
+  cities.Append(dingodb::ColumnValue{false, 0, "shanghai"});
+  cities.Append(dingodb::ColumnValue{false, 0, "beijing"});
+  auto chunk = dingodb::ColumnChunk::Build(cities);
+
+  dingodb::ColumnPredicate predicate;
+  predicate.bytes_min = "beijing";
+  predicate.bytes_max = "beijing";
+  std::vector<uint8_t> selection(4, 1);
+  chunk->Filter(predicate, selection);
+  EXPECT_EQ(std::vector<uint8_t>({1, 0, 0, 1}), selection);
+
+  predicate.bytes_min = "x";
+  predicate.bytes_max.clear();
+  EXPECT_FALSE(chunk->MayMatch(predicate));
+}
+
+TEST(ColumnarRowTest, EncodeAndDecode) {
+  std::vector<dingodb::ColumnValue> row;
+  EXPECT_TRUE(dingodb::ColumnarRow::Decode(GenSchema(), GenRow(-5, "hangzhou"), row));
+  EXPECT_EQ(-5, row[0].int_value);
+  EXPECT_EQ("hangzhou", row[1].bytes_value);
+
+  EXPECT_TRUE(dingodb::ColumnarRow::Decode(GenSchema(), GenRow(7, ""), row));
+  EXPECT_TRUE(row[1].is_null);
+
+  EXPECT_FALSE(dingodb::ColumnarRow::Decode(GenSchema(), "not a row", row));
+  EXPECT_FALSE(dingodb::ColumnarRow::Decode(GenSchema(), GenRow(1, "a") + "x", row));
+}
+
+class RawColumnarEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    engine_ = NewRawEngine<dingodb::RawColumnarEngine>(
+        "  columnarFlushRows: 16\n"
+        "  columnarGroupRows: 64\n");
+    ASSERT_NE(nullptr, engine_);
+
+    dingodb::pb::common::Range range;
+    range.set_start_key("t");
+    range.set_end_key("u");
+    engine_->SetSchema(range, GenSchema());
+  }
+  void TearDown() override {}
+
+  std::shared_ptr<dingodb::RawColumnarEngine> engine_;
+};
+
+TEST_F(RawColumnarEngineTest, ReadAndWrite) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+
+  // Some rows are merged into row groups, others are in buffer.
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenRow(i, i % 2 == 0 ? "beijing" : "shanghai"))).ok());
+  }
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(10), GenRow(10, "hangzhou"))).ok());
+  EXPECT_TRUE(writer->KvDelete(GenKey(11)).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(GenKey(10), value).ok());
+  EXPECT_EQ(GenRow(10, "hangzhou"), value);
+  EXPECT_TRUE(reader->KvGet(GenKey(150), value).ok());
+  EXPECT_EQ(GenRow(150, "beijing"), value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(GenKey(11), value).error_code());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount("t", "u", count).ok());
+  EXPECT_EQ(199, count);
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(GenKey(5), GenKey(15), kvs).ok());
+  ASSERT_EQ(9, kvs.size());
+  EXPECT_EQ(GenKey(5), kvs[0].key());
+  EXPECT_EQ(GenKey(12), kvs[6].key());
+
+  dingodb::pb::common::Range range;
+  range.set_start_key(GenKey(20));
+  range.set_end_key(GenKey(180));
+  EXPECT_TRUE(writer->KvDeleteRange(range).ok());
+  EXPECT_TRUE(reader->KvCount("t", "u", count).ok());
+  EXPECT_EQ(39, count);
+
+  std::vector<std::string> put_keys;
+  EXPECT_TRUE(writer->KvBatchPutIfAbsent({GenKv(GenKey(1), GenRow(1, "")), GenKv(GenKey(30), GenRow(30, ""))},
+                                         put_keys, false)
+                  .ok());
+  EXPECT_EQ(std::vector<std::string>({GenKey(30)}), put_keys);
+  EXPECT_TRUE(writer->KvCompareAndSet(GenKv(GenKey(30), GenRow(30, "")), GenRow(30, "xian")).ok());
+  EXPECT_TRUE(reader->KvGet(GenKey(30), value).ok());
+  EXPECT_EQ(GenRow(30, "xian"), value);
+}
+
+TEST_F(RawColumnarEngineTest, Snapshot) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenRow(i, "beijing"))).ok());
+  }
+
+  auto snapshot = engine_->GetSnapshot();
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenRow(i, "shanghai"))).ok());
+  }
+  EXPECT_TRUE(writer->KvDelete(GenKey(0)).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(snapshot, GenKey(0), value).ok());
+  EXPECT_EQ(GenRow(0, "beijing"), value);
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(snapshot, "t", "u", kvs).ok());
+  ASSERT_EQ(100, kvs.size());
+  EXPECT_EQ(GenRow(99, "beijing"), kvs[99].value());
+  engine_->ReleaseSnapshot(snapshot);
+
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(GenKey(0), value).error_code());
+}
+
+TEST_F(RawColumnarEngineTest, ScanColumns) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = std::dynamic_pointer_cast<dingodb::RawColumnarEngine::Reader>(engine_->NewReader(kDefaultCf));
+  for (int i = 0; i < 300; ++i) {
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenRow(i, i % 3 == 0 ? "beijing" : "shanghai"))).ok());
+  }
+  // Overwrite in buffer
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(3), GenRow(3, "shanghai"))).ok());
+  EXPECT_TRUE(writer->KvDelete(GenKey(6)).ok());
+
+  dingodb::ColumnPredicate city;
+  city.column = 1;
+  city.bytes_min = "beijing";
+  city.bytes_max = "beijing";
+  dingodb::ColumnPredicate id;
+  id.column = 0;
+  id.int_min = 0;
+  id.int_max = 29;
+
+  dingodb::ColumnBatch batch;
+  EXPECT_TRUE(reader->KvScanColumns(nullptr, "t", "u", {0}, {city, id}, batch).ok());
+  // 0, 9, 12, ..., 27
+  ASSERT_EQ(8, batch.Size());
+  EXPECT_EQ(dingodb::pb::common::COLUMN_TYPE_INT64, batch.columns[0].type);
+  EXPECT_EQ(0, batch.columns[0].ints[0]);
+  EXPECT_EQ(9, batch.columns[0].ints[1]);
+  EXPECT_EQ(27, batch.columns[0].ints[7]);
+
+  EXPECT_TRUE(reader->KvScanColumns(nullptr, GenKey(100), GenKey(200), {1, 0}, {}, batch).ok());
+  ASSERT_EQ(100, batch.Size());
+  EXPECT_EQ(GenKey(100), batch.keys[0]);
+  EXPECT_EQ(100, batch.columns[1].ints[0]);
+
+  EXPECT_FALSE(reader->KvScanColumns(nullptr, "t", "u", {2}, {}, batch).ok());
+
+  // Value not of schema layout
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(500), "raw value")).ok());
+  engine_->Flush(kDefaultCf);
+  EXPECT_EQ(dingodb::pb::error::ENOT_SUPPORT,
+            reader->KvScanColumns(nullptr, "t", "u", {0}, {}, batch).error_code());
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(GenKey(500), value).ok());
+  EXPECT_EQ("raw value", value);
+}
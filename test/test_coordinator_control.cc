@@ -0,0 +1,291 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/constant.h"
+#include "coordinator/coordinator_control.h"
+#include "engine/raw_mem_engine.h"
+#include "engine_test_helper.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+#include "proto/coordinator.pb.h"
+#include "proto/coordinator_internal.pb.h"
+#include "proto/meta.pb.h"
+
+class CoordinatorControlTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    engine_ = NewRawEngine<dingodb::RawMemEngine>();
+    ASSERT_NE(nullptr, engine_);
+    control_ = NewControl();
+  }
+  void TearDown() override {}
+
+  std::shared_ptr<dingodb::CoordinatorControl> NewControl() {
+    return std::make_shared<dingodb::CoordinatorControl>(std::make_shared<dingodb::MetaReader>(engine_),
+                                                         std::make_shared<dingodb::MetaWriter>(engine_));
+  }
+
+  std::shared_ptr<dingodb::RawMemEngine> engine_;
+  std::shared_ptr<dingodb::CoordinatorControl> control_;
+};
+
+TEST_F(CoordinatorControlTest, LateApplyDoesNotRewindLeasedIds) {
+  const auto key = dingodb::pb::coordinator_internal::IdEpochType::ID_NEXT_REGION;
+
+  // an older increment proposed before the lease, applied after it
+  dingodb::pb::coordinator_internal::MetaIncrement old_increment;
+  uint64_t old_id = control_->GetNextId(key, old_increment);
+  control_->ResetIdLeases();
+
+  dingodb::pb::coordinator_internal::MetaIncrement new_increment;
+  uint64_t new_id = control_->GetNextId(key, new_increment);
+  EXPECT_GT(new_id, old_id);
+  uint64_t high_water = control_->GetPresentId(key);
+  EXPECT_EQ(old_id - 1 + 2 * dingodb::Constant::kIdLeaseBlockSize, high_water);
+
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(new_increment, true));
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(old_increment, true));
+  EXPECT_EQ(high_water, control_->GetPresentId(key));
+
+  // a new lease starts above every id of the previous block
+  control_->ResetIdLeases();
+  dingodb::pb::coordinator_internal::MetaIncrement next_increment;
+  EXPECT_GT(control_->GetNextId(key, next_increment), high_water);
+
+  // the persisted value is the high-water mark too
+  auto recovered = NewControl();
+  ASSERT_TRUE(recovered->Recover());
+  EXPECT_EQ(high_water, recovered->GetPresentId(key));
+}
+
+TEST_F(CoordinatorControlTest, DiscardedIncrementDoesNotReissueIds) {
+  const auto key = dingodb::pb::coordinator_internal::IdEpochType::ID_NEXT_TABLE;
+
+  // the increment leasing the block is discarded, e.g. CreateTable failed after GetNextId
+  dingodb::pb::coordinator_internal::MetaIncrement discarded_increment;
+  uint64_t discarded_id = control_->GetNextId(key, discarded_increment);
+  ASSERT_EQ(1, discarded_increment.idepochs_size());
+
+  // ids of the block still carry the high-water mark until it is applied
+  dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
+  uint64_t id = control_->GetNextId(key, meta_increment);
+  EXPECT_GT(id, discarded_id);
+  ASSERT_EQ(1, meta_increment.idepochs_size());
+  uint64_t high_water = meta_increment.idepochs(0).idepoch().value();
+  EXPECT_GE(high_water, id);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  // a restarted coordinator never issues an id of an applied increment again
+  auto recovered = NewControl();
+  ASSERT_TRUE(recovered->Recover());
+  dingodb::pb::coordinator_internal::MetaIncrement recovered_increment;
+  EXPECT_GT(recovered->GetNextId(key, recovered_increment), id);
+
+  // once applied, the block is used without persisting anything
+  meta_increment.Clear();
+  EXPECT_EQ(id + 1, control_->GetNextId(key, meta_increment));
+  EXPECT_EQ(0, meta_increment.idepochs_size());
+}
+
+static void AddRegionIncrement(dingodb::pb::coordinator_internal::MetaIncrement& meta_increment, uint64_t region_id,
+                               const std::string& start_key, const std::string& end_key,
+                               dingodb::pb::coordinator_internal::MetaIncrementOpType op_type) {
+  auto* region_increment = meta_increment.add_regions();
+  region_increment->set_id(region_id);
+  region_increment->set_op_type(op_type);
+  region_increment->mutable_region()->set_id(region_id);
+  region_increment->mutable_region()->mutable_range()->set_start_key(start_key);
+  region_increment->mutable_region()->mutable_range()->set_end_key(end_key);
+}
+
+TEST_F(CoordinatorControlTest, DropDeadRangeReclaimedByAllStores) {
+  dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
+  for (uint64_t store_id : {1, 2}) {
+    auto* store_increment = meta_increment.add_stores();
+    store_increment->set_id(store_id);
+    store_increment->set_op_type(dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+    store_increment->mutable_store()->set_id(store_id);
+    store_increment->mutable_store()->set_state(dingodb::pb::common::StoreState::STORE_NORMAL);
+  }
+  AddRegionIncrement(meta_increment, 10, "a", "b", dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  meta_increment.Clear();
+  AddRegionIncrement(meta_increment, 10, "a", "b", dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  // Only sent to store with an older epoch.
+  google::protobuf::RepeatedPtrField<dingodb::pb::coordinator::DeadRange> dead_ranges;
+  uint64_t epoch = control_->GetDeadRanges(0, dead_ranges);
+  ASSERT_EQ(1, dead_ranges.size());
+  EXPECT_EQ(10, dead_ranges.Get(0).id());
+  EXPECT_EQ("a", dead_ranges.Get(0).range().start_key());
+  dead_ranges.Clear();
+  EXPECT_EQ(epoch, control_->GetDeadRanges(epoch, dead_ranges));
+  EXPECT_EQ(0, dead_ranges.size());
+
+  // Kept until every normal store has reclaimed it.
+  meta_increment.Clear();
+  control_->UpdateDeadRanges(1, {10}, meta_increment);
+  EXPECT_EQ(0, meta_increment.deleted_regions_size());
+
+  control_->UpdateDeadRanges(2, {10}, meta_increment);
+  ASSERT_EQ(1, meta_increment.deleted_regions_size());
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  uint64_t new_epoch = control_->GetDeadRanges(epoch, dead_ranges);
+  EXPECT_GT(new_epoch, epoch);
+  EXPECT_EQ(0, dead_ranges.size());
+}
+
+TEST_F(CoordinatorControlTest, DropDeadRangeReusedByLiveRegion) {
+  dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
+  AddRegionIncrement(meta_increment, 10, "a", "c", dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+  meta_increment.Clear();
+  AddRegionIncrement(meta_increment, 10, "a", "c", dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  meta_increment.Clear();
+  control_->UpdateDeadRanges(1, {}, meta_increment);
+  EXPECT_EQ(0, meta_increment.deleted_regions_size());
+
+  meta_increment.Clear();
+  AddRegionIncrement(meta_increment, 11, "b", "d", dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  meta_increment.Clear();
+  control_->UpdateDeadRanges(1, {}, meta_increment);
+  ASSERT_EQ(1, meta_increment.deleted_regions_size());
+  EXPECT_EQ(10, meta_increment.deleted_regions(0).id());
+}
+
+TEST_F(CoordinatorControlTest, SumRegionMetricsOfLiveRegions) {
+  dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
+  AddRegionIncrement(meta_increment, 10, "a", "b", dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+
+  auto gen_metrics = [](uint64_t region_id, int64_t write_qps) {
+    dingodb::pb::common::RegionMetrics metrics;
+    metrics.set_region_id(region_id);
+    metrics.set_write_qps(write_qps);
+    return metrics;
+  };
+
+  // Region 99 is unknown to coordinator.
+  control_->UpdateRegionMetrics(1, {gen_metrics(10, 100), gen_metrics(99, 100)});
+  control_->UpdateRegionMetrics(2, {gen_metrics(10, 0)});
+  std::vector<dingodb::pb::common::RegionMetrics> region_metrics;
+  control_->GetRegionMetrics(region_metrics);
+  ASSERT_EQ(1, region_metrics.size());
+  EXPECT_EQ(10, region_metrics[0].region_id());
+  EXPECT_EQ(100, region_metrics[0].write_qps());
+
+  // Newer heartbeat replaces flow of the same store.
+  control_->UpdateRegionMetrics(1, {gen_metrics(10, 30)});
+  region_metrics.clear();
+  control_->GetRegionMetrics(region_metrics);
+  ASSERT_EQ(1, region_metrics.size());
+  EXPECT_EQ(30, region_metrics[0].write_qps());
+
+  meta_increment.Clear();
+  AddRegionIncrement(meta_increment, 10, "a", "b", dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+  region_metrics.clear();
+  control_->GetRegionMetrics(region_metrics);
+  EXPECT_EQ(0, region_metrics.size());
+}
+
+static dingodb::pb::meta::TableDefinition GenTableDefinition(dingodb::pb::common::Engine engine, uint64_t ttl) {
+  dingodb::pb::meta::TableDefinition table_definition;
+  table_definition.set_name("t1");
+  table_definition.set_engine(engine);
+  table_definition.set_ttl(ttl);
+  auto* column = table_definition.add_columns();
+  column->set_name("id");
+  column->set_sql_type(dingodb::pb::meta::SQL_TYPE_BIGINT);
+  column = table_definition.add_columns();
+  column->set_name("name");
+  column->set_sql_type(dingodb::pb::meta::SQL_TYPE_VARCHAR);
+  for (const auto& [start_key, end_key] : {std::make_pair("a", "b"), std::make_pair("b", "c")}) {
+    auto* range = table_definition.mutable_table_partition()->mutable_range_partition()->add_ranges();
+    range->set_start_key(start_key);
+    range->set_end_key(end_key);
+  }
+  return table_definition;
+}
+
+TEST_F(CoordinatorControlTest, GenColumnSchemas) {
+  auto table_definition = GenTableDefinition(dingodb::pb::common::ENG_COLUMNAR, 0);
+  table_definition.add_columns()->set_sql_type(dingodb::pb::meta::SQL_TYPE_TIMESTAMP);
+
+  auto columns = dingodb::CoordinatorControl::GenColumnSchemas(table_definition);
+  ASSERT_EQ(3, columns.size());
+  EXPECT_EQ("id", columns[0].name());
+  EXPECT_EQ(dingodb::pb::common::COLUMN_TYPE_INT64, columns[0].type());
+  EXPECT_EQ("name", columns[1].name());
+  EXPECT_EQ(dingodb::pb::common::COLUMN_TYPE_BYTES, columns[1].type());
+  EXPECT_EQ(dingodb::pb::common::COLUMN_TYPE_INT64, columns[2].type());
+}
+
+TEST_F(CoordinatorControlTest, CreateTableOfEngine) {
+  ASSERT_TRUE(control_->Init());
+  dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
+  for (uint64_t store_id : {1, 2, 3}) {
+    auto* store_increment = meta_increment.add_stores();
+    store_increment->set_id(store_id);
+    store_increment->set_op_type(dingodb::pb::coordinator_internal::MetaIncrementOpType::CREATE);
+    store_increment->mutable_store()->set_id(store_id);
+    store_increment->mutable_store()->set_state(dingodb::pb::common::StoreState::STORE_NORMAL);
+  }
+  EXPECT_EQ(0, control_->ApplyMetaIncrement(meta_increment, true));
+  const uint64_t schema_id = dingodb::pb::meta::ReservedSchemaIds::DINGO_SCHEMA;
+
+  // Engine and value columns are copied to every region of the table.
+  uint64_t table_id = 0;
+  meta_increment.Clear();
+  ASSERT_EQ(0, control_->CreateTable(schema_id, GenTableDefinition(dingodb::pb::common::ENG_COLUMNAR, 0), table_id,
+                                     meta_increment));
+  ASSERT_EQ(2, meta_increment.regions_size());
+  for (const auto& region_increment : meta_increment.regions()) {
+    EXPECT_EQ(dingodb::pb::common::ENG_COLUMNAR, region_increment.region().engine());
+    ASSERT_EQ(2, region_increment.region().columns_size());
+    EXPECT_EQ("id", region_increment.region().columns(0).name());
+    EXPECT_EQ(dingodb::pb::common::COLUMN_TYPE_BYTES, region_increment.region().columns(1).type());
+  }
+
+  // Rocksdb region has ttl and no columns.
+  meta_increment.Clear();
+  ASSERT_EQ(0, control_->CreateTable(schema_id, GenTableDefinition(dingodb::pb::common::ENG_ROCKSDB, 60), table_id,
+                                     meta_increment));
+  ASSERT_EQ(2, meta_increment.regions_size());
+  EXPECT_EQ(60, meta_increment.regions(0).region().ttl());
+  EXPECT_EQ(0, meta_increment.regions(0).region().columns_size());
+
+  // Only rocksdb expire keys.
+  for (auto engine : {dingodb::pb::common::ENG_MEMORY, dingodb::pb::common::ENG_COLUMNAR,
+                      dingodb::pb::common::ENG_XDP}) {
+    meta_increment.Clear();
+    EXPECT_EQ(-1, control_->CreateTable(schema_id, GenTableDefinition(engine, 60), table_id, meta_increment));
+    EXPECT_EQ(0, meta_increment.regions_size());
+  }
+}
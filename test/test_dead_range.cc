@@ -0,0 +1,105 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "engine/dead_range.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine_test_helper.h"
+#include "proto/coordinator.pb.h"
+#include "store/store_control.h"
+
+static const std::string kDbPath = "./dead_range_test_db";
+
+static dingodb::pb::common::Range GenRange(const std::string& start_key, const std::string& end_key) {
+  dingodb::pb::common::Range range;
+  range.set_start_key(start_key);
+  range.set_end_key(end_key);
+  return range;
+}
+
+TEST(DeadRangeTest, Build) {
+  // [a, b) [c, f), illegal range is skipped
+  auto range_map = dingodb::DeadRange::Build(
+      {GenRange("c", "e"), GenRange("a", "b"), GenRange("d", "f"), GenRange("e", "f"), GenRange("y", "x")});
+  EXPECT_EQ(2, range_map->size());
+  EXPECT_EQ("b", range_map->at("a"));
+  EXPECT_EQ("f", range_map->at("c"));
+}
+
+TEST(DeadRangeTest, Contains) {
+  auto range_map = dingodb::DeadRange::Build({GenRange("a", "b"), GenRange("c", "f")});
+
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*range_map, "a"));
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*range_map, "aaa"));
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*range_map, "b"));
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*range_map, "e"));
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*range_map, "f"));
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*range_map, "0"));
+}
+
+TEST(DeadRangeTest, Update) {
+  dingodb::DeadRange::Update({GenRange("k", "m")});
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "l"));
+  EXPECT_FALSE(dingodb::DeadRange::GetMvcc()->empty());
+
+  dingodb::DeadRange::Update({});
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "l"));
+}
+
+static dingodb::pb::coordinator::DeadRange GenDeadRange(uint64_t id, const std::string& start_key,
+                                                        const std::string& end_key) {
+  dingodb::pb::coordinator::DeadRange dead_range;
+  dead_range.set_id(id);
+  *dead_range.mutable_range() = GenRange(start_key, end_key);
+  return dead_range;
+}
+
+TEST(DeadRangeTest, ReviveByAddedRegion) {
+  auto engine = NewRawEngine<dingodb::RawRocksEngine>("  dbPath: " + kDbPath + "\n");
+  ASSERT_NE(nullptr, engine);
+
+  dingodb::StoreControl store_control;
+  store_control.SetDeadRanges(1, {GenDeadRange(10, "a", "c"), GenDeadRange(11, "x", "y")});
+  store_control.UpdateDeadRanges(std::vector<dingodb::pb::common::Range>{});
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "b"));
+
+  // Region added over a dead range keep its data before the next heartbeat.
+  store_control.ReviveDeadRanges(GenRange("b", "d"));
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "b"));
+  EXPECT_TRUE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "x1"));
+
+  auto writer = engine->NewWriter(kDefaultCf);
+  ASSERT_TRUE(writer->KvPut(GenKv("b1", "value")).ok());
+  ASSERT_TRUE(writer->KvPut(GenKv("x1", "value")).ok());
+  ASSERT_TRUE(engine->CompactRange(kDefaultCf, GenRange("a", "z")).ok());
+
+  auto reader = engine->NewReader(kDefaultCf);
+  std::string value;
+  EXPECT_TRUE(reader->KvGet("b1", value).ok());
+  EXPECT_FALSE(reader->KvGet("x1", value).ok());
+
+  // Heartbeat after the region is added keep the range alive.
+  store_control.UpdateDeadRanges({GenRange("b", "d")});
+  EXPECT_FALSE(dingodb::DeadRange::Contains(*dingodb::DeadRange::Get(), "b"));
+  ASSERT_TRUE(engine->CompactRange(kDefaultCf, GenRange("a", "z")).ok());
+  EXPECT_TRUE(reader->KvGet("b1", value).ok());
+
+  dingodb::DeadRange::Update({});
+  engine.reset();
+  std::filesystem::remove_all(kDbPath);
+}
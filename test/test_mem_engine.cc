@@ -0,0 +1,246 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/mem_table.h"
+#include "engine/raw_mem_engine.h"
+#include "engine_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+class RawMemEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    engine_ = NewRawEngine<dingodb::RawMemEngine>();
+    ASSERT_NE(nullptr, engine_);
+  }
+  void TearDown() override {}
+
+  std::shared_ptr<dingodb::RawMemEngine> engine_;
+};
+
+TEST_F(RawMemEngineTest, PutAndGet) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+  EXPECT_EQ(nullptr, engine_->NewWriter("not_exist_cf"));
+
+  EXPECT_TRUE(writer->KvPut(GenKv("key1", "value1")).ok());
+  EXPECT_TRUE(writer->KvBatchPut({GenKv("key2", "value2"), GenKv("key3", "value3")}).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet("key1", value).ok());
+  EXPECT_EQ("value1", value);
+  EXPECT_TRUE(reader->KvGet("key3", value).ok());
+  EXPECT_EQ("value3", value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet("key4", value).error_code());
+
+  // Overwrite
+  EXPECT_TRUE(writer->KvPut(GenKv("key1", "value11")).ok());
+  EXPECT_TRUE(reader->KvGet("key1", value).ok());
+  EXPECT_EQ("value11", value);
+
+  // Other column family is isolated
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, engine_->NewReader("meta")->KvGet("key1", value).error_code());
+}
+
+TEST_F(RawMemEngineTest, ScanAndCount) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+  EXPECT_TRUE(writer->KvBatchPut({GenKv("c", "3"), GenKv("a", "1"), GenKv("b", "2"), GenKv("d", "4")}).ok());
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan("a", "d", kvs).ok());
+  ASSERT_EQ(3, kvs.size());
+  EXPECT_EQ("a", kvs[0].key());
+  EXPECT_EQ("b", kvs[1].key());
+  EXPECT_EQ("c", kvs[2].key());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount("b", "z", count).ok());
+  EXPECT_EQ(3, count);
+
+  std::vector<std::string> keys;
+  auto iter = reader->NewIterator("b", "d");
+  for (; iter->HasNext(); iter->Next()) {
+    std::string key;
+    std::string value;
+    iter->GetKV(key, value);
+    keys.push_back(key);
+  }
+  EXPECT_EQ(std::vector<std::string>({"b", "c"}), keys);
+}
+
+TEST_F(RawMemEngineTest, DeleteAndDeleteRange) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+  EXPECT_TRUE(writer->KvBatchPut({GenKv("a", "1"), GenKv("b", "2"), GenKv("c", "3"), GenKv("d", "4")}).ok());
+
+  std::string value;
+  EXPECT_TRUE(writer->KvDelete("a").ok());
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet("a", value).error_code());
+
+  dingodb::pb::common::Range range;
+  range.set_start_key("b");
+  range.set_end_key("d");
+  EXPECT_TRUE(writer->KvDeleteRange(range).ok());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount("a", "z", count).ok());
+  EXPECT_EQ(1, count);
+  EXPECT_TRUE(reader->KvGet("d", value).ok());
+}
+
+TEST_F(RawMemEngineTest, PutIfAbsentAndCompareAndSet) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+
+  EXPECT_TRUE(writer->KvPutIfAbsent(GenKv("key1", "value1")).ok());
+  EXPECT_EQ(dingodb::pb::error::EKEY_EXIST, writer->KvPutIfAbsent(GenKv("key1", "value2")).error_code());
+
+  // Atomic batch put nothing when any key exist
+  std::vector<std::string> put_keys;
+  auto status = writer->KvBatchPutIfAbsent({GenKv("key1", "v"), GenKv("key2", "v")}, put_keys, true);
+  EXPECT_FALSE(status.ok());
+  EXPECT_TRUE(put_keys.empty());
+  std::string value;
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet("key2", value).error_code());
+
+  put_keys.clear();
+  EXPECT_TRUE(writer->KvBatchPutIfAbsent({GenKv("key1", "v"), GenKv("key2", "v")}, put_keys, false).ok());
+  EXPECT_EQ(std::vector<std::string>({"key2"}), put_keys);
+
+  EXPECT_FALSE(writer->KvCompareAndSet(GenKv("key1", "other"), "value3").ok());
+  EXPECT_TRUE(writer->KvCompareAndSet(GenKv("key1", "value1"), "value3").ok());
+  EXPECT_TRUE(reader->KvGet("key1", value).ok());
+  EXPECT_EQ("value3", value);
+}
+
+TEST_F(RawMemEngineTest, Snapshot) {
+  auto writer = engine_->NewWriter(kDefaultCf);
+  auto reader = engine_->NewReader(kDefaultCf);
+  EXPECT_TRUE(writer->KvPut(GenKv("key1", "value1")).ok());
+
+  auto snapshot = engine_->GetSnapshot();
+  EXPECT_TRUE(writer->KvPut(GenKv("key1", "value2")).ok());
+  EXPECT_TRUE(writer->KvPut(GenKv("key2", "value2")).ok());
+  EXPECT_TRUE(writer->KvDelete("key1").ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(snapshot, "key1", value).ok());
+  EXPECT_EQ("value1", value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(snapshot, "key2", value).error_code());
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(snapshot, "key", "kez", kvs).ok());
+  EXPECT_EQ(1, kvs.size());
+
+  engine_->ReleaseSnapshot(snapshot);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet("key1", value).error_code());
+  EXPECT_TRUE(reader->KvGet("key2", value).ok());
+}
+
+// Values are "key:n", a reader seeing a freed node or version finds a value not of its key.
+TEST(MemTableTest, ConcurrentReadWriteAndReclaim) {
+  const int kKeyNum = 64;
+  const int kWriteNum = 5000;
+  dingodb::MemTable table;
+  std::atomic<bool> stopped{false};
+  std::atomic<int64_t> max_memory_usage{0};
+
+  auto writer = [&](int id) {
+    std::mt19937 random(id);
+    for (int i = 0; i < kWriteNum; ++i) {
+      dingodb::MemTable::WriteBatch batch(&table);
+      int k = random() % kKeyNum;
+      switch (random() % 4) {
+        case 0:
+          batch.Delete(GenKey(k));
+          break;
+        case 1:
+          batch.DeleteRange(GenKey(k), GenKey(k + 4));
+          break;
+        default:
+          batch.Put(GenKey(k), GenKey(k) + ":" + std::to_string(i));
+          batch.Put(GenKey(k + 1), GenKey(k + 1) + ":" + std::to_string(i));
+      }
+      max_memory_usage = std::max(max_memory_usage.load(), table.ApproximateMemoryUsage());
+    }
+  };
+
+  std::atomic<int64_t> bad_reads{0};
+  auto getter = [&](int id) {
+    std::mt19937 random(id);
+    while (!stopped) {
+      std::string key = GenKey(random() % kKeyNum);
+      std::string value;
+      if (table.Get(key, 0, value) && value.compare(0, key.size() + 1, key + ":") != 0) {
+        ++bad_reads;
+      }
+    }
+  };
+
+  auto scanner = [&]() {
+    while (!stopped) {
+      dingodb::MemTable::Iterator iter(&table, 0);
+      std::string last_key;
+      for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+        if (iter.key() <= last_key || iter.value().compare(0, iter.key().size() + 1, iter.key() + ":") != 0) {
+          ++bad_reads;
+        }
+        last_key = iter.key();
+      }
+    }
+  };
+
+  std::vector<std::thread> readers;
+  readers.emplace_back(getter, 100);
+  readers.emplace_back(getter, 101);
+  readers.emplace_back(scanner);
+  readers.emplace_back(scanner);
+  std::vector<std::thread> writers;
+  writers.emplace_back(writer, 1);
+  writers.emplace_back(writer, 2);
+  for (auto& thread : writers) {
+    thread.join();
+  }
+  stopped = true;
+  for (auto& thread : readers) {
+    thread.join();
+  }
+  EXPECT_EQ(0, bad_reads.load());
+
+  // Without readers and snapshots, retired nodes and versions are freed within two more writes.
+  {
+    dingodb::MemTable::WriteBatch batch(&table);
+    batch.DeleteRange(GenKey(0), GenKey(kKeyNum + 1));
+  }
+  for (int i = 0; i < 3; ++i) {
+    dingodb::MemTable::WriteBatch batch(&table);
+    batch.Put("z", "z:" + std::to_string(i));
+  }
+  std::string value;
+  EXPECT_FALSE(table.Get(GenKey(1), 0, value));
+  EXPECT_GT(max_memory_usage.load(), 4 * 1024);
+  EXPECT_LT(table.ApproximateMemoryUsage(), 1024);
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "proto/error.pb.h"
+#include "proto/meta.pb.h"
+#include "sdk/meta_cache.h"
+
+static dingodb::pb::meta::DingoCommonId GenTableId(uint64_t table_id) {
+  dingodb::pb::meta::DingoCommonId id;
+  id.set_entity_type(dingodb::pb::meta::EntityType::ENTITY_TYPE_TABLE);
+  id.set_parent_entity_id(dingodb::pb::meta::ReservedSchemaIds::DINGO_SCHEMA);
+  id.set_entity_id(table_id);
+  return id;
+}
+
+static void AddPart(dingodb::pb::meta::Table& table, uint64_t region_id, const std::string& start_key,
+                    const std::string& end_key, int leader_port) {
+  auto* part = table.add_parts();
+  part->mutable_id()->set_entity_id(region_id);
+  part->mutable_range()->set_start_key(start_key);
+  part->mutable_range()->set_end_key(end_key);
+  if (leader_port > 0) {
+    part->mutable_leader()->set_host("127.0.0.1");
+    part->mutable_leader()->set_port(leader_port);
+  }
+}
+
+// [b, d) [d, f) [f, )
+static dingodb::pb::meta::Table GenTable(uint64_t table_id) {
+  dingodb::pb::meta::Table table;
+  table.mutable_id()->CopyFrom(GenTableId(table_id));
+  AddPart(table, 1001, "d", "f", 20001);
+  AddPart(table, 1000, "b", "d", 20001);
+  AddPart(table, 1002, "f", "", 0);
+  return table;
+}
+
+TEST(MetaCacheTest, Lookup) {
+  dingodb::sdk::MetaCache meta_cache(nullptr);
+  ASSERT_TRUE(meta_cache.Update(GenTable(100)));
+
+  std::shared_ptr<const dingodb::sdk::RegionRoute> route;
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "b", route).ok());
+  EXPECT_EQ(1000, route->region_id);
+  EXPECT_TRUE(route->has_leader);
+  EXPECT_EQ(20001, route->leader.port);
+
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "czzz", route).ok());
+  EXPECT_EQ(1000, route->region_id);
+
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "d", route).ok());
+  EXPECT_EQ(1001, route->region_id);
+
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "zzzz", route).ok());
+  EXPECT_EQ(1002, route->region_id);
+  EXPECT_FALSE(route->has_leader);
+
+  auto status = meta_cache.Lookup(GenTableId(100), "a", route);
+  EXPECT_EQ(dingodb::pb::error::EKEY_OUT_OF_RANGE, status.error_code());
+  EXPECT_EQ(nullptr, route);
+}
+
+TEST(MetaCacheTest, Invalidate) {
+  dingodb::sdk::MetaCache meta_cache(nullptr);
+  ASSERT_TRUE(meta_cache.Update(GenTable(100)));
+
+  std::shared_ptr<const dingodb::sdk::RegionRoute> old_route;
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "c", old_route).ok());
+
+  // A newer fetch is not dropped by the route of older one.
+  ASSERT_TRUE(meta_cache.Update(GenTable(100)));
+  meta_cache.Invalidate(100, old_route);
+  std::shared_ptr<const dingodb::sdk::RegionRoute> route;
+  ASSERT_TRUE(meta_cache.Lookup(GenTableId(100), "c", route).ok());
+  EXPECT_NE(old_route, route);
+
+  // Table is fetched again after invalidate, no coordinator here.
+  meta_cache.Invalidate(100, route);
+  auto status = meta_cache.Lookup(GenTableId(100), "c", route);
+  EXPECT_EQ(dingodb::pb::error::EINTERNAL, status.error_code());
+
+  dingodb::pb::meta::Table empty_table;
+  empty_table.mutable_id()->CopyFrom(GenTableId(101));
+  EXPECT_FALSE(meta_cache.Update(empty_table));
+}
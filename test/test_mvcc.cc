@@ -0,0 +1,167 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "engine/mvcc.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine_test_helper.h"
+#include "proto/error.pb.h"
+
+static const std::string kDbPath = "./mvcc_test_db";
+
+TEST(MvccTest, EncodeDecodeKey) {
+  std::vector<std::string> user_keys = {"a", "abcdefgh", "abcdefghi", std::string("a\0b", 3)};
+  for (const auto& user_key : user_keys) {
+    std::string encode_key = dingodb::Mvcc::EncodeKey(user_key, 100);
+
+    std::string decode_key;
+    uint64_t ts = 0;
+    EXPECT_TRUE(dingodb::Mvcc::DecodeKey(encode_key, decode_key, ts));
+    EXPECT_EQ(user_key, decode_key);
+    EXPECT_EQ(100, ts);
+  }
+}
+
+TEST(MvccTest, KeyOrder) {
+  // user key ascending, then ts descending
+  std::vector<std::string> encode_keys = {
+      dingodb::Mvcc::EncodeKey("a", 10),  dingodb::Mvcc::EncodeKey("a", 5),         dingodb::Mvcc::EncodeKey("ab", 20),
+      dingodb::Mvcc::EncodeKey("ab", 1), dingodb::Mvcc::EncodeKey("abcdefgh", 3), dingodb::Mvcc::EncodeKey("b", 7),
+  };
+
+  std::vector<std::string> sorted_keys = encode_keys;
+  std::sort(sorted_keys.begin(), sorted_keys.end());
+
+  EXPECT_EQ(encode_keys, sorted_keys);
+}
+
+TEST(MvccTest, Value) {
+  std::string put_value = dingodb::Mvcc::EncodeValue("value", false);
+  EXPECT_FALSE(dingodb::Mvcc::IsDeleteValue(put_value));
+  EXPECT_EQ("value", dingodb::Mvcc::DecodeValue(put_value));
+
+  std::string delete_value = dingodb::Mvcc::EncodeValue("", true);
+  EXPECT_TRUE(dingodb::Mvcc::IsDeleteValue(delete_value));
+}
+
+TEST(MvccTest, SafePoint) {
+  dingodb::Mvcc::SetSafePoint(100);
+  dingodb::Mvcc::SetSafePoint(50);
+
+  EXPECT_EQ(100, dingodb::Mvcc::GetSafePoint());
+}
+
+class MvccEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // Column family mvcc is appended to the default and meta list of the helper config.
+    engine_ = NewRawEngine<dingodb::RawRocksEngine>("    - " + dingodb::Constant::kStoreMvccCF + "\n  dbPath: " +
+                                                    kDbPath + "\n");
+    ASSERT_NE(nullptr, engine_);
+    reader_ = std::make_shared<dingodb::MvccReader>(engine_->NewReader(dingodb::Constant::kStoreMvccCF));
+    writer_ = std::make_shared<dingodb::MvccWriter>(engine_->NewWriter(dingodb::Constant::kStoreMvccCF));
+  }
+  void TearDown() override {
+    reader_.reset();
+    writer_.reset();
+    engine_.reset();
+    std::filesystem::remove_all(kDbPath);
+  }
+
+  // Versions of user_key in the mvcc column family, newest first.
+  std::vector<uint64_t> GetVersions(const std::string& user_key) {
+    std::vector<uint64_t> versions;
+    auto reader = engine_->NewReader(dingodb::Constant::kStoreMvccCF);
+    auto iter =
+        reader->NewIterator(dingodb::Mvcc::EncodeKeyPrefix(user_key), dingodb::Mvcc::EncodeKey(user_key, 0) + '\0');
+    for (; iter->HasNext(); iter->Next()) {
+      std::string key;
+      std::string value;
+      iter->GetKV(key, value);
+      std::string decode_key;
+      uint64_t ts = 0;
+      EXPECT_TRUE(dingodb::Mvcc::DecodeKey(key, decode_key, ts));
+      versions.push_back(ts);
+    }
+    return versions;
+  }
+
+  std::shared_ptr<dingodb::RawRocksEngine> engine_;
+  std::shared_ptr<dingodb::MvccReader> reader_;
+  std::shared_ptr<dingodb::MvccWriter> writer_;
+};
+
+TEST_F(MvccEngineTest, ReadAtTs) {
+  ASSERT_TRUE(writer_->KvPut(1200, GenKv("a", "v1200")).ok());
+  ASSERT_TRUE(writer_->KvPut(1300, GenKv("a", "v1300")).ok());
+  ASSERT_TRUE(writer_->KvPut(1300, GenKv("b", "v1300")).ok());
+  ASSERT_TRUE(writer_->KvDelete(1400, "b").ok());
+
+  std::string value;
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader_->KvGet(1100, "a", value).error_code());
+  ASSERT_TRUE(reader_->KvGet(1200, "a", value).ok());
+  EXPECT_EQ("v1200", value);
+  ASSERT_TRUE(reader_->KvGet(1299, "a", value).ok());
+  EXPECT_EQ("v1200", value);
+  ASSERT_TRUE(reader_->KvGet(2000, "a", value).ok());
+  EXPECT_EQ("v1300", value);
+
+  // Delete hides older versions from later reads only.
+  ASSERT_TRUE(reader_->KvGet(1399, "b", value).ok());
+  EXPECT_EQ("v1300", value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader_->KvGet(1400, "b", value).error_code());
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  ASSERT_TRUE(reader_->KvScan(1350, "a", "c", kvs).ok());
+  ASSERT_EQ(2, kvs.size());
+  EXPECT_EQ("v1300", kvs[0].value());
+  EXPECT_EQ("b", kvs[1].key());
+
+  kvs.clear();
+  ASSERT_TRUE(reader_->KvScan(1400, "a", "c", kvs).ok());
+  ASSERT_EQ(1, kvs.size());
+  EXPECT_EQ("a", kvs[0].key());
+}
+
+TEST_F(MvccEngineTest, GcBelowSafePoint) {
+  for (uint64_t ts : {1200, 1300, 1400}) {
+    ASSERT_TRUE(writer_->KvPut(ts, GenKv("a", "v" + std::to_string(ts))).ok());
+  }
+  ASSERT_TRUE(writer_->KvPut(1200, GenKv("b", "v1200")).ok());
+  ASSERT_TRUE(writer_->KvDelete(1300, "b").ok());
+
+  dingodb::Mvcc::SetSafePoint(1350);
+  dingodb::pb::common::Range range;
+  range.set_start_key("");
+  range.set_end_key("\xff");
+  ASSERT_TRUE(engine_->CompactRange(dingodb::Constant::kStoreMvccCF, range).ok());
+
+  // Versions newer than safe point and the newest one not newer than it are kept.
+  EXPECT_EQ(std::vector<uint64_t>({1400, 1300}), GetVersions("a"));
+  EXPECT_EQ(std::vector<uint64_t>({1300}), GetVersions("b"));
+
+  std::string value;
+  ASSERT_TRUE(reader_->KvGet(1350, "a", value).ok());
+  EXPECT_EQ("v1300", value);
+  ASSERT_TRUE(reader_->KvGet(1500, "a", value).ok());
+  EXPECT_EQ("v1400", value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader_->KvGet(1350, "b", value).error_code());
+}
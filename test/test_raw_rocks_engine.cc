@@ -0,0 +1,170 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/raw_rocks_engine.h"
+#include "engine_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "rocksdb/table.h"
+
+static const std::string kDbPath = "./raw_rocks_engine_test_db";
+
+class RawRocksEngineTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    engine_ = NewRawEngine<dingodb::RawRocksEngine>("  dbPath: " + kDbPath + "\n");
+    ASSERT_NE(nullptr, engine_);
+  }
+  void TearDown() override {
+    engine_.reset();
+    std::filesystem::remove_all(kDbPath);
+  }
+
+  std::shared_ptr<dingodb::RawRocksEngine> engine_;
+};
+
+TEST_F(RawRocksEngineTest, BulkLoadMode) {
+  EXPECT_EQ(dingodb::pb::error::EILLEGAL_PARAMTETERS, engine_->SetBulkLoadMode("not_exist_cf", true).error_code());
+
+  EXPECT_TRUE(engine_->SetBulkLoadMode(kDefaultCf, true).ok());
+  EXPECT_TRUE(engine_->IsBulkLoadMode(kDefaultCf));
+  // Enable again is no-op.
+  EXPECT_TRUE(engine_->SetBulkLoadMode(kDefaultCf, true).ok());
+
+  // Option changed in bulk load mode take effect when the mode end.
+  std::vector<std::string> need_reopen_options;
+  EXPECT_TRUE(engine_->SetOptions(kDefaultCf, {{"disable_auto_compactions", "false"}}, need_reopen_options).ok());
+  EXPECT_TRUE(need_reopen_options.empty());
+
+  auto writer = engine_->NewWriter(kDefaultCf);
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  for (int i = 0; i < 1000; ++i) {
+    dingodb::pb::common::KeyValue kv;
+    kv.set_key("key" + std::to_string(i));
+    kv.set_value("value" + std::to_string(i));
+    kvs.push_back(kv);
+  }
+  EXPECT_TRUE(writer->KvBatchPut(kvs).ok());
+
+  // Compaction run in background, return at once and data is readable.
+  EXPECT_TRUE(engine_->SetBulkLoadMode(kDefaultCf, false).ok());
+  EXPECT_FALSE(engine_->IsBulkLoadMode(kDefaultCf));
+
+  std::string value;
+  EXPECT_TRUE(engine_->NewReader(kDefaultCf)->KvGet("key999", value).ok());
+  EXPECT_EQ("value999", value);
+}
+
+TEST_F(RawRocksEngineTest, SetOptions) {
+  std::vector<std::string> need_reopen_options;
+  EXPECT_TRUE(engine_
+                  ->SetOptions(kDefaultCf, {{"num_levels", "5"}, {"level0_file_num_compaction_trigger", "8"}},
+                               need_reopen_options)
+                  .ok());
+  ASSERT_EQ(1, need_reopen_options.size());
+  EXPECT_EQ("num_levels", need_reopen_options[0]);
+
+  need_reopen_options.clear();
+  EXPECT_TRUE(engine_->SetOptions("", {{"max_background_jobs", "4"}, {"use_fsync", "true"}}, need_reopen_options).ok());
+  ASSERT_EQ(1, need_reopen_options.size());
+  EXPECT_EQ("use_fsync", need_reopen_options[0]);
+
+  // Mutable option with bad value is an error, not need reopen.
+  need_reopen_options.clear();
+  EXPECT_EQ(dingodb::pb::error::EILLEGAL_PARAMTETERS,
+            engine_->SetOptions("", {{"max_background_jobs", "abc"}}, need_reopen_options).error_code());
+  EXPECT_TRUE(need_reopen_options.empty());
+}
+
+TEST_F(RawRocksEngineTest, SetOptionsAllOrNone) {
+  // One bad value fails the call, the other options are not applied either.
+  std::vector<std::string> need_reopen_options;
+  int max_background_jobs = engine_->GetDBOptions().max_background_jobs;
+  std::map<std::string, std::string> db_options = {{"max_background_jobs", std::to_string(max_background_jobs + 2)},
+                                                   {"max_open_files", "abc"}};
+  EXPECT_EQ(dingodb::pb::error::EILLEGAL_PARAMTETERS,
+            engine_->SetOptions("", db_options, need_reopen_options).error_code());
+  EXPECT_EQ(max_background_jobs, engine_->GetDBOptions().max_background_jobs);
+
+  int trigger = engine_->GetCfOptions(kDefaultCf).level0_file_num_compaction_trigger;
+  std::map<std::string, std::string> cf_options = {
+      {"level0_file_num_compaction_trigger", std::to_string(trigger + 2)}, {"write_buffer_size", "abc"}};
+  EXPECT_EQ(dingodb::pb::error::EILLEGAL_PARAMTETERS,
+            engine_->SetOptions(kDefaultCf, cf_options, need_reopen_options).error_code());
+  EXPECT_EQ(trigger, engine_->GetCfOptions(kDefaultCf).level0_file_num_compaction_trigger);
+}
+
+TEST_F(RawRocksEngineTest, ReloadDBOptions) {
+  engine_->ReloadOptions(GenEngineConfig("  dbPath: " + kDbPath + "\n  dbOptions:\n    max_background_jobs: 7\n"));
+  EXPECT_EQ(7, engine_->GetDBOptions().max_background_jobs);
+
+  // Immutable option is not applied at runtime, only at open.
+  engine_->ReloadOptions(GenEngineConfig("  dbPath: " + kDbPath +
+                                         "\n  dbOptions:\n    max_background_jobs: 7\n    use_fsync: true\n"));
+  EXPECT_FALSE(engine_->GetDBOptions().use_fsync);
+
+  engine_.reset();
+  engine_ = NewRawEngine<dingodb::RawRocksEngine>("  dbPath: " + kDbPath +
+                                                  "\n  dbOptions:\n    max_background_jobs: 7\n    use_fsync: true\n");
+  ASSERT_NE(nullptr, engine_);
+  EXPECT_EQ(7, engine_->GetDBOptions().max_background_jobs);
+  EXPECT_TRUE(engine_->GetDBOptions().use_fsync);
+}
+
+TEST_F(RawRocksEngineTest, BlobOptions) {
+  engine_.reset();
+  engine_ = NewRawEngine<dingodb::RawRocksEngine>(
+      "  dbPath: " + kDbPath +
+      "\n  base:\n"
+      "    enable_blob_files: 1\n"
+      "    min_blob_size: 1024\n"
+      "    blob_file_size: 1048576\n"
+      "    blob_compression_type: zstd\n"
+      "    enable_blob_garbage_collection: 0\n"
+      "    blob_garbage_collection_age_cutoff: 0.5\n"
+      "    blob_garbage_collection_force_threshold: 0.8\n");
+  ASSERT_NE(nullptr, engine_);
+
+  auto cf_options = engine_->GetCfOptions(kDefaultCf);
+  EXPECT_TRUE(cf_options.enable_blob_files);
+  EXPECT_EQ(1024, cf_options.min_blob_size);
+  EXPECT_EQ(1048576, cf_options.blob_file_size);
+  EXPECT_EQ(rocksdb::CompressionType::kZSTD, cf_options.blob_compression_type);
+  EXPECT_FALSE(cf_options.enable_blob_garbage_collection);
+  EXPECT_DOUBLE_EQ(0.5, cf_options.blob_garbage_collection_age_cutoff);
+  EXPECT_DOUBLE_EQ(0.8, cf_options.blob_garbage_collection_force_threshold);
+
+  // Blobs share the block cache of the column family.
+  auto* table_options = cf_options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>();
+  ASSERT_NE(nullptr, table_options);
+  ASSERT_NE(nullptr, cf_options.blob_cache);
+  EXPECT_EQ(table_options->block_cache, cf_options.blob_cache);
+
+  // Large value is written to blob file and read back.
+  auto writer = engine_->NewWriter(kDefaultCf);
+  std::string large_value(4096, 'v');
+  EXPECT_TRUE(writer->KvPut(GenKv("large", large_value)).ok());
+  engine_->Flush(kDefaultCf);
+  std::string value;
+  EXPECT_TRUE(engine_->NewReader(kDefaultCf)->KvGet("large", value).ok());
+  EXPECT_EQ(large_value, value);
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "brpc/closure_guard.h"
+#include "brpc/controller.h"
+#include "brpc/server.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/meta.pb.h"
+#include "proto/store.pb.h"
+#include "sdk/client.h"
+
+static const uint64_t kTableId = 100;
+
+static dingodb::pb::meta::DingoCommonId GenTableId() {
+  dingodb::pb::meta::DingoCommonId id;
+  id.set_entity_type(dingodb::pb::meta::EntityType::ENTITY_TYPE_TABLE);
+  id.set_parent_entity_id(dingodb::pb::meta::ReservedSchemaIds::DINGO_SCHEMA);
+  id.set_entity_id(kTableId);
+  return id;
+}
+
+static dingodb::pb::common::KeyValue GenKv(const std::string& key, const std::string& value) {
+  dingodb::pb::common::KeyValue kv;
+  kv.set_key(key);
+  kv.set_value(value);
+  return kv;
+}
+
+// Table of region 1001 [a, m) and region 1002 [m, ), leader of both is the mock server.
+class MockMetaService : public dingodb::pb::meta::MetaService {
+ public:
+  void GetTable(google::protobuf::RpcController* /*controller*/, const dingodb::pb::meta::GetTableRequest* request,
+                dingodb::pb::meta::GetTableResponse* response, google::protobuf::Closure* done) override {
+    brpc::ClosureGuard done_guard(done);
+    ++get_table_count;
+
+    auto* table = response->mutable_table();
+    table->mutable_id()->CopyFrom(request->table_id());
+    for (const auto& [region_id, range] : std::map<uint64_t, std::pair<std::string, std::string> >{
+             {1001, {"a", "m"}}, {1002, {"m", ""}}}) {
+      auto* part = table->add_parts();
+      part->mutable_id()->set_entity_id(region_id);
+      part->mutable_range()->set_start_key(range.first);
+      part->mutable_range()->set_end_key(range.second);
+      part->mutable_leader()->set_host("127.0.0.1");
+      part->mutable_leader()->set_port(port);
+    }
+  }
+
+  int port = 0;
+  std::atomic<int> get_table_count{0};
+};
+
+// Keeps kvs in memory, the first not_leader_count KvBatchPut and KvPutIfAbsent reply ERAFT_NOTLEADER,
+// the first fail_after_apply_count put if absent apply kvs and then fail the rpc.
+class MockStoreService : public dingodb::pb::store::StoreService {
+ public:
+  void KvBatchPut(google::protobuf::RpcController* /*controller*/, const dingodb::pb::store::KvBatchPutRequest* request,
+                  dingodb::pb::store::KvBatchPutResponse* response, google::protobuf::Closure* done) override {
+    brpc::ClosureGuard done_guard(done);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not_leader_count > 0) {
+      --not_leader_count;
+      response->mutable_error()->set_errcode(dingodb::pb::error::ERAFT_NOTLEADER);
+      return;
+    }
+    for (const auto& kv : request->kvs()) {
+      kvs[kv.key()] = kv.value();
+    }
+  }
+
+  void KvPutIfAbsent(google::protobuf::RpcController* controller,
+                     const dingodb::pb::store::KvPutIfAbsentRequest* request,
+                     dingodb::pb::store::KvPutIfAbsentResponse* response, google::protobuf::Closure* done) override {
+    brpc::ClosureGuard done_guard(done);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++put_if_absent_count;
+    if (not_leader_count > 0) {
+      --not_leader_count;
+      response->mutable_error()->set_errcode(dingodb::pb::error::ERAFT_NOTLEADER);
+      return;
+    }
+    if (!kvs.emplace(request->kv().key(), request->kv().value()).second) {
+      response->mutable_error()->set_errcode(dingodb::pb::error::EKEY_EXIST);
+      return;
+    }
+    FailAfterApply(controller);
+  }
+
+  void KvBatchPutIfAbsent(google::protobuf::RpcController* controller,
+                          const dingodb::pb::store::KvBatchPutIfAbsentRequest* request,
+                          dingodb::pb::store::KvBatchPutIfAbsentResponse* response,
+                          google::protobuf::Closure* done) override {
+    brpc::ClosureGuard done_guard(done);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++batch_put_if_absent_count;
+    if (!request->allow_partial()) {
+      for (const auto& kv : request->kvs()) {
+        if (kvs.count(kv.key()) > 0) {
+          response->mutable_error()->set_errcode(dingodb::pb::error::EKEY_EXIST);
+          return;
+        }
+      }
+    }
+    for (const auto& kv : request->kvs()) {
+      if (kvs.emplace(kv.key(), kv.value()).second) {
+        response->add_put_keys(kv.key());
+      }
+    }
+    FailAfterApply(controller);
+  }
+
+  void FailAfterApply(google::protobuf::RpcController* controller) {
+    if (fail_after_apply_count > 0) {
+      --fail_after_apply_count;
+      static_cast<brpc::Controller*>(controller)->SetFailed("Fail after apply");
+    }
+  }
+
+  std::mutex mutex;
+  std::map<std::string, std::string> kvs;
+  int not_leader_count = 0;
+  int fail_after_apply_count = 0;
+  int put_if_absent_count = 0;
+  int batch_put_if_absent_count = 0;
+};
+
+class SdkClientTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(0, server_.AddService(&meta_service_, brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server_.AddService(&store_service_, brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server_.Start(brpc::PortRange(20000, 30000), nullptr));
+    meta_service_.port = server_.listen_address().port;
+
+    dingodb::sdk::Client::Options options;
+    options.coordinator_addrs = "127.0.0.1:" + std::to_string(meta_service_.port);
+    options.retry_interval_ms = 1;
+    ASSERT_TRUE(client_.Init(options));
+  }
+  void TearDown() override {
+    server_.Stop(0);
+    server_.Join();
+  }
+
+  MockMetaService meta_service_;
+  MockStoreService store_service_;
+  brpc::Server server_;
+  dingodb::sdk::Client client_;
+};
+
+TEST_F(SdkClientTest, RetryNotLeader) {
+  store_service_.not_leader_count = 1;
+  ASSERT_TRUE(client_.KvBatchPut(GenTableId(), {GenKv("b", "1"), GenKv("n", "2")}).ok());
+
+  // Table is fetched again after not leader.
+  EXPECT_EQ(2, meta_service_.get_table_count.load());
+  EXPECT_EQ(2, store_service_.kvs.size());
+  EXPECT_EQ("2", store_service_.kvs["n"]);
+}
+
+TEST_F(SdkClientTest, BatchPutIfAbsentReturnPutKeys) {
+  store_service_.kvs["b"] = "old";
+
+  std::vector<std::string> put_keys;
+  ASSERT_TRUE(
+      client_.KvBatchPutIfAbsent(GenTableId(), {GenKv("a", "1"), GenKv("b", "1"), GenKv("n", "1")}, put_keys, false)
+          .ok());
+  std::sort(put_keys.begin(), put_keys.end());
+  EXPECT_EQ(std::vector<std::string>({"a", "n"}), put_keys);
+  EXPECT_EQ("old", store_service_.kvs["b"]);
+
+  // Atomic is per region, region 1002 is written though region 1001 fails.
+  auto status =
+      client_.KvBatchPutIfAbsent(GenTableId(), {GenKv("c", "2"), GenKv("b", "2"), GenKv("o", "2")}, put_keys, true);
+  EXPECT_EQ(dingodb::pb::error::EKEY_EXIST, status.error_code());
+  EXPECT_EQ(std::vector<std::string>({"o"}), put_keys);
+  EXPECT_EQ(0, store_service_.kvs.count("c"));
+}
+
+TEST_F(SdkClientTest, PutIfAbsentNotRetryFailedRpc) {
+  store_service_.fail_after_apply_count = 1;
+  EXPECT_EQ(dingodb::pb::error::EUNKNOWN_RESULT, client_.KvPutIfAbsent(GenTableId(), GenKv("b", "1")).error_code());
+  EXPECT_EQ(1, store_service_.put_if_absent_count);
+  EXPECT_EQ("1", store_service_.kvs["b"]);
+
+  // A retry would reply EKEY_EXIST though the first rpc put the key.
+  store_service_.fail_after_apply_count = 1;
+  std::vector<std::string> put_keys;
+  auto status = client_.KvBatchPutIfAbsent(GenTableId(), {GenKv("c", "2"), GenKv("n", "2")}, put_keys, true);
+  EXPECT_EQ(dingodb::pb::error::EUNKNOWN_RESULT, status.error_code());
+  EXPECT_EQ(2, store_service_.batch_put_if_absent_count);
+  EXPECT_EQ("2", store_service_.kvs["c"]);
+  EXPECT_EQ("2", store_service_.kvs["n"]);
+}
+
+TEST_F(SdkClientTest, PutIfAbsentRetryNotLeader) {
+  store_service_.not_leader_count = 1;
+  ASSERT_TRUE(client_.KvPutIfAbsent(GenTableId(), GenKv("b", "1")).ok());
+  EXPECT_EQ(2, store_service_.put_if_absent_count);
+  EXPECT_EQ("1", store_service_.kvs["b"]);
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "engine/mem_engine.h"
+#include "engine/raft_kv_engine.h"
+#include "engine/raw_mem_engine.h"
+#include "engine/storage.h"
+#include "engine_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+TEST(StorageTest, RouteByEngineOfRegion) {
+  auto rocks_raw_engine = NewRawEngine<dingodb::RawMemEngine>();
+  auto mem_raw_engine = NewRawEngine<dingodb::RawMemEngine>();
+  ASSERT_NE(nullptr, rocks_raw_engine);
+  ASSERT_NE(nullptr, mem_raw_engine);
+  ASSERT_TRUE(rocks_raw_engine->NewWriter(kDefaultCf)->KvPut(GenKv("key", "rocks")).ok());
+  ASSERT_TRUE(mem_raw_engine->NewWriter(kDefaultCf)->KvPut(GenKv("key", "memory")).ok());
+
+  std::map<dingodb::pb::common::Engine, std::shared_ptr<dingodb::Engine> > engines;
+  engines[dingodb::pb::common::ENG_ROCKSDB] = std::make_shared<dingodb::RaftKvEngine>(rocks_raw_engine);
+  engines[dingodb::pb::common::ENG_MEMORY] = std::make_shared<dingodb::MemEngine>(mem_raw_engine);
+  dingodb::Storage storage(engines);
+
+  auto ctx = std::make_shared<dingodb::Context>();
+  ctx->SetCfName(kDefaultCf);
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+
+  ctx->SetEngineId(dingodb::pb::common::ENG_ROCKSDB);
+  ASSERT_TRUE(storage.KvGet(ctx, {"key"}, kvs).ok());
+  ASSERT_EQ(1, kvs.size());
+  EXPECT_EQ("rocks", kvs[0].value());
+
+  kvs.clear();
+  ctx->SetEngineId(dingodb::pb::common::ENG_MEMORY);
+  ASSERT_TRUE(storage.KvGet(ctx, {"key"}, kvs).ok());
+  ASSERT_EQ(1, kvs.size());
+  EXPECT_EQ("memory", kvs[0].value());
+
+  // Region of an engine not started on this store.
+  kvs.clear();
+  ctx->SetEngineId(dingodb::pb::common::ENG_XDP);
+  EXPECT_EQ(dingodb::pb::error::ESTORE_NOTEXIST_RAFTENGINE, storage.KvGet(ctx, {"key"}, kvs).error_code());
+  EXPECT_TRUE(kvs.empty());
+  EXPECT_EQ(dingodb::pb::error::ESTORE_NOTEXIST_RAFTENGINE, storage.KvPut(ctx, {GenKv("key", "xdp")}).error_code());
+}
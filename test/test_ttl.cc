@@ -0,0 +1,42 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "engine/ttl.h"
+
+TEST(TtlTest, Value) {
+  std::string value = dingodb::Ttl::EncodeValue("value", 1000);
+  EXPECT_EQ(1000, dingodb::Ttl::DecodeExpireTime(value));
+  EXPECT_EQ("value", dingodb::Ttl::DecodeValue(value));
+
+  std::string empty_value = dingodb::Ttl::EncodeValue("", 0);
+  EXPECT_EQ(0, dingodb::Ttl::DecodeExpireTime(empty_value));
+  EXPECT_EQ("", dingodb::Ttl::DecodeValue(empty_value));
+}
+
+TEST(TtlTest, Expire) {
+  EXPECT_EQ(0, dingodb::Ttl::CalcExpireTime(0, 5000));
+  EXPECT_EQ(15000, dingodb::Ttl::CalcExpireTime(10, 5000));
+
+  std::string value = dingodb::Ttl::EncodeValue("value", 15000);
+  EXPECT_FALSE(dingodb::Ttl::IsExpired(value, 14999));
+  EXPECT_TRUE(dingodb::Ttl::IsExpired(value, 15000));
+
+  // Never expire.
+  std::string forever_value = dingodb::Ttl::EncodeValue("value", 0);
+  EXPECT_FALSE(dingodb::Ttl::IsExpired(forever_value, INT64_MAX));
+}
@@ -0,0 +1,304 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/raw_xdp_engine.h"
+#include "engine/xdp_store.h"
+#include "engine_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+static std::string GenValue(int i, size_t size) {
+  std::string value = "v" + std::to_string(i) + "_";
+  value.resize(size, static_cast<char>('a' + i % 26));
+  return value;
+}
+
+class XdpTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/dingo_xdp_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(path));
+    path_ = path;
+  }
+  void TearDown() override { std::filesystem::remove_all(path_); }
+
+  std::shared_ptr<dingodb::RawXdpEngine> NewEngine() {
+    return NewRawEngine<dingodb::RawXdpEngine>("  xdpPath: " + path_ + "\n");
+  }
+
+  std::shared_ptr<dingodb::XdpStore> NewStore() {
+    dingodb::XdpStore::Options options;
+    options.path = path_ + "/store";
+    options.max_file_size = 4096;
+    auto store = std::make_shared<dingodb::XdpStore>(options);
+    return store->Open() ? store : nullptr;
+  }
+
+  std::string path_;
+};
+
+TEST_F(XdpTest, ReadAndWrite) {
+  auto engine = NewEngine();
+  ASSERT_NE(nullptr, engine);
+  auto writer = engine->NewWriter(kDefaultCf);
+  auto reader = engine->NewReader(kDefaultCf);
+
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenValue(i, 32))).ok());
+  }
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(10), "new")).ok());
+  EXPECT_TRUE(writer->KvDelete(GenKey(11)).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(GenKey(10), value).ok());
+  EXPECT_EQ("new", value);
+  EXPECT_TRUE(reader->KvGet(GenKey(150), value).ok());
+  EXPECT_EQ(GenValue(150, 32), value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(GenKey(11), value).error_code());
+
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount("t", "u", count).ok());
+  EXPECT_EQ(199, count);
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(GenKey(5), GenKey(15), kvs).ok());
+  ASSERT_EQ(9, kvs.size());
+  EXPECT_EQ(GenKey(5), kvs[0].key());
+  EXPECT_EQ("new", kvs[5].value());
+  EXPECT_EQ(GenKey(12), kvs[6].key());
+
+  dingodb::pb::common::Range range;
+  range.set_start_key(GenKey(20));
+  range.set_end_key(GenKey(180));
+  EXPECT_TRUE(writer->KvDeleteRange(range).ok());
+  EXPECT_TRUE(reader->KvCount("t", "u", count).ok());
+  EXPECT_EQ(39, count);
+
+  std::vector<std::string> put_keys;
+  EXPECT_EQ(dingodb::pb::error::EKEY_EXIST,
+            writer->KvBatchPutIfAbsent({GenKv(GenKey(1), "x"), GenKv(GenKey(30), "x")}, put_keys, true).error_code());
+  EXPECT_TRUE(writer->KvBatchPutIfAbsent({GenKv(GenKey(1), "x"), GenKv(GenKey(30), "x")}, put_keys, false).ok());
+  EXPECT_EQ(std::vector<std::string>({GenKey(30)}), put_keys);
+  EXPECT_TRUE(writer->KvCompareAndSet(GenKv(GenKey(30), "x"), "y").ok());
+  EXPECT_FALSE(writer->KvCompareAndSet(GenKv(GenKey(30), "x"), "z").ok());
+  EXPECT_TRUE(reader->KvGet(GenKey(30), value).ok());
+  EXPECT_EQ("y", value);
+}
+
+TEST_F(XdpTest, Snapshot) {
+  auto engine = NewEngine();
+  ASSERT_NE(nullptr, engine);
+  auto writer = engine->NewWriter(kDefaultCf);
+  auto reader = engine->NewReader(kDefaultCf);
+
+  EXPECT_TRUE(writer->KvBatchPut({GenKv(GenKey(1), "a"), GenKv(GenKey(2), "b")}).ok());
+  auto snapshot = engine->GetSnapshot();
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(1), "c")).ok());
+  EXPECT_TRUE(writer->KvDelete(GenKey(2)).ok());
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(3), "d")).ok());
+
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(snapshot, GenKey(1), value).ok());
+  EXPECT_EQ("a", value);
+  EXPECT_TRUE(reader->KvGet(snapshot, GenKey(2), value).ok());
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(snapshot, GenKey(3), value).error_code());
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvScan(snapshot, "t", "u", kvs).ok());
+  ASSERT_EQ(2, kvs.size());
+  EXPECT_EQ("b", kvs[1].value());
+
+  // Iterator keeps its view.
+  auto iter = reader->NewIterator("t", "u");
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(4), "e")).ok());
+  int count = 0;
+  for (; iter->HasNext(); iter->Next()) {
+    ++count;
+  }
+  EXPECT_EQ(2, count);
+}
+
+TEST_F(XdpTest, Recover) {
+  {
+    auto engine = NewEngine();
+    ASSERT_NE(nullptr, engine);
+    auto writer = engine->NewWriter(kDefaultCf);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(writer->KvPut(GenKv(GenKey(i), GenValue(i, 100))).ok());
+    }
+    EXPECT_TRUE(writer->KvPut(GenKv(GenKey(5), "new")).ok());
+    EXPECT_TRUE(writer->KvDelete(GenKey(6)).ok());
+  }
+
+  auto engine = NewEngine();
+  ASSERT_NE(nullptr, engine);
+  auto reader = engine->NewReader(kDefaultCf);
+  std::string value;
+  EXPECT_TRUE(reader->KvGet(GenKey(5), value).ok());
+  EXPECT_EQ("new", value);
+  EXPECT_EQ(dingodb::pb::error::EKEY_NOTFOUND, reader->KvGet(GenKey(6), value).error_code());
+  EXPECT_TRUE(reader->KvGet(GenKey(99), value).ok());
+  EXPECT_EQ(GenValue(99, 100), value);
+
+  // Writes after recovery are newer than recovered records.
+  auto writer = engine->NewWriter(kDefaultCf);
+  EXPECT_TRUE(writer->KvPut(GenKv(GenKey(6), "again")).ok());
+  engine = nullptr;
+  reader = nullptr;
+  writer = nullptr;
+
+  engine = NewEngine();
+  ASSERT_NE(nullptr, engine);
+  reader = engine->NewReader(kDefaultCf);
+  EXPECT_TRUE(reader->KvGet(GenKey(6), value).ok());
+  EXPECT_EQ("again", value);
+  int64_t count = 0;
+  EXPECT_TRUE(reader->KvCount("t", "u", count).ok());
+  EXPECT_EQ(100, count);
+}
+
+TEST_F(XdpTest, Merge) {
+  auto store = NewStore();
+  ASSERT_NE(nullptr, store);
+  for (int round = 0; round < 4; ++round) {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    for (int i = 0; i < 100; ++i) {
+      batch.Put(GenKey(i), GenValue(i + round, 200));
+    }
+    ASSERT_TRUE(batch.Commit());
+  }
+  {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.DeleteRange(GenKey(50), GenKey(100));
+    ASSERT_TRUE(batch.Commit());
+  }
+  EXPECT_EQ(50, store->KeyCount());
+  EXPECT_TRUE(store->NeedMerge(50));
+
+  // A view taken before merge still reads merged files.
+  auto view = store->GetView();
+  int64_t total_bytes = store->TotalBytes();
+  ASSERT_TRUE(store->Merge());
+  EXPECT_LT(store->TotalBytes(), total_bytes / 4);
+  EXPECT_FALSE(store->NeedMerge(50));
+
+  std::string value;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i < 50, store->Get(GenKey(i), value));
+    if (i < 50) {
+      EXPECT_EQ(GenValue(i + 3, 200), value);
+    }
+  }
+  EXPECT_TRUE(dingodb::XdpStore::Get(view, GenKey(10), value));
+  EXPECT_EQ(GenValue(13, 200), value);
+  view = dingodb::XdpStore::View();
+
+  // Recover from hint files of merged files.
+  {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Put(GenKey(1), "latest");
+    ASSERT_TRUE(batch.Commit());
+  }
+  store = nullptr;
+  store = NewStore();
+  ASSERT_NE(nullptr, store);
+  EXPECT_EQ(50, store->KeyCount());
+  EXPECT_TRUE(store->Get(GenKey(1), value));
+  EXPECT_EQ("latest", value);
+  EXPECT_TRUE(store->Get(GenKey(49), value));
+  EXPECT_EQ(GenValue(52, 200), value);
+  EXPECT_FALSE(store->Get(GenKey(50), value));
+}
+
+TEST_F(XdpTest, NeedMergeOfSealedFiles) {
+  auto store = NewStore();
+  ASSERT_NE(nullptr, store);
+  // Fill a sealed file with live records.
+  for (int i = 0; i < 20; ++i) {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Put(GenKey(i), GenValue(i, 200));
+    ASSERT_TRUE(batch.Commit());
+  }
+  // Garbage of the active file is not merged, it does not trigger merge.
+  for (int i = 0; i < 20; ++i) {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Put(GenKey(100), GenValue(i, 100));
+    ASSERT_TRUE(batch.Commit());
+  }
+  EXPECT_GT((store->TotalBytes() - store->LiveBytes()) * 100, 30 * store->TotalBytes());
+  EXPECT_FALSE(store->NeedMerge(30));
+
+  // Garbage of sealed file triggers merge.
+  for (int i = 0; i < 20; ++i) {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Delete(GenKey(i));
+    ASSERT_TRUE(batch.Commit());
+  }
+  EXPECT_TRUE(store->NeedMerge(30));
+  ASSERT_TRUE(store->Merge());
+  EXPECT_FALSE(store->NeedMerge(30));
+  EXPECT_EQ(1, store->KeyCount());
+}
+
+TEST_F(XdpTest, BrokenTail) {
+  auto store = NewStore();
+  ASSERT_NE(nullptr, store);
+  {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Put(GenKey(1), "a");
+    batch.Put(GenKey(2), "b");
+    ASSERT_TRUE(batch.Commit());
+  }
+  store = nullptr;
+
+  // Tail of a crashed write is ignored.
+  std::string last;
+  for (const auto& entry : std::filesystem::directory_iterator(path_ + "/store")) {
+    if (entry.path().extension() == ".data" && std::filesystem::file_size(entry.path()) > 0) {
+      last = entry.path();
+    }
+  }
+  ASSERT_FALSE(last.empty());
+  std::ofstream(last, std::ios::app) << "broken record";
+
+  store = NewStore();
+  ASSERT_NE(nullptr, store);
+  std::string value;
+  EXPECT_TRUE(store->Get(GenKey(2), value));
+  EXPECT_EQ("b", value);
+  EXPECT_EQ(2, store->KeyCount());
+}
+
+TEST_F(XdpTest, DiscardBatchNotCommitted) {
+  auto store = NewStore();
+  ASSERT_NE(nullptr, store);
+  {
+    dingodb::XdpStore::WriteBatch batch(store.get());
+    batch.Put(GenKey(1), "a");
+  }
+  std::string value;
+  EXPECT_FALSE(store->Get(GenKey(1), value));
+  EXPECT_EQ(0, store->KeyCount());
+  EXPECT_EQ(0, store->TotalBytes());
+}